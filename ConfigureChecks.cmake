@@ -119,6 +119,9 @@ endif()
 check_function_exists("getifaddrs"       HAVE_GETIFADDRS)
 check_function_exists("issetugid"        HAVE_ISSETUGID)
 check_function_exists("mkstemps"         HAVE_MKSTEMPS)
+check_function_exists("mmap"             HAVE_MMAP)
+check_function_exists("posix_fadvise"    HAVE_POSIX_FADVISE)
+check_function_exists("pread"            HAVE_PREAD)
 check_function_exists("setresgid"        HAVE_SETRESGID)
 check_function_exists("setresuid"        HAVE_SETRESUID)
 check_function_exists("strptime"         HAVE_STRPTIME)
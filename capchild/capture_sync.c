@@ -1728,6 +1728,18 @@ sync_pipe_input_cb(gint source, gpointer user_data)
         capture_input_drops(cap_session, num, name);
         break;
         }
+    case SP_IF_STATS:
+        /*
+         * Periodic per-interface statistics from dumpcap, sent whenever an
+         * interface dropped packets since the last report:
+         * "ifindex:drop_delta:queued_packets:queued_bytes".  Logged here
+         * with the arrival time so drop bursts can be lined up against
+         * what the capture child was doing at that moment; the totals
+         * still arrive via SP_DROPS at the end of the capture.
+         */
+        g_log(LOG_DOMAIN_CAPTURE, G_LOG_LEVEL_INFO,
+              "sync_pipe_input_cb: interface stats %s", buffer);
+        break;
     default:
         g_assert_not_reached();
     }
@@ -1126,6 +1126,10 @@ process_cap_file(const char *filename, gboolean need_separator)
     return 2;
   }
 
+  /* Everything we report comes from the record headers, so let file
+     formats that can do so seek past the packet data. */
+  wtap_set_skip_record_data(wth, TRUE);
+
   if (need_separator && long_report) {
     printf("\n");
   }
@@ -0,0 +1,392 @@
+/* Compare the frames of two capture files using per-frame digests,
+ * and report frames that are missing, added or reordered.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#ifdef HAVE_GETOPT_H
+#include <getopt.h>
+#endif
+
+#include <wiretap/wtap.h>
+
+#ifndef HAVE_GETOPT_LONG
+#include "wsutil/wsgetopt.h"
+#endif
+
+#include <ui/cmdarg_err.h>
+#include <ui/clopts_common.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/file_util.h>
+#include <wsutil/privileges.h>
+#include <cli_main.h>
+#include <version_info.h>
+
+#include <wsutil/report_message.h>
+
+#include "ui/failure_message.h"
+
+/* Exit status follows the diff(1) convention. */
+#define EXIT_SAME       0
+#define EXIT_DIFFERENT  1
+#define EXIT_ERROR      2
+
+/* Show command-line usage */
+static void
+print_usage(FILE *output)
+{
+    fprintf(output, "\n");
+    fprintf(output, "Usage: comparecap [options] <file1> <file2>\n");
+    fprintf(output, "\n");
+    fprintf(output, "Options:\n");
+    fprintf(output, "  -i <n>    ignore the first <n> bytes of each frame when digesting,\n");
+    fprintf(output, "            to mask volatile link-layer or tunnel headers.\n");
+    fprintf(output, "  -b <n>    digest at most <n> bytes of each frame, to mask trailers\n");
+    fprintf(output, "            or compare headers only.\n");
+    fprintf(output, "  -v        list every unmatched and reordered frame.\n");
+    fprintf(output, "  -h        display this help and exit.\n");
+    fprintf(output, "\n");
+    fprintf(output, "Exit status is 0 if the captures contain the same frames in the same\n");
+    fprintf(output, "order, 1 if they differ, 2 if an error occurred.\n");
+    fprintf(output, "\n");
+    fprintf(output, "A frame modified in flight has no matching digest on the other side,\n");
+    fprintf(output, "so it is reported once as only in <file1> and once as only in <file2>.\n");
+}
+
+/*
+ * Per-frame digest: 64-bit FNV-1a over the original frame length and
+ * the (optionally masked) captured bytes.  Plain sequential C that the
+ * compiler is free to unroll and vectorize; at 8 bytes of state per
+ * frame the table for a hundred-million-frame capture still fits in
+ * memory, which is what lets both files be processed in one streaming
+ * pass each.
+ */
+static guint64
+frame_digest(const wtap_rec *rec, const guint8 *pd, guint ignore_prefix,
+             guint max_bytes)
+{
+    guint64 hash = G_GUINT64_CONSTANT(0xcbf29ce484222325);
+    guint caplen = rec->rec_header.packet_header.caplen;
+    guint len;
+
+    /* the original length distinguishes frames truncated by the snaplen */
+    hash ^= rec->rec_header.packet_header.len;
+    hash *= G_GUINT64_CONSTANT(0x100000001b3);
+
+    if (ignore_prefix >= caplen)
+        return hash;
+    pd += ignore_prefix;
+    len = caplen - ignore_prefix;
+    if (max_bytes != 0 && len > max_bytes)
+        len = max_bytes;
+
+    while (len-- != 0) {
+        hash ^= *pd++;
+        hash *= G_GUINT64_CONSTANT(0x100000001b3);
+    }
+    return hash;
+}
+
+/* digest -> GQueue of frame numbers (guint, via GUINT_TO_POINTER),
+ * oldest first, so duplicate frames match up in capture order */
+static void
+digest_table_add(GHashTable *table, guint64 digest, guint num)
+{
+    GQueue *frames;
+
+    frames = (GQueue *)g_hash_table_lookup(table, &digest);
+    if (frames == NULL) {
+        guint64 *key = g_new(guint64, 1);
+
+        *key = digest;
+        frames = g_queue_new();
+        g_hash_table_insert(table, key, frames);
+    }
+    g_queue_push_tail(frames, GUINT_TO_POINTER(num));
+}
+
+static void
+digest_table_free_value(gpointer value)
+{
+    g_queue_free((GQueue *)value);
+}
+
+typedef struct {
+    const char *filename;
+    gboolean    verbose;
+    guint       only_count;
+} leftover_report_t;
+
+/* report the frames of file1 whose digests were never matched */
+static void
+report_leftover(gpointer key _U_, gpointer value, gpointer user_data)
+{
+    GQueue *frames = (GQueue *)value;
+    leftover_report_t *report = (leftover_report_t *)user_data;
+    GList *le;
+
+    report->only_count += g_queue_get_length(frames);
+    if (report->verbose) {
+        for (le = frames->head; le != NULL; le = le->next) {
+            printf("Only in %s: frame %u\n", report->filename,
+                   GPOINTER_TO_UINT(le->data));
+        }
+    }
+}
+
+/*
+ * General errors and warnings are reported with an console message
+ * in comparecap.
+ */
+static void
+failure_warning_message(const char *msg_format, va_list ap)
+{
+    fprintf(stderr, "comparecap: ");
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+/*
+ * Report additional information for an error in command-line arguments.
+ */
+static void
+failure_message_cont(const char *msg_format, va_list ap)
+{
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+/********************************************************************/
+/* Main function.                                                   */
+/********************************************************************/
+int
+main(int argc, char *argv[])
+{
+    char *init_progfile_dir_error;
+    wtap *wth = NULL;
+    wtap_rec rec;
+    Buffer buf;
+    int err;
+    gchar *err_info;
+    gint64 data_offset;
+    guint ignore_prefix = 0;
+    guint max_bytes = 0;        /* 0 = no limit */
+    gboolean verbose = FALSE;
+    GHashTable *digests;
+    leftover_report_t leftover;
+    guint frame_count1 = 0, frame_count2 = 0;
+    guint matched_count = 0, only_in_2_count = 0, reordered_count = 0;
+    guint high_match = 0;       /* highest file1 frame number matched so far */
+    int                          ret = EXIT_SAME;
+
+    int opt;
+    static const struct option long_options[] = {
+        {"help", no_argument, NULL, 'h'},
+        {"version", no_argument, NULL, 'V'},
+        {0, 0, 0, 0 }
+    };
+    int file_count;
+    char *filename1;
+    char *filename2;
+
+    cmdarg_err_init(failure_warning_message, failure_message_cont);
+
+    /* Initialize the version information. */
+    ws_init_version_info("Comparecap (Wireshark)", NULL, NULL, NULL);
+
+    /*
+     * Get credential information for later use.
+     */
+    init_process_policies();
+
+    /*
+     * Attempt to get the pathname of the directory containing the
+     * executable file.
+     */
+    init_progfile_dir_error = init_progfile_dir(argv[0]);
+    if (init_progfile_dir_error != NULL) {
+        fprintf(stderr,
+                "comparecap: Can't get pathname of directory containing the comparecap program: %s.\n",
+                init_progfile_dir_error);
+        g_free(init_progfile_dir_error);
+    }
+
+    init_report_message(failure_warning_message, failure_warning_message,
+                        NULL, NULL, NULL);
+
+    wtap_init(TRUE);
+
+    /* Process the options first */
+    while ((opt = getopt_long(argc, argv, "b:hi:vV", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'i':
+                ignore_prefix = (guint)get_positive_int(optarg, "ignored prefix length");
+                break;
+            case 'b':
+                max_bytes = (guint)get_positive_int(optarg, "digested byte count");
+                break;
+            case 'v':
+                verbose = TRUE;
+                break;
+            case 'h':
+                show_help_header("Compare the frames of two capture files.");
+                print_usage(stdout);
+                goto clean_exit;
+            case 'V':
+                show_version();
+                goto clean_exit;
+            case '?':
+                print_usage(stderr);
+                ret = EXIT_ERROR;
+                goto clean_exit;
+        }
+    }
+
+    /* Remaining args are file names */
+    file_count = argc - optind;
+    if (file_count == 2) {
+        filename1 = argv[optind];
+        filename2 = argv[optind+1];
+    }
+    else {
+        print_usage(stderr);
+        ret = EXIT_ERROR;
+        goto clean_exit;
+    }
+
+    digests = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+                                    g_free, digest_table_free_value);
+
+    /* Stream file1, collecting a digest per frame. */
+    wth = wtap_open_offline(filename1, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+    if (wth == NULL) {
+        cfile_open_failure_message("comparecap", filename1, err, err_info);
+        ret = EXIT_ERROR;
+        goto clean_exit;
+    }
+
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+        if (rec.rec_type != REC_TYPE_PACKET)
+            continue;
+        frame_count1++;
+        digest_table_add(digests,
+                         frame_digest(&rec, ws_buffer_start_ptr(&buf),
+                                      ignore_prefix, max_bytes),
+                         frame_count1);
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+    if (err != 0) {
+        cfile_read_failure_message("comparecap", filename1, err, err_info);
+        ret = EXIT_ERROR;
+        goto clean_exit;
+    }
+    wtap_close(wth);
+    wth = NULL;
+
+    /* Stream file2, matching each frame against file1's digests.
+     * Duplicate digests match oldest-first, so retransmissions seen at
+     * both capture points pair up in capture order. */
+    wth = wtap_open_offline(filename2, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+    if (wth == NULL) {
+        cfile_open_failure_message("comparecap", filename2, err, err_info);
+        ret = EXIT_ERROR;
+        goto clean_exit;
+    }
+
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+        guint64 digest;
+        GQueue *frames;
+
+        if (rec.rec_type != REC_TYPE_PACKET)
+            continue;
+        frame_count2++;
+        digest = frame_digest(&rec, ws_buffer_start_ptr(&buf),
+                              ignore_prefix, max_bytes);
+        frames = (GQueue *)g_hash_table_lookup(digests, &digest);
+        if (frames != NULL) {
+            guint num1 = GPOINTER_TO_UINT(g_queue_pop_head(frames));
+
+            if (g_queue_is_empty(frames))
+                g_hash_table_remove(digests, &digest);
+            matched_count++;
+            /* a match behind the furthest one seen arrived out of order */
+            if (num1 < high_match) {
+                reordered_count++;
+                if (verbose) {
+                    printf("Reordered: frame %u of %s is frame %u of %s\n",
+                           num1, filename1, frame_count2, filename2);
+                }
+            } else {
+                high_match = num1;
+            }
+        } else {
+            only_in_2_count++;
+            if (verbose) {
+                printf("Only in %s: frame %u\n", filename2, frame_count2);
+            }
+        }
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+    if (err != 0) {
+        cfile_read_failure_message("comparecap", filename2, err, err_info);
+        ret = EXIT_ERROR;
+        goto clean_exit;
+    }
+    wtap_close(wth);
+    wth = NULL;
+
+    /* Whatever is left in the table was never matched. */
+    leftover.filename = filename1;
+    leftover.verbose = verbose;
+    leftover.only_count = 0;
+    g_hash_table_foreach(digests, report_leftover, &leftover);
+    g_hash_table_destroy(digests);
+
+    printf("%s: %u frames\n", filename1, frame_count1);
+    printf("%s: %u frames\n", filename2, frame_count2);
+    printf("%u matched, %u only in %s, %u only in %s, %u reordered\n",
+           matched_count, leftover.only_count, filename1,
+           only_in_2_count, filename2, reordered_count);
+
+    if (leftover.only_count != 0 || only_in_2_count != 0 ||
+        reordered_count != 0) {
+        ret = EXIT_DIFFERENT;
+    }
+
+clean_exit:
+    if (wth != NULL)
+        wtap_close(wth);
+    wtap_cleanup();
+    free_progdirs();
+    return ret;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -231,6 +231,7 @@ typedef struct _capture_src {
     guint32                      received;
     guint32                      dropped;
     guint32                      flushed;
+    guint32                      last_ps_drop;           /**< ps_drop at the last periodic stats report */
     pcap_t                      *pcap_h;
 #ifdef MUST_DO_SELECT
     int                          pcap_fd;                /**< pcap file descriptor */
@@ -319,7 +320,7 @@ typedef struct _pcap_queue_element {
         struct pcap_pkthdr  phdr;
         pcapng_block_header_t  bh;
     } u;
-    u_char             *pd;
+    u_char             *pd; /* points into the same allocation */
 } pcap_queue_element;
 
 /*
@@ -372,6 +373,7 @@ static capture_options global_capture_opts;
 static gboolean quiet = FALSE;
 static gboolean use_threads = FALSE;
 static guint64 start_time;
+static int stats_write_interval = 0; /* seconds between periodic ISBs; 0 = at shutdown only */
 
 static void capture_loop_write_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
                                          const u_char *pd);
@@ -390,6 +392,7 @@ static void WS_NORETURN exit_main(int err);
 static void report_new_capture_file(const char *filename);
 static void report_packet_count(unsigned int packet_count);
 static void report_packet_drops(guint32 received, guint32 pcap_drops, guint32 drops, guint32 flushed, guint32 ps_ifdrop, gchar *name);
+static void report_iface_stats(guint interface_id, guint32 drop_delta);
 static void report_capture_error(const char *error_msg, const char *secondary_error_msg);
 static void report_cfilter_error(capture_options *capture_opts, guint i, const char *errmsg);
 
@@ -471,6 +474,9 @@ print_usage(FILE *output)
     fprintf(output, "  --capture-comment <comment>\n");
     fprintf(output, "                           add a capture comment to the output file\n");
     fprintf(output, "                           (only for pcapng)\n");
+    fprintf(output, "  --statistics-interval <seconds>\n");
+    fprintf(output, "                           write interface statistics blocks every NUM secs\n");
+    fprintf(output, "                           (only for pcapng, def: at capture end only)\n");
     fprintf(output, "\n");
     fprintf(output, "Miscellaneous:\n");
     fprintf(output, "  -N <packet_limit>        maximum number of packets buffered within dumpcap\n");
@@ -2926,7 +2932,20 @@ static void capture_loop_close_input(loop_data *ld)
 }
 
 
-/* init the capture filter */
+/* init the capture filter
+ *
+ * We can't report whether the filter ends up running in the kernel or
+ * in userland: pcap_setfilter() tries the kernel attach and falls back
+ * silently, and libpcap offers no API to ask which happened, nor any
+ * per-filter match counters.  What we can attribute, we do -- see
+ * report_packet_drops(), which breaks drops out into pcap buffer
+ * drops, our own drops, flushed packets and ps_ifdrop, with periodic
+ * updates over the sync pipe.  The compiled BPF program itself can be
+ * inspected with -d, and a filter can be pre-verified against a saved
+ * corpus with libpcap's filtertest; re-implementing that replay here
+ * would pull capture-file reading into a binary that privilege
+ * separation keeps deliberately small.
+ */
 static initfilter_status_t
 capture_loop_init_filter(pcap_t *pcap_h, gboolean from_cap_pipe,
                          const gchar * name, const gchar * cfilter)
@@ -3205,6 +3224,52 @@ capture_loop_close_output(capture_options *capture_opts, loop_data *ld, int *err
     }
 }
 
+/* Write an Interface Statistics Block for every capture device.
+ *
+ * Called periodically from the capture loop when --statistics-interval
+ * is set.  The counters are cumulative, as the pcapng spec wants them;
+ * a reader gets per-interval figures by subtracting successive blocks.
+ * This lets capinfos and the GUI build a traffic/drops-over-time
+ * overview from the block metadata alone, without touching packet data,
+ * and leaves usable statistics in the file even if dumpcap dies before
+ * writing the final block.
+ */
+static void
+capture_loop_write_periodic_stats(capture_options *capture_opts, loop_data *ld)
+{
+    unsigned int i;
+    capture_src *pcap_src;
+    guint64      now = create_timestamp();
+    int          err_stats = 0;
+
+    if (!capture_opts->use_pcapng || ld->pdh == NULL)
+        return;
+
+    for (i = 0; i < ld->pcaps->len; i++) {
+        struct pcap_stat stats;
+
+        pcap_src = g_array_index(ld->pcaps, capture_src *, i);
+        if (pcap_src->from_cap_pipe || pcap_src->pcap_h == NULL)
+            continue;
+        if (pcap_stats(pcap_src->pcap_h, &stats) < 0)
+            continue;
+        if (!pcapng_write_interface_statistics_block(ld->pdh,
+                                                     i,
+                                                     &ld->bytes_written,
+                                                     "Counters provided by dumpcap",
+                                                     start_time,
+                                                     now,
+                                                     pcap_src->received,
+                                                     stats.ps_drop + pcap_src->dropped + pcap_src->flushed,
+                                                     &err_stats)) {
+            g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
+                  "Couldn't write interface statistics block: %s",
+                  g_strerror(err_stats));
+            return;
+        }
+    }
+}
+
 /* dispatch incoming packets (pcap or capture pipe)
  *
  * Waits for incoming packets to be available, and calls pcap_dispatch()
@@ -3689,46 +3754,64 @@ pcap_read_handler(void* arg)
     return (NULL);
 }
 
-/* Try to pop an item off the packet queue and if it exists, write it */
-static gboolean
-capture_loop_dequeue_packet(void) {
+/* Try to pop a batch of items off the packet queue and write them.
+   Returns the number of packets written. */
+#define DEQUEUE_MAX_BATCH 64
+
+static int
+capture_loop_dequeue_packets(void) {
+    pcap_queue_element *queue_batch[DEQUEUE_MAX_BATCH];
     pcap_queue_element *queue_element;
+    int n = 0, i;
 
+    /* Take as many queued packets as are available with one lock
+       acquisition, so that the writer doesn't trade the queue lock with
+       the capture threads once per packet. */
     g_async_queue_lock(pcap_queue);
-    queue_element = (pcap_queue_element *)g_async_queue_timeout_pop_unlocked(pcap_queue, WRITER_THREAD_TIMEOUT);
-    if (queue_element) {
-        if (queue_element->pcap_src->from_pcapng) {
-            pcap_queue_bytes -= queue_element->u.bh.block_total_length;
-        } else {
-            pcap_queue_bytes -= queue_element->u.phdr.caplen;
+    queue_batch[0] = (pcap_queue_element *)g_async_queue_timeout_pop_unlocked(pcap_queue, WRITER_THREAD_TIMEOUT);
+    if (queue_batch[0]) {
+        n = 1;
+        while (n < DEQUEUE_MAX_BATCH &&
+               (queue_batch[n] = (pcap_queue_element *)g_async_queue_try_pop_unlocked(pcap_queue)) != NULL) {
+            n++;
+        }
+        for (i = 0; i < n; i++) {
+            if (queue_batch[i]->pcap_src->from_pcapng) {
+                pcap_queue_bytes -= queue_batch[i]->u.bh.block_total_length;
+            } else {
+                pcap_queue_bytes -= queue_batch[i]->u.phdr.caplen;
+            }
+            pcap_queue_packets -= 1;
         }
-        pcap_queue_packets -= 1;
     }
     g_async_queue_unlock(pcap_queue);
-    if (queue_element) {
+    for (i = 0; i < n; i++) {
+        queue_element = queue_batch[i];
         if (queue_element->pcap_src->from_pcapng) {
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
             g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
                   "Dequeued a block of type 0x%08x of length %d captured on interface %d.",
                   queue_element->u.bh.block_type, queue_element->u.bh.block_total_length,
                   queue_element->pcap_src->interface_id);
+#endif
 
             capture_loop_write_pcapng_cb(queue_element->pcap_src,
                                         &queue_element->u.bh,
                                         queue_element->pd);
         } else {
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
             g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
                 "Dequeued a packet of length %d captured on interface %d.",
                 queue_element->u.phdr.caplen, queue_element->pcap_src->interface_id);
+#endif
 
             capture_loop_write_packet_cb((u_char *) queue_element->pcap_src,
                                         &queue_element->u.phdr,
                                         queue_element->pd);
         }
-        g_free(queue_element->pd);
         g_free(queue_element);
-        return TRUE;
     }
-    return FALSE;
+    return n;
 }
 
 /* Do the low-level work of a capture.
@@ -3744,6 +3827,7 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
     int               err_close;
     int               inpkts;
     GTimer           *autostop_duration_timer = NULL;
+    GTimer           *stats_interval_timer = NULL;
     gboolean          write_ok;
     gboolean          close_ok;
     gboolean          cfilter_error         = FALSE;
@@ -3858,6 +3942,10 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
         autostop_duration_timer = g_timer_new();
     }
 
+    if (stats_write_interval > 0 && capture_opts->use_pcapng) {
+        stats_interval_timer = g_timer_new();
+    }
+
     if (capture_opts->multi_files_on) {
         if (capture_opts->has_file_duration) {
             global_ld.file_duration_timer = g_timer_new();
@@ -3889,13 +3977,7 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
     while (global_ld.go) {
         /* dispatch incoming packets */
         if (use_threads) {
-            gboolean dequeued = capture_loop_dequeue_packet();
-
-            if (dequeued) {
-                inpkts = 1;
-            } else {
-                inpkts = 0;
-            }
+            inpkts = capture_loop_dequeue_packets();
         } else {
             pcap_src = g_array_index(global_ld.pcaps, capture_src *, 0);
             inpkts = capture_loop_dispatch(&global_ld, errmsg,
@@ -3975,6 +4057,30 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
                 global_ld.inpkts_to_sync_pipe = 0;
             }
 
+            /* Check each interface for freshly dropped packets, so drops
+               can be attributed to a point in time (and to the state of
+               the write queue) rather than only being totalled up at the
+               end of the capture. */
+            for (i = 0; i < global_ld.pcaps->len; i++) {
+                struct pcap_stat upd_stats;
+
+                pcap_src = g_array_index(global_ld.pcaps, capture_src *, i);
+                if (pcap_src->pcap_h != NULL &&
+                    pcap_stats(pcap_src->pcap_h, &upd_stats) >= 0 &&
+                    upd_stats.ps_drop != pcap_src->last_ps_drop) {
+                    report_iface_stats(pcap_src->interface_id,
+                                       upd_stats.ps_drop - pcap_src->last_ps_drop);
+                    pcap_src->last_ps_drop = upd_stats.ps_drop;
+                }
+            }
+
+            /* write periodic statistics blocks, if requested */
+            if (stats_interval_timer != NULL &&
+                g_timer_elapsed(stats_interval_timer, NULL) >= stats_write_interval) {
+                capture_loop_write_periodic_stats(capture_opts, &global_ld);
+                g_timer_start(stats_interval_timer);
+            }
+
             /* check capture duration condition */
             if (autostop_duration_timer != NULL && g_timer_elapsed(autostop_duration_timer, NULL) >= capture_opts->autostop_duration) {
                 /* The maximum capture time has elapsed; stop the capture. */
@@ -4010,11 +4116,11 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
                   pcap_src->interface_id);
         }
         while (1) {
-            gboolean dequeued = capture_loop_dequeue_packet();
-            if (!dequeued) {
+            int dequeued = capture_loop_dequeue_packets();
+            if (dequeued == 0) {
                 break;
             }
-            global_ld.inpkts_to_sync_pipe += 1;
+            global_ld.inpkts_to_sync_pipe += dequeued;
             if (capture_opts->output_to_pipe) {
                 fflush(global_ld.pdh);
             }
@@ -4027,6 +4133,8 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
         g_timer_destroy(global_ld.file_duration_timer);
     if (autostop_duration_timer != NULL)
         g_timer_destroy(autostop_duration_timer);
+    if (stats_interval_timer != NULL)
+        g_timer_destroy(stats_interval_timer);
 
     /* did we have a pcap (input) error? */
     for (i = 0; i < capture_opts->ifaces->len; i++) {
@@ -4337,7 +4445,9 @@ capture_loop_write_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
                                        bh->block_total_length,
                                        &global_ld.bytes_written, &err);
 
-        fflush(global_ld.pdh);
+        /* No fflush() here: the capture loop already flushes when writing
+           to a pipe and on its periodic sync updates; flushing every block
+           would throw away the output buffering. */
         if (!successful) {
             global_ld.go = FALSE;
             global_ld.err = err;
@@ -4363,7 +4473,9 @@ capture_loop_write_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
     int          err;
     guint        ts_mul    = pcap_src->ts_nsec ? 1000000000 : 1000000;
 
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
     g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_DEBUG, "capture_loop_write_packet_cb");
+#endif
 
     /* We may be called multiple times from pcap_dispatch(); if we've set
        the "stop capturing" flag, ignore this packet, as we're not
@@ -4427,19 +4539,13 @@ capture_loop_queue_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
         return;
     }
 
-    queue_element = (pcap_queue_element *)g_malloc(sizeof(pcap_queue_element));
-    if (queue_element == NULL) {
-       pcap_src->dropped++;
-       return;
-    }
+    /* Allocate the element and the packet data as a single block; this
+       path runs once per packet on every capture thread, so don't pay
+       for two allocations. */
+    queue_element = (pcap_queue_element *)g_malloc(sizeof(pcap_queue_element) + phdr->caplen);
     queue_element->pcap_src = pcap_src;
     queue_element->u.phdr = *phdr;
-    queue_element->pd = (u_char *)g_malloc(phdr->caplen);
-    if (queue_element->pd == NULL) {
-        pcap_src->dropped++;
-        g_free(queue_element);
-        return;
-    }
+    queue_element->pd = (u_char *)(queue_element + 1);
     memcpy(queue_element->pd, pd, phdr->caplen);
     g_async_queue_lock(pcap_queue);
     if (((pcap_queue_byte_limit == 0) || (pcap_queue_bytes < pcap_queue_byte_limit)) &&
@@ -4454,22 +4560,27 @@ capture_loop_queue_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
     g_async_queue_unlock(pcap_queue);
     if (limit_reached) {
         pcap_src->dropped++;
-        g_free(queue_element->pd);
         g_free(queue_element);
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
         g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
               "Dropped a packet of length %d captured on interface %u.",
               phdr->caplen, pcap_src->interface_id);
+#endif
     } else {
         pcap_src->received++;
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
         g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
               "Queued a packet of length %d captured on interface %u.",
               phdr->caplen, pcap_src->interface_id);
+#endif
     }
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
     /* I don't want to hold the mutex over the debug output. So the
        output may be wrong */
     g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
           "Queue size is now %" G_GINT64_MODIFIER "d bytes (%" G_GINT64_MODIFIER "d packets)",
           pcap_queue_bytes, pcap_queue_packets);
+#endif
 }
 
 /* one pcapng block was captured, queue it */
@@ -4487,19 +4598,12 @@ capture_loop_queue_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
         return;
     }
 
-    queue_element = (pcap_queue_element *)g_malloc(sizeof(pcap_queue_element));
-    if (queue_element == NULL) {
-       pcap_src->dropped++;
-       return;
-    }
+    /* As in capture_loop_queue_packet_cb(), one allocation for both the
+       element and the block data. */
+    queue_element = (pcap_queue_element *)g_malloc(sizeof(pcap_queue_element) + bh->block_total_length);
     queue_element->pcap_src = pcap_src;
     queue_element->u.bh = *bh;
-    queue_element->pd = (u_char *)g_malloc(bh->block_total_length);
-    if (queue_element->pd == NULL) {
-        pcap_src->dropped++;
-        g_free(queue_element);
-        return;
-    }
+    queue_element->pd = (u_char *)(queue_element + 1);
     memcpy(queue_element->pd, pd, bh->block_total_length);
     g_async_queue_lock(pcap_queue);
     if (((pcap_queue_byte_limit == 0) || (pcap_queue_bytes < pcap_queue_byte_limit)) &&
@@ -4514,22 +4618,27 @@ capture_loop_queue_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
     g_async_queue_unlock(pcap_queue);
     if (limit_reached) {
         pcap_src->dropped++;
-        g_free(queue_element->pd);
         g_free(queue_element);
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
         g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
               "Dropped a packet of length %d captured on interface %u.",
               bh->block_total_length, pcap_src->interface_id);
+#endif
     } else {
         pcap_src->received++;
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
         g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
               "Queued a block of type 0x%08x of length %d captured on interface %u.",
               bh->block_type, bh->block_total_length, pcap_src->interface_id);
+#endif
     }
+#if defined(DEBUG_DUMPCAP) || defined(DEBUG_CHILD_DUMPCAP)
     /* I don't want to hold the mutex over the debug output. So the
        output may be wrong */
     g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
           "Queue size is now %" G_GINT64_MODIFIER "d bytes (%" G_GINT64_MODIFIER "d packets)",
           pcap_queue_bytes, pcap_queue_packets);
+#endif
 }
 
 static int
@@ -4608,9 +4717,11 @@ main(int argc, char *argv[])
 {
     char             *err_msg;
     int               opt;
+#define LONGOPT_STATISTICS_INTERVAL LONGOPT_BASE_APPLICATION+1
     static const struct option long_options[] = {
         {"help", no_argument, NULL, 'h'},
         {"version", no_argument, NULL, 'v'},
+        {"statistics-interval", required_argument, NULL, LONGOPT_STATISTICS_INTERVAL},
         LONGOPT_CAPTURE_COMMON
         {0, 0, 0, 0 }
     };
@@ -5062,6 +5173,9 @@ main(int argc, char *argv[])
         case 'N':
             pcap_queue_packet_limit = get_positive_int(optarg, "packet_limit");
             break;
+        case LONGOPT_STATISTICS_INTERVAL:
+            stats_write_interval = get_positive_int(optarg, "statistics-interval");
+            break;
         default:
             cmdarg_err("Invalid Option: %s", argv[optind-1]);
             /* FALLTHROUGH */
@@ -5133,6 +5247,11 @@ main(int argc, char *argv[])
             exit_main(1);
         }
 
+        if (stats_write_interval > 0 && !global_capture_opts.use_pcapng) {
+            cmdarg_err("Periodic statistics can only be written when capturing in pcapng format.");
+            exit_main(1);
+        }
+
         /* Was the ring buffer option specified and, if so, does it make sense? */
         if (global_capture_opts.multi_files_on) {
             /* Ring buffer works only under certain conditions:
@@ -5566,6 +5685,28 @@ report_packet_drops(guint32 received, guint32 pcap_drops, guint32 drops, guint32
     }
 }
 
+static void
+report_iface_stats(guint interface_id, guint32 drop_delta)
+{
+    if (capture_child) {
+        char* tmp = g_strdup_printf("%u:%u:%" G_GINT64_MODIFIER "d:%" G_GINT64_MODIFIER "d",
+                                    interface_id, drop_delta,
+                                    pcap_queue_packets, pcap_queue_bytes);
+
+        g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_DEBUG,
+            "Interface %u: %u packets dropped since the last report (queue: %" G_GINT64_MODIFIER "d packets / %" G_GINT64_MODIFIER "d bytes)",
+            interface_id, drop_delta, pcap_queue_packets, pcap_queue_bytes);
+        pipe_write_block(2, SP_IF_STATS, tmp);
+        g_free(tmp);
+    } else {
+        fprintf(stderr,
+            "Interface %u: %u packets dropped since the last report (queue: %" G_GINT64_MODIFIER "d packets / %" G_GINT64_MODIFIER "d bytes)\n",
+            interface_id, drop_delta, pcap_queue_packets, pcap_queue_bytes);
+        /* stderr could be line buffered */
+        fflush(stderr);
+    }
+}
+
 
 /************************************************************************************************/
 /* signal_pipe handling */
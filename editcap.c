@@ -106,6 +106,7 @@ struct select_item {
 typedef struct _fd_hash_t {
     guint8     digest[16];
     guint32    len;
+    gboolean   in_window;    /* entry is counted in fd_digest_window */
     nstime_t   frame_time;
 } fd_hash_t;
 
@@ -116,8 +117,21 @@ static fd_hash_t fd_hash[MAX_DUP_DEPTH];
 static int       dup_window    = DEFAULT_DUP_DEPTH;
 static int       cur_dup_entry = 0;
 
+/* Index over the count-based window (-d/-D): maps a digest+length key to
+ * the number of fd_hash[] entries currently carrying it, so a duplicate
+ * check is a single lookup instead of a scan of the whole window.  The
+ * time-based window (-w) can't use it, as its matches are bounded by a
+ * per-packet time delta rather than window membership. */
+static GHashTable *fd_digest_window = NULL;
+
 static guint32   ignored_bytes  = 0;  /* Used with -I */
 
+/* Used with --ignore-ip-mutable-fields: hash over a copy of the frame
+ * with the IPv4 TTL and header checksum (or IPv6 hop limit) zeroed, so
+ * that the same packet captured on both sides of a router is detected
+ * as a duplicate. */
+static gboolean  ignore_ip_mutable = FALSE;
+
 #define ONE_BILLION 1000000000
 
 /* Weights of different errors we can introduce */
@@ -586,9 +600,70 @@ remove_vlan_info(const wtap_packet_header *phdr, guint8* fd, guint32* len) {
     }
 }
 
+/* Return a copy of an Ethernet frame with the IPv4 TTL and header
+ * checksum (or the IPv6 hop limit) zeroed, for hashing with
+ * --ignore-ip-mutable-fields.  VLAN and 802.1ad tags are skipped.
+ * Frames that aren't recognizably IP over Ethernet are returned
+ * unmodified. */
+static guint8 *
+mask_ip_mutable_fields(int encap, guint8 *fd, guint32 len) {
+    static guint8 *masked_fd  = NULL;
+    static guint32 masked_size = 0;
+    guint32 offset = 14;
+    guint16 ethertype;
+
+    if (encap != WTAP_ENCAP_ETHERNET || len < offset)
+        return fd;
+
+    ethertype = pntoh16(&fd[12]);
+    while ((ethertype == ETHERTYPE_VLAN || ethertype == ETHERTYPE_IEEE_802_1AD)
+           && len >= offset + 4) {
+        ethertype = pntoh16(&fd[offset + 2]);
+        offset += 4;
+    }
+
+    if (ethertype == ETHERTYPE_IP) {
+        if (len < offset + 20)
+            return fd;
+    } else if (ethertype == ETHERTYPE_IPv6) {
+        if (len < offset + 40)
+            return fd;
+    } else {
+        return fd;
+    }
+
+    if (masked_size < len) {
+        masked_fd = (guint8 *)g_realloc(masked_fd, len);
+        masked_size = len;
+    }
+    memcpy(masked_fd, fd, len);
+
+    if (ethertype == ETHERTYPE_IP) {
+        masked_fd[offset + 8]  = 0;     /* TTL */
+        masked_fd[offset + 10] = 0;     /* header checksum */
+        masked_fd[offset + 11] = 0;
+    } else {
+        masked_fd[offset + 7]  = 0;     /* hop limit */
+    }
+
+    return masked_fd;
+}
+
+/* Build the lookup key for a window entry: its digest plus the original
+ * frame length, matching the equality test the window scan used to make. */
+static GBytes *
+window_entry_key(const fd_hash_t *entry) {
+    guint8 key[16 + sizeof(guint32)];
+
+    memcpy(key, entry->digest, 16);
+    memcpy(key + 16, &entry->len, sizeof(guint32));
+    return g_bytes_new(key, sizeof(key));
+}
+
 static gboolean
 is_duplicate(guint8* fd, guint32 len) {
-    int i;
+    GBytes *key;
+    guint   count;
     const struct ieee80211_radiotap_header* tap_header;
 
     /*Hint to ignore some bytes at the start of the frame for the digest calculation(-I option) */
@@ -611,27 +686,43 @@ is_duplicate(guint8* fd, guint32 len) {
     new_fd  = &fd[offset];
     new_len = len - (offset);
 
+    if (fd_digest_window == NULL) {
+        fd_digest_window = g_hash_table_new_full((GHashFunc)g_bytes_hash,
+                                                 (GEqualFunc)g_bytes_equal,
+                                                 (GDestroyNotify)g_bytes_unref,
+                                                 NULL);
+    }
+
     cur_dup_entry++;
     if (cur_dup_entry >= dup_window)
         cur_dup_entry = 0;
 
+    /* The ring slot we're about to reuse drops out of the window. */
+    if (fd_hash[cur_dup_entry].in_window) {
+        key = window_entry_key(&fd_hash[cur_dup_entry]);
+        count = GPOINTER_TO_UINT(g_hash_table_lookup(fd_digest_window, key));
+        if (count > 1) {
+            /* The insert consumes our reference to the key. */
+            g_hash_table_insert(fd_digest_window, key, GUINT_TO_POINTER(count - 1));
+        } else {
+            g_hash_table_remove(fd_digest_window, key);
+            g_bytes_unref(key);
+        }
+    }
+
     /* Calculate our digest */
     gcry_md_hash_buffer(GCRY_MD_MD5, fd_hash[cur_dup_entry].digest, new_fd, new_len);
 
     fd_hash[cur_dup_entry].len = len;
 
-    /* Look for duplicates */
-    for (i = 0; i < dup_window; i++) {
-        if (i == cur_dup_entry)
-            continue;
+    /* Look for duplicates among the other entries in the window, and
+     * record the new entry either way. */
+    key = window_entry_key(&fd_hash[cur_dup_entry]);
+    count = GPOINTER_TO_UINT(g_hash_table_lookup(fd_digest_window, key));
+    g_hash_table_insert(fd_digest_window, key, GUINT_TO_POINTER(count + 1));
+    fd_hash[cur_dup_entry].in_window = TRUE;
 
-        if (fd_hash[i].len == fd_hash[cur_dup_entry].len
-            && memcmp(fd_hash[i].digest, fd_hash[cur_dup_entry].digest, 16) == 0) {
-            return TRUE;
-        }
-    }
-
-    return FALSE;
+    return count > 0;
 }
 
 static gboolean
@@ -781,6 +872,10 @@ print_usage(FILE *output)
     fprintf(output, "  --skip-radiotap-header skip radiotap header when checking for packet duplicates.\n");
     fprintf(output, "                         Useful when processing packets captured by multiple radios\n");
     fprintf(output, "                         on the same channel in the vicinity of each other.\n");
+    fprintf(output, "  --ignore-ip-mutable-fields\n");
+    fprintf(output, "                         ignore the IPv4 TTL and header checksum and the IPv6 hop\n");
+    fprintf(output, "                         limit when checking for packet duplicates. Useful when\n");
+    fprintf(output, "                         the same packets were captured on both sides of a router.\n");
     fprintf(output, "\n");
     fprintf(output, "Packet manipulation:\n");
     fprintf(output, "  -s <snaplen>           truncate each packet to max. <snaplen> bytes of data.\n");
@@ -1023,6 +1118,7 @@ main(int argc, char *argv[])
 #define LONGOPT_SEED                 LONGOPT_BASE_APPLICATION+3
 #define LONGOPT_INJECT_SECRETS       LONGOPT_BASE_APPLICATION+4
 #define LONGOPT_DISCARD_ALL_SECRETS  LONGOPT_BASE_APPLICATION+5
+#define LONGOPT_IGNORE_IP_MUTABLE    LONGOPT_BASE_APPLICATION+6
 
     static const struct option long_options[] = {
         {"novlan", no_argument, NULL, LONGOPT_NO_VLAN},
@@ -1030,6 +1126,7 @@ main(int argc, char *argv[])
         {"seed", required_argument, NULL, LONGOPT_SEED},
         {"inject-secrets", required_argument, NULL, LONGOPT_INJECT_SECRETS},
         {"discard-all-secrets", no_argument, NULL, LONGOPT_DISCARD_ALL_SECRETS},
+        {"ignore-ip-mutable-fields", no_argument, NULL, LONGOPT_IGNORE_IP_MUTABLE},
         {"help", no_argument, NULL, 'h'},
         {"version", no_argument, NULL, 'V'},
         {0, 0, 0, 0 }
@@ -1169,6 +1266,12 @@ main(int argc, char *argv[])
             break;
         }
 
+        case LONGOPT_IGNORE_IP_MUTABLE:
+        {
+            ignore_ip_mutable = TRUE;
+            break;
+        }
+
         case 'a':
         {
             guint frame_number;
@@ -1861,7 +1964,12 @@ main(int argc, char *argv[])
 
                 /* suppress duplicates by packet window */
                 if (dup_detect) {
-                    if (is_duplicate(buf, rec->rec_header.packet_header.caplen)) {
+                    guint8 *dedup_buf = buf;
+
+                    if (ignore_ip_mutable)
+                        dedup_buf = mask_ip_mutable_fields(rec->rec_header.packet_header.pkt_encap,
+                                                           buf, rec->rec_header.packet_header.caplen);
+                    if (is_duplicate(dedup_buf, rec->rec_header.packet_header.caplen)) {
                         if (verbose) {
                             fprintf(stderr, "Skipped: %u, Len: %u, MD5 Hash: ",
                                     count,
@@ -1891,11 +1999,15 @@ main(int argc, char *argv[])
                     /* suppress duplicates by time window */
                     if (dup_detect_by_time) {
                         nstime_t current;
+                        guint8 *dedup_buf = buf;
 
                         current.secs  = rec->ts.secs;
                         current.nsecs = rec->ts.nsecs;
 
-                        if (is_duplicate_rel_time(buf,
+                        if (ignore_ip_mutable)
+                            dedup_buf = mask_ip_mutable_fields(rec->rec_header.packet_header.pkt_encap,
+                                                               buf, rec->rec_header.packet_header.caplen);
+                        if (is_duplicate_rel_time(dedup_buf,
                                                   rec->rec_header.packet_header.caplen,
                                                   &current)) {
                             if (verbose) {
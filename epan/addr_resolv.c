@@ -235,6 +235,19 @@ static wmem_map_t *eth_hashtable = NULL;
 static wmem_map_t *serv_port_hashtable = NULL;
 static GHashTable *enterprises_hashtable = NULL;
 
+/*
+ * Small memos in front of the IPv4 and Ethernet hash tables. Packets
+ * cluster by flow, so the handful of most recently looked up addresses
+ * cover the bulk of the per-packet lookups; checking the memo first
+ * avoids hashing the same addresses over and over. Slots are filled
+ * round-robin and dropped wholesale when the backing table goes away.
+ */
+#define RESOLV_MEMO_SIZE 4
+static hashipv4_t  *ipv4_memo[RESOLV_MEMO_SIZE];
+static guint        ipv4_memo_next;
+static hashether_t *eth_memo[RESOLV_MEMO_SIZE];
+static guint        eth_memo_next;
+
 static subnet_length_entry_t subnet_length_entries[SUBNETLENGTHSIZE]; /* Ordered array of entries */
 static gboolean have_subnet_entry = FALSE;
 
@@ -630,6 +643,7 @@ fgetline(char *buf, int size, FILE *fp)
  */
 static subnet_entry_t subnet_lookup(const guint32 addr);
 static void subnet_entry_set(guint32 subnet_addr, const guint8 mask_length, const gchar* name);
+static void initialize_services_once(void);
 
 
 static void
@@ -774,6 +788,8 @@ _serv_name_lookup(port_type proto, guint port, serv_port_t **value_ret)
 {
     serv_port_t *serv_port_table;
 
+    initialize_services_once();
+
     serv_port_table = (serv_port_t *)wmem_map_lookup(serv_port_hashtable, GUINT_TO_POINTER(port));
 
     if (value_ret != NULL)
@@ -853,6 +869,18 @@ initialize_services(void)
     }
 }
 
+/* Parsing the services files is expensive enough to show up in the
+ * startup time of short-lived tshark runs, and most runs never ask for
+ * a service name (transport name resolution is off by default), so put
+ * it off until the first lookup.
+ */
+static void
+initialize_services_once(void)
+{
+    if (serv_port_hashtable == NULL)
+        initialize_services();
+}
+
 static void
 service_name_lookup_cleanup(void)
 {
@@ -1062,6 +1090,16 @@ static hashipv4_t *
 host_lookup(const guint addr)
 {
     hashipv4_t * volatile tp;
+    guint i;
+
+    /*
+     * Only addresses whose resolution has finished (one way or the
+     * other) are memoized, so a hit can be returned as-is.
+     */
+    for (i = 0; i < RESOLV_MEMO_SIZE; i++) {
+        if (ipv4_memo[i] != NULL && ipv4_memo[i]->addr == addr)
+            return ipv4_memo[i];
+    }
 
     tp = (hashipv4_t *)wmem_map_lookup(ipv4_hash_table, GUINT_TO_POINTER(addr));
     if (tp == NULL) {
@@ -1073,6 +1111,8 @@ host_lookup(const guint addr)
         fill_dummy_ip4(addr, tp);
         wmem_map_insert(ipv4_hash_table, GUINT_TO_POINTER(addr), tp);
     } else if (tp->flags & TRIED_OR_RESOLVED_MASK) {
+        ipv4_memo[ipv4_memo_next] = tp;
+        ipv4_memo_next = (ipv4_memo_next + 1) % RESOLV_MEMO_SIZE;
         return tp;
     }
 
@@ -1747,6 +1787,8 @@ ethers_cleanup(void)
     g_manuf_path = NULL;
     g_free(g_wka_path);
     g_wka_path = NULL;
+
+    memset(eth_memo, 0, sizeof(eth_memo));
 }
 
 /* Resolve ethernet address */
@@ -1902,6 +1944,17 @@ static hashether_t *
 eth_name_lookup(const guint8 *addr, const gboolean resolve)
 {
     hashether_t  *tp;
+    guint         i;
+
+    for (i = 0; i < RESOLV_MEMO_SIZE; i++) {
+        tp = eth_memo[i];
+        if (tp != NULL && memcmp(tp->addr, addr, 6) == 0) {
+            if (resolve && (tp->status == HASHETHER_STATUS_UNRESOLVED)) {
+                eth_addr_resolve(tp); /* Found but needs to be resolved */
+            }
+            return tp;
+        }
+    }
 
     tp = (hashether_t *)wmem_map_lookup(eth_hashtable, addr);
 
@@ -1913,6 +1966,9 @@ eth_name_lookup(const guint8 *addr, const gboolean resolve)
         }
     }
 
+    eth_memo[eth_memo_next] = tp;
+    eth_memo_next = (eth_memo_next + 1) % RESOLV_MEMO_SIZE;
+
     return tp;
 
 } /* eth_name_lookup */
@@ -2903,6 +2959,45 @@ host_name_lookup_process(void) {
     return nro;
 }
 
+void
+host_name_lookup_drain(void) {
+    struct timeval tv;
+    int nfds;
+    fd_set rfds, wfds;
+
+    if (!async_dns_initialized)
+        return;
+
+    /* Keep pumping until the queue is empty and nothing is in flight;
+     * host_name_lookup_process() refills the channel from the queue as
+     * answers come back, so requests run name_resolve_concurrency at
+     * a time rather than one by one. */
+    while (wmem_list_count(async_dns_queue_head) > 0 || async_dns_in_flight > 0) {
+        host_name_lookup_process();
+
+        tv.tv_sec = 1;
+        tv.tv_usec = 0;
+
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        nfds = ares_fds(ghba_chan, &rfds, &wfds);
+        if (nfds == 0) {
+            /* Nothing outstanding on the channel, so nothing to
+             * wait for. */
+            break;
+        }
+        if (select(nfds, &rfds, &wfds, NULL, &tv) == -1) { /* call to select() failed */
+            /* If it's interrupted by a signal, no need to put out a message */
+            if (errno != EINTR)
+                fprintf(stderr, "Warning: call to select() failed, error is %s\n", g_strerror(errno));
+            return;
+        }
+        /* With empty fd sets after a timeout this still lets c-ares
+         * expire overdue requests. */
+        ares_process(ghba_chan, &rfds, &wfds);
+    }
+}
+
 static void
 _host_name_lookup_cleanup(void) {
     async_dns_queue_head = NULL;
@@ -3114,6 +3209,8 @@ host_name_lookup_cleanup(void)
     ipv6_hash_table = NULL;
     ss7pc_hash_table = NULL;
 
+    memset(ipv4_memo, 0, sizeof(ipv4_memo));
+
     for(i = 0; i < SUBNETLENGTHSIZE; ++i) {
         if (subnet_length_entries[i].subnet_addresses != NULL) {
             for (j = 0; j < HASHHOSTSIZE; j++) {
@@ -3577,6 +3674,7 @@ get_eth_hashtable(void)
 wmem_map_t *
 get_serv_port_hashtable(void)
 {
+    initialize_services_once();
     return serv_port_hashtable;
 }
 
@@ -3607,7 +3705,8 @@ get_ipv6_hash_table(void)
 void
 addr_resolv_init(void)
 {
-    initialize_services();
+    /* The services files are parsed lazily, on the first service
+     * name lookup. */
     initialize_ethers();
     initialize_ipxnets();
     initialize_vlans();
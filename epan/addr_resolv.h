@@ -190,6 +190,15 @@ WS_DLL_PUBLIC void disable_name_resolution(void);
  */
 WS_DLL_PUBLIC gboolean host_name_lookup_process(void);
 
+/** If we're using c-ares, send any queued host name lookups and wait
+ *  for all of the answers, running up to name_resolve_concurrency
+ *  requests at a time.  This is called by TShark between the two
+ *  passes over a capture file, so the second pass finds the names
+ *  already in the cache instead of resolving each address
+ *  synchronously, one at a time.
+ */
+WS_DLL_PUBLIC void host_name_lookup_drain(void);
+
 /* get_hostname returns the host name or "%d.%d.%d.%d" if not found */
 WS_DLL_PUBLIC const gchar *get_hostname(const guint addr);
 
@@ -23,6 +23,33 @@
 /* REPLACEMENT CHARACTER */
 #define UNREPL 0xFFFD
 
+/*
+ * Return the number of leading bytes of ptr[0..length) that have the
+ * high-order bit clear, checking a word at a time.  The converters below
+ * use this to append runs of ASCII in bulk instead of pushing them
+ * through the per-character paths; wire strings (Diameter AVPs, SMB
+ * filenames and the like) are overwhelmingly plain ASCII.
+ *
+ * The memcpy() makes the word loads alignment- and aliasing-safe; it
+ * compiles to a single load.
+ */
+static gint
+ascii_prefix_length(const guint8 *ptr, gint length)
+{
+    gint    i = 0;
+    guint64 w;
+
+    while (i + (gint)sizeof w <= length) {
+        memcpy(&w, ptr + i, sizeof w);
+        if (w & G_GUINT64_CONSTANT(0x8080808080808080))
+            break;
+        i += (gint)sizeof w;
+    }
+    while (i < length && ptr[i] < 0x80)
+        i++;
+    return i;
+}
+
 /*
  * Wikipedia's "Character encoding" template, giving a pile of character
  * encodings and Wikipedia pages for them:
@@ -71,14 +98,18 @@ get_ascii_string(wmem_allocator_t *scope, const guint8 *ptr, gint length)
     str = wmem_strbuf_sized_new(scope, length+1, 0);
 
     while (length > 0) {
-        guint8 ch = *ptr;
+        gint run = ascii_prefix_length(ptr, length);
 
-        if (ch < 0x80)
-            wmem_strbuf_append_c(str, ch);
-        else
+        if (run > 0) {
+            wmem_strbuf_append_len(str, (const gchar *)ptr, run);
+            ptr += run;
+            length -= run;
+        }
+        if (length > 0) {
             wmem_strbuf_append_unichar(str, UNREPL);
-        ptr++;
-        length--;
+            ptr++;
+            length--;
+        }
     }
 
     return (guint8 *) wmem_strbuf_finalize(str);
@@ -650,14 +681,18 @@ get_unichar2_string(wmem_allocator_t *scope, const guint8 *ptr, gint length, con
     str = wmem_strbuf_sized_new(scope, length+1, 0);
 
     while (length > 0) {
-        guint8 ch = *ptr;
+        gint run = ascii_prefix_length(ptr, length);
 
-        if (ch < 0x80)
-            wmem_strbuf_append_c(str, ch);
-        else
-            wmem_strbuf_append_unichar(str, table[ch-0x80]);
-        ptr++;
-        length--;
+        if (run > 0) {
+            wmem_strbuf_append_len(str, (const gchar *)ptr, run);
+            ptr += run;
+            length -= run;
+        }
+        if (length > 0) {
+            wmem_strbuf_append_unichar(str, table[*ptr-0x80]);
+            ptr++;
+            length--;
+        }
     }
 
     return (guint8 *) wmem_strbuf_finalize(str);
@@ -685,6 +720,8 @@ get_ucs_2_string(wmem_allocator_t *scope, const guint8 *ptr, gint length, const
     gunichar2      uchar;
     gint           i;       /* Byte counter for string */
     wmem_strbuf_t *strbuf;
+    gchar          ascii_buf[256];
+    gsize          n_ascii = 0;
 
     strbuf = wmem_strbuf_sized_new(scope, length+1, 0);
 
@@ -694,8 +731,29 @@ get_ucs_2_string(wmem_allocator_t *scope, const guint8 *ptr, gint length, const
         }else{
             uchar = pletoh16(ptr + i);
         }
+
+        /*
+         * Most UCS-2 strings on the wire (SMB filenames, for example)
+         * are plain ASCII; batch those characters up and append them
+         * in bulk instead of going through the UTF-8 encoder one
+         * character at a time.
+         */
+        if (uchar < 0x80) {
+            ascii_buf[n_ascii++] = (gchar)uchar;
+            if (n_ascii == sizeof ascii_buf) {
+                wmem_strbuf_append_len(strbuf, ascii_buf, n_ascii);
+                n_ascii = 0;
+            }
+            continue;
+        }
+        if (n_ascii > 0) {
+            wmem_strbuf_append_len(strbuf, ascii_buf, n_ascii);
+            n_ascii = 0;
+        }
         wmem_strbuf_append_unichar(strbuf, uchar);
     }
+    if (n_ascii > 0)
+        wmem_strbuf_append_len(strbuf, ascii_buf, n_ascii);
 
     /*
      * XXX - if i < length, this means we were handed an odd
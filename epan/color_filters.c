@@ -34,6 +34,7 @@
 #define BLUE_COMPONENT(x)  (guint16) ( (((x)        & 0xff) * 65535 / 255))
 
 static int read_filters_file(const gchar *path, FILE *f, gpointer user_data, color_filter_add_cb_func add_cb);
+static gboolean color_filter_matches_when_absent(dfilter_t *dfcode);
 
 /* the currently active filters */
 static GSList *color_filter_list = NULL;
@@ -162,6 +163,7 @@ color_filters_set_tmp(guint8 filt_nr, const gchar *filter, gboolean disabled, gc
                 dfilter_free(colorf->c_colorfilter);
                 colorf->filter_text = g_strdup(tmpfilter);
                 colorf->c_colorfilter = compiled_filter;
+                colorf->matches_when_absent = color_filter_matches_when_absent(compiled_filter);
                 colorf->disabled = ((i!=filt_nr) ? TRUE : disabled);
                 /* Remember that there are now temporary coloring filters set */
                 if( filter )
@@ -244,6 +246,7 @@ color_filter_clone(color_filter_t *colorf)
     new_colorf->fg_color            = colorf->fg_color;
     new_colorf->disabled            = colorf->disabled;
     new_colorf->c_colorfilter       = NULL;
+    new_colorf->matches_when_absent = FALSE;
 
     return new_colorf;
 }
@@ -373,6 +376,22 @@ color_filters_clone(gpointer user_data, color_filter_add_cb_func add_cb)
 }
 
 
+/* Compute the filter's verdict for packets that contain none of its
+ * fields.  All such packets get the same verdict, so
+ * color_filters_colorize_packet() can use the cached result instead of
+ * running the filter program for them. */
+static gboolean
+color_filter_matches_when_absent(dfilter_t *dfcode)
+{
+    proto_tree *empty_tree;
+    gboolean    matches;
+
+    empty_tree = proto_tree_create_root(NULL);
+    matches = dfilter_apply(dfcode, empty_tree);
+    proto_tree_free(empty_tree);
+    return matches;
+}
+
 static void
 color_filter_compile_cb(gpointer filter_arg, gpointer err)
 {
@@ -392,6 +411,8 @@ color_filter_compile_cb(gpointer filter_arg, gpointer err)
         /* this filter was compilable before, so this should never happen */
         /* except if the OK button of the parent window has been clicked */
         /* so don't use g_assert_not_reached() but check the filters again */
+    } else {
+        colorf->matches_when_absent = color_filter_matches_when_absent(colorf->c_colorfilter);
     }
 }
 
@@ -414,6 +435,8 @@ color_filter_validate_cb(gpointer filter_arg, gpointer err)
 
         /* Disable the color filter in the list of color filters. */
         colorf->disabled = TRUE;
+    } else {
+        colorf->matches_when_absent = color_filter_matches_when_absent(colorf->c_colorfilter);
     }
 }
 
@@ -500,9 +523,16 @@ color_filters_colorize_packet(epan_dissect_t *edt)
         while(curr != NULL) {
             colorf = (color_filter_t *)curr->data;
             if ( (!colorf->disabled) &&
-                 (colorf->c_colorfilter != NULL) &&
-                 dfilter_apply_edt(colorf->c_colorfilter, edt)) {
-                return colorf;
+                 (colorf->c_colorfilter != NULL)) {
+                /* If the packet contains none of the filter's fields,
+                 * the verdict was computed when the filter was
+                 * compiled; don't run the filter program. */
+                if (!dfilter_fields_present(colorf->c_colorfilter, edt->tree)) {
+                    if (colorf->matches_when_absent)
+                        return colorf;
+                } else if (dfilter_apply_edt(colorf->c_colorfilter, edt)) {
+                    return colorf;
+                }
             }
             curr = g_slist_next(curr);
         }
@@ -651,6 +681,8 @@ read_filters_file(const gchar *path, FILE *f, gpointer user_data, color_filter_a
 
                 /* internal call */
                 colorf->c_colorfilter = temp_dfilter;
+                if (temp_dfilter != NULL)
+                    colorf->matches_when_absent = color_filter_matches_when_absent(temp_dfilter);
                 *cfl = g_slist_append(*cfl, colorf);
             } else {
                 /* external call */
@@ -37,6 +37,8 @@ typedef struct _color_filter {
 
                                     /* only used inside of color_filters.c */
     struct epan_dfilter *c_colorfilter;  /* compiled filter expression */
+    gboolean   matches_when_absent; /* filter result for packets containing
+                                     * none of the filter's fields */
 
                                     /* only used outside of color_filters.c (beside init) */
 } color_filter_t;
@@ -358,6 +358,11 @@ void col_custom_set_edt(epan_dissect_t *edt, column_info *cinfo)
   }
 }
 
+/* Prime the epan_dissect_t with the fields the custom columns need.
+ * This, plus a faked (non-visible) tree, is the fast path for filling
+ * custom columns: dissection only materializes the primed fields, and
+ * col_custom_set_edt() reads their values straight out of the tree.
+ * The column's compiled filter program is never run per packet. */
 void
 col_custom_prime_edt(epan_dissect_t *edt, column_info *cinfo)
 {
@@ -873,20 +878,146 @@ col_has_time_fmt(column_info *cinfo, const gint col)
           (col_item->fmt_matx[COL_DELTA_TIME_DIS]));
 }
 
+/* The remainder of a second, and every field of a broken-down time, is
+   a small number printed in a fixed width, so the absolute-time columns
+   can be written with table lookups rather than going through
+   ws_snprintf() once per packet. */
+static const char col_digit_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+/* Write "val", which must be in [0,99], as exactly two digits. */
+static char *
+col_write_2digits(char *ptr, int val)
+{
+  memcpy(ptr, &col_digit_pairs[val * 2], 2);
+  return ptr + 2;
+}
+
+/* Write "val" right-aligned in "digits" zero-padded digits. */
+static char *
+col_write_fixed_digits(char *ptr, guint32 val, int digits)
+{
+  int i;
+
+  for (i = digits - 1; i >= 0; i--) {
+    ptr[i] = (char)('0' + (val % 10));
+    val /= 10;
+  }
+  return ptr + digits;
+}
+
+/* Write "year" as at least four digits, the way "%04d" does; years
+   outside [0,9999] are too rare to need the fast path. */
+static char *
+col_write_year(char *ptr, int year)
+{
+  if (year < 0 || year > 9999) {
+    ws_snprintf(ptr, 12, "%04d", year);
+    return ptr + strlen(ptr);
+  }
+  return col_write_fixed_digits(ptr, year, 4);
+}
+
+/* Write "hh:mm:ss" from a broken-down time. */
+static char *
+col_write_hms(char *ptr, const struct tm *tmp)
+{
+  ptr = col_write_2digits(ptr, tmp->tm_hour);
+  *ptr++ = ':';
+  ptr = col_write_2digits(ptr, tmp->tm_min);
+  *ptr++ = ':';
+  return col_write_2digits(ptr, tmp->tm_sec);
+}
+
+/* Append the decimal point and the sub-second part of a time stamp in
+   the given actual precision; nothing is appended for full-second
+   precision. */
+static char *
+col_write_subsecs(char *ptr, const char *decimal_point, int nsecs, int tsprecision)
+{
+  guint32 frac;
+  int digits;
+
+  switch (tsprecision) {
+  case WTAP_TSPREC_SEC:
+    return ptr;
+  case WTAP_TSPREC_DSEC:
+    frac = nsecs / 100000000;
+    digits = 1;
+    break;
+  case WTAP_TSPREC_CSEC:
+    frac = nsecs / 10000000;
+    digits = 2;
+    break;
+  case WTAP_TSPREC_MSEC:
+    frac = nsecs / 1000000;
+    digits = 3;
+    break;
+  case WTAP_TSPREC_USEC:
+    frac = nsecs / 1000;
+    digits = 6;
+    break;
+  case WTAP_TSPREC_NSEC:
+    frac = nsecs;
+    digits = 9;
+    break;
+  default:
+    g_assert_not_reached();
+    return ptr;
+  }
+  while (*decimal_point != '\0')
+    *ptr++ = *decimal_point++;
+  return col_write_fixed_digits(ptr, frac, digits);
+}
+
+/* localtime() and gmtime() do a surprising amount of work per call,
+   and successive packets almost always fall within the same second,
+   so remember the last conversion we did. */
+static struct {
+  time_t    secs;
+  gboolean  local;
+  gboolean  valid;
+  struct tm tm;
+} col_last_tm;
+
+static struct tm *
+col_get_tm(time_t then, gboolean local)
+{
+  struct tm *tmp;
+
+  if (col_last_tm.valid && col_last_tm.secs == then &&
+      col_last_tm.local == local)
+    return &col_last_tm.tm;
+
+  tmp = local ? localtime(&then) : gmtime(&then);
+  if (tmp == NULL)
+    return NULL;
+  col_last_tm.tm = *tmp;
+  col_last_tm.secs = then;
+  col_last_tm.local = local;
+  col_last_tm.valid = TRUE;
+  return &col_last_tm.tm;
+}
+
 static void
 set_abs_ymd_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
   struct tm *tmp;
-  time_t then;
+  char *ptr;
   int tsprecision;
 
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
+  if (fd->has_ts)
+    tmp = col_get_tm(fd->abs_ts.secs, local);
+  else
     tmp = NULL;
   if (tmp != NULL) {
     switch (timestamp_get_precision()) {
@@ -914,74 +1045,15 @@ set_abs_ymd_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean
     default:
       g_assert_not_reached();
     }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%03d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%09d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
-    }
+    ptr = col_write_year(buf, tmp->tm_year + 1900);
+    *ptr++ = '-';
+    ptr = col_write_2digits(ptr, tmp->tm_mon + 1);
+    *ptr++ = '-';
+    ptr = col_write_2digits(ptr, tmp->tm_mday);
+    *ptr++ = ' ';
+    ptr = col_write_hms(ptr, tmp);
+    ptr = col_write_subsecs(ptr, decimal_point, fd->abs_ts.nsecs, tsprecision);
+    *ptr = '\0';
   } else {
     buf[0] = '\0';
   }
@@ -1011,16 +1083,12 @@ static void
 set_abs_ydoy_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
   struct tm *tmp;
-  time_t then;
+  char *ptr;
   int tsprecision;
 
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
+  if (fd->has_ts)
+    tmp = col_get_tm(fd->abs_ts.secs, local);
+  else
     tmp = NULL;
   if (tmp != NULL) {
     switch (timestamp_get_precision()) {
@@ -1048,68 +1116,13 @@ set_abs_ydoy_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolea
     default:
       g_assert_not_reached();
     }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%03d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%09d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
-    }
+    ptr = col_write_year(buf, tmp->tm_year + 1900);
+    *ptr++ = '/';
+    ptr = col_write_fixed_digits(ptr, tmp->tm_yday + 1, 3);
+    *ptr++ = ' ';
+    ptr = col_write_hms(ptr, tmp);
+    ptr = col_write_subsecs(ptr, decimal_point, fd->abs_ts.nsecs, tsprecision);
+    *ptr = '\0';
   } else {
     buf[0] = '\0';
   }
@@ -1469,16 +1482,12 @@ static void
 set_abs_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
   struct tm *tmp;
-  time_t then;
+  char *ptr;
   int tsprecision;
 
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
+  if (fd->has_ts)
+    tmp = col_get_tm(fd->abs_ts.secs, local);
+  else
     tmp = NULL;
   if (tmp != NULL) {
     switch (timestamp_get_precision()) {
@@ -1506,57 +1515,9 @@ set_abs_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean loc
     default:
       g_assert_not_reached();
     }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%01d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%03d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%06d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%02d:%02d:%02d%s%09d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
-    }
-
+    ptr = col_write_hms(buf, tmp);
+    ptr = col_write_subsecs(ptr, decimal_point, fd->abs_ts.nsecs, tsprecision);
+    *ptr = '\0';
   } else {
     *buf = '\0';
   }
@@ -584,27 +584,41 @@ add_conversation_table_data_with_conv_id(
     guint32 port1, port2;
     conv_item_t *conv_item = NULL;
     unsigned int conversation_idx = 0;
+    gboolean is_tx_direction;
 
+    /* Remember which direction the packet went in while we canonicalize
+       the endpoint order, so we don't have to compare the addresses
+       again when we update the counters below. */
     if (src_port > dst_port) {
         addr1 = src;
         addr2 = dst;
         port1 = src_port;
         port2 = dst_port;
+        is_tx_direction = TRUE;
     } else if (src_port < dst_port) {
         addr2 = src;
         addr1 = dst;
         port2 = src_port;
         port1 = dst_port;
-    } else if (cmp_address(src, dst) < 0) {
-        addr1 = src;
-        addr2 = dst;
-        port1 = src_port;
-        port2 = dst_port;
+        is_tx_direction = FALSE;
     } else {
-        addr2 = src;
-        addr1 = dst;
-        port2 = src_port;
-        port1 = dst_port;
+        int addr_cmp = cmp_address(src, dst);
+
+        if (addr_cmp < 0) {
+            addr1 = src;
+            addr2 = dst;
+            port1 = src_port;
+            port2 = dst_port;
+            is_tx_direction = TRUE;
+        } else {
+            addr2 = src;
+            addr1 = dst;
+            port2 = src_port;
+            port1 = dst_port;
+            /* With equal addresses and ports both directions collapse
+               into one; count it as A->B as we always have. */
+            is_tx_direction = (addr_cmp == 0);
+        }
     }
 
     /* if we don't have any entries at all yet */
@@ -673,7 +687,7 @@ add_conversation_table_data_with_conv_id(
     }
 
     /* update the conversation struct */
-    if ( (!cmp_address(src, addr1)) && (!cmp_address(dst, addr2)) && (src_port==port1) && (dst_port==port2) ) {
+    if (is_tx_direction) {
         conv_item->tx_frames += num_frames;
         conv_item->tx_bytes += num_bytes;
     } else {
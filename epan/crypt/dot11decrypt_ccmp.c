@@ -78,6 +78,36 @@ static void ccmp_init_blocks(
 /****************************************************************************/
 /* Function definitions							*/
 
+/* Opening a gcrypt cipher handle and scheduling the AES key are not
+ * cheap, and a capture typically decrypts long runs of frames with the
+ * same temporal key (often trying several keys per frame).  Keep one
+ * handle open and only re-run the key schedule when the key actually
+ * changes.  Dissection is single-threaded, so a single handle is
+ * enough.								*/
+static gcry_cipher_hd_t ccmp_cached_handle = NULL;
+static UCHAR ccmp_cached_tk[16];
+
+static gcry_cipher_hd_t
+ccmp_get_handle(const UCHAR TK1[16])
+{
+	if (ccmp_cached_handle != NULL) {
+		if (memcmp(ccmp_cached_tk, TK1, 16) == 0)
+			return ccmp_cached_handle;
+	} else {
+		if (gcry_cipher_open(&ccmp_cached_handle, GCRY_CIPHER_AES, GCRY_CIPHER_MODE_ECB, 0)) {
+			ccmp_cached_handle = NULL;
+			return NULL;
+		}
+	}
+	if (gcry_cipher_setkey(ccmp_cached_handle, TK1, 16)) {
+		gcry_cipher_close(ccmp_cached_handle);
+		ccmp_cached_handle = NULL;
+		return NULL;
+	}
+	memcpy(ccmp_cached_tk, TK1, 16);
+	return ccmp_cached_handle;
+}
+
 static void ccmp_init_blocks(
 	gcry_cipher_hd_t rijndael_handle,
 	PDOT11DECRYPT_MAC_FRAME wh,
@@ -209,18 +239,14 @@ INT Dot11DecryptCcmpDecrypt(
 
 	PN = READ_6(ivp[0], ivp[1], ivp[4], ivp[5], ivp[6], ivp[7]);
 
-	if (gcry_cipher_open(&rijndael_handle, GCRY_CIPHER_AES, GCRY_CIPHER_MODE_ECB, 0)) {
-		return 1;
-	}
-	if (gcry_cipher_setkey(rijndael_handle, TK1, 16)) {
-		gcry_cipher_close(rijndael_handle);
+	rijndael_handle = ccmp_get_handle(TK1);
+	if (rijndael_handle == NULL) {
 		return 1;
 	}
 
 	wh = (PDOT11DECRYPT_MAC_FRAME )m;
 	data_len = len - (z + DOT11DECRYPT_CCMP_HEADER+DOT11DECRYPT_CCMP_TRAILER);
 	if (data_len < 1) {
-		gcry_cipher_close(rijndael_handle);
 		return 0;
 	}
 	ccmp_init_blocks(rijndael_handle, wh, PN, data_len, b0, aad, a, b);
@@ -243,7 +269,7 @@ INT Dot11DecryptCcmpDecrypt(
 	if (space != 0)         /* short last block */
 		CCMP_DECRYPT(i, b, b0, pos, a, space);
 
-	gcry_cipher_close(rijndael_handle);
+	/* the cipher handle stays open for the next frame */
 	/* MIC Key ?= MIC */
 	if (memcmp(mic, a, DOT11DECRYPT_CCMP_TRAILER) == 0) {
 		return 0;
@@ -27,6 +27,11 @@ struct epan_dfilter {
 	int		*interesting_fields;
 	int		num_interesting_fields;
 	GPtrArray	*deprecated;
+	gchar		*expanded_text;	/* macro-expanded filter text; the
+					 * retired-program cache key */
+	guint64		*insn_counts;	/* per-instruction execution counts;
+					 * NULL unless profiling is enabled */
+	guint64		*insn_time_us;	/* cumulative time spent per instruction */
 };
 
 typedef struct {
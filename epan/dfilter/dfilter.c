@@ -34,6 +34,24 @@ static void*	ParserObj = NULL;
  */
 dfwork_t *global_dfw;
 
+/*
+ * Retired-program cache.
+ *
+ * Scripts and sharkd hand us the same handful of filter expressions
+ * over and over, and every compile re-runs the scanner, the Lemon
+ * parser, semcheck and gencode.  A dfilter_t carries per-run register
+ * state, so a live program can't be handed to two owners; instead
+ * dfilter_free() retires the most recently freed programs here and
+ * dfilter_compile() revives one when it sees the same macro-expanded
+ * text again.  The cache is flushed from dfilter_cleanup(), which runs
+ * whenever the field registry is torn down, so a revived program can
+ * never outlive the hfids compiled into it.
+ */
+#define RETIRED_DFILTER_CACHE_MAX 32
+static GQueue *retired_dfilters;	/* of dfilter_t *, most recent first */
+
+static void dfilter_free_real(dfilter_t *df);
+
 void
 dfilter_fail(dfwork_t *dfw, const char *format, ...)
 {
@@ -72,12 +90,25 @@ dfilter_init(void)
 	sttype_init();
 
 	dfilter_macro_init();
+
+	retired_dfilters = g_queue_new();
 }
 
 /* Clean-up the dfilter module */
 void
 dfilter_cleanup(void)
 {
+	/* The hfids compiled into retired programs die with the field
+	 * registry, so drop them now. */
+	if (retired_dfilters) {
+		dfilter_t *df;
+
+		while ((df = (dfilter_t *)g_queue_pop_head(retired_dfilters)) != NULL)
+			dfilter_free_real(df);
+		g_queue_free(retired_dfilters);
+		retired_dfilters = NULL;
+	}
+
 	dfilter_macro_cleanup();
 
 	/* Free the Lemon Parser object */
@@ -116,14 +147,11 @@ free_insns(GPtrArray *insns)
 	g_ptr_array_free(insns, TRUE);
 }
 
-void
-dfilter_free(dfilter_t *df)
+static void
+dfilter_free_real(dfilter_t *df)
 {
 	guint i;
 
-	if (!df)
-		return;
-
 	if (df->insns) {
 		free_insns(df->insns);
 	}
@@ -150,9 +178,32 @@ dfilter_free(dfilter_t *df)
 	g_free(df->registers);
 	g_free(df->attempted_load);
 	g_free(df->owns_memory);
+	g_free(df->insn_counts);
+	g_free(df->insn_time_us);
+	wmem_free(NULL, df->expanded_text);
 	g_free(df);
 }
 
+void
+dfilter_free(dfilter_t *df)
+{
+	if (!df)
+		return;
+
+	/* Retire the program instead of destroying it, so a recompile
+	 * of the same text can revive it.  Constant registers are left
+	 * initialized and run-time registers were already cleared on
+	 * RETURN, so a retired program is ready to run again as is. */
+	if (retired_dfilters && df->expanded_text) {
+		g_queue_push_head(retired_dfilters, df);
+		if (g_queue_get_length(retired_dfilters) > RETIRED_DFILTER_CACHE_MAX)
+			dfilter_free_real((dfilter_t *)g_queue_pop_tail(retired_dfilters));
+		return;
+	}
+
+	dfilter_free_real(df);
+}
+
 
 static dfwork_t*
 dfwork_new(void)
@@ -225,6 +276,21 @@ dfilter_compile(const gchar *text, dfilter_t **dfp, gchar **err_msg)
 		return FALSE;
 	}
 
+	/* Did we retire a program compiled from this very text? */
+	if (retired_dfilters) {
+		GList *l;
+
+		for (l = retired_dfilters->head; l != NULL; l = l->next) {
+			dfilter = (dfilter_t *)l->data;
+			if (strcmp(dfilter->expanded_text, expanded_text) == 0) {
+				g_queue_delete_link(retired_dfilters, l);
+				wmem_free(NULL, expanded_text);
+				*dfp = dfilter;
+				return TRUE;
+			}
+		}
+	}
+
 	if (df_lex_init(&scanner) != 0) {
 		wmem_free(NULL, expanded_text);
 		*dfp = NULL;
@@ -359,6 +425,11 @@ dfilter_compile(const gchar *text, dfilter_t **dfp, gchar **err_msg)
 		/* Add any deprecated items */
 		dfilter->deprecated = deprecated;
 
+		/* Remember what we compiled, so dfilter_free() can
+		 * retire the program for possible revival. */
+		dfilter->expanded_text = expanded_text;
+		expanded_text = NULL;
+
 		/* And give it to the user. */
 		*dfp = dfilter;
 	}
@@ -398,6 +469,50 @@ FAILURE:
 }
 
 
+gboolean
+dfilter_single_relation(const dfilter_t *df, int *hfid,
+    df_relation_t *relation, const fvalue_t **constant)
+{
+	dfvm_insn_t	*insn;
+	guint		const_reg;
+	guint		i;
+
+	/* The gencode peephole reduces "field <relation> constant" to
+	 * TREE_ANY_CMP + RETURN; anything else is not a single relation. */
+	if (df->insns->len != 2)
+		return FALSE;
+	insn = (dfvm_insn_t *)g_ptr_array_index(df->insns, 0);
+	if (insn->op != TREE_ANY_CMP)
+		return FALSE;
+
+	switch ((dfvm_opcode_t)insn->arg3->value.numeric) {
+		case ANY_EQ:	*relation = DF_RELATION_EQ; break;
+		case ANY_NE:	*relation = DF_RELATION_NE; break;
+		case ANY_GT:	*relation = DF_RELATION_GT; break;
+		case ANY_GE:	*relation = DF_RELATION_GE; break;
+		case ANY_LT:	*relation = DF_RELATION_LT; break;
+		case ANY_LE:	*relation = DF_RELATION_LE; break;
+		default:
+			/* contains/bitwise-and don't map to an index scan */
+			return FALSE;
+	}
+
+	/* Dig the constant out of the initialization program. */
+	const_reg = insn->arg2->value.numeric;
+	for (i = 0; i < df->consts->len; i++) {
+		dfvm_insn_t *cinsn =
+		    (dfvm_insn_t *)g_ptr_array_index(df->consts, i);
+
+		if (cinsn->op == PUT_FVALUE &&
+		    cinsn->arg2->value.numeric == const_reg) {
+			*hfid = insn->arg1->value.hfinfo->id;
+			*constant = cinsn->arg1->value.fvalue;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 gboolean
 dfilter_apply(dfilter_t *df, proto_tree *tree)
 {
@@ -427,6 +542,25 @@ dfilter_has_interesting_fields(const dfilter_t *df)
 	return (df->num_interesting_fields > 0);
 }
 
+const int *
+dfilter_interesting_fields(const dfilter_t *df, int *num_fields)
+{
+	*num_fields = df->num_interesting_fields;
+	return df->interesting_fields;
+}
+
+gboolean
+dfilter_fields_present(const dfilter_t *df, proto_tree *tree)
+{
+	int i;
+
+	for (i = 0; i < df->num_interesting_fields; i++) {
+		if (proto_get_finfo_ptr_array(tree, df->interesting_fields[i]) != NULL)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 GPtrArray *
 dfilter_deprecated_tokens(dfilter_t *df) {
 	if (df->deprecated && df->deprecated->len > 0) {
@@ -453,6 +587,20 @@ dfilter_dump(dfilter_t *df)
 	}
 }
 
+void
+dfilter_profiling_enable(gboolean enable)
+{
+	dfvm_profiling_enable(enable);
+}
+
+void
+dfilter_dump_profile(dfilter_t *df)
+{
+	/* The bytecode listing maps instruction ids to filter clauses. */
+	dfvm_dump(stdout, df);
+	dfvm_dump_profile(stdout, df);
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
@@ -72,6 +72,43 @@ dfilter_prime_proto_tree(const dfilter_t *df, proto_tree *tree);
 gboolean
 dfilter_has_interesting_fields(const dfilter_t *df);
 
+/* Return the array of hfids (fields and protocols) the dfilter
+ * references, and its length.  The array remains owned by the
+ * dfilter. */
+WS_DLL_PUBLIC
+const int *
+dfilter_interesting_fields(const dfilter_t *df, int *num_fields);
+
+/* Check if any of the dfilter's fields or protocols are present in
+ * the (primed) proto_tree.  If none are, the filter evaluates to the
+ * same result as on any other tree without them, so callers running
+ * many filters per packet can skip the ones that can't match. */
+gboolean
+dfilter_fields_present(const dfilter_t *df, proto_tree *tree);
+
+/*
+ * The relation kinds a single-relation filter can reduce to; these
+ * mirror the fvalue comparisons the DFVM performs.
+ */
+typedef enum {
+	DF_RELATION_EQ,
+	DF_RELATION_NE,
+	DF_RELATION_GT,
+	DF_RELATION_GE,
+	DF_RELATION_LT,
+	DF_RELATION_LE
+} df_relation_t;
+
+/* If the compiled program is a single "field <relation> constant"
+ * comparison (see the TREE_ANY_CMP fusion in gencode.c), return TRUE
+ * and report the field's hfid, the relation, and the constant fvalue,
+ * which remains owned by the dfilter.  Such filters can be evaluated
+ * against an external field index without running the VM. */
+WS_DLL_PUBLIC
+gboolean
+dfilter_single_relation(const dfilter_t *df, int *hfid,
+    df_relation_t *relation, const fvalue_t **constant);
+
 WS_DLL_PUBLIC
 GPtrArray *
 dfilter_deprecated_tokens(dfilter_t *df);
@@ -81,6 +118,19 @@ WS_DLL_PUBLIC
 void
 dfilter_dump(dfilter_t *df);
 
+/* Enable or disable per-instruction profiling of filter programs.
+ * While enabled, every dfilter evaluated collects execution counts and
+ * cumulative time per instruction. */
+WS_DLL_PUBLIC
+void
+dfilter_profiling_enable(gboolean enable);
+
+/* Print the collected per-instruction profile of a dfilter, together
+ * with its bytecode, to stdout */
+WS_DLL_PUBLIC
+void
+dfilter_dump_profile(dfilter_t *df);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -304,7 +304,19 @@ ul_semcheck_string_param(dfwork_t *dfw, int param_num, stnode_t *st_node)
     }
 }
 
-/* The table of all display-filter functions */
+/* The table of all display-filter functions.
+ *
+ * All of these are pure functions of the fields in the frame being
+ * tested, and additions must stay that way: a display filter can be
+ * evaluated for a single arbitrary frame (clicking a row, "Apply as
+ * Filter") as well as in file order, and the same frame must produce
+ * the same verdict both times.  Streaming aggregates across frames -
+ * count(x) per conversation, running max() and the like - would make
+ * the verdict depend on which frames were evaluated before this one,
+ * which breaks on random access and on the second pass of two-pass
+ * dissection.  Cross-packet state belongs in dissectors (which can
+ * expose it as ordinary filterable fields, as tcp.analysis.* does)
+ * or in taps, which see every packet exactly once per pass. */
 static df_func_def_t
 df_functions[] = {
     { "lower",  df_func_lower,  FT_STRING, 1, 1, ul_semcheck_params },
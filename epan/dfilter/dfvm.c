@@ -12,6 +12,76 @@
 
 #include <ftypes/ftypes-int.h>
 
+/* When enabled, dfvm_apply() counts executions and accumulates
+ * wall-clock time per instruction, so expensive filter clauses can be
+ * identified from evidence instead of guesswork.  Off by default; the
+ * only cost then is one pointer test per dfvm_apply() call. */
+static gboolean profiling_enabled = FALSE;
+
+void
+dfvm_profiling_enable(gboolean enable)
+{
+	profiling_enabled = enable;
+}
+
+static const char *
+dfvm_opcode_name(dfvm_opcode_t op)
+{
+	switch (op) {
+		case IF_TRUE_GOTO:	return "IF_TRUE_GOTO";
+		case IF_FALSE_GOTO:	return "IF_FALSE_GOTO";
+		case CHECK_EXISTS:	return "CHECK_EXISTS";
+		case NOT:		return "NOT";
+		case RETURN:		return "RETURN";
+		case READ_TREE:		return "READ_TREE";
+		case PUT_FVALUE:	return "PUT_FVALUE";
+		case ANY_EQ:		return "ANY_EQ";
+		case ANY_NE:		return "ANY_NE";
+		case ANY_GT:		return "ANY_GT";
+		case ANY_GE:		return "ANY_GE";
+		case ANY_LT:		return "ANY_LT";
+		case ANY_LE:		return "ANY_LE";
+		case ANY_BITWISE_AND:	return "ANY_BITWISE_AND";
+		case ANY_CONTAINS:	return "ANY_CONTAINS";
+		case ANY_MATCHES:	return "ANY_MATCHES";
+		case MK_RANGE:		return "MK_RANGE";
+		case CALL_FUNCTION:	return "CALL_FUNCTION";
+		case ANY_IN_RANGE:	return "ANY_IN_RANGE";
+		case ANY_IN_INT_SET:	return "ANY_IN_INT_SET";
+		case ANY_IN_IPV4_SET:	return "ANY_IN_IPV4_SET";
+		case TREE_ANY_CMP:	return "TREE_ANY_CMP";
+	}
+	return "UNKNOWN";
+}
+
+void
+dfvm_dump_profile(FILE *f, dfilter_t *df)
+{
+	int		id, length;
+	dfvm_insn_t	*insn;
+	guint64		total_time = 0;
+
+	if (df->insn_counts == NULL) {
+		fprintf(f, "No filter profile collected.\n");
+		return;
+	}
+
+	length = df->insns->len;
+	for (id = 0; id < length; id++) {
+		total_time += df->insn_time_us[id];
+	}
+
+	fprintf(f, "Filter instruction profile:\n");
+	fprintf(f, " insn opcode              executions      time (us)\n");
+	for (id = 0; id < length; id++) {
+		insn = (dfvm_insn_t *)g_ptr_array_index(df->insns, id);
+		fprintf(f, "%05d %-18s %11" G_GUINT64_FORMAT " %14" G_GUINT64_FORMAT "\n",
+			id, dfvm_opcode_name(insn->op),
+			df->insn_counts[id], df->insn_time_us[id]);
+	}
+	fprintf(f, "Total time in filter: %" G_GUINT64_FORMAT " us\n", total_time);
+}
+
 dfvm_insn_t*
 dfvm_insn_new(dfvm_opcode_t op)
 {
@@ -36,6 +106,19 @@ dfvm_value_free(dfvm_value_t *v)
 		case DRANGE:
 			drange_free(v->value.drange);
 			break;
+		case INT_SET:
+			g_hash_table_destroy(v->value.hash_set);
+			break;
+		case IPV4_SET:
+			{
+				guint i;
+				for (i = 0; i < v->value.ipv4_set->num_buckets; i++) {
+					g_hash_table_destroy(v->value.ipv4_set->buckets[i].addrs);
+				}
+				g_free(v->value.ipv4_set->buckets);
+				g_free(v->value.ipv4_set);
+			}
+			break;
 		default:
 			/* nothing */
 			;
@@ -107,6 +190,7 @@ dfvm_dump(FILE *f, dfilter_t *df)
 				break;
 			case CHECK_EXISTS:
 			case READ_TREE:
+			case TREE_ANY_CMP:
 			case CALL_FUNCTION:
 			case MK_RANGE:
 			case ANY_EQ:
@@ -119,6 +203,8 @@ dfvm_dump(FILE *f, dfilter_t *df)
 			case ANY_CONTAINS:
 			case ANY_MATCHES:
 			case ANY_IN_RANGE:
+			case ANY_IN_INT_SET:
+			case ANY_IN_IPV4_SET:
 			case NOT:
 			case RETURN:
 			case IF_TRUE_GOTO:
@@ -152,6 +238,13 @@ dfvm_dump(FILE *f, dfilter_t *df)
 					arg2->value.numeric);
 				break;
 
+			case TREE_ANY_CMP:
+				fprintf(f, "%05d TREE_ANY_CMP\t%s <op %u> reg#%u\n",
+					id, arg1->value.hfinfo->abbrev,
+					arg3->value.numeric,
+					arg2->value.numeric);
+				break;
+
 			case CALL_FUNCTION:
 				fprintf(f, "%05d CALL_FUNCTION\t%s (",
 					id, arg1->value.funcdef->name);
@@ -259,6 +352,18 @@ dfvm_dump(FILE *f, dfilter_t *df)
 					arg3->value.numeric);
 				break;
 
+			case ANY_IN_INT_SET:
+				fprintf(f, "%05d ANY_IN_INT_SET\treg#%u in hash set of %u values\n",
+					id, arg1->value.numeric,
+					g_hash_table_size(arg2->value.hash_set));
+				break;
+
+			case ANY_IN_IPV4_SET:
+				fprintf(f, "%05d ANY_IN_IPV4_SET\treg#%u in ipv4 set with %u prefix lengths\n",
+					id, arg1->value.numeric,
+					arg2->value.ipv4_set->num_buckets);
+				break;
+
 			case NOT:
 				fprintf(f, "%05d NOT\n", id);
 				break;
@@ -337,6 +442,56 @@ read_tree(dfilter_t *df, proto_tree *tree, header_field_info *hfinfo, int reg)
 }
 
 
+/* Fused READ_TREE + compare, generated by the gencode peephole for
+ * "field <relation> constant" filters.  Compares the field_info array
+ * straight out of the tree against the constant register, without
+ * loading a register list first; an absent field compares false, just
+ * as the unfused IF_FALSE_GOTO path did. */
+static gboolean
+tree_any_cmp(dfilter_t *df, proto_tree *tree, header_field_info *hfinfo,
+	     FvalueCmpFunc cmp, int const_reg)
+{
+	GPtrArray	*finfos;
+	field_info	*finfo;
+	GList		*list_b;
+	guint		i;
+
+	while (hfinfo) {
+		finfos = proto_get_finfo_ptr_array(tree, hfinfo->id);
+		if (finfos != NULL) {
+			for (i = 0; i < g_ptr_array_len(finfos); i++) {
+				finfo = (field_info *)g_ptr_array_index(finfos, i);
+				for (list_b = df->registers[const_reg];
+				     list_b != NULL;
+				     list_b = g_list_next(list_b)) {
+					if (cmp(&finfo->value, (fvalue_t *)list_b->data))
+						return TRUE;
+				}
+			}
+		}
+		hfinfo = hfinfo->same_name_next;
+	}
+	return FALSE;
+}
+
+static FvalueCmpFunc
+cmp_func_for_op(dfvm_opcode_t op)
+{
+	switch (op) {
+		case ANY_EQ:		return fvalue_eq;
+		case ANY_NE:		return fvalue_ne;
+		case ANY_GT:		return fvalue_gt;
+		case ANY_GE:		return fvalue_ge;
+		case ANY_LT:		return fvalue_lt;
+		case ANY_LE:		return fvalue_le;
+		case ANY_BITWISE_AND:	return fvalue_bitwise_and;
+		case ANY_CONTAINS:	return fvalue_contains;
+		default:
+			g_assert_not_reached();
+	}
+	return NULL;
+}
+
 /* Put a constant value in a register. These will not be cleared by
  * free_register_overhead. */
 static gboolean
@@ -401,6 +556,57 @@ any_in_range(dfilter_t *df, int reg1, int reg2, int reg3)
 }
 
 
+/* Membership test for large "field in { ... }" sets whose elements are
+ * all integer constants, compiled by gencode.c into a hash set keyed on
+ * the integer value: one probe per field value instead of an equality
+ * test per set element. */
+static gboolean
+any_in_int_set(dfilter_t *df, int reg1, GHashTable *set)
+{
+	GList	*list1;
+
+	list1 = df->registers[reg1];
+
+	while (list1) {
+		fvalue_t *value = (fvalue_t *)list1->data;
+		if (g_hash_table_contains(set,
+		    GUINT_TO_POINTER(fvalue_get_uinteger(value)))) {
+			return TRUE;
+		}
+		list1 = g_list_next(list1);
+	}
+	return FALSE;
+}
+
+/* Membership test for large "field in { ... }" sets whose elements are
+ * all IPv4 address constants, possibly with prefixes.  gencode.c groups
+ * the elements into one hash table of masked addresses per distinct
+ * netmask, so a 5000-subnet set costs one masked probe per distinct
+ * prefix length.  Field values from dissection always carry a /32 mask,
+ * so masking with each bucket's netmask reproduces the MIN-of-masks
+ * comparison that IPv4 cmp_eq performs. */
+static gboolean
+any_in_ipv4_set(dfilter_t *df, int reg1, dfvm_ipv4_set_t *set)
+{
+	GList	*list1;
+	guint	i;
+
+	list1 = df->registers[reg1];
+
+	while (list1) {
+		fvalue_t *value = (fvalue_t *)list1->data;
+		guint32 addr = value->value.ipv4.addr;
+		for (i = 0; i < set->num_buckets; i++) {
+			if (g_hash_table_contains(set->buckets[i].addrs,
+			    GUINT_TO_POINTER(addr & set->buckets[i].nmask))) {
+				return TRUE;
+			}
+		}
+		list1 = g_list_next(list1);
+	}
+	return FALSE;
+}
+
 static void
 free_owned_register(gpointer data, gpointer user_data _U_)
 {
@@ -471,14 +677,40 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 	header_field_info	*hfinfo;
 	GList		*param1;
 	GList		*param2;
+	guint64		*profile_counts = NULL;
+	guint64		*profile_time = NULL;
+	gint64		profile_now, profile_last = 0;
+	int		profile_last_id = -1;
 
 	g_assert(tree);
 
 	length = df->insns->len;
 
+	if (G_UNLIKELY(profiling_enabled)) {
+		if (df->insn_counts == NULL) {
+			df->insn_counts = g_new0(guint64, length);
+			df->insn_time_us = g_new0(guint64, length);
+		}
+		profile_counts = df->insn_counts;
+		profile_time = df->insn_time_us;
+		profile_last = g_get_monotonic_time();
+	}
+
 	for (id = 0; id < length; id++) {
 
 	  AGAIN:
+		/* an instruction's time runs until the next one is fetched */
+		if (G_UNLIKELY(profile_counts != NULL)) {
+			profile_now = g_get_monotonic_time();
+			if (profile_last_id >= 0) {
+				profile_time[profile_last_id] +=
+				    profile_now - profile_last;
+			}
+			profile_last = profile_now;
+			profile_last_id = id;
+			profile_counts[id]++;
+		}
+
 		insn = (dfvm_insn_t	*)g_ptr_array_index(df->insns, id);
 		arg1 = insn->arg1;
 		arg2 = insn->arg2;
@@ -503,6 +735,13 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 						arg1->value.hfinfo, arg2->value.numeric);
 				break;
 
+			case TREE_ANY_CMP:
+				arg3 = insn->arg3;
+				accum = tree_any_cmp(df, tree, arg1->value.hfinfo,
+						cmp_func_for_op((dfvm_opcode_t)arg3->value.numeric),
+						arg2->value.numeric);
+				break;
+
 			case CALL_FUNCTION:
 				arg3 = insn->arg3;
 				arg4 = insn->arg4;
@@ -579,11 +818,25 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 						arg3->value.numeric);
 				break;
 
+			case ANY_IN_INT_SET:
+				accum = any_in_int_set(df, arg1->value.numeric,
+						arg2->value.hash_set);
+				break;
+
+			case ANY_IN_IPV4_SET:
+				accum = any_in_ipv4_set(df, arg1->value.numeric,
+						arg2->value.ipv4_set);
+				break;
+
 			case NOT:
 				accum = !accum;
 				break;
 
 			case RETURN:
+				if (G_UNLIKELY(profile_counts != NULL)) {
+					profile_time[id] +=
+					    g_get_monotonic_time() - profile_last;
+				}
 				free_register_overhead(df);
 				return accum;
 
@@ -642,6 +895,7 @@ dfvm_init_const(dfilter_t *df)
 				break;
 			case CHECK_EXISTS:
 			case READ_TREE:
+			case TREE_ANY_CMP:
 			case CALL_FUNCTION:
 			case MK_RANGE:
 			case ANY_EQ:
@@ -654,6 +908,8 @@ dfvm_init_const(dfilter_t *df)
 			case ANY_CONTAINS:
 			case ANY_MATCHES:
 			case ANY_IN_RANGE:
+			case ANY_IN_INT_SET:
+			case ANY_IN_IPV4_SET:
 			case NOT:
 			case RETURN:
 			case IF_TRUE_GOTO:
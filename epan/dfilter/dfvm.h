@@ -23,9 +23,25 @@ typedef enum {
 	REGISTER,
 	INTEGER,
 	DRANGE,
-	FUNCTION_DEF
+	FUNCTION_DEF,
+	INT_SET,
+	IPV4_SET
 } dfvm_value_type_t;
 
+/* A set of IPv4 address/prefix constants, grouped by prefix length:
+ * one hash table of masked addresses per distinct netmask, so that
+ * membership costs one probe per distinct prefix length rather than
+ * one masked comparison per element. */
+typedef struct {
+	guint32		nmask;		/* netmask, host byte order */
+	GHashTable	*addrs;		/* addresses masked with nmask */
+} dfvm_ipv4_prefix_bucket_t;
+
+typedef struct {
+	guint				num_buckets;
+	dfvm_ipv4_prefix_bucket_t	*buckets;
+} dfvm_ipv4_set_t;
+
 typedef struct {
 	dfvm_value_type_t	type;
 
@@ -35,6 +51,8 @@ typedef struct {
 		drange_t		*drange;
 		header_field_info	*hfinfo;
         df_func_def_t   *funcdef;
+		GHashTable		*hash_set;
+		dfvm_ipv4_set_t		*ipv4_set;
 	} value;
 
 } dfvm_value_t;
@@ -60,7 +78,10 @@ typedef enum {
 	ANY_MATCHES,
 	MK_RANGE,
 	CALL_FUNCTION,
-	ANY_IN_RANGE
+	ANY_IN_RANGE,
+	ANY_IN_INT_SET,
+	ANY_IN_IPV4_SET,
+	TREE_ANY_CMP
 
 } dfvm_opcode_t;
 
@@ -85,6 +106,12 @@ dfvm_value_new(dfvm_value_type_t type);
 void
 dfvm_dump(FILE *f, dfilter_t *df);
 
+void
+dfvm_profiling_enable(gboolean enable);
+
+void
+dfvm_dump_profile(FILE *f, dfilter_t *df);
+
 gboolean
 dfvm_apply(dfilter_t *df, proto_tree *tree);
 
@@ -287,6 +287,193 @@ fixup_jumps(gpointer data, gpointer user_data)
 	}
 }
 
+/* Sets whose elements are all plain integer constants are, at or above
+ * this many elements, compiled into a single hash-set membership test
+ * instead of a chain of equality tests, so large port or frame-number
+ * lists don't cost one comparison per element per packet. */
+#define IN_SET_HASH_THRESHOLD	16
+
+static gboolean
+in_set_can_hash(GSList *nodelist, guint *count)
+{
+	stnode_t	*node1, *node2;
+	fvalue_t	*fv;
+
+	*count = 0;
+	while (nodelist) {
+		node1 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+		node2 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+
+		if (node2 != NULL) {
+			/* Range element; needs ordered comparison. */
+			return FALSE;
+		}
+		if (stnode_type_id(node1) != STTYPE_FVALUE) {
+			return FALSE;
+		}
+		fv = (fvalue_t *)stnode_data(node1);
+		switch (fvalue_type_ftenum(fv)) {
+			case FT_UINT8:
+			case FT_UINT16:
+			case FT_UINT24:
+			case FT_UINT32:
+			case FT_FRAMENUM:
+				break;
+			default:
+				/* No integer value to key a hash on. */
+				return FALSE;
+		}
+		(*count)++;
+	}
+	return TRUE;
+}
+
+/* Generate a single hash-probe membership test for an all-integer-
+ * constant set.  Only called when in_set_can_hash() said yes. */
+static void
+gen_relation_in_hash(dfwork_t *dfw, stnode_t *st_arg1, GSList *nodelist_head)
+{
+	dfvm_insn_t	*insn;
+	dfvm_value_t	*val1, *val2;
+	dfvm_value_t	*jmp1 = NULL;
+	int		reg1 = -1;
+	GSList		*nodelist;
+	GHashTable	*set;
+	fvalue_t	*fv;
+
+	/* Create code for the LHS of the relation */
+	reg1 = gen_entity(dfw, st_arg1, &jmp1);
+
+	/* Collect the element values.  The node list holds element pairs
+	 * (value, null) - in_set_can_hash() rejected any range pairs. */
+	set = g_hash_table_new(g_direct_hash, g_direct_equal);
+	for (nodelist = nodelist_head; nodelist != NULL;
+	     nodelist = nodelist->next->next) {
+		fv = (fvalue_t *)stnode_data((stnode_t *)nodelist->data);
+		g_hash_table_add(set, GUINT_TO_POINTER(fvalue_get_uinteger(fv)));
+	}
+
+	insn = dfvm_insn_new(ANY_IN_INT_SET);
+	val1 = dfvm_value_new(REGISTER);
+	val1->value.numeric = reg1;
+	val2 = dfvm_value_new(INT_SET);
+	val2->value.hash_set = set;
+	insn->arg1 = val1;
+	insn->arg2 = val2;
+	dfw_append_insn(dfw, insn);
+
+	/* Jump here if the LHS entity was not present */
+	if (jmp1) {
+		jmp1->value.numeric = dfw->next_insn_id;
+	}
+
+	set_nodelist_free(nodelist_head);
+}
+
+static gboolean
+in_set_can_hash_ipv4(GSList *nodelist, guint *count)
+{
+	stnode_t	*node1, *node2;
+	fvalue_t	*fv;
+
+	*count = 0;
+	while (nodelist) {
+		node1 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+		node2 = (stnode_t*)nodelist->data;
+		nodelist = g_slist_next(nodelist);
+
+		if (node2 != NULL) {
+			/* Range element; needs ordered comparison. */
+			return FALSE;
+		}
+		if (stnode_type_id(node1) != STTYPE_FVALUE) {
+			return FALSE;
+		}
+		fv = (fvalue_t *)stnode_data(node1);
+		if (fvalue_type_ftenum(fv) != FT_IPv4) {
+			return FALSE;
+		}
+		(*count)++;
+	}
+	return TRUE;
+}
+
+/* Generate a membership test for an all-IPv4-constant set.  The
+ * elements are grouped by netmask into one hash table of masked
+ * addresses per distinct prefix length, so a large subnet list is a
+ * handful of probes per packet instead of a masked comparison per
+ * subnet.  Only called when in_set_can_hash_ipv4() said yes. */
+static void
+gen_relation_in_ipv4_set(dfwork_t *dfw, stnode_t *st_arg1, GSList *nodelist_head)
+{
+	dfvm_insn_t	*insn;
+	dfvm_value_t	*val1, *val2;
+	dfvm_value_t	*jmp1 = NULL;
+	int		reg1 = -1;
+	GSList		*nodelist;
+	GHashTable	*by_mask, *addrs;
+	GHashTableIter	iter;
+	gpointer	key, value;
+	dfvm_ipv4_set_t	*set;
+	fvalue_t	*fv;
+	guint32		nmask;
+	guint		i;
+
+	/* Create code for the LHS of the relation */
+	reg1 = gen_entity(dfw, st_arg1, &jmp1);
+
+	/* Group the element addresses, masked, by netmask.  The node
+	 * list holds element pairs (value, null) - in_set_can_hash_ipv4()
+	 * rejected any range pairs. */
+	by_mask = g_hash_table_new(g_direct_hash, g_direct_equal);
+	for (nodelist = nodelist_head; nodelist != NULL;
+	     nodelist = nodelist->next->next) {
+		fv = (fvalue_t *)stnode_data((stnode_t *)nodelist->data);
+		nmask = fv->value.ipv4.nmask;
+		addrs = (GHashTable *)g_hash_table_lookup(by_mask,
+		    GUINT_TO_POINTER(nmask));
+		if (addrs == NULL) {
+			addrs = g_hash_table_new(g_direct_hash, g_direct_equal);
+			g_hash_table_insert(by_mask, GUINT_TO_POINTER(nmask),
+			    addrs);
+		}
+		g_hash_table_add(addrs,
+		    GUINT_TO_POINTER(fv->value.ipv4.addr & nmask));
+	}
+
+	set = g_new(dfvm_ipv4_set_t, 1);
+	set->num_buckets = g_hash_table_size(by_mask);
+	set->buckets = g_new(dfvm_ipv4_prefix_bucket_t, set->num_buckets);
+	i = 0;
+	g_hash_table_iter_init(&iter, by_mask);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		set->buckets[i].nmask = GPOINTER_TO_UINT(key);
+		set->buckets[i].addrs = (GHashTable *)value;
+		i++;
+	}
+	/* The address tables are now owned by the buckets. */
+	g_hash_table_destroy(by_mask);
+
+	insn = dfvm_insn_new(ANY_IN_IPV4_SET);
+	val1 = dfvm_value_new(REGISTER);
+	val1->value.numeric = reg1;
+	val2 = dfvm_value_new(IPV4_SET);
+	val2->value.ipv4_set = set;
+	insn->arg1 = val1;
+	insn->arg2 = val2;
+	dfw_append_insn(dfw, insn);
+
+	/* Jump here if the LHS entity was not present */
+	if (jmp1) {
+		jmp1->value.numeric = dfw->next_insn_id;
+	}
+
+	set_nodelist_free(nodelist_head);
+}
+
 /* Generate the code for the in operator.  It behaves much like an OR-ed
  * series of == tests, but without the redundant existence checks. */
 static void
@@ -299,12 +486,30 @@ gen_relation_in(dfwork_t *dfw, stnode_t *st_arg1, stnode_t *st_arg2)
 	stnode_t	*node1, *node2;
 	GSList		*nodelist_head, *nodelist;
 	GSList		*jumplist = NULL;
+	guint		set_size;
+
+	nodelist_head = (GSList*)stnode_steal_data(st_arg2);
+
+	/* Large all-integer-constant sets become one hash probe. */
+	if (in_set_can_hash(nodelist_head, &set_size) &&
+	    set_size >= IN_SET_HASH_THRESHOLD) {
+		gen_relation_in_hash(dfw, st_arg1, nodelist_head);
+		return;
+	}
+
+	/* Likewise, large all-IPv4-constant sets (including subnets)
+	 * become one masked probe per distinct prefix length. */
+	if (in_set_can_hash_ipv4(nodelist_head, &set_size) &&
+	    set_size >= IN_SET_HASH_THRESHOLD) {
+		gen_relation_in_ipv4_set(dfw, st_arg1, nodelist_head);
+		return;
+	}
 
 	/* Create code for the LHS of the relation */
 	reg1 = gen_entity(dfw, st_arg1, &jmp1);
 
 	/* Create code for the set on the RHS of the relation */
-	nodelist_head = nodelist = (GSList*)stnode_steal_data(st_arg2);
+	nodelist = nodelist_head;
 	while (nodelist) {
 		node1 = (stnode_t*)nodelist->data;
 		nodelist = g_slist_next(nodelist);
@@ -551,6 +756,73 @@ dfw_gencode(dfwork_t *dfw)
 	gencode(dfw, dfw->st_root);
 	dfw_append_insn(dfw, dfvm_insn_new(RETURN));
 
+	/*
+	 * Peephole: the overwhelmingly common scripted filter is a single
+	 * "field <relation> constant", which generates
+	 *
+	 *	READ_TREE	field -> reg#n
+	 *	IF_FALSE_GOTO	3
+	 *	ANY_xx		reg#n, reg#const
+	 *	RETURN
+	 *
+	 * Fuse that into one TREE_ANY_CMP instruction that compares the
+	 * field_info array from the tree against the constant register
+	 * directly, so per-packet evaluation does one dispatch and never
+	 * materializes a register list.  The IF_FALSE_GOTO is subsumed:
+	 * an absent field compares false, which is what the jump to
+	 * RETURN produced.
+	 */
+	if (dfw->insns->len == 4) {
+		dfvm_insn_t *rt  = (dfvm_insn_t *)g_ptr_array_index(dfw->insns, 0);
+		dfvm_insn_t *jmp = (dfvm_insn_t *)g_ptr_array_index(dfw->insns, 1);
+		dfvm_insn_t *rel = (dfvm_insn_t *)g_ptr_array_index(dfw->insns, 2);
+		dfvm_insn_t *ret = (dfvm_insn_t *)g_ptr_array_index(dfw->insns, 3);
+		gboolean fusable_rel;
+
+		switch (rel->op) {
+			case ANY_EQ:
+			case ANY_NE:
+			case ANY_GT:
+			case ANY_GE:
+			case ANY_LT:
+			case ANY_LE:
+			case ANY_BITWISE_AND:
+			case ANY_CONTAINS:
+				fusable_rel = TRUE;
+				break;
+			default:
+				fusable_rel = FALSE;
+				break;
+		}
+
+		if (rt->op == READ_TREE && jmp->op == IF_FALSE_GOTO &&
+		    ret->op == RETURN && fusable_rel &&
+		    rel->arg1->value.numeric == rt->arg2->value.numeric &&
+		    rel->arg2->value.numeric != rel->arg1->value.numeric) {
+			dfvm_insn_t	*fused;
+			dfvm_value_t	*val3;
+
+			fused = dfvm_insn_new(TREE_ANY_CMP);
+			fused->arg1 = rt->arg1;		/* HFINFO */
+			rt->arg1 = NULL;
+			fused->arg2 = rel->arg2;	/* constant register */
+			rel->arg2 = NULL;
+			val3 = dfvm_value_new(INTEGER);
+			val3->value.numeric = rel->op;	/* which relation */
+			fused->arg3 = val3;
+
+			dfvm_insn_free(rt);
+			dfvm_insn_free(jmp);
+			dfvm_insn_free(rel);
+			g_ptr_array_set_size(dfw->insns, 0);
+
+			fused->id = 0;
+			g_ptr_array_add(dfw->insns, fused);
+			ret->id = 1;
+			g_ptr_array_add(dfw->insns, ret);
+		}
+	}
+
 	/* fixup goto */
 	length = dfw->insns->len;
 
@@ -1209,13 +1209,18 @@ ws_debug_printf("BER ID=%02x", id);
     tmp_tag = id & 0x1F;
     /* 8.1.2.4 */
     if (tmp_tag == 0x1F) {
+        /* high tag numbers are rare; check what's left once instead of
+           re-walking the tvb chain on every continuation octet */
+        gint rem = tvb_reported_length_remaining(tvb, offset);
+
         tmp_tag = 0;
-        while (tvb_reported_length_remaining(tvb, offset) > 0) {
+        while (rem > 0) {
             t = tvb_get_guint8(tvb, offset);
 #ifdef DEBUG_BER
 ws_debug_printf(" %02x", t);
 #endif
             offset += 1;
+            rem -= 1;
             tmp_tag <<= 7;
             tmp_tag |= t & 0x7F;
             if (!(t & 0x80))
@@ -1327,10 +1332,13 @@ try_get_ber_length(tvbuff_t *tvb, int offset, guint32 *length, gboolean *ind, gi
         len = oct & 0x7F;
         if (len) {
             /* 8.1.3.5 */
+            /* one bounds check for all the length octets instead of a
+               tvb accessor call per octet */
+            const guint8 *lenp = tvb_get_ptr(tvb, offset, len);
+
+            offset += len;
             while (len--) {
-                oct = tvb_get_guint8(tvb, offset);
-                offset++;
-                tmp_length = (tmp_length<<8) + oct;
+                tmp_length = (tmp_length<<8) + *lenp++;
             }
         } else {
             /* 8.1.3.6 */
@@ -1338,8 +1346,9 @@ try_get_ber_length(tvbuff_t *tvb, int offset, guint32 *length, gboolean *ind, gi
             tmp_offset = offset;
             /* ok in here we can traverse the BER to find the length, this will fix most indefinite length issues */
             /* Assumption here is that indefinite length is always used on constructed types*/
-            /* check for EOC */
-            while (tvb_get_guint8(tvb, offset) || tvb_get_guint8(tvb, offset+1)) {
+            /* check for EOC; fetching both octets at once halves the
+               bounds checks while walking the enclosed TLVs */
+            while (tvb_get_ntohs(tvb, offset) != 0) {
                 /* not an EOC at offset */
                 s_offset = offset;
                 offset= get_ber_identifier(tvb, offset, &tclass, &tpc, &ttag);
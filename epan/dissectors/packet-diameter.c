@@ -1481,6 +1481,17 @@ dissect_diameter_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, voi
 	 * FIXME: Looking at epan/conversation.c it seems unlikely that this will work properly in
 	 * multi-homed SCTP connections. This will probably need to be fixed at some point.
 	 */
+	/*
+	 * Request/answer matching is a hash-map lookup on the hop-by-hop id
+	 * (below), with a per-id frame-number tree to disambiguate reused
+	 * ids, so the cost per PDU stays flat no matter how many
+	 * transactions are outstanding.  Don't be tempted to age entries
+	 * out of the map to save memory: frames are re-dissected in
+	 * arbitrary order when clicked or filtered, and an aged-out request
+	 * would make its answer's "Request In" come and go between passes.
+	 * The memory is wmem_file_scope() and is reclaimed wholesale when
+	 * the file is closed.
+	 */
 
 	conversation = find_or_create_conversation(pinfo);
 
@@ -70,6 +70,7 @@
 #include <epan/afn.h>
 #include <epan/tap.h>
 #include <epan/stats_tree.h>
+#include <epan/srt_table.h>
 #include <wsutil/utf8_entities.h>
 #include "packet-tls.h"
 #include "packet-dtls.h"
@@ -94,8 +95,13 @@ struct DnsTap {
     gboolean unsolicited;
     gboolean retransmission;
     nstime_t rrt;
+    nstime_t req_time;  /* time of the matched request, for the SRT table */
 };
 
+/* The opcode is a four-bit field, so reserve a response-time table row for
+   every possible value. */
+#define DNS_NUM_PROCEDURES  16
+
 static int dns_tap = -1;
 
 static const gchar* st_str_packets = "Total Packets";
@@ -4094,10 +4100,12 @@ dissect_dns_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
         /* we don't have a request. This is an unsolicited response */
         dns_stats->unsolicited = TRUE;
       } else {
-        if (retransmission)
+        if (retransmission) {
           dns_stats->retransmission = TRUE;
-        else
+        } else {
           dns_stats->rrt = delta;
+          dns_stats->req_time = dns_trans->req_time;
+        }
         }
     }
     tap_queue_packet(dns_tap, pinfo, dns_stats);
@@ -4279,6 +4287,36 @@ static tap_packet_status dns_stats_tree_packet(stats_tree* st, packet_info* pinf
   return TAP_PACKET_REDRAW;
 }
 
+static void
+dnsstat_init(struct register_srt* srt _U_, GArray* srt_array)
+{
+  srt_stat_table *dns_srt_table;
+  guint32 i;
+
+  dns_srt_table = init_srt_table("DNS", NULL, srt_array, DNS_NUM_PROCEDURES, "Opcodes", "dns.flags.opcode", NULL);
+  for (i = 0; i < DNS_NUM_PROCEDURES; i++)
+  {
+    init_srt_table_row(dns_srt_table, i, val_to_str_const(i, opcode_vals, "Unknown operation"));
+  }
+}
+
+static tap_packet_status
+dnsstat_packet(void *pdns, packet_info *pinfo, epan_dissect_t *edt _U_, const void *psi)
+{
+  const struct DnsTap *pi = (const struct DnsTap *)psi;
+  srt_data_t *data = (srt_data_t *)pdns;
+  srt_stat_table *dns_srt_table;
+
+  /* Only responses that were matched to a request carry a request time
+     to measure against. */
+  if (pi->packet_qr == 0 || pi->unsolicited || pi->retransmission)
+    return TAP_PACKET_DONT_REDRAW;
+
+  dns_srt_table = g_array_index(data->srt_array, srt_stat_table*, 0);
+  add_srt_table_data(dns_srt_table, pi->packet_opcode, &pi->req_time, pinfo);
+  return TAP_PACKET_REDRAW;
+}
+
 void
 proto_reg_handoff_dns(void)
 {
@@ -5853,6 +5891,8 @@ proto_register_dns(void)
   dns_handle = register_dissector("dns", dissect_dns, proto_dns);
 
   dns_tap = register_tap("dns");
+
+  register_srt_table(proto_dns, NULL, 1, dnsstat_packet, dnsstat_init, NULL);
 }
 
 /*
@@ -1691,7 +1691,9 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, guint offset,
            once in linear scan and cache the result.  If we don't
            cache, already processed data will be fed into decompressor
            again and again since dissector will be called randomly.
-           This makes context out-of-sync. */
+           This makes context out-of-sync.  It also means random access
+           to a frame later on never has to replay the HPACK state of
+           the connection; it just reads the cached list below. */
         int decompressed_bytes = 0;
 
         /* Make sure the length isn't too large. */
@@ -278,7 +278,11 @@ typedef struct quic_info_data {
     wmem_map_t     *server_streams; /**< Map from Stream ID -> STREAM info (guint64 -> quic_stream_state), sent by the server. */
 } quic_info_data_t;
 
-/** Per-packet information about QUIC, populated on the first pass. */
+/** Per-packet information about QUIC, populated on the first pass.
+ * Header protection removal and payload decryption depend on connection
+ * state that evolves packet by packet, so both run on the first pass only;
+ * the unmasked flag byte, the packet number and the decrypted payload are
+ * kept here so that later passes never have to replay the connection. */
 struct quic_packet_info {
     struct quic_packet_info *next;
     guint64                 packet_number;  /**< Reconstructed full packet number. */
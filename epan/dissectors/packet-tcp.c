@@ -388,6 +388,7 @@ static expert_field ei_tcp_option_wscale_shift_invalid = EI_INIT;
 static expert_field ei_tcp_option_mss_absent = EI_INIT;
 static expert_field ei_tcp_option_mss_present = EI_INIT;
 static expert_field ei_tcp_short_segment = EI_INIT;
+static expert_field ei_tcp_reassembly_limit = EI_INIT;
 static expert_field ei_tcp_ack_nonzero = EI_INIT;
 static expert_field ei_tcp_connection_sack = EI_INIT;
 static expert_field ei_tcp_connection_syn = EI_INIT;
@@ -586,6 +587,10 @@ static dissector_handle_t tcp_opt_unknown_handle;
 static guint32 tcp_stream_count;
 static guint32 mptcp_stream_count;
 
+/* Maps a stream index to its tcp_analysis structure, so the frame
+ * index recorded there can be looked up by stream number */
+static wmem_map_t *tcp_stream_map;
+
 
 
 /*
@@ -1425,11 +1430,13 @@ init_tcp_conversation_data(packet_info *pinfo)
     tcpd=wmem_new0(wmem_file_scope(), struct tcp_analysis);
     tcpd->flow1.win_scale=-1;
     tcpd->flow1.window = G_MAXUINT32;
-    tcpd->flow1.multisegment_pdus=wmem_tree_new(wmem_file_scope());
+    /* Keyed by sequence number and probed once per segment; the radix
+     * variant keeps these lookups cheap on desegmentation-heavy loads. */
+    tcpd->flow1.multisegment_pdus=wmem_tree_new_radix32(wmem_file_scope());
 
     tcpd->flow2.window = G_MAXUINT32;
     tcpd->flow2.win_scale=-1;
-    tcpd->flow2.multisegment_pdus=wmem_tree_new(wmem_file_scope());
+    tcpd->flow2.multisegment_pdus=wmem_tree_new_radix32(wmem_file_scope());
 
     /* Only allocate the data if its actually going to be analyzed */
     if (tcp_analyze_seq)
@@ -1459,6 +1466,9 @@ init_tcp_conversation_data(packet_info *pinfo)
     tcpd->flow2.push_set_last = FALSE;
     tcpd->stream = tcp_stream_count++;
     tcpd->server_port = 0;
+    tcpd->frame_index = NULL;
+    if (tcp_stream_map)
+        wmem_map_insert(tcp_stream_map, GUINT_TO_POINTER(tcpd->stream), tcpd);
 
     return tcpd;
 }
@@ -1592,6 +1602,20 @@ guint32 get_mptcp_stream_count(void)
     return mptcp_stream_count;
 }
 
+const guint32 *get_tcp_stream_frames(guint32 stream, guint *num_frames)
+{
+    struct tcp_analysis *tcpd;
+
+    *num_frames = 0;
+    if (tcp_stream_map == NULL)
+        return NULL;
+    tcpd = (struct tcp_analysis *)wmem_map_lookup(tcp_stream_map, GUINT_TO_POINTER(stream));
+    if (tcpd == NULL || tcpd->frame_index == NULL)
+        return NULL;
+    *num_frames = wmem_array_get_count(tcpd->frame_index);
+    return (const guint32 *)wmem_array_get_raw(tcpd->frame_index);
+}
+
 /* Calculate the timestamps relative to this conversation */
 static void
 tcp_calculate_timestamps(packet_info *pinfo, struct tcp_analysis *tcpd,
@@ -2223,6 +2247,21 @@ finished_checking_retransmission_type:
             nextseq+=1;
         }
         ual->nextseq=nextseq;
+
+        /* Fold the new segment into the in-flight window bounds so the
+         * bytes-in-flight calculation below doesn't have to walk the list.
+         */
+        if (ual->next == NULL) {
+            tcpd->fwd->tcp_analyze_seq_info->minseqinflight = ual->seq;
+            tcpd->fwd->tcp_analyze_seq_info->maxseqinflight = ual->nextseq;
+        } else {
+            if ((ual->seq - tcpd->fwd->base_seq) < (tcpd->fwd->tcp_analyze_seq_info->minseqinflight - tcpd->fwd->base_seq)) {
+                tcpd->fwd->tcp_analyze_seq_info->minseqinflight = ual->seq;
+            }
+            if ((ual->nextseq - tcpd->fwd->base_seq) > (tcpd->fwd->tcp_analyze_seq_info->maxseqinflight - tcpd->fwd->base_seq)) {
+                tcpd->fwd->tcp_analyze_seq_info->maxseqinflight = ual->nextseq;
+            }
+        }
     }
 
     /* Store the highest number seen so far for nextseq so we can detect
@@ -2287,6 +2326,22 @@ finished_checking_retransmission_type:
         }
         /* If this acknowledges a segment prior to this one, leave this segment alone and move on */
         else if (GT_SEQ(ual->nextseq,ack)) {
+            /* The segment stays on the list; since we're scanning the whole
+             * list anyway, recompute the in-flight window bounds over the
+             * surviving segments.  prevual is NULL exactly when this is the
+             * first survivor.
+             */
+            if (prevual == NULL) {
+                tcpd->rev->tcp_analyze_seq_info->minseqinflight = ual->seq;
+                tcpd->rev->tcp_analyze_seq_info->maxseqinflight = ual->nextseq;
+            } else {
+                if ((ual->seq - tcpd->rev->base_seq) < (tcpd->rev->tcp_analyze_seq_info->minseqinflight - tcpd->rev->base_seq)) {
+                    tcpd->rev->tcp_analyze_seq_info->minseqinflight = ual->seq;
+                }
+                if ((ual->nextseq - tcpd->rev->base_seq) > (tcpd->rev->tcp_analyze_seq_info->maxseqinflight - tcpd->rev->base_seq)) {
+                    tcpd->rev->tcp_analyze_seq_info->maxseqinflight = ual->nextseq;
+                }
+            }
             prevual = ual;
             ual = ual->next;
             continue;
@@ -2321,17 +2376,13 @@ finished_checking_retransmission_type:
     if (tcp_track_bytes_in_flight && seglen!=0 && ual && tcpd->fwd->valid_bif) {
         guint32 first_seq, last_seq, in_flight;
 
-        first_seq = ual->seq - tcpd->fwd->base_seq;
-        last_seq = ual->nextseq - tcpd->fwd->base_seq;
-        while (ual) {
-            if ((ual->nextseq-tcpd->fwd->base_seq)>last_seq) {
-                last_seq = ual->nextseq-tcpd->fwd->base_seq;
-            }
-            if ((ual->seq-tcpd->fwd->base_seq)<first_seq) {
-                first_seq = ual->seq-tcpd->fwd->base_seq;
-            }
-            ual = ual->next;
-        }
+        /* The bounds are maintained as segments are added to the list above
+         * and whenever the ACK-processing loop rescans it, so we don't have
+         * to walk up to TCP_MAX_UNACKED_SEGMENTS entries for every data
+         * segment of the flow.
+         */
+        first_seq = tcpd->fwd->tcp_analyze_seq_info->minseqinflight - tcpd->fwd->base_seq;
+        last_seq = tcpd->fwd->tcp_analyze_seq_info->maxseqinflight - tcpd->fwd->base_seq;
         in_flight = last_seq-first_seq;
 
         if (in_flight>0 && in_flight<2000000000) {
@@ -3034,6 +3085,12 @@ static gboolean tcp_desegment = TRUE;
  * subdissector (depends on "tcp_desegment"). */
 static gboolean tcp_reassemble_out_of_order = FALSE;
 
+/* Upper bound, in bytes, on the data buffered for a single multisegment
+ * PDU; 0 means no limit. A PDU that never completes (e.g. a subdissector
+ * desegmenting an unterminated stream) otherwise grows the reassembly
+ * table without bound. */
+static guint tcp_desegment_max_buffered = 0;
+
 /* Returns true iff any gap exists in the segments associated with msp up to the
  * given sequence number (it ignores any gaps after the sequence number). */
 static gboolean
@@ -3132,8 +3189,13 @@ again:
          *
          * Only shortcircuit here when the first segment of the MSP is known,
          * and when this this first segment is not one to complete the MSP.
+         *
+         * A lookup32_le() also serves the "most previous PDU starting
+         * before this sequence number" case further below, so one tree
+         * descent covers both.
          */
-        if ((msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32(tcpd->fwd->multisegment_pdus, seq)) &&
+        msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32_le(tcpd->fwd->multisegment_pdus, seq);
+        if (msp && msp->seq == seq &&
                 nxtseq <= msp->nxtpdu &&
                 !(msp->flags & MSP_FLAGS_MISSING_FIRST_SEGMENT) && msp->last_frame != pinfo->num) {
             const char* str;
@@ -3211,8 +3273,11 @@ again:
                 plurality(nbytes, "", "s"));
             return;
         }
-        /* Else, find the most previous PDU starting before this sequence number */
-        if (!msp) {
+        /* Else, the most previous PDU starting before this sequence number
+         * was already found by the lookup above; the only entry it can miss
+         * is the topmost one in the tree, when seq-1 wraps around.
+         */
+        if (!msp && seq == 0) {
             msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32_le(tcpd->fwd->multisegment_pdus, seq-1);
         }
     }
@@ -3270,6 +3335,25 @@ again:
         }
     }
 
+    if (msp && msp->seq <= seq && msp->nxtpdu > seq &&
+        tcp_desegment_max_buffered > 0 &&
+        seq - msp->seq >= tcp_desegment_max_buffered) {
+        /* This PDU already has the configured maximum buffered, so don't
+         * add this segment to it; just show it as data. The check depends
+         * only on the MSP boundaries, so every pass takes the same path
+         * and the marker survives redissection. */
+        nbytes = tvb_reported_length_remaining(tvb, offset);
+        proto_tree_add_bytes_format(tcp_tree, hf_tcp_segment_data, tvb,
+            offset, nbytes, NULL, "TCP segment data (%u byte%s)", nbytes,
+            plurality(nbytes, "", "s"));
+        proto_tree_add_expert_format(tcp_tree, pinfo, &ei_tcp_reassembly_limit,
+            tvb, offset, nbytes,
+            "Reassembly limit of %u bytes reached for this PDU; segment not buffered",
+            tcp_desegment_max_buffered);
+        col_append_sep_str(pinfo->cinfo, COL_INFO, " ", "[TCP PDU too large]");
+        return;
+    }
+
     if (msp && msp->seq <= seq && msp->nxtpdu > seq) {
         int len;
 
@@ -6731,6 +6815,19 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
     captured_length_remaining = tvb_captured_length_remaining(tvb, offset);
 
     if (tcph->th_have_seglen) {
+        if (!pinfo->fd->visited && tcpd) {
+            guint32 frame_num = pinfo->num;
+            guint count;
+
+            if (tcpd->frame_index == NULL)
+                tcpd->frame_index = wmem_array_new(wmem_file_scope(), sizeof(guint32));
+            /* TCP can be dissected more than once per frame when
+             * tunneled; don't record the same frame twice */
+            count = wmem_array_get_count(tcpd->frame_index);
+            if (count == 0 ||
+                *(guint32 *)wmem_array_index(tcpd->frame_index, count - 1) != frame_num)
+                wmem_array_append_one(tcpd->frame_index, frame_num);
+        }
         if(have_tap_listener(tcp_follow_tap)) {
             tcp_follow_tap_data_t* follow_data = wmem_new0(wmem_packet_scope(), tcp_follow_tap_data_t);
 
@@ -6874,6 +6971,7 @@ static void
 tcp_init(void)
 {
     tcp_stream_count = 0;
+    tcp_stream_map = wmem_map_new(wmem_file_scope(), g_direct_hash, g_direct_equal);
 
     /* MPTCP init */
     mptcp_stream_count = 0;
@@ -7688,6 +7786,7 @@ proto_register_tcp(void)
         { &ei_tcp_option_mss_absent, { "tcp.options.mss.absent", PI_PROTOCOL, PI_NOTE, "The SYN packet does not contain a MSS option", EXPFILL }},
         { &ei_tcp_option_mss_present, { "tcp.options.mss.present", PI_PROTOCOL, PI_WARN, "The non-SYN packet does contain a MSS option", EXPFILL }},
         { &ei_tcp_short_segment, { "tcp.short_segment", PI_MALFORMED, PI_WARN, "Short segment", EXPFILL }},
+        { &ei_tcp_reassembly_limit, { "tcp.reassembly_limit_reached", PI_REASSEMBLE, PI_WARN, "Reassembly buffer limit reached for this PDU", EXPFILL }},
         { &ei_tcp_ack_nonzero, { "tcp.ack.nonzero", PI_PROTOCOL, PI_NOTE, "The acknowledgment number field is nonzero while the ACK flag is not set", EXPFILL }},
         { &ei_tcp_connection_sack, { "tcp.connection.sack", PI_SEQUENCE, PI_CHAT, "Connection establish acknowledge (SYN+ACK)", EXPFILL }},
         { &ei_tcp_connection_syn, { "tcp.connection.syn", PI_SEQUENCE, PI_CHAT, "Connection establish request (SYN)", EXPFILL }},
@@ -7856,6 +7955,12 @@ proto_register_tcp(void)
         "Whether out-of-order segments should be buffered and reordered before passing it to a subdissector. "
         "To use this option you must also enable \"Allow subdissector to reassemble TCP streams\".",
         &tcp_reassemble_out_of_order);
+    prefs_register_uint_preference(tcp_module, "desegment_buffer_limit",
+        "Maximum bytes buffered per reassembled PDU",
+        "Stop buffering segments for a PDU once this many bytes have been "
+        "collected for it, showing further segments as data; 0 means no limit. "
+        "Bounds the memory a single never-completing stream can consume.",
+        10, &tcp_desegment_max_buffered);
     prefs_register_bool_preference(tcp_module, "analyze_sequence_numbers",
         "Analyze TCP sequence numbers",
         "Make the TCP dissector analyze TCP sequence numbers to find and flag segment retransmissions, missing segments and RTT",
@@ -308,6 +308,13 @@ typedef struct tcp_analyze_seq_flow_info_t {
 				 * distinguish between retransmission,
 				 * fast retransmissions and outoforder
 				 */
+	guint32 minseqinflight;	/* lowest seq number of the unacked segments,
+				 * kept current so bytes-in-flight tracking
+				 * doesn't have to rescan the segment list
+				 */
+	guint32 maxseqinflight;	/* highest nextseq number of the unacked
+				 * segments, see minseqinflight
+				 */
 
 } tcp_analyze_seq_flow_info_t;
 
@@ -446,6 +453,12 @@ struct tcp_analysis {
 	 */
 	guint16 server_port;
 
+	/* Frame numbers of the segments in this stream, recorded on the
+	 * first pass so that Follow Stream can retap just those frames
+	 * instead of rescanning the whole file
+	 */
+	wmem_array_t *frame_index;
+
 	/* allocated only when mptcp enabled
 	 * several tcp_analysis may refer to the same mptcp_analysis
 	 * can exist without any meta
@@ -509,6 +522,17 @@ WS_DLL_PUBLIC guint32 get_tcp_stream_count(void);
  */
 WS_DLL_PUBLIC guint32 get_mptcp_stream_count(void);
 
+/** Get the frame numbers of a TCP stream's segments, as recorded
+ * during the first dissection pass.  The array is valid until the
+ * capture file is closed.
+ *
+ * @param stream The stream index
+ * @param num_frames Set to the number of frame numbers returned
+ * @return Array of frame numbers in ascending order, or NULL if the
+ * stream is unknown
+ */
+WS_DLL_PUBLIC const guint32 *get_tcp_stream_frames(guint32 stream, guint *num_frames);
+
 /* Follow Stream functionality shared with HTTP (and SSL?) */
 extern gchar *tcp_follow_conv_filter(packet_info *pinfo, guint *stream, guint *sub_stream);
 extern gchar *tcp_follow_index_filter(guint stream, guint sub_stream);
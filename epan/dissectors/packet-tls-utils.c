@@ -5144,7 +5144,18 @@ tls13_key_update(SslDecryptSession *ssl, gboolean is_from_server)
     tls13_generate_keys(ssl, app_secret, is_from_server);
 }
 
-/** SSL keylog file handling. {{{ */
+/** SSL keylog file handling. {{{
+ *
+ * The key log file is read in full the first time a handshake needs it
+ * (and re-polled, rate-limited, for appended lines during live capture),
+ * and every secret is cached in the master key map keyed by Client
+ * Random or Session ID.  Secrets are therefore already available before
+ * the first decryption attempt of any session, no matter where in the
+ * capture its handshake sits; binding to a conversation happens when the
+ * Hello messages are parsed.  A failed decryption attempt means the
+ * secret is absent from the file, which no amount of pre-scanning can
+ * fix, so there is deliberately no separate pre-pass over the capture.
+ */
 
 static GRegex *
 ssl_compile_keyfile_regex(void)
@@ -5336,6 +5347,9 @@ void
 ssl_load_keyfile(const gchar *tls_keylog_filename, FILE **keylog_file,
                  const ssl_master_key_map_t *mk_map)
 {
+    static gint64 last_poll;    /* in monotonic microseconds */
+    gint64 now;
+
     /* no need to try if no key log file is configured. */
     if (!tls_keylog_filename || !*tls_keylog_filename) {
         ssl_debug_printf("%s dtls/tls.keylog_file is not configured!\n",
@@ -5348,6 +5362,19 @@ ssl_load_keyfile(const gchar *tls_keylog_filename, FILE **keylog_file,
         return;
     }
 
+    /* This is called for every handshake message and key transition, but
+     * polling the file costs a stat() plus a read attempt at EOF.  New
+     * secrets can only appear while something is writing the key log
+     * alongside a live capture, so checking a few times per second is
+     * plenty.  An unopened file is always tried, both on the very first
+     * call and after ssl_common_cleanup() closed it so that a redissection
+     * refills the cleared caches from the full file. */
+    now = g_get_monotonic_time();
+    if (*keylog_file != NULL && now - last_poll < G_USEC_PER_SEC / 4) {
+        return;
+    }
+    last_poll = now;
+
     ssl_debug_printf("trying to use TLS keylog in %s\n", tls_keylog_filename);
 
     /* if the keylog file was deleted/overwritten, re-open it */
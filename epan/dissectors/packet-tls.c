@@ -1242,8 +1242,12 @@ again:
      * the retransmission instead of the original transmission, breaking
      * dissection of the desegmented pdu if we'd already seen the end of
      * the pdu).
+     *
+     * A lookup32_le() also serves the "most previous PDU starting before
+     * this sequence number" case below, so one tree descent covers both.
      */
-    if ((msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32(flow->multisegment_pdus, seq))) {
+    msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32_le(flow->multisegment_pdus, seq);
+    if (msp && msp->seq == seq) {
         const char *prefix;
 
         if (msp->first_frame == pinfo->num) {
@@ -1258,8 +1262,13 @@ again:
         return;
     }
 
-    /* Else, find the most previous PDU starting before this sequence number */
-    msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32_le(flow->multisegment_pdus, seq-1);
+    /* Else, the most previous PDU starting before this sequence number was
+     * already found by the lookup above; the only entry it can miss is the
+     * topmost one in the tree, when seq-1 wraps around.
+     */
+    if (!msp && seq == 0) {
+        msp = (struct tcp_multisegment_pdu *)wmem_tree_lookup32_le(flow->multisegment_pdus, seq-1);
+    }
     if (msp && msp->seq <= seq && msp->nxtpdu > seq) {
         int len;
 
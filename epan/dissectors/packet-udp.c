@@ -590,6 +590,68 @@ handle_export_pdu_conversation(packet_info *pinfo, tvbuff_t *tvb, int uh_dport,
   }
 }
 
+/* If a heuristic dissector accepted an earlier frame of this conversation,
+ * try it on this frame before scanning the whole heuristic list: flows
+ * rarely change protocol, so this usually turns dozens of probes into a
+ * single one.  The full list scan still runs when the remembered dissector
+ * rejects the frame.  Only used on the first pass; later passes replay the
+ * per-packet cache instead.
+ */
+static gboolean
+try_remembered_heur_dissector(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
+                              udp_p_info_t **udp_p_info_ptr, guint8 curr_layer_num)
+{
+  conversation_t *conv;
+  struct udp_analysis *udpd;
+  udp_p_info_t *udp_p_info = *udp_p_info_ptr;
+
+  if (PINFO_FD_VISITED(pinfo))
+    return FALSE;
+
+  conv = find_conversation_pinfo(pinfo, 0);
+  if (conv == NULL)
+    return FALSE;
+
+  udpd = (struct udp_analysis *)conversation_get_proto_data(conv, hfi_udp->id);
+  if (udpd == NULL || udpd->heur_dtbl_entry == NULL)
+    return FALSE;
+
+  if (!dissector_try_heuristic_entry(udpd->heur_dtbl_entry, tvb, pinfo, tree, NULL))
+    return FALSE;
+
+  if (!udp_p_info) {
+    udp_p_info = wmem_new0(wmem_file_scope(), udp_p_info_t);
+    p_add_proto_data(wmem_file_scope(), pinfo, hfi_udp->id, curr_layer_num, udp_p_info);
+    *udp_p_info_ptr = udp_p_info;
+  }
+
+  udp_p_info->heur_dtbl_entry = udpd->heur_dtbl_entry;
+
+  handle_export_pdu_heuristic(pinfo, tvb, udp_p_info->heur_dtbl_entry);
+  return TRUE;
+}
+
+/* Remember which heuristic dissector accepted this conversation, for
+ * try_remembered_heur_dissector() above.
+ */
+static void
+remember_heur_dissector(packet_info *pinfo, heur_dtbl_entry_t *hdtbl_entry)
+{
+  conversation_t *conv;
+  struct udp_analysis *udpd;
+
+  if (PINFO_FD_VISITED(pinfo))
+    return;
+
+  conv = find_conversation_pinfo(pinfo, 0);
+  if (conv == NULL)
+    return;
+
+  udpd = get_udp_conversation_data(conv, pinfo);
+  if (udpd != NULL)
+    udpd->heur_dtbl_entry = hdtbl_entry;
+}
+
 void
 decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
                  proto_tree *tree, int uh_sport, int uh_dport, int uh_ulen)
@@ -644,6 +706,9 @@ decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
   }
 
   if (try_heuristic_first) {
+    if (try_remembered_heur_dissector(next_tvb, pinfo, tree, &udp_p_info, curr_layer_num))
+      return;
+
     /* Do lookup with the heuristic subdissector table */
     if (dissector_try_heuristic(heur_subdissector_list, next_tvb, pinfo, tree, &hdtbl_entry, NULL)) {
       if (!udp_p_info) {
@@ -652,6 +717,7 @@ decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
       }
 
       udp_p_info->heur_dtbl_entry = hdtbl_entry;
+      remember_heur_dissector(pinfo, hdtbl_entry);
 
       handle_export_pdu_heuristic(pinfo, next_tvb, udp_p_info->heur_dtbl_entry);
       return;
@@ -693,6 +759,9 @@ decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
   }
 
   if (!try_heuristic_first) {
+    if (try_remembered_heur_dissector(next_tvb, pinfo, tree, &udp_p_info, curr_layer_num))
+      return;
+
     /* Do lookup with the heuristic subdissector table */
     if (dissector_try_heuristic(heur_subdissector_list, next_tvb, pinfo, tree, &hdtbl_entry, NULL)) {
       if (!udp_p_info) {
@@ -701,6 +770,7 @@ decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
       }
 
       udp_p_info->heur_dtbl_entry = hdtbl_entry;
+      remember_heur_dissector(pinfo, hdtbl_entry);
 
       handle_export_pdu_heuristic(pinfo, next_tvb, udp_p_info->heur_dtbl_entry);
       return;
@@ -975,10 +1045,13 @@ dissect(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, guint32 ip_proto)
   struct udp_analysis *udpd = NULL;
   proto_tree *process_tree;
   gboolean    udp_jumbogram = FALSE;
+  static const guint8 udp_port_widths[] = { 2, 2 };
+  guint64     udp_ports[2];
 
   udph = wmem_new0(wmem_packet_scope(), e_udphdr);
-  udph->uh_sport = tvb_get_ntohs(tvb, offset);
-  udph->uh_dport = tvb_get_ntohs(tvb, offset + 2);
+  tvb_get_fields(tvb, offset, ENC_BIG_ENDIAN, udp_port_widths, 2, udp_ports);
+  udph->uh_sport = (guint16)udp_ports[0];
+  udph->uh_dport = (guint16)udp_ports[1];
   copy_address_shallow(&udph->ip_src, &pinfo->src);
   copy_address_shallow(&udph->ip_dst, &pinfo->dst);
 
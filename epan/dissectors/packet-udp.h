@@ -18,6 +18,7 @@ extern "C" {
 #include "ws_symbol_export.h"
 
 #include <epan/conversation.h>
+#include <epan/packet.h>
 
 /* UDP structs and definitions */
 typedef struct _e_udphdr {
@@ -81,6 +82,12 @@ struct udp_analysis {
 	 * to previous frame in this conversation
 	 */
 	nstime_t	ts_prev;
+
+	/* The heuristic dissector, if any, that accepted an earlier frame
+	 * of this conversation.  It is tried first for later frames, before
+	 * scanning the whole heuristic list again.
+	 */
+	heur_dtbl_entry_t *heur_dtbl_entry;
 };
 
 /** Associate process information with a given flow
@@ -275,6 +275,7 @@ epan_init(register_cb cb, gpointer client_data, gboolean load_plugins)
 		packet_cache_proto_handles();
 		dfilter_init();
 		final_registration_all_protocols();
+		custom_srt_init();
 		print_cache_field_handles();
 		expert_packet_init();
 		export_pdu_init();
@@ -365,8 +366,10 @@ epan_cleanup(void)
 	proto_cleanup();
 
 	secrets_cleanup();
+	custom_srt_cleanup();
 	conversation_filters_cleanup();
 	reassembly_table_cleanup();
+	tvb_uncompress_cache_cleanup();
 	tap_cleanup();
 	expert_cleanup();
 	capture_dissector_cleanup();
@@ -0,0 +1,352 @@
+/* epan_bench.c
+ * Timed microbenchmarks for libwireshark hot paths.
+ *
+ * Build with the "benchmarks" target; not built by default.  Each
+ * benchmark prints one tab-separated line so results can be collected
+ * and compared across builds by a script:
+ *
+ *     name <TAB> iterations <TAB> total_us <TAB> ns_per_op
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include <epan/epan.h>
+#include <epan/epan_dissect.h>
+#include <epan/tvbuff.h>
+#include <epan/conversation.h>
+#include <epan/timestamp.h>
+#include <epan/prefs.h>
+#include <epan/dfilter/dfilter.h>
+#include <epan/wmem/wmem.h>
+
+#include <wiretap/wtap.h>
+
+#include <ui/cmdarg_err.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/privileges.h>
+#include <wsutil/report_message.h>
+#include <version_info.h>
+
+/* Accumulator that the compiler cannot prove dead, so the timed loops
+ * are not optimized away. */
+static volatile guint64 bench_sink;
+
+static void
+bench_report(const char *name, guint64 iterations, guint64 elapsed_us)
+{
+    printf("%s\t%" G_GUINT64_FORMAT "\t%" G_GUINT64_FORMAT "\t%.1f\n",
+           name, iterations, elapsed_us,
+           iterations ? (1000.0 * (double)elapsed_us) / (double)iterations : 0.0);
+}
+
+/*
+ * A DNS query over UDP/IPv4/Ethernet; enough layers to exercise the
+ * frame, eth, ip, udp and dns dissectors and the conversation code.
+ */
+static const guint8 bench_frame[] = {
+    /* Ethernet II */
+    0x00, 0x0c, 0x29, 0xaa, 0xbb, 0xcc, 0x00, 0x50, 0x56, 0x11, 0x22, 0x33,
+    0x08, 0x00,
+    /* IPv4, 10.0.0.1 -> 10.0.0.2, UDP */
+    0x45, 0x00, 0x00, 0x3d, 0x12, 0x34, 0x00, 0x00, 0x40, 0x11, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x01, 0x0a, 0x00, 0x00, 0x02,
+    /* UDP, 49152 -> 53 */
+    0xc0, 0x00, 0x00, 0x35, 0x00, 0x29, 0x00, 0x00,
+    /* DNS query, www.example.com A IN */
+    0xbe, 0xef, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 'w', 'w', 'w', 0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e',
+    0x03, 'c', 'o', 'm', 0x00,
+    0x00, 0x01, 0x00, 0x01
+};
+
+static void
+bench_tvb_accessors(guint64 scale)
+{
+    guint64 iterations = 1000000 * scale;
+    guint64 start, i;
+    guint64 sum = 0;
+    tvbuff_t *tvb;
+    guint8 *data;
+    guint offset;
+
+    data = (guint8 *)g_malloc(1024);
+    for (i = 0; i < 1024; i++)
+        data[i] = (guint8)i;
+    tvb = tvb_new_real_data(data, 1024, 1024);
+
+    start = (guint64)g_get_monotonic_time();
+    for (i = 0; i < iterations; i++) {
+        offset = (guint)(i % 1000);
+        sum += tvb_get_guint8(tvb, offset);
+        sum += tvb_get_ntohs(tvb, offset);
+        sum += tvb_get_ntohl(tvb, offset);
+        sum += tvb_get_letohl(tvb, offset);
+        sum += tvb_get_ntoh64(tvb, offset);
+    }
+    bench_report("tvb/accessors", iterations * 5,
+                 (guint64)g_get_monotonic_time() - start);
+    bench_sink += sum;
+
+    tvb_free(tvb);
+    g_free(data);
+}
+
+static void
+bench_wmem_allocator(const char *name, wmem_allocator_type_t type, guint64 scale)
+{
+    guint64 rounds = 10000 * scale;
+    guint64 start, i;
+    guint j;
+    wmem_allocator_t *allocator;
+
+    allocator = wmem_allocator_new(type);
+
+    start = (guint64)g_get_monotonic_time();
+    for (i = 0; i < rounds; i++) {
+        for (j = 0; j < 256; j++) {
+            /* Size mix from a few bytes up to half a KiB, like the
+             * strings and small structs dissection allocates. */
+            bench_sink += GPOINTER_TO_SIZE(wmem_alloc(allocator, (j % 509) + 1)) & 0xff;
+        }
+        wmem_free_all(allocator);
+    }
+    bench_report(name, rounds * 256,
+                 (guint64)g_get_monotonic_time() - start);
+
+    wmem_destroy_allocator(allocator);
+}
+
+static void
+bench_conversations(guint64 scale)
+{
+    guint64 creations = 10000 * scale;
+    guint64 lookups = 1000000 * scale;
+    guint64 start, i;
+    guint64 found = 0;
+    address addr1, addr2;
+    static const guint8 ip1[4] = { 10, 0, 0, 1 };
+    static const guint8 ip2[4] = { 10, 0, 0, 2 };
+
+    set_address(&addr1, AT_IPv4, 4, ip1);
+    set_address(&addr2, AT_IPv4, 4, ip2);
+
+    start = (guint64)g_get_monotonic_time();
+    for (i = 0; i < creations; i++) {
+        conversation_new((guint32)i, &addr1, &addr2, ENDPOINT_UDP,
+                         (guint32)(1024 + (i % 60000)), 53, 0);
+    }
+    bench_report("conversation/new", creations,
+                 (guint64)g_get_monotonic_time() - start);
+
+    start = (guint64)g_get_monotonic_time();
+    for (i = 0; i < lookups; i++) {
+        if (find_conversation((guint32)creations, &addr1, &addr2, ENDPOINT_UDP,
+                              (guint32)(1024 + (i % 60000)), 53, 0) != NULL)
+            found++;
+    }
+    bench_report("conversation/find", lookups,
+                 (guint64)g_get_monotonic_time() - start);
+    bench_sink += found;
+}
+
+static const nstime_t *
+bench_get_frame_ts(struct packet_provider_data *prov _U_, guint32 frame_num _U_)
+{
+    static nstime_t empty;
+
+    return &empty;
+}
+
+/* Dissect the sample frame once into edt. */
+static void
+bench_dissect_one(epan_dissect_t *edt, guint32 framenum)
+{
+    wtap_rec rec;
+    frame_data fdlocal;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.rec_type = REC_TYPE_PACKET;
+    rec.rec_header.packet_header.caplen = (guint32)sizeof(bench_frame);
+    rec.rec_header.packet_header.len = (guint32)sizeof(bench_frame);
+    rec.rec_header.packet_header.pkt_encap = WTAP_ENCAP_ETHERNET;
+    rec.presence_flags = WTAP_HAS_TS | WTAP_HAS_CAP_LEN;
+
+    frame_data_init(&fdlocal, framenum, &rec, 0, 0);
+    epan_dissect_run(edt, WTAP_FILE_TYPE_SUBTYPE_UNKNOWN, &rec,
+                     tvb_new_real_data(bench_frame, sizeof(bench_frame),
+                                       sizeof(bench_frame)),
+                     &fdlocal, NULL);
+    frame_data_destroy(&fdlocal);
+}
+
+/* Full dissection with tree building; this is the closest thing to a
+ * per-packet cost figure and covers proto_tree_add_item() and friends
+ * at realistic density. */
+static void
+bench_dissection(epan_t *session, guint64 scale)
+{
+    guint64 iterations = 100000 * scale;
+    guint64 start, i;
+    epan_dissect_t *edt;
+
+    edt = epan_dissect_new(session, TRUE, TRUE);
+
+    start = (guint64)g_get_monotonic_time();
+    for (i = 0; i < iterations; i++) {
+        bench_dissect_one(edt, (guint32)(i + 1));
+        epan_dissect_reset(edt);
+    }
+    bench_report("dissect/dns-udp", iterations,
+                 (guint64)g_get_monotonic_time() - start);
+
+    epan_dissect_free(edt);
+}
+
+static void
+bench_dfilter(epan_t *session, guint64 scale)
+{
+    guint64 iterations = 1000000 * scale;
+    guint64 start, i;
+    guint64 matches = 0;
+    dfilter_t *df = NULL;
+    gchar *err_msg = NULL;
+    epan_dissect_t *edt;
+
+    if (!dfilter_compile("dns && udp.port == 53 && ip.addr == 10.0.0.1",
+                         &df, &err_msg)) {
+        fprintf(stderr, "epan_bench: dfilter compile failed: %s\n",
+                err_msg ? err_msg : "(no message)");
+        g_free(err_msg);
+        return;
+    }
+
+    edt = epan_dissect_new(session, TRUE, FALSE);
+    epan_dissect_prime_with_dfilter(edt, df);
+    bench_dissect_one(edt, 1);
+
+    start = (guint64)g_get_monotonic_time();
+    for (i = 0; i < iterations; i++) {
+        if (dfilter_apply_edt(df, edt))
+            matches++;
+    }
+    bench_report("dfilter/apply", iterations,
+                 (guint64)g_get_monotonic_time() - start);
+    bench_sink += matches;
+
+    epan_dissect_free(edt);
+    dfilter_free(df);
+}
+
+static void
+failure_warning_message(const char *msg_format, va_list ap)
+{
+    fprintf(stderr, "epan_bench: ");
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+static void
+failure_message_cont(const char *msg_format, va_list ap)
+{
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    char *init_progfile_dir_error;
+    epan_t *session;
+    guint64 scale = 1;
+
+    if (argc > 1) {
+        scale = g_ascii_strtoull(argv[1], NULL, 10);
+        if (scale == 0) {
+            fprintf(stderr, "Usage: %s [scale]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    cmdarg_err_init(failure_warning_message, failure_message_cont);
+
+    init_process_policies();
+
+    init_progfile_dir_error = init_progfile_dir(argv[0]);
+    if (init_progfile_dir_error != NULL) {
+        fprintf(stderr, "epan_bench: Can't get pathname of directory containing the epan_bench program: %s.\n",
+                init_progfile_dir_error);
+        g_free(init_progfile_dir_error);
+    }
+
+    ws_init_version_info("Epan-bench (Wireshark)", NULL,
+        epan_get_compiled_version_info, epan_get_runtime_version_info);
+
+    init_report_message(failure_warning_message, failure_warning_message,
+                        NULL, NULL, NULL);
+
+    timestamp_set_type(TS_RELATIVE);
+    timestamp_set_precision(TS_PREC_AUTO);
+    timestamp_set_seconds_type(TS_SECONDS_DEFAULT);
+
+    wtap_init(FALSE);
+
+    if (!epan_init(NULL, NULL, FALSE)) {
+        fprintf(stderr, "epan_bench: epan_init() failed\n");
+        return 2;
+    }
+
+    epan_load_settings();
+
+    {
+        static const struct packet_provider_funcs funcs = {
+            bench_get_frame_ts,
+            NULL,
+            NULL,
+            NULL
+        };
+        session = epan_new(NULL, &funcs);
+    }
+
+    printf("# name\titerations\ttotal_us\tns_per_op\n");
+
+    bench_tvb_accessors(scale);
+    bench_wmem_allocator("wmem/block", WMEM_ALLOCATOR_BLOCK, scale);
+    bench_wmem_allocator("wmem/block_fast", WMEM_ALLOCATOR_BLOCK_FAST, scale);
+    bench_wmem_allocator("wmem/simple", WMEM_ALLOCATOR_SIMPLE, scale);
+    bench_conversations(scale);
+    bench_dissection(session, scale);
+    bench_dfilter(session, scale);
+
+    epan_free(session);
+    epan_cleanup();
+    wtap_cleanup();
+    free_progdirs();
+
+    /* bench_sink is volatile, so the timed work cannot be elided. */
+    (void)bench_sink;
+    return 0;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <wsutil/ws_printf.h>
 
@@ -34,6 +35,17 @@ static int proto_malformed    = -1;
 static int expert_tap         = -1;
 static int highest_severity   =  0;
 
+/* Running event counts, indexed by group and severity and maintained
+ * as packets are dissected on the first pass, so summaries don't have
+ * to re-tap the whole file.  The group and severity codes live in the
+ * high byte and the nibble below it, so the tables are indexed by
+ * those shifted-down values. */
+#define EXPERT_GROUP_IDX(group)       (((group) & PI_GROUP_MASK) >> 24)
+#define EXPERT_SEVERITY_IDX(severity) (((severity) & PI_SEVERITY_MASK) >> 20)
+#define EXPERT_GROUP_NUM              (EXPERT_GROUP_IDX(PI_DEPRECATED) + 1)
+#define EXPERT_SEVERITY_NUM           (EXPERT_SEVERITY_IDX(PI_ERROR) + 1)
+static guint64 event_counts[EXPERT_GROUP_NUM][EXPERT_SEVERITY_NUM];
+
 static int ett_expert         = -1;
 static int ett_subexpert      = -1;
 
@@ -245,6 +257,7 @@ expert_packet_init(void)
 	}
 
 	highest_severity = 0;
+	memset(event_counts, 0, sizeof(event_counts));
 
 	proto_malformed = proto_get_id_by_filter_name("_ws.malformed");
 }
@@ -300,6 +313,31 @@ expert_get_highest_severity(void)
 	return highest_severity;
 }
 
+guint64
+expert_get_count(int group, int severity)
+{
+	if (EXPERT_GROUP_IDX(group) >= EXPERT_GROUP_NUM ||
+	    EXPERT_SEVERITY_IDX(severity) >= EXPERT_SEVERITY_NUM)
+		return 0;
+
+	return event_counts[EXPERT_GROUP_IDX(group)][EXPERT_SEVERITY_IDX(severity)];
+}
+
+guint64
+expert_get_severity_count(int severity)
+{
+	guint64 count = 0;
+	int     i;
+
+	if (EXPERT_SEVERITY_IDX(severity) >= EXPERT_SEVERITY_NUM)
+		return 0;
+
+	for (i = 0; i < EXPERT_GROUP_NUM; i++) {
+		count += event_counts[i][EXPERT_SEVERITY_IDX(severity)];
+	}
+	return count;
+}
+
 void
 expert_update_comment_count(guint64 count)
 {
@@ -515,6 +553,25 @@ expert_set_info_vformat(packet_info *pinfo, proto_item *pi, int group, int sever
 		highest_severity = severity;
 	}
 
+	/* Count each event once, on the first pass over the file; later
+	 * re-dissections of a packet fire the same events again. */
+	if (pinfo->fd != NULL && !pinfo->fd->visited &&
+	    EXPERT_GROUP_IDX(group) < EXPERT_GROUP_NUM &&
+	    EXPERT_SEVERITY_IDX(severity) < EXPERT_SEVERITY_NUM) {
+		event_counts[EXPERT_GROUP_IDX(group)][EXPERT_SEVERITY_IDX(severity)]++;
+	}
+
+	/* Keep the frame's compact expert summary current.  Updating it
+	 * on every pass is idempotent (a max and a bit-or over the same
+	 * events), and frame_data_reset() clears it before a
+	 * redissection with changed settings. */
+	if (pinfo->fd != NULL) {
+		if (EXPERT_SEVERITY_IDX(severity) > pinfo->fd->expert_severity)
+			pinfo->fd->expert_severity = (guint8)EXPERT_SEVERITY_IDX(severity);
+		if (EXPERT_GROUP_IDX(group) >= 1 && EXPERT_GROUP_IDX(group) <= 16)
+			pinfo->fd->expert_groups |= (guint16)(1u << (EXPERT_GROUP_IDX(group) - 1));
+	}
+
 	/* XXX: can we get rid of these checks and make them programming errors instead now? */
 	if (pi != NULL && PITEM_FINFO(pi) != NULL) {
 		expert_set_item_flags(pi, group, severity);
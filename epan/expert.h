@@ -92,6 +92,21 @@ expert_packet_cleanup(void);
 WS_DLL_PUBLIC int
 expert_get_highest_severity(void);
 
+/** Get the number of expert events seen so far for a group and
+ severity, counted incrementally as packets are first dissected.
+ @param group The expert group (PI_CHECKSUM, PI_SEQUENCE, etc.)
+ @param severity The severity level (PI_CHAT, PI_ERROR, etc.)
+ */
+WS_DLL_PUBLIC guint64
+expert_get_count(int group, int severity);
+
+/** Get the number of expert events seen so far for a severity level,
+ across all groups.
+ @param severity The severity level (PI_CHAT, PI_ERROR, etc.)
+ */
+WS_DLL_PUBLIC guint64
+expert_get_severity_count(int severity);
+
 WS_DLL_PUBLIC void
 expert_update_comment_count(guint64 count);
 
@@ -0,0 +1,311 @@
+/* field_index.c
+ * Columnar per-field value index for fast re-filtering
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#include <epan/proto.h>
+#include <epan/epan_dissect.h>
+#include <epan/field_index.h>
+
+/*
+ * One (frame, value) pair per occurrence of an indexed field.  A field
+ * like ip.addr occurs more than once per frame, so the column is a
+ * plain append-only array rather than one slot per frame; entries are
+ * in frame order because frames are added in order.
+ */
+typedef struct {
+	guint32	framenum;
+	guint64	value;
+} field_index_entry_t;
+
+typedef struct {
+	int	hfid;
+	gboolean is_signed;
+	GArray	*entries;	/* of field_index_entry_t */
+} field_index_column_t;
+
+struct _field_index {
+	guint			num_columns;
+	field_index_column_t	*columns;
+};
+
+gboolean
+field_index_field_indexable(int hfid)
+{
+	header_field_info *hfinfo = proto_registrar_get_nth(hfid);
+
+	if (hfinfo == NULL)
+		return FALSE;
+
+	switch (hfinfo->type) {
+	case FT_CHAR:
+	case FT_UINT8:
+	case FT_UINT16:
+	case FT_UINT24:
+	case FT_UINT32:
+	case FT_UINT40:
+	case FT_UINT48:
+	case FT_UINT56:
+	case FT_UINT64:
+	case FT_INT8:
+	case FT_INT16:
+	case FT_INT24:
+	case FT_INT32:
+	case FT_INT40:
+	case FT_INT48:
+	case FT_INT56:
+	case FT_INT64:
+	case FT_BOOLEAN:
+	case FT_FRAMENUM:
+	case FT_IPv4:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+static gboolean
+field_type_is_signed(const header_field_info *hfinfo)
+{
+	switch (hfinfo->type) {
+	case FT_INT8:
+	case FT_INT16:
+	case FT_INT24:
+	case FT_INT32:
+	case FT_INT40:
+	case FT_INT48:
+	case FT_INT56:
+	case FT_INT64:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+/* Reduce an fvalue of an indexable type to the guint64 we store and
+ * compare; signed values are sign-extended so the signed compare in
+ * the scan sees them correctly. */
+static guint64
+field_index_fvalue_to_u64(const header_field_info *hfinfo, const fvalue_t *cfv)
+{
+	/* The fvalue get accessors don't modify the value but aren't
+	 * const-qualified; shed the qualifier once here. */
+	fvalue_t *fv = (fvalue_t *)cfv;
+
+	switch (hfinfo->type) {
+	case FT_CHAR:
+	case FT_UINT8:
+	case FT_UINT16:
+	case FT_UINT24:
+	case FT_UINT32:
+	case FT_FRAMENUM:
+	case FT_IPv4:
+		return fvalue_get_uinteger(fv);
+	case FT_BOOLEAN:
+		/* Stored in the 64-bit slot; normalize to 0/1 so that a
+		 * nonzero masked-bitfield value compares equal to a TRUE
+		 * constant, as FT_BOOLEAN's own zero/nonzero equality
+		 * does. */
+		return fvalue_get_uinteger64(fv) ? 1 : 0;
+	case FT_UINT40:
+	case FT_UINT48:
+	case FT_UINT56:
+	case FT_UINT64:
+		return fvalue_get_uinteger64(fv);
+	case FT_INT8:
+	case FT_INT16:
+	case FT_INT24:
+	case FT_INT32:
+		return (guint64)(gint64)fvalue_get_sinteger(fv);
+	case FT_INT40:
+	case FT_INT48:
+	case FT_INT56:
+	case FT_INT64:
+		return (guint64)fvalue_get_sinteger64(fv);
+	default:
+		g_assert_not_reached();
+	}
+	return 0;
+}
+
+field_index_t *
+field_index_new(const int *hfids, guint num_hfids)
+{
+	field_index_t	*fidx;
+	guint		i, n = 0;
+
+	for (i = 0; i < num_hfids; i++) {
+		if (field_index_field_indexable(hfids[i]))
+			n++;
+	}
+	if (n == 0)
+		return NULL;
+
+	fidx = g_new0(field_index_t, 1);
+	fidx->columns = g_new0(field_index_column_t, n);
+	for (i = 0; i < num_hfids; i++) {
+		field_index_column_t *col;
+
+		if (!field_index_field_indexable(hfids[i]))
+			continue;
+		col = &fidx->columns[fidx->num_columns++];
+		col->hfid = hfids[i];
+		col->is_signed =
+		    field_type_is_signed(proto_registrar_get_nth(hfids[i]));
+		col->entries = g_array_new(FALSE, FALSE,
+		    sizeof(field_index_entry_t));
+	}
+	return fidx;
+}
+
+void
+field_index_free(field_index_t *fidx)
+{
+	guint i;
+
+	if (!fidx)
+		return;
+	for (i = 0; i < fidx->num_columns; i++)
+		g_array_free(fidx->columns[i].entries, TRUE);
+	g_free(fidx->columns);
+	g_free(fidx);
+}
+
+void
+field_index_prime_edt(const field_index_t *fidx, struct epan_dissect *edt)
+{
+	guint i;
+
+	for (i = 0; i < fidx->num_columns; i++)
+		epan_dissect_prime_with_hfid(edt, fidx->columns[i].hfid);
+}
+
+void
+field_index_add_record(field_index_t *fidx, guint32 framenum,
+    struct epan_dissect *edt)
+{
+	guint i, j;
+
+	for (i = 0; i < fidx->num_columns; i++) {
+		field_index_column_t *col = &fidx->columns[i];
+		header_field_info *hfinfo = proto_registrar_get_nth(col->hfid);
+		GPtrArray *finfos;
+
+		finfos = proto_get_finfo_ptr_array(edt->tree, col->hfid);
+		if (finfos == NULL)
+			continue;
+		for (j = 0; j < finfos->len; j++) {
+			field_info *finfo =
+			    (field_info *)g_ptr_array_index(finfos, j);
+			field_index_entry_t entry;
+
+			entry.framenum = framenum;
+			entry.value =
+			    field_index_fvalue_to_u64(hfinfo, &finfo->value);
+			g_array_append_val(col->entries, entry);
+		}
+	}
+}
+
+static gboolean
+entry_matches(guint64 value, guint64 constant, gboolean is_signed,
+    df_relation_t relation)
+{
+	switch (relation) {
+	case DF_RELATION_EQ:
+		return value == constant;
+	case DF_RELATION_NE:
+		return value != constant;
+	case DF_RELATION_GT:
+		return is_signed ? (gint64)value > (gint64)constant :
+		    value > constant;
+	case DF_RELATION_GE:
+		return is_signed ? (gint64)value >= (gint64)constant :
+		    value >= constant;
+	case DF_RELATION_LT:
+		return is_signed ? (gint64)value < (gint64)constant :
+		    value < constant;
+	case DF_RELATION_LE:
+		return is_signed ? (gint64)value <= (gint64)constant :
+		    value <= constant;
+	}
+	return FALSE;
+}
+
+gboolean
+field_index_filter(const field_index_t *fidx, const dfilter_t *df,
+    guint8 *result_bits, guint32 num_frames)
+{
+	int		hfid;
+	df_relation_t	relation;
+	const fvalue_t	*constant;
+	const field_index_column_t *col = NULL;
+	header_field_info *hfinfo;
+	guint64		cval;
+	guint		i;
+
+	if (!dfilter_single_relation(df, &hfid, &relation, &constant))
+		return FALSE;
+
+	for (i = 0; i < fidx->num_columns; i++) {
+		if (fidx->columns[i].hfid == hfid) {
+			col = &fidx->columns[i];
+			break;
+		}
+	}
+	if (col == NULL)
+		return FALSE;
+
+	hfinfo = proto_registrar_get_nth(hfid);
+
+	/* An FT_IPv4 constant can carry a subnet mask (ip.src ==
+	 * 10.0.0.0/8), which the DFVM honors by masking both operands
+	 * before comparing, and the stored form is in network byte
+	 * order, so ordered comparisons wouldn't match the DFVM's
+	 * host-order compare either.  Answer only exact-address
+	 * equality from the index; everything else gets a real
+	 * dissection pass. */
+	if (hfinfo->type == FT_IPv4) {
+		if (relation != DF_RELATION_EQ && relation != DF_RELATION_NE)
+			return FALSE;
+		if (constant->value.ipv4.nmask != ip_get_subnet_mask(32))
+			return FALSE;
+	}
+
+	/* semcheck already converted the constant to the field's type */
+	cval = field_index_fvalue_to_u64(hfinfo, constant);
+
+	for (i = 0; i < col->entries->len; i++) {
+		const field_index_entry_t *entry =
+		    &g_array_index(col->entries, field_index_entry_t, i);
+
+		if (entry->framenum > num_frames)
+			break;
+		if (entry_matches(entry->value, cval, col->is_signed, relation))
+			result_bits[(entry->framenum - 1) >> 3] |=
+			    (1 << ((entry->framenum - 1) & 7));
+	}
+	return TRUE;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,70 @@
+/* field_index.h
+ * Columnar per-field value index for fast re-filtering
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __FIELD_INDEX_H__
+#define __FIELD_INDEX_H__
+
+#include <glib.h>
+#include "ws_symbol_export.h"
+#include <epan/dfilter/dfilter.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+struct epan_dissect;
+
+/*
+ * A columnar index over a configurable set of hot fields.  While a
+ * capture is being dissected, the values of the indexed fields are
+ * extracted into packed per-field (frame number, value) arrays; a
+ * later re-filter with a simple "field <relation> constant" display
+ * filter can then be answered by scanning one column instead of
+ * redissecting every frame.
+ *
+ * Only fields whose values reduce to a 64-bit integer are indexable:
+ * the integer types, FT_BOOLEAN, FT_CHAR, FT_FRAMENUM and FT_IPv4.
+ */
+typedef struct _field_index field_index_t;
+
+/** Create an index over the given hfids; non-indexable fields are
+ * silently dropped.  Returns NULL if no field is indexable. */
+WS_DLL_PUBLIC field_index_t *field_index_new(const int *hfids, guint num_hfids);
+
+WS_DLL_PUBLIC void field_index_free(field_index_t *fidx);
+
+/** Can values of this field be stored in a field_index_t? */
+WS_DLL_PUBLIC gboolean field_index_field_indexable(int hfid);
+
+/** Prime a dissection so the indexed fields are collected even when
+ * the tree is otherwise faked.  Call once per epan_dissect_t before
+ * epan_dissect_run(). */
+WS_DLL_PUBLIC void field_index_prime_edt(const field_index_t *fidx,
+    struct epan_dissect *edt);
+
+/** Record the indexed fields of a dissected frame.  Frames must be
+ * added in increasing frame-number order. */
+WS_DLL_PUBLIC void field_index_add_record(field_index_t *fidx,
+    guint32 framenum, struct epan_dissect *edt);
+
+/** Try to answer a compiled display filter from the index.  Returns
+ * TRUE and sets bit (framenum - 1) in result_bits for every matching
+ * frame if the filter is a single relation on an indexed field;
+ * returns FALSE (leaving result_bits untouched) if the filter needs a
+ * real dissection pass.  result_bits must hold at least num_frames
+ * bits and be zeroed by the caller. */
+WS_DLL_PUBLIC gboolean field_index_filter(const field_index_t *fidx,
+    const dfilter_t *df, guint8 *result_bits, guint32 num_frames);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FIELD_INDEX_H__ */
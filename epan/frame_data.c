@@ -41,7 +41,29 @@
                  ((time1).nsecs > (time2).nsecs) ? 1 : \
                  COMPARE_FRAME_NUM())
 
-#define COMPARE_TS(ts) COMPARE_TS_REAL(fdata1->ts, fdata2->ts)
+/* Compare two time stamps (or already-computed deltas), with the same
+   reference-time and frame-number ordering rules as COMPARE_TS_REAL.
+   Sorting the packet list evaluates this for every comparison, so when
+   both values fit the packed 64-bit-nanoseconds form - which any
+   capture in practice does - compare them with one integer subtraction
+   instead of the normalization branches above. */
+static gint
+frame_data_compare_times(const frame_data *fdata1, const frame_data *fdata2,
+                         const nstime_t *ts1, const nstime_t *ts2)
+{
+  if (G_LIKELY(nstime_fits_ns(ts1) && nstime_fits_ns(ts2))) {
+    gint64 ns1, ns2;
+
+    if (fdata1->ref_time != fdata2->ref_time)
+      return fdata1->ref_time ? -1 : 1;
+    ns1 = nstime_to_ns(ts1);
+    ns2 = nstime_to_ns(ts2);
+    if (ns1 != ns2)
+      return (ns1 < ns2) ? -1 : 1;
+    return COMPARE_FRAME_NUM();
+  }
+  return COMPARE_TS_REAL(*ts1, *ts2);
+}
 
 void
 frame_delta_abs_time(const struct epan_session *epan, const frame_data *fdata, guint32 prev_num, nstime_t *delta)
@@ -66,7 +88,7 @@ frame_data_time_delta_compare(const struct epan_session *epan, const frame_data
   frame_delta_abs_time(epan, fdata1, fdata1->num - 1, &del_cap_ts1);
   frame_delta_abs_time(epan, fdata2, fdata2->num - 1, &del_cap_ts2);
 
-  return COMPARE_TS_REAL(del_cap_ts1, del_cap_ts2);
+  return frame_data_compare_times(fdata1, fdata2, &del_cap_ts1, &del_cap_ts2);
 }
 
 static gint
@@ -77,7 +99,7 @@ frame_data_time_delta_rel_compare(const struct epan_session *epan, const frame_d
   frame_delta_abs_time(epan, fdata1, fdata1->frame_ref_num, &del_rel_ts1);
   frame_delta_abs_time(epan, fdata2, fdata2->frame_ref_num, &del_rel_ts2);
 
-  return COMPARE_TS_REAL(del_rel_ts1, del_rel_ts2);
+  return frame_data_compare_times(fdata1, fdata2, &del_rel_ts1, &del_rel_ts2);
 }
 
 static gint
@@ -88,7 +110,7 @@ frame_data_time_delta_dis_compare(const struct epan_session *epan, const frame_d
   frame_delta_abs_time(epan, fdata1, fdata1->prev_dis_num, &del_dis_ts1);
   frame_delta_abs_time(epan, fdata2, fdata2->prev_dis_num, &del_dis_ts2);
 
-  return COMPARE_TS_REAL(del_dis_ts1, del_dis_ts2);
+  return frame_data_compare_times(fdata1, fdata2, &del_dis_ts1, &del_dis_ts2);
 }
 
 gint
@@ -107,7 +129,7 @@ frame_data_compare(const struct epan_session *epan, const frame_data *fdata1, co
     case TS_UTC_WITH_YMD:
     case TS_UTC_WITH_YDOY:
     case TS_EPOCH:
-      return COMPARE_TS(abs_ts);
+      return frame_data_compare_times(fdata1, fdata2, &fdata1->abs_ts, &fdata2->abs_ts);
 
     case TS_RELATIVE:
       return frame_data_time_delta_rel_compare(epan, fdata1, fdata2);
@@ -129,7 +151,7 @@ frame_data_compare(const struct epan_session *epan, const frame_data *fdata1, co
   case COL_UTC_TIME:
   case COL_UTC_YMD_TIME:
   case COL_UTC_YDOY_TIME:
-    return COMPARE_TS(abs_ts);
+    return frame_data_compare_times(fdata1, fdata2, &fdata1->abs_ts, &fdata2->abs_ts);
 
   case COL_REL_TIME:
     return frame_data_time_delta_rel_compare(epan, fdata1, fdata2);
@@ -158,6 +180,8 @@ frame_data_init(frame_data *fdata, guint32 num, const wtap_rec *rec,
   fdata->num = num;
   fdata->file_off = offset;
   fdata->subnum = 0;
+  fdata->expert_groups = 0;
+  fdata->expert_severity = 0;
   fdata->passed_dfilter = 0;
   fdata->dependent_of_displayed = 0;
   fdata->encoding = PACKET_CHAR_ENC_CHAR_ASCII;
@@ -263,6 +287,10 @@ frame_data_reset(frame_data *fdata)
 {
   fdata->visited = 0;
   fdata->subnum = 0;
+  /* A redissection with different settings can raise different expert
+     events, so the summary is rebuilt from scratch. */
+  fdata->expert_groups = 0;
+  fdata->expert_severity = 0;
 
   if (fdata->pfd) {
     g_slist_free(fdata->pfd);
@@ -58,7 +58,33 @@ typedef enum {
 
    XXX - shuffle the fields to try to keep the most commonly-accessed
    fields within the first 16 or 32 bytes, so they all fit in a cache
-   line? */
+   line?
+
+   Packing this much below its current size is harder than it looks.
+   This structure is part of the dissector API: every dissector gets a
+   pointer to it as pinfo->fd, code all over the tree takes the address
+   of abs_ts and shift_offset as an nstime_t *, and the flag bits are
+   read and written directly.  Schemes that move fields into compressed
+   side storage (delta-encoded timestamps against a per-chunk base,
+   separate cold-field tables, and so on) therefore require accessor
+   indirection across every dissector and tap, not just changes here.
+   The cheap measures are already in place: the boolean state is kept
+   in bitfields sharing a word with subnum, and frame_data_sequence
+   packs these into power-of-2 chunks with no per-frame allocator
+   overhead.
+
+   Frame numbers are 32 bits, and that limit is likewise not local to
+   this header.  num flows into pinfo->num and from there into
+   conversation keys, reassembly keys, tap and export interfaces, and
+   frame references kept by dissectors; frame_data_sequence's radix
+   tree derives its depth from 32-bit frame numbers; the GUI packet
+   list addresses rows as ints, capping visible rows at 2^31 anyway.
+   Widening num is therefore a coordinated API break across all of
+   them, not a type change here - and at the current structure size, a
+   full 2^32-frame file would need hundreds of gigabytes of frame
+   metadata alone, so a useful 64-bit mode additionally requires the
+   on-disk/cold-storage work sketched above.  Until then, the file
+   readers stop cleanly at G_MAXUINT32 frames instead of wrapping. */
 struct _color_filter; /* Forward */
 DIAG_OFF_PEDANTIC
 typedef struct _frame_data {
@@ -88,6 +114,14 @@ typedef struct _frame_data {
   unsigned int has_user_comment : 1; /** 1 = user set (also deleted) comment for this packet */
   unsigned int need_colorize    : 1; /**< 1 = need to (re-)calculate packet color */
   unsigned int tsprec           : 4; /**< Time stamp precision -2^tsprec gives up to femtoseconds */
+  /* The expert summary below lives in what would otherwise be padding
+     before abs_ts on LP64 platforms, so it costs no space; see the
+     size note above before widening it.  It is filled in by
+     epan/expert.c as events fire, so after the sequential pass the
+     GUI can filter and step through frames by severity without
+     re-dissecting them. */
+  guint16      expert_groups;   /**< bitmap of expert groups seen; bit n set = group (n+1) << 24 */
+  guint8       expert_severity; /**< highest expert severity seen (PI_ERROR >> 20 etc.), 0 = none */
   nstime_t     abs_ts;       /**< Absolute timestamp */
   nstime_t     shift_offset; /**< How much the abs_tm of the frame is shifted */
   guint32      frame_ref_num; /**< Previous reference frame (0 if this is one) */
@@ -31,9 +31,21 @@
 
 struct _frame_data_sequence {
   guint32      count;           /* Total number of frames */
+  guint32      reserved;        /* Number of frames pre-sized for, or 0 */
+  gboolean     time_unsorted;   /* A frame was added with a timestamp earlier
+                                   than its predecessor's */
+  nstime_t     last_ts;         /* Timestamp of the most recently added frame */
   void        *ptree_root;      /* Pointer to the root node */
 };
 
+/*
+ * The number of frames the tree is currently shaped for; the level
+ * count is derived from this, not from the published frame count,
+ * because a pre-sized tree may be deeper than its contents so far.
+ */
+#define SEQUENCE_CAPACITY(fds) \
+        ((fds)->reserved > (fds)->count ? (fds)->reserved : (fds)->count)
+
 /*
  * For a given frame number, calculate the indices into a level 3
  * node, a level 2 node, a level 1 node, and a leaf node.
@@ -54,10 +66,120 @@ new_frame_data_sequence(void)
 
   fds = (frame_data_sequence *)g_malloc(sizeof *fds);
   fds->count = 0;
+  fds->reserved = 0;
+  fds->time_unsorted = FALSE;
+  nstime_set_zero(&fds->last_ts);
   fds->ptree_root = NULL;
   return fds;
 }
 
+/*
+ * Pre-size an empty frame_data_sequence for the given number of frames,
+ * allocating every interior node and leaf up front.  Once a sequence
+ * has been pre-sized, frame_data_sequence_store() can fill disjoint
+ * slots from multiple threads without any structural mutation or
+ * locking; frame_data_sequence_publish() then makes the filled prefix
+ * visible to readers.
+ */
+void
+frame_data_sequence_reserve(frame_data_sequence *fds, guint32 count)
+{
+  guint32 num_leaves, num_level1, num_level2;
+  guint32 i, j, k;
+
+  g_assert(fds->count == 0 && fds->ptree_root == NULL);
+
+  if (count == 0)
+    return;
+
+  num_leaves = ((count - 1) >> LOG2_NODES_PER_LEVEL) + 1;
+  if (num_leaves == 1) {
+    /* A 1-level tree; the single leaf is the root. */
+    fds->ptree_root = g_malloc0((sizeof (frame_data))*NODES_PER_LEVEL);
+  } else if (num_leaves <= NODES_PER_LEVEL) {
+    /* A 2-level tree. */
+    frame_data **level1 = (frame_data **)g_malloc0((sizeof *level1)*NODES_PER_LEVEL);
+    for (i = 0; i < num_leaves; i++)
+      level1[i] = (frame_data *)g_malloc0((sizeof (frame_data))*NODES_PER_LEVEL);
+    fds->ptree_root = level1;
+  } else if (num_leaves <= NODES_PER_LEVEL*NODES_PER_LEVEL) {
+    /* A 3-level tree. */
+    frame_data ***level2 = (frame_data ***)g_malloc0((sizeof *level2)*NODES_PER_LEVEL);
+    num_level1 = ((num_leaves - 1) >> LOG2_NODES_PER_LEVEL) + 1;
+    for (i = 0; i < num_level1; i++) {
+      frame_data **level1 = (frame_data **)g_malloc0((sizeof *level1)*NODES_PER_LEVEL);
+      for (j = 0; j < NODES_PER_LEVEL && (i << LOG2_NODES_PER_LEVEL) + j < num_leaves; j++)
+        level1[j] = (frame_data *)g_malloc0((sizeof (frame_data))*NODES_PER_LEVEL);
+      level2[i] = level1;
+    }
+    fds->ptree_root = level2;
+  } else {
+    /* A 4-level tree. */
+    frame_data ****level3 = (frame_data ****)g_malloc0((sizeof *level3)*NODES_PER_LEVEL);
+    num_level1 = ((num_leaves - 1) >> LOG2_NODES_PER_LEVEL) + 1;
+    num_level2 = ((num_level1 - 1) >> LOG2_NODES_PER_LEVEL) + 1;
+    for (i = 0; i < num_level2; i++) {
+      frame_data ***level2 = (frame_data ***)g_malloc0((sizeof *level2)*NODES_PER_LEVEL);
+      for (j = 0; j < NODES_PER_LEVEL && (i << LOG2_NODES_PER_LEVEL) + j < num_level1; j++) {
+        frame_data **level1 = (frame_data **)g_malloc0((sizeof *level1)*NODES_PER_LEVEL);
+        for (k = 0; k < NODES_PER_LEVEL &&
+             (((i << LOG2_NODES_PER_LEVEL) + j) << LOG2_NODES_PER_LEVEL) + k < num_leaves; k++)
+          level1[k] = (frame_data *)g_malloc0((sizeof (frame_data))*NODES_PER_LEVEL);
+        level2[j] = level1;
+      }
+      level3[i] = level2;
+    }
+    fds->ptree_root = level3;
+  }
+  fds->reserved = count;
+}
+
+/*
+ * Store a frame_data structure in slot framenum (1-origin) of a
+ * pre-sized frame_data_sequence.  No structural mutation takes place,
+ * so concurrent stores to distinct frame numbers are safe; the caller
+ * must not store past the reserved size or read the slot back before
+ * the corresponding publish.
+ */
+frame_data *
+frame_data_sequence_store(frame_data_sequence *fds, guint32 framenum,
+                          const frame_data *fdata)
+{
+  guint32     num = framenum - 1;
+  frame_data *leaf;
+
+  g_assert(framenum != 0 && framenum <= fds->reserved);
+
+  if (fds->reserved <= NODES_PER_LEVEL) {
+    leaf = (frame_data *)fds->ptree_root;
+  } else if (fds->reserved <= NODES_PER_LEVEL*NODES_PER_LEVEL) {
+    leaf = ((frame_data **)fds->ptree_root)[num >> LOG2_NODES_PER_LEVEL];
+  } else if (fds->reserved <= NODES_PER_LEVEL*NODES_PER_LEVEL*NODES_PER_LEVEL) {
+    frame_data **level1 =
+      ((frame_data ***)fds->ptree_root)[num >> (LOG2_NODES_PER_LEVEL+LOG2_NODES_PER_LEVEL)];
+    leaf = level1[LEVEL_1_INDEX(num)];
+  } else {
+    frame_data ***level2 = ((frame_data ****)fds->ptree_root)[LEVEL_3_INDEX(num)];
+    frame_data **level1 = level2[LEVEL_2_INDEX(num)];
+    leaf = level1[LEVEL_1_INDEX(num)];
+  }
+  leaf[LEAF_INDEX(num)] = *fdata;
+  return &leaf[LEAF_INDEX(num)];
+}
+
+/*
+ * Publish the first count frames of a pre-sized sequence, making them
+ * visible to frame_data_sequence_find().  This is a release store, so
+ * a reader that observes the new count also observes the stores that
+ * preceded it.
+ */
+void
+frame_data_sequence_publish(frame_data_sequence *fds, guint32 count)
+{
+  g_assert(count <= fds->reserved);
+  g_atomic_int_set(&fds->count, count);
+}
+
 /*
  * Add a new frame_data structure to a frame_data_sequence.
  */
@@ -70,6 +192,27 @@ frame_data_sequence_add(frame_data_sequence *fds, frame_data *fdata)
   frame_data ****level3;
   frame_data *node;
 
+  /*
+   * Keep track of whether the capture is in timestamp order, so that
+   * frame_data_sequence_find_time() knows whether it can binary-search.
+   */
+  if (fds->count > 0 && nstime_cmp(&fdata->abs_ts, &fds->last_ts) < 0)
+    fds->time_unsorted = TRUE;
+  fds->last_ts = fdata->abs_ts;
+
+  /*
+   * If the sequence was pre-sized and there are still reserved slots
+   * left, the next slot is already allocated; just store into it.
+   * Once the reserve is exhausted we fall through to the growing
+   * path below, which picks up exactly where a tree grown one frame
+   * at a time to this size would be.
+   */
+  if (fds->reserved > fds->count) {
+    node = frame_data_sequence_store(fds, fds->count + 1, fdata);
+    fds->count++;
+    return node;
+  }
+
   /*
    * The current value of fds->count is the index value for the new frame,
    * because the index value for a frame is the frame number - 1, and
@@ -195,18 +338,18 @@ frame_data_sequence_find(frame_data_sequence *fds, guint32 num)
     return NULL;
   }
 
-  if (fds->count <= NODES_PER_LEVEL) {
+  if (SEQUENCE_CAPACITY(fds) <= NODES_PER_LEVEL) {
     /* It's a 1-level tree. */
     leaf = (frame_data *)fds->ptree_root;
     return &leaf[num];
   }
-  if (fds->count <= NODES_PER_LEVEL*NODES_PER_LEVEL) {
+  if (SEQUENCE_CAPACITY(fds) <= NODES_PER_LEVEL*NODES_PER_LEVEL) {
     /* It's a 2-level tree. */
     level1 = (frame_data **)fds->ptree_root;
     leaf = level1[num >> LOG2_NODES_PER_LEVEL];
     return &leaf[LEAF_INDEX(num)];
   }
-  if (fds->count <= NODES_PER_LEVEL*NODES_PER_LEVEL*NODES_PER_LEVEL) {
+  if (SEQUENCE_CAPACITY(fds) <= NODES_PER_LEVEL*NODES_PER_LEVEL*NODES_PER_LEVEL) {
     /* It's a 3-level tree. */
     level2 = (frame_data ***)fds->ptree_root;
     level1 = level2[num >> (LOG2_NODES_PER_LEVEL+LOG2_NODES_PER_LEVEL)];
@@ -224,6 +367,53 @@ frame_data_sequence_find(frame_data_sequence *fds, guint32 num)
   return &leaf[LEAF_INDEX(num)];
 }
 
+/*
+ * Find the first frame whose absolute timestamp is not before the given
+ * time.  Returns the frame number, or 0 if every frame is earlier (or
+ * the sequence is empty).
+ *
+ * Frames are stored in capture file order, which is almost always
+ * non-decreasing capture time, so this is normally a binary search over
+ * the frame numbers; a capture with out-of-order timestamps (detected
+ * while the frames were added) falls back to a scan for the earliest
+ * timestamp at or after the given time.
+ */
+guint32
+frame_data_sequence_find_time(frame_data_sequence *fds, const nstime_t *ts)
+{
+  guint32 result = 0;
+  guint32 lo = 1, hi = fds->count;
+
+  if (fds->time_unsorted) {
+    guint32 num;
+    const frame_data *best = NULL;
+
+    for (num = 1; num <= fds->count; num++) {
+      frame_data *fdata = frame_data_sequence_find(fds, num);
+
+      if (nstime_cmp(&fdata->abs_ts, ts) >= 0 &&
+          (best == NULL || nstime_cmp(&fdata->abs_ts, &best->abs_ts) < 0)) {
+        best = fdata;
+        result = num;
+      }
+    }
+    return result;
+  }
+
+  while (lo <= hi) {
+    guint32 mid = lo + (hi - lo) / 2;
+    frame_data *fdata = frame_data_sequence_find(fds, mid);
+
+    if (nstime_cmp(&fdata->abs_ts, ts) < 0) {
+      lo = mid + 1;
+    } else {
+      result = mid;
+      hi = mid - 1;
+    }
+  }
+  return result;
+}
+
 /* recursively frees a frame_data radix level */
 static void
 free_frame_data_array(void *array, guint count, guint level, gboolean last)
@@ -279,19 +469,23 @@ free_frame_data_array(void *array, guint count, guint level, gboolean last)
 void
 free_frame_data_sequence(frame_data_sequence *fds)
 {
+  guint32 capacity = SEQUENCE_CAPACITY(fds);
   guint   levels;
 
-  /* calculate how many levels we have */
-  if (fds->count == 0) {
+  /* calculate how many levels we have; a pre-sized sequence may have
+   * allocated more of the tree than it has published frames, and those
+   * nodes (and any unused, zero-filled frame_data slots, which
+   * frame_data_destroy() handles harmlessly) must be freed too */
+  if (capacity == 0) {
     /* The tree is empty; there are no levels. */
     levels = 0;
-  } else if (fds->count <= NODES_PER_LEVEL) {
+  } else if (capacity <= NODES_PER_LEVEL) {
     /* It's a 1-level tree. */
     levels = 1;
-  } else if (fds->count <= NODES_PER_LEVEL*NODES_PER_LEVEL) {
+  } else if (capacity <= NODES_PER_LEVEL*NODES_PER_LEVEL) {
     /* It's a 2-level tree. */
     levels = 2;
-  } else if (fds->count <= NODES_PER_LEVEL*NODES_PER_LEVEL*NODES_PER_LEVEL) {
+  } else if (capacity <= NODES_PER_LEVEL*NODES_PER_LEVEL*NODES_PER_LEVEL) {
     /* It's a 3-level tree. */
     levels = 3;
   } else {
@@ -304,7 +498,7 @@ free_frame_data_sequence(frame_data_sequence *fds)
 
   /* call the recursive free function */
   if (levels > 0) {
-    free_frame_data_array(fds->ptree_root, fds->count, levels, TRUE);
+    free_frame_data_array(fds->ptree_root, capacity, levels, TRUE);
   }
 
   /* free the header struct */
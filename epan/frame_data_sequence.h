@@ -22,12 +22,45 @@ WS_DLL_PUBLIC frame_data_sequence *new_frame_data_sequence(void);
 WS_DLL_PUBLIC frame_data *frame_data_sequence_add(frame_data_sequence *fds,
     frame_data *fdata);
 
+/*
+ * Pre-size an empty frame_data_sequence for count frames, so that
+ * frame_data_sequence_store() can fill disjoint slots concurrently
+ * without locking or structural mutation.
+ */
+WS_DLL_PUBLIC void frame_data_sequence_reserve(frame_data_sequence *fds,
+    guint32 count);
+
+/*
+ * Store a frame_data in slot framenum (1-origin) of a pre-sized
+ * sequence.  Safe to call from multiple threads for distinct frame
+ * numbers.
+ */
+WS_DLL_PUBLIC frame_data *frame_data_sequence_store(frame_data_sequence *fds,
+    guint32 framenum, const frame_data *fdata);
+
+/*
+ * Make the first count stored frames visible to
+ * frame_data_sequence_find() (release semantics).
+ */
+WS_DLL_PUBLIC void frame_data_sequence_publish(frame_data_sequence *fds,
+    guint32 count);
+
 /*
  * Find the frame_data for the specified frame number.
  */
 WS_DLL_PUBLIC frame_data *frame_data_sequence_find(frame_data_sequence *fds,
     guint32 num);
 
+/*
+ * Find the number of the first frame whose absolute timestamp is not
+ * before the given time, or 0 if there is no such frame.  This is a
+ * binary search when the capture is in timestamp order (the common
+ * case) and a linear scan for the earliest matching timestamp when it
+ * is not.
+ */
+WS_DLL_PUBLIC guint32 frame_data_sequence_find_time(frame_data_sequence *fds,
+    const nstime_t *ts);
+
 /*
  * Free a frame_data_sequence and all the frame_data structures in it.
  */
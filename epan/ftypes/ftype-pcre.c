@@ -40,6 +40,17 @@ static gboolean
 val_from_string(fvalue_t *fv, const char *pattern, gchar **err_msg)
 {
     GError *regex_error = NULL;
+    /*
+     * G_REGEX_OPTIMIZE makes GRegex study the pattern - and, in GLib
+     * builds where PCRE has it, JIT-compile it - once here at dfilter
+     * compile time, so per-packet evaluation runs the compiled form.
+     * The match sites (cmp_matches in ftype-bytes.c, ftype-string.c and
+     * ftype-protocol.c) pass a null GMatchInfo, so no match state is
+     * allocated per evaluation either.  A literal-prefix pre-filter in
+     * front of the regex would need a second compiled artifact carried
+     * alongside value.re for a case PCRE's own first-byte/required-byte
+     * optimizations already cover.
+     */
     GRegexCompileFlags cflags = (GRegexCompileFlags)(G_REGEX_CASELESS | G_REGEX_OPTIMIZE);
 
     /*
@@ -76,22 +76,37 @@ in_cksum(const vec_t *vec, int veclen)
 			byte_swapped = 1;
 		}
 		/*
-		 * Unroll the loop to make overhead from
-		 * branches &c small.
+		 * Sum the bulk of the chunk 32 bits at a time into a
+		 * 64-bit accumulator, deferring all the carries to a
+		 * single fold at the end (RFC 1071, section 2(A)).
+		 * Summing aligned 32-bit words is equivalent to summing
+		 * their 16-bit halves, in either byte order, and halves
+		 * the number of loads and adds in the hot loop.
 		 */
-		while ((mlen -= 32) >= 0) {
-			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
-			sum += w[4]; sum += w[5]; sum += w[6]; sum += w[7];
-			sum += w[8]; sum += w[9]; sum += w[10]; sum += w[11];
-			sum += w[12]; sum += w[13]; sum += w[14]; sum += w[15];
-			w += 16;
-		}
-		mlen += 32;
-		while ((mlen -= 8) >= 0) {
-			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
-			w += 4;
+		if (mlen >= 8) {
+			guint64 sum64 = 0;
+			const guint32 *w32;
+
+			if (2 & (gintptr)w) {
+				sum += *w++;
+				mlen -= 2;
+			}
+			w32 = (const guint32 *)(const void *)w;
+			while ((mlen -= 8) >= 0) {
+				sum64 += w32[0];
+				sum64 += w32[1];
+				w32 += 2;
+			}
+			mlen += 8;
+			w = (const guint16 *)(const void *)w32;
+
+			/* Fold the deferred carries back to 16 bits. */
+			sum64 = (sum64 & 0xffffffff) + (sum64 >> 32);
+			sum64 = (sum64 & 0xffff) + (sum64 >> 16);
+			sum64 = (sum64 & 0xffff) + (sum64 >> 16);
+			sum64 = (sum64 & 0xffff) + (sum64 >> 16);
+			sum += (int)sum64;
 		}
-		mlen += 8;
 		if (mlen == 0 && byte_swapped == 0)
 			continue;
 		REDUCE;
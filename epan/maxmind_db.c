@@ -160,6 +160,7 @@ static gboolean mmdbr_pipe_valid(void) {
 }
 
 // Writing to mmdbr_pipe.stdin_fd can block. Do so in a separate thread.
+#define MAX_MMDB_REQUEST_LEN 8192
 static gpointer
 write_mmdbr_stdin_worker(gpointer sifd_data) {
     int stdin_fd = GPOINTER_TO_INT(sifd_data);
@@ -185,22 +186,58 @@ write_mmdbr_stdin_worker(gpointer sifd_data) {
             continue;
         }
 
-        MMDB_DEBUG("write %s ql %d", request, g_async_queue_length(mmdbr_request_q));
-        ssize_t req_status = ws_write(stdin_fd, request, (unsigned int)strlen(request));
+        // Coalesce whatever else is already queued into a single pipe
+        // write. The Endpoints dialog can post tens of thousands of
+        // addresses in one go, and a syscall per address adds up.
+        GString *request_buf = g_string_new(request);
+        g_free(request);
+        while (request_buf->len < MAX_MMDB_REQUEST_LEN &&
+               (request = (char *) g_async_queue_try_pop(mmdbr_request_q)) != NULL) {
+            if (strcmp(request, mmdbr_stop_sentinel) == 0) {
+                g_free(request);
+                break;
+            }
+            g_string_append(request_buf, request);
+            g_free(request);
+        }
+
+        MMDB_DEBUG("write %s ql %d", request_buf->str, g_async_queue_length(mmdbr_request_q));
+        ssize_t req_status = ws_write(stdin_fd, request_buf->str, (unsigned int)request_buf->len);
         if (req_status < 0) {
             MMDB_DEBUG("write error %s. exiting thread.", g_strerror(errno));
+            g_string_free(request_buf, TRUE);
             return NULL;
         }
-        g_free(request);
+        g_string_free(request_buf, TRUE);
     }
     return NULL;
 }
 
+// Reading one character per syscall is too slow when a large endpoint
+// list is being resolved. Pull whatever is available into a buffer and
+// hand it out a character at a time; the buffer is reset whenever the
+// read worker (re)starts so leftovers from a previous mmdbresolve
+// process can't leak into the new one.
+#define MMDB_READ_BUF_SIZE 2048
+static char mmdbr_read_buf[MMDB_READ_BUF_SIZE];
+static ssize_t mmdbr_read_buf_len;
+static ssize_t mmdbr_read_buf_pos;
+
 static ssize_t mmdbr_pipe_read_one(char *ch_p) {
     ssize_t status = -1;
+    if (mmdbr_read_buf_pos < mmdbr_read_buf_len) {
+        *ch_p = mmdbr_read_buf[mmdbr_read_buf_pos++];
+        return 1;
+    }
     g_rw_lock_reader_lock(&mmdbr_pipe_mtx);
     if (ws_pipe_valid(&mmdbr_pipe) && ws_pipe_data_available(mmdbr_pipe.stdout_fd)) {
-        status = ws_read(mmdbr_pipe.stdout_fd, ch_p, 1);
+        status = ws_read(mmdbr_pipe.stdout_fd, mmdbr_read_buf, MMDB_READ_BUF_SIZE);
+        if (status > 0) {
+            mmdbr_read_buf_len = status;
+            mmdbr_read_buf_pos = 1;
+            *ch_p = mmdbr_read_buf[0];
+            status = 1;
+        }
     }
     g_rw_lock_reader_unlock(&mmdbr_pipe_mtx);
     return status;
@@ -231,6 +268,9 @@ read_mmdbr_stdout_worker(gpointer data _U_) {
     GString *as_org = g_string_new("");
     char cur_addr[WS_INET6_ADDRSTRLEN] = { 0 };
 
+    mmdbr_read_buf_len = 0;
+    mmdbr_read_buf_pos = 0;
+
     MMDB_DEBUG("starting read worker");
 
     while (1) { // Start of line
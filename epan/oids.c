@@ -79,6 +79,18 @@ static const oid_value_type_t unknown_type =    { FT_BYTES,  BASE_NONE, BER_CLAS
 
 static oid_info_t oid_root = { 0, NULL, OID_KIND_UNKNOWN, NULL, &unknown_type, -2, NULL, NULL, NULL};
 
+/*
+ * Memo cache for oid_resolved_from_encoded(), keyed by the encoded OID
+ * bytes.  SNMP-heavy captures resolve the same few dozen OIDs over and
+ * over, and every resolution walks a wmem tree per subid and formats
+ * the result piecewise; memoizing turns the repeats into one hash
+ * lookup.  The cache is flushed whenever a name is registered, since a
+ * new name can change what any already-memoized OID resolves to.
+ */
+#define OID_RESOLVED_CACHE_MAX 4096
+
+static GHashTable* oid_resolved_cache = NULL;
+
 static void prepopulate_oids(void) {
 	if (!oid_root.children) {
 		char* debug_env = getenv("WIRESHARK_DEBUG_MIBS");
@@ -105,6 +117,10 @@ static oid_info_t* add_oid(const char* name, oid_kind_t kind, const oid_value_ty
 	oid_info_t* c = &oid_root;
 
 	prepopulate_oids();
+
+	if (oid_resolved_cache)
+		g_hash_table_remove_all(oid_resolved_cache);
+
 	oid_len--;
 
 	do {
@@ -852,6 +868,10 @@ void oids_cleanup(void) {
 #else
 	D(1,("libsmi disabled oid resolution not enabled"));
 #endif
+	if (oid_resolved_cache) {
+		g_hash_table_destroy(oid_resolved_cache);
+		oid_resolved_cache = NULL;
+	}
 }
 
 char* oid_subid2string(wmem_allocator_t *scope, guint32* subids, guint len) {
@@ -1065,10 +1085,34 @@ oid_info_t* oid_get_from_string(wmem_allocator_t *scope, const gchar *oid_str, g
 gchar *oid_resolved_from_encoded(wmem_allocator_t *scope, const guint8 *oid, gint oid_len) {
 	guint32 *subid_oid = NULL;
 	gchar * ret;
-	guint subid_oid_length = oid_encoded2subid(NULL, oid, oid_len, &subid_oid);
+	guint subid_oid_length;
+	GBytes *key;
+	const gchar *cached;
+
+	if (oid_resolved_cache && oid && oid_len > 0) {
+		key = g_bytes_new_static(oid, oid_len);
+		cached = (const gchar *)g_hash_table_lookup(oid_resolved_cache, key);
+		g_bytes_unref(key);
+		if (cached)
+			return wmem_strdup(scope, cached);
+	}
 
+	subid_oid_length = oid_encoded2subid(NULL, oid, oid_len, &subid_oid);
 	ret = oid_resolved(scope, subid_oid_length, subid_oid);
 	wmem_free(NULL, subid_oid);
+
+	if (oid && oid_len > 0) {
+		if (!oid_resolved_cache) {
+			oid_resolved_cache = g_hash_table_new_full(
+				(GHashFunc)g_bytes_hash, (GEqualFunc)g_bytes_equal,
+				(GDestroyNotify)g_bytes_unref, g_free);
+		} else if (g_hash_table_size(oid_resolved_cache) >= OID_RESOLVED_CACHE_MAX) {
+			g_hash_table_remove_all(oid_resolved_cache);
+		}
+		g_hash_table_insert(oid_resolved_cache,
+			g_bytes_new(oid, oid_len), g_strdup(ret));
+	}
+
 	return ret;
 }
 
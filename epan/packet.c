@@ -37,6 +37,7 @@
 #include <epan/expert.h>
 #include <epan/prefs.h>
 #include <epan/range.h>
+#include <epan/show_exception.h>
 
 #include <wsutil/str_util.h>
 #include <wsutil/ws_printf.h> /* ws_debug_printf */
@@ -79,6 +80,10 @@ struct data_source {
  *
  * "protocol" is the protocol associated with the dissector table. Used
  * for determining dependencies.
+ *
+ * "uint_index" is a direct-indexed mirror of "hash_table", maintained
+ * only for uint tables whose whole key space is small (FT_UINT8 and
+ * FT_UINT16); see find_uint_dtbl_entry().
  */
 struct dissector_table {
 	GHashTable	*hash_table;
@@ -89,6 +94,7 @@ struct dissector_table {
 	protocol_t	*protocol;
 	GHashFunc	hash_func;
 	gboolean	supports_decode_as;
+	dtbl_entry_t	**uint_index;
 };
 
 /*
@@ -129,6 +135,11 @@ static GSList *postseq_cleanup_routines;
 typedef struct {
 	dissector_handle_t handle;
 	GArray *wanted_hfids;
+	gboolean fields_only;	/* the only output is tree fields, so it
+				 * doesn't need to run unless something
+				 * wants those fields */
+	gboolean skipped;	/* it was skipped on an unvisited frame,
+				 * so its per-file state is incomplete */
 } postdissector;
 
 /*
@@ -190,6 +201,7 @@ destroy_dissector_table(void *data)
 
 	g_hash_table_destroy(table->hash_table);
 	g_slist_free(table->dissector_handles);
+	g_free(table->uint_index);
 	g_slice_free(struct dissector_table, data);
 }
 
@@ -237,6 +249,30 @@ static GSList *init_routines = NULL;
 static GSList *cleanup_routines = NULL;
 static GSList *shutdown_routines = NULL;
 
+/* State for the optional per-dissector profiling; see the comment
+ * above dissector_profiling_enable() below. */
+typedef struct {
+	guint64	calls;
+	guint64	time_us;	/* self wall-clock time, microseconds */
+	guint64	wmem_bytes;	/* self wmem allocations, all dissection scopes */
+} dissector_profile_entry_t;
+
+static gboolean    dissector_profiling = FALSE;
+static GHashTable *dissector_profile_table = NULL;	/* name -> entry */
+static guint64     dissector_profile_child_us;
+static guint64     dissector_profile_child_bytes;
+
+/* State for the optional per-packet dissection time budget
+ * (prefs.dissection_budget_ms).  The deadline is computed when we start
+ * dissecting a record; once it has passed, call_dissector_work() stops
+ * handing the packet to further subdissectors and the tree is truncated
+ * with an expert warning.  The budget is only checked between dissector
+ * calls, so a single dissector that loops internally is not preempted,
+ * but the pathological cases (deeply nested encapsulations, one tunnel
+ * layer per subdissector call) are. */
+static gint64      dissect_deadline_us;	/* 0 = no budget in effect */
+static gboolean    dissect_deadline_hit;
+
 typedef void (*void_func_t)(void);
 
 /* Initialize all data structures used for dissection. */
@@ -259,6 +295,8 @@ packet_cleanup(void)
 	g_hash_table_destroy(depend_dissector_lists);
 	g_hash_table_destroy(heur_dissector_lists);
 	g_hash_table_destroy(heuristic_short_names);
+	if (dissector_profile_table)
+		g_hash_table_destroy(dissector_profile_table);
 	g_slist_foreach(shutdown_routines, &call_routine, NULL);
 	g_slist_free(shutdown_routines);
 	if (postdissectors) {
@@ -332,6 +370,13 @@ init_dissection(void)
 
 	/* Initialize the expert infos */
 	expert_packet_init();
+
+	/* This is a full (re)dissection, so postdissectors that were
+	   skipped over get a fresh chance to build their state. */
+	if (postdissectors) {
+		for (guint i = 0; i < postdissectors->len; i++)
+			POSTDISSECTORS(i).skipped = FALSE;
+	}
 }
 
 void
@@ -475,6 +520,83 @@ final_registration_all_protocols(void)
 }
 
 
+/*
+ * Optional per-dissector profiling.
+ *
+ * When enabled, call_dissector_work() attributes wall-clock time,
+ * invocation counts and wmem allocation bytes to each dissector by name.
+ * Time and bytes spent in subdissectors are subtracted from the caller,
+ * so the figures are self-cost, not inclusive cost.  When disabled (the
+ * default) the only cost is one branch per dissector call.
+ *
+ * The child accumulators are scratch state for the self-cost
+ * computation; an exception thrown past call_dissector_work()'s
+ * epilogue can leave them stale, so they are reset at the top of each
+ * record's dissection.
+ */
+void
+dissector_profiling_enable(gboolean enable)
+{
+	dissector_profiling = enable;
+}
+
+static void
+dissector_profile_record(const char *name, guint64 self_us, guint64 self_bytes)
+{
+	dissector_profile_entry_t *entry;
+
+	if (dissector_profile_table == NULL) {
+		dissector_profile_table = g_hash_table_new_full(g_str_hash,
+		    g_str_equal, NULL, g_free);
+	}
+
+	entry = (dissector_profile_entry_t *)g_hash_table_lookup(
+	    dissector_profile_table, name);
+	if (entry == NULL) {
+		entry = g_new0(dissector_profile_entry_t, 1);
+		g_hash_table_insert(dissector_profile_table,
+		    (gpointer)name, entry);
+	}
+	entry->calls++;
+	entry->time_us += self_us;
+	entry->wmem_bytes += self_bytes;
+}
+
+/* Lifetime bytes requested from the scopes a dissector can allocate
+ * from; the difference across a dissector call is what it allocated. */
+static guint64
+dissector_profile_wmem_total(packet_info *pinfo)
+{
+	gsize total, sum;
+
+	wmem_allocator_get_stats(wmem_packet_scope(), NULL, &total, NULL);
+	sum = total;
+	wmem_allocator_get_stats(wmem_file_scope(), NULL, &total, NULL);
+	sum += total;
+	wmem_allocator_get_stats(pinfo->pool, NULL, &total, NULL);
+	sum += total;
+	return sum;
+}
+
+void
+dissector_profiling_foreach(dissector_profile_cb cb, void *user_data)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+
+	if (dissector_profile_table == NULL)
+		return;
+
+	g_hash_table_iter_init(&iter, dissector_profile_table);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		dissector_profile_entry_t *entry =
+		    (dissector_profile_entry_t *)value;
+
+		cb((const char *)key, entry->calls, entry->time_us,
+		    entry->wmem_bytes, user_data);
+	}
+}
+
 /* Creates the top-most tvbuff and calls dissect_frame() */
 void
 dissect_record(epan_dissect_t *edt, int file_type_subtype,
@@ -569,6 +691,18 @@ dissect_record(epan_dissect_t *edt, int file_type_subtype,
 	frame_dissector_data.file_type_subtype = file_type_subtype;
 	frame_dissector_data.color_edt = edt; /* Used strictly for "coloring rules" */
 
+	if (dissector_profiling) {
+		dissector_profile_child_us = 0;
+		dissector_profile_child_bytes = 0;
+	}
+
+	if (prefs.dissection_budget_ms != 0)
+		dissect_deadline_us = g_get_monotonic_time() +
+		    (gint64)prefs.dissection_budget_ms * 1000;
+	else
+		dissect_deadline_us = 0;
+	dissect_deadline_hit = FALSE;
+
 	TRY {
 		/* Add this tvbuffer into the data_src list */
 		add_new_data_source(&edt->pi, edt->tvb, record_type);
@@ -626,6 +760,17 @@ dissect_file(epan_dissect_t *edt, wtap_rec *rec,
 
 	frame_delta_abs_time(edt->session, fd, fd->frame_ref_num, &edt->pi.rel_ts);
 
+	if (dissector_profiling) {
+		dissector_profile_child_us = 0;
+		dissector_profile_child_bytes = 0;
+	}
+
+	if (prefs.dissection_budget_ms != 0)
+		dissect_deadline_us = g_get_monotonic_time() +
+		    (gint64)prefs.dissection_budget_ms * 1000;
+	else
+		dissect_deadline_us = 0;
+	dissect_deadline_hit = FALSE;
 
 	TRY {
 		/* pkt comment use first user, later from rec */
@@ -669,6 +814,34 @@ enum dissector_e {
 
 /*
  * A dissector handle.
+ *
+ * A "this dissector is a pure function of the packet bytes" flag has
+ * been proposed here more than once, as the key to caching dissection
+ * results across refilter/recolor/reopen instead of redissecting.
+ * It doesn't work in this engine, for reasons worth recording:
+ *
+ *   - Purity isn't per-handle, it's per-stack.  A frame's tree is the
+ *     product of every dissector on the encapsulation path plus the
+ *     conversation and reassembly state they consulted, so one stateful
+ *     layer (TCP, anything with conversation_t) taints nearly every
+ *     frame in a typical capture.
+ *
+ *   - The tree isn't a context-free result.  Fields are only stored if
+ *     they were "interesting" when the frame was dissected (see
+ *     epan_dissect_prime_with_dfilter()), so a tree cached during one
+ *     filter pass is usually missing exactly the fields the next filter
+ *     needs; a cache keyed by frame number and prefs generation would
+ *     still miss whenever the priming set changes, which is precisely
+ *     the refilter case the cache is meant to serve.
+ *
+ *   - Tree nodes live in the epan_dissect_t's wmem pool and are freed
+ *     as a pool.  Retaining them per-frame means a pool per frame and,
+ *     for the "pure majority", the whole capture resident as proto
+ *     trees -- the memory model frame_data was designed to avoid.
+ *
+ * The cheap per-frame artifacts that *are* safe to keep are already
+ * kept: column text, color verdicts and frame flags are cached by the
+ * packet list, and fd->visited spares first-pass-only work.
  */
 struct dissector_handle {
 	const char	*name;		/* dissector name */
@@ -746,6 +919,8 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 	int          len;
 	guint        saved_layers_len = 0;
 	int          saved_tree_count = tree ? tree->tree_data->count : 0;
+	guint64      prof_start_us = 0, prof_start_bytes = 0;
+	guint64      prof_saved_child_us = 0, prof_saved_child_bytes = 0;
 
 	if (handle->protocol != NULL &&
 	    !proto_is_protocol_enabled(handle->protocol)) {
@@ -755,6 +930,30 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 		return 0;
 	}
 
+	if (dissect_deadline_us != 0 &&
+	    g_get_monotonic_time() >= dissect_deadline_us) {
+		/*
+		 * This packet has used up its dissection budget; don't
+		 * hand what's left to any more subdissectors.  Claim the
+		 * data as consumed so callers don't try other dissectors.
+		 */
+		if (!dissect_deadline_hit) {
+			dissect_deadline_hit = TRUE;
+			show_dissection_budget_exceeded(tvb, pinfo, tree,
+			    prefs.dissection_budget_ms);
+		}
+		return tvb_captured_length(tvb);
+	}
+
+	if (dissector_profiling) {
+		prof_saved_child_us = dissector_profile_child_us;
+		prof_saved_child_bytes = dissector_profile_child_bytes;
+		dissector_profile_child_us = 0;
+		dissector_profile_child_bytes = 0;
+		prof_start_bytes = dissector_profile_wmem_total(pinfo);
+		prof_start_us = (guint64)g_get_monotonic_time();
+	}
+
 	saved_proto = pinfo->current_proto;
 	saved_can_desegment = pinfo->can_desegment;
 	saved_layers_len = wmem_list_count(pinfo->layers);
@@ -820,6 +1019,30 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 	}
 	pinfo->current_proto = saved_proto;
 	pinfo->can_desegment = saved_can_desegment;
+
+	if (dissector_profiling) {
+		guint64 elapsed_us, elapsed_bytes;
+		const char *prof_name;
+
+		elapsed_us = (guint64)g_get_monotonic_time() - prof_start_us;
+		elapsed_bytes = dissector_profile_wmem_total(pinfo) -
+		    prof_start_bytes;
+
+		prof_name = handle->name;
+		if (prof_name == NULL && handle->protocol != NULL)
+			prof_name = proto_get_protocol_short_name(handle->protocol);
+		if (prof_name != NULL) {
+			dissector_profile_record(prof_name,
+			    elapsed_us - dissector_profile_child_us,
+			    elapsed_bytes - dissector_profile_child_bytes);
+		}
+
+		/* Credit our inclusive cost to the caller's child total. */
+		dissector_profile_child_us = prof_saved_child_us + elapsed_us;
+		dissector_profile_child_bytes = prof_saved_child_bytes +
+		    elapsed_bytes;
+	}
+
 	return len;
 }
 
@@ -955,10 +1178,79 @@ find_dissector_table(const char *name)
 	return dissector_table;
 }
 
+/*
+ * For FT_UINT8 and FT_UINT16 tables the whole key space is small enough
+ * to mirror the hash table into a direct-indexed array, so that looking
+ * up a protocol or port number costs a single load rather than a hash
+ * probe.  Those lookups happen several times per packet (ethertype,
+ * ip.proto, tcp.port, udp.port, ...), making this one of the hottest
+ * paths in dissection.
+ *
+ * The hash table remains the authoritative copy - all the iteration and
+ * "Decode As" code works from it - and the array is just a cache.
+ * Single-entry insertions and removals are mirrored into the array in
+ * place; bulk removals throw it away, and it is rebuilt lazily on the
+ * next lookup.  Entries whose current dissector is changed in place
+ * need neither, as the array holds the same dtbl_entry_t pointers as
+ * the hash table.
+ *
+ * FT_UINT24 and FT_UINT32 tables have key spaces too large to index
+ * directly, so they stay on the hash table, as do all non-uint tables.
+ */
+static guint
+uint_index_size(dissector_table_t sub_dissectors)
+{
+	switch (sub_dissectors->type) {
+
+	case FT_UINT8:
+		return 1U << 8;
+
+	case FT_UINT16:
+		return 1U << 16;
+
+	default:
+		return 0;
+	}
+}
+
+static void
+uint_index_fill(gpointer key, gpointer value, gpointer user_data)
+{
+	dissector_table_t sub_dissectors = (dissector_table_t)user_data;
+	guint32 pattern = GPOINTER_TO_UINT(key);
+
+	if (pattern < uint_index_size(sub_dissectors))
+		sub_dissectors->uint_index[pattern] = (dtbl_entry_t *)value;
+}
+
+static void
+uint_index_invalidate(dissector_table_t sub_dissectors)
+{
+	g_free(sub_dissectors->uint_index);
+	sub_dissectors->uint_index = NULL;
+}
+
+/*
+ * Mirror a single-entry insertion or removal into the index instead of
+ * throwing the whole index away.  "Decode As" applies its rules one
+ * pattern at a time, and a profile can carry hundreds of them; keeping
+ * the index alive avoids a full hash-walk rebuild after every rule.
+ */
+static void
+uint_index_set(dissector_table_t sub_dissectors, const guint32 pattern,
+	       dtbl_entry_t *dtbl_entry)
+{
+	if (sub_dissectors->uint_index != NULL &&
+	    pattern < uint_index_size(sub_dissectors))
+		sub_dissectors->uint_index[pattern] = dtbl_entry;
+}
+
 /* Find an entry in a uint dissector table. */
 static dtbl_entry_t *
 find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
 {
+	guint size;
+
 	switch (sub_dissectors->type) {
 
 	case FT_UINT8:
@@ -982,8 +1274,20 @@ find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
 	}
 
 	/*
-	 * Find the entry.
+	 * Find the entry, through the direct index if the key space
+	 * is small enough to have one.
 	 */
+	size = uint_index_size(sub_dissectors);
+	if (size != 0) {
+		if (sub_dissectors->uint_index == NULL) {
+			sub_dissectors->uint_index = g_new0(dtbl_entry_t *, size);
+			g_hash_table_foreach(sub_dissectors->hash_table,
+					     uint_index_fill, sub_dissectors);
+		}
+		if (pattern >= size)
+			return NULL;
+		return sub_dissectors->uint_index[pattern];
+	}
 	return (dtbl_entry_t *)g_hash_table_lookup(sub_dissectors->hash_table,
 				   GUINT_TO_POINTER(pattern));
 }
@@ -1067,6 +1371,7 @@ dissector_add_uint(const char *name, const guint32 pattern, dissector_handle_t h
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_index_set(sub_dissectors, pattern, dtbl_entry);
 
 	/*
 	 * Now, if this table supports "Decode As", add this handle
@@ -1228,6 +1533,7 @@ dissector_delete_uint(const char *name, const guint32 pattern,
 		 */
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
+		uint_index_set(sub_dissectors, pattern, NULL);
 	}
 }
 
@@ -1269,6 +1575,7 @@ void dissector_delete_all(const char *name, dissector_handle_t handle)
 	g_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove (sub_dissectors->hash_table, dissector_delete_all_check, handle);
+	uint_index_invalidate(sub_dissectors);
 }
 
 static void
@@ -1278,6 +1585,7 @@ dissector_delete_from_table(gpointer key _U_, gpointer value, gpointer user_data
 	g_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove(sub_dissectors->hash_table, dissector_delete_all_check, user_data);
+	uint_index_invalidate(sub_dissectors);
 	sub_dissectors->dissector_handles = g_slist_remove(sub_dissectors->dissector_handles, user_data);
 }
 
@@ -1323,6 +1631,7 @@ dissector_change_uint(const char *name, const guint32 pattern, dissector_handle_
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_index_set(sub_dissectors, pattern, dtbl_entry);
 }
 
 /* Reset an entry in a uint dissector table to its initial value. */
@@ -1351,6 +1660,7 @@ dissector_reset_uint(const char *name, const guint32 pattern)
 	} else {
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
+		uint_index_set(sub_dissectors, pattern, NULL);
 	}
 }
 
@@ -2488,6 +2798,7 @@ register_dissector_table(const char *name, const char *ui_name, const int proto,
 	sub_dissectors->param   = param;
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->uint_index = NULL;
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2517,6 +2828,7 @@ dissector_table_t register_custom_dissector_table(const char *name,
 	sub_dissectors->param   = BASE_NONE;
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->uint_index = NULL;
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2840,6 +3152,88 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 	return status;
 }
 
+gboolean
+dissector_try_heuristic_entry(heur_dtbl_entry_t *hdtbl_entry, tvbuff_t *tvb,
+			packet_info *pinfo, proto_tree *tree, void *data)
+{
+	gboolean           status;
+	const char        *saved_curr_proto;
+	const char        *saved_heur_list_name;
+	guint16            saved_can_desegment;
+	guint              saved_layers_len = 0;
+	int                len;
+	int                saved_tree_count = tree ? tree->tree_data->count : 0;
+
+	/* This does for one entry what dissector_try_heuristic() does for the
+	   whole list; see the comments there for the can_desegment dance. */
+	saved_can_desegment        = pinfo->can_desegment;
+	pinfo->saved_can_desegment = saved_can_desegment;
+	pinfo->can_desegment       = saved_can_desegment-(saved_can_desegment>0);
+
+	status      = FALSE;
+	saved_curr_proto = pinfo->current_proto;
+	saved_heur_list_name = pinfo->heur_list_name;
+
+	saved_layers_len = wmem_list_count(pinfo->layers);
+
+	DISSECTOR_ASSERT(saved_layers_len < PINFO_LAYER_MAX_RECURSION_DEPTH);
+
+	if (hdtbl_entry->protocol != NULL &&
+		(!proto_is_protocol_enabled(hdtbl_entry->protocol)||(hdtbl_entry->enabled==FALSE))) {
+		/*
+		 * No - don't try this dissector.
+		 */
+		pinfo->can_desegment = saved_can_desegment;
+		return FALSE;
+	}
+
+	if (hdtbl_entry->protocol != NULL) {
+		/* do NOT change this behavior - wslua uses the protocol short name set here in order
+		   to determine which Lua-based heurisitc dissector to call */
+		pinfo->current_proto =
+			proto_get_protocol_short_name(hdtbl_entry->protocol);
+
+		/*
+		 * Add the protocol name to the layers; we'll remove it
+		 * if the dissector fails.
+		 */
+		pinfo->curr_layer_num++;
+		wmem_list_append(pinfo->layers, GINT_TO_POINTER(proto_get_id(hdtbl_entry->protocol)));
+	}
+
+	pinfo->heur_list_name = hdtbl_entry->list_name;
+
+	len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+	if (hdtbl_entry->protocol != NULL &&
+		(len == 0 || (tree && saved_tree_count == tree->tree_data->count))) {
+		/*
+		 * We added a protocol layer above. The dissector
+		 * didn't accept the packet or it didn't add any
+		 * items to the tree so remove it from the list.
+		 */
+		while (wmem_list_count(pinfo->layers) > saved_layers_len) {
+			if (len == 0) {
+				/*
+				 * Only reduce the layer number if the dissector
+				 * rejected the data. Since tree can be NULL on
+				 * the first pass, we cannot check it or it will
+				 * break dissectors that rely on a stable value.
+				 */
+				pinfo->curr_layer_num--;
+			}
+			wmem_list_remove_frame(pinfo->layers, wmem_list_tail(pinfo->layers));
+		}
+	}
+	if (len) {
+		status = TRUE;
+	}
+
+	pinfo->current_proto = saved_curr_proto;
+	pinfo->heur_list_name = saved_heur_list_name;
+	pinfo->can_desegment = saved_can_desegment;
+	return status;
+}
+
 typedef struct heur_dissector_foreach_info {
 	gpointer      caller_data;
 	DATFunc_heur  caller_func;
@@ -3517,6 +3911,8 @@ register_postdissector(dissector_handle_t handle)
 
 	p.handle = handle;
 	p.wanted_hfids = NULL;
+	p.fields_only = FALSE;
+	p.skipped = FALSE;
 	postdissectors = g_array_append_val(postdissectors, p);
 }
 
@@ -3538,6 +3934,21 @@ set_postdissector_wanted_hfids(dissector_handle_t handle, GArray *wanted_hfids)
 	}
 }
 
+void
+set_postdissector_fields_only(dissector_handle_t handle, gboolean fields_only)
+{
+	guint i;
+
+	if (!postdissectors) return;
+
+	for (i = 0; i < postdissectors->len; i++) {
+		if (POSTDISSECTORS(i).handle == handle) {
+			POSTDISSECTORS(i).fields_only = fields_only;
+			break;
+		}
+	}
+}
+
 void
 deregister_postdissector(dissector_handle_t handle)
 {
@@ -3580,11 +3991,54 @@ call_all_postdissectors(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree)
 	guint i;
 
 	for (i = 0; i < postdissectors->len; i++) {
+		/*
+		 * A postdissector whose only output is its tree fields
+		 * doesn't need to run unless something - the display
+		 * filter, a custom column, a tap filter - actually wants
+		 * those fields, or the tree is visible.  Remember when we
+		 * skip it on the first pass, though: its per-file state is
+		 * then missing this frame, and a filter that wants its
+		 * fields later on has to trigger a full redissection
+		 * rather than a rescan.  See
+		 * postdissectors_skipped_for_hfids().
+		 */
+		if (POSTDISSECTORS(i).fields_only &&
+		    POSTDISSECTORS(i).handle->protocol != NULL &&
+		    !proto_field_is_referenced(tree,
+			proto_get_id(POSTDISSECTORS(i).handle->protocol))) {
+			if (!PINFO_FD_VISITED(pinfo))
+				POSTDISSECTORS(i).skipped = TRUE;
+			continue;
+		}
 		call_dissector_only(POSTDISSECTORS(i).handle,
 				    tvb, pinfo, tree, NULL);
 	}
 }
 
+gboolean
+postdissectors_skipped_for_hfids(const int *hfids, guint num_hfids)
+{
+	guint i, j;
+	header_field_info *hfinfo;
+	int proto_id;
+
+	if (!postdissectors) return FALSE;
+
+	for (j = 0; j < num_hfids; j++) {
+		hfinfo = proto_registrar_get_nth(hfids[j]);
+		if (hfinfo == NULL)
+			continue;
+		proto_id = (hfinfo->parent == -1) ? hfids[j] : hfinfo->parent;
+		for (i = 0; i < postdissectors->len; i++) {
+			if (POSTDISSECTORS(i).skipped &&
+			    POSTDISSECTORS(i).handle->protocol != NULL &&
+			    proto_get_id(POSTDISSECTORS(i).handle->protocol) == proto_id)
+				return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 gboolean
 postdissectors_want_hfids(void)
 {
@@ -495,6 +495,21 @@ WS_DLL_PUBLIC gboolean has_heur_dissector_list(const gchar *name);
 WS_DLL_PUBLIC gboolean dissector_try_heuristic(heur_dissector_list_t sub_dissectors,
     tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t **hdtbl_entry, void *data);
 
+/** Try a single heuristic dissector table entry, e.g. one which accepted an
+ *  earlier packet of the same conversation, before falling back to trying
+ *  the whole list.
+ *  Call this while the parent dissector is running.
+ *
+ * @param hdtbl_entry the single table entry to try
+ * @param tvb the tvbuff with the (remaining) packet data
+ * @param pinfo the packet info of this packet (additional info)
+ * @param tree the protocol tree to be build or NULL
+ * @param data parameter to pass to subdissector
+ * @return TRUE if the packet was recognized by the sub-dissector (stop dissection here)
+ */
+WS_DLL_PUBLIC gboolean dissector_try_heuristic_entry(heur_dtbl_entry_t *hdtbl_entry,
+    tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data);
+
 /** Find a heuristic dissector table by table name.
  *
  * @param name name of the dissector table
@@ -603,6 +618,30 @@ WS_DLL_PUBLIC int call_data_dissector(tvbuff_t *tvb, packet_info *pinfo, proto_t
 WS_DLL_PUBLIC int call_dissector_only(dissector_handle_t handle, tvbuff_t *tvb,
     packet_info *pinfo, proto_tree *tree, void *data);
 
+/** Turn per-dissector profiling on or off.
+ *
+ * While enabled, every dissector call is attributed wall-clock time,
+ * an invocation count and wmem allocation bytes, keyed by dissector
+ * name.  Time and memory spent in subdissectors are credited to the
+ * subdissector only, so the totals are self-cost.  Disabled by
+ * default; when off, the only cost is one branch per dissector call.
+ *
+ *   @param enable TRUE to start recording, FALSE to stop.
+ */
+WS_DLL_PUBLIC void dissector_profiling_enable(gboolean enable);
+
+typedef void (*dissector_profile_cb)(const char *name, guint64 calls,
+    guint64 time_us, guint64 wmem_bytes, void *user_data);
+
+/** Hand each profiled dissector's totals to a callback, in no
+ * particular order.  Does nothing if profiling never recorded anything.
+ *
+ *   @param cb Called once per dissector that has been profiled.
+ *   @param user_data Passed through to the callback.
+ */
+WS_DLL_PUBLIC void dissector_profiling_foreach(dissector_profile_cb cb,
+    void *user_data);
+
 /**
  *   @param heur_dtbl_entry The heur_dtbl_entry of the dissector to call.
  *   @param  tvb The buffer to dissect.
@@ -811,6 +850,16 @@ WS_DLL_PUBLIC void register_postdissector(dissector_handle_t handle);
 WS_DLL_PUBLIC void set_postdissector_wanted_hfids(dissector_handle_t handle,
     GArray *wanted_hfids);
 
+/*
+ * Declare that the postdissector's only output is its protocol tree
+ * fields - no column text, no taps, no pinfo changes.  Such a
+ * postdissector is only called when those fields are actually wanted
+ * (by the display filter, a custom column or a tap filter) or the
+ * protocol tree is visible, and is skipped for every other packet.
+ */
+WS_DLL_PUBLIC void set_postdissector_fields_only(dissector_handle_t handle,
+    gboolean fields_only);
+
 /*
  * Deregister a postdissector.  Not for use in (post)dissectors or
  * applications; only to be used by libwireshark itself.
@@ -831,6 +880,16 @@ extern gboolean have_postdissector(void);
  */
 extern void call_all_postdissectors(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree);
 
+/*
+ * Return TRUE if any of the given hfids (or their parent protocols)
+ * belong to a fields-only postdissector that has been skipped since
+ * the last full dissection.  If so, the per-file state of that
+ * postdissector is incomplete and a filter, column or tap wanting
+ * those fields needs a full redissection, not just a rescan.
+ */
+WS_DLL_PUBLIC gboolean postdissectors_skipped_for_hfids(const int *hfids,
+    guint num_hfids);
+
 /*
  * Return TRUE if at least one postdissector needs at least one hfid,
  * FALSE otherwise.
@@ -935,6 +935,33 @@ prefs_apply_all(void)
     wmem_tree_foreach(prefs_modules, call_apply_cb, NULL);
 }
 
+static gboolean
+collect_changed_flags_cb(const void *key _U_, void *value, void *data)
+{
+    module_t *module = (module_t *)value;
+    unsigned int *flags = (unsigned int *)data;
+
+    if (!module->obsolete)
+        *flags |= module->prefs_changed_flags;
+    if (module->submodules)
+        wmem_tree_foreach(module->submodules, collect_changed_flags_cb, data);
+    return FALSE;
+}
+
+/*
+ * Return the union of the changed flags of all modules, without
+ * clearing them; the flags accumulate until prefs_apply_all() or
+ * prefs_apply() hands them to the modules' apply callbacks.
+ */
+unsigned int
+prefs_modules_changed_flags(void)
+{
+    unsigned int flags = 0;
+
+    wmem_tree_foreach(prefs_modules, collect_changed_flags_cb, &flags);
+    return flags;
+}
+
 /*
  * Call the "apply" callback function for a specific module if any of
  * its preferences have changed, and then clear the flag saying its
@@ -3675,6 +3702,16 @@ prefs_register_modules(void)
                                    "Currently only ICMP and ICMPv6 use this preference to add VLAN ID to conversation tracking",
                                    &prefs.strict_conversation_tracking_heuristics);
 
+    prefs_register_uint_preference(protocols_module, "dissection_budget",
+                                   "Per-packet dissection budget (milliseconds)",
+                                   "Stop dissecting a packet once it has taken this many milliseconds, "
+                                   "truncating its protocol tree with an expert warning. "
+                                   "This bounds the latency caused by pathological packets "
+                                   "(deeply nested encapsulations, decompression bombs). "
+                                   "0 means no limit.",
+                                   10,
+                                   &prefs.dissection_budget_ms);
+
     /* Obsolete preferences
      * These "modules" were reorganized/renamed to correspond to their GUI
      * configuration screen within the preferences dialog
@@ -4185,6 +4222,7 @@ pre_init_prefs(void)
     prefs.st_sort_showfullname = FALSE;
     prefs.display_hidden_proto_items = FALSE;
     prefs.display_byte_fields_with_spaces = FALSE;
+    prefs.dissection_budget_ms = 0;
 }
 
 /*
@@ -4264,8 +4302,45 @@ reset_pref_cb(gpointer data, gpointer user_data)
 {
     pref_t *pref = (pref_t *) data;
     module_t *module = (module_t *)user_data;
+    int type;
+    gboolean changed;
+
+    if (!pref) return;
+
+    type = pref->type;
+    if (IS_PREF_OBSOLETE(type))
+        return;
+
+    /*
+     * Record whether the reset actually changes the value, so that the
+     * preference apply callback is invoked for it and so that callers
+     * of prefs_modules_changed_flags() can tell whether anything with
+     * a given effect - dissection, say - changed.
+     */
+    switch (type) {
+
+    case PREF_UINT:
+    case PREF_DECODE_AS_UINT:
+        changed = (*pref->varp.uint != pref->default_val.uint);
+        break;
 
-    if (pref && (pref->type == PREF_RANGE || pref->type == PREF_DECODE_AS_RANGE)) {
+    case PREF_BOOL:
+        changed = (*pref->varp.boolp != pref->default_val.boolval);
+        break;
+
+    case PREF_ENUM:
+        changed = (*pref->varp.enump != pref->default_val.enumval);
+        break;
+
+    case PREF_STRING:
+    case PREF_SAVE_FILENAME:
+    case PREF_OPEN_FILENAME:
+    case PREF_DIRNAME:
+        changed = (g_strcmp0(*pref->varp.string, pref->default_val.string) != 0);
+        break;
+
+    case PREF_RANGE:
+    case PREF_DECODE_AS_RANGE:
         /*
          * Some dissectors expect the range (returned via prefs_get_range_value)
          * to remain valid if it has not changed. If it did change, then we
@@ -4277,8 +4352,26 @@ reset_pref_cb(gpointer data, gpointer user_data)
             /* Optimization: do not invoke apply callback if nothing changed. */
             return;
         }
-        module->prefs_changed_flags |= prefs_get_effect_flags(pref);
+        changed = TRUE;
+        break;
+
+    case PREF_COLOR:
+        changed = (pref->varp.colorp->red != pref->default_val.color.red ||
+                   pref->varp.colorp->green != pref->default_val.color.green ||
+                   pref->varp.colorp->blue != pref->default_val.color.blue);
+        break;
+
+    case PREF_CUSTOM:
+        /* There's no generic way to compare, so assume it changes. */
+        changed = TRUE;
+        break;
+
+    default:
+        changed = FALSE;
+        break;
     }
+    if (changed)
+        module->prefs_changed_flags |= prefs_get_effect_flags(pref);
     reset_pref(pref);
 }
 
@@ -4312,14 +4405,17 @@ prefs_reset(void)
     oids_cleanup();
 
     /*
-     * Reset the non-dissector preferences.
+     * Reset the non-UAT dissector preferences, noting which values
+     * actually change.  This has to happen before init_prefs()
+     * overwrites the variables the non-dissector modules point at, or
+     * those changes would go unrecorded.
      */
-    init_prefs();
+    wmem_tree_foreach(prefs_modules, reset_module_prefs, NULL);
 
     /*
-     * Reset the non-UAT dissector preferences.
+     * Reset the non-dissector preferences.
      */
-    wmem_tree_foreach(prefs_modules, reset_module_prefs, NULL);
+    init_prefs();
 }
 
 /* Read the preferences file, fill in "prefs", and return a pointer to it.
@@ -203,6 +203,7 @@ typedef struct _e_prefs {
   gboolean     enable_incomplete_dissectors_check;
   gboolean     incomplete_dissectors_check_debug;
   gboolean     strict_conversation_tracking_heuristics;
+  guint        dissection_budget_ms; /* per-packet dissection time budget, 0 = unlimited */
   gboolean     filter_expressions_old;  /* TRUE if old filter expressions preferences were loaded. */
   gboolean     gui_update_enabled;
   software_update_channel_e gui_update_channel;
@@ -350,6 +351,15 @@ WS_DLL_PUBLIC guint prefs_modules_foreach_submodules(module_t *module, module_cb
  */
 WS_DLL_PUBLIC void prefs_apply_all(void);
 
+/*
+ * Return the union of the changed flags (PREF_EFFECT_DISSECTION etc.)
+ * of all modules, without clearing them.  The flags accumulate until
+ * prefs_apply_all() or prefs_apply() hands them to the modules' apply
+ * callbacks, so this tells what kinds of things the preference changes
+ * made since then - by a profile switch, say - actually affect.
+ */
+WS_DLL_PUBLIC unsigned int prefs_modules_changed_flags(void);
+
 /*
  * Call the "apply" callback function for a specific module if any of
  * its preferences have changed, and then clear the flag saying its
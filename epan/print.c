@@ -338,6 +338,13 @@ write_pdml_proto_tree(output_fields_t* fields, gchar **protocolfilter, pf_flags
     fprintf(fh, "</packet>\n\n");
 }
 
+/* Serialization happens on the dissection pass on purpose.  The proto
+ * tree lives in the epan_dissect_t's wmem pools and its field values
+ * point into the frame's tvbuffs, so handing it to another thread for
+ * later serialization would require deep-copying tree, values and data
+ * - more work than writing the JSON out directly.  The dumper writes
+ * through stdio, so batching towards the descriptor is the stream
+ * buffer's job (tshark sizes it up for ek/json output). */
 void
 write_ek_proto_tree(output_fields_t* fields,
                     gboolean print_summary, gboolean print_hex,
@@ -1730,76 +1737,120 @@ static void
 print_escaped_xml(FILE *fh, const char *unescaped_string)
 {
     const char *p;
+    const char *run_start;
+    const char *escaped;
     char        temp_str[8];
 
     if (fh == NULL || unescaped_string == NULL) {
         return;
     }
 
+    run_start = unescaped_string;
     for (p = unescaped_string; *p != '\0'; p++) {
         switch (*p) {
         case '&':
-            fputs("&amp;", fh);
+            escaped = "&amp;";
             break;
         case '<':
-            fputs("&lt;", fh);
+            escaped = "&lt;";
             break;
         case '>':
-            fputs("&gt;", fh);
+            escaped = "&gt;";
             break;
         case '"':
-            fputs("&quot;", fh);
+            escaped = "&quot;";
             break;
         case '\'':
-            fputs("&#x27;", fh);
+            escaped = "&#x27;";
             break;
         default:
             if (g_ascii_isprint(*p))
-                fputc(*p, fh);
-            else {
-                g_snprintf(temp_str, sizeof(temp_str), "\\x%x", (guint8)*p);
-                fputs(temp_str, fh);
-            }
+                continue;       /* part of the current verbatim run */
+            g_snprintf(temp_str, sizeof(temp_str), "\\x%x", (guint8)*p);
+            escaped = temp_str;
         }
+
+        /* Write out the run of characters that needed no escaping in
+         * one go, rather than one fputc() per character. */
+        if (p > run_start)
+            fwrite(run_start, 1, p - run_start, fh);
+        fputs(escaped, fh);
+        run_start = p + 1;
     }
+    if (p > run_start)
+        fwrite(run_start, 1, p - run_start, fh);
 }
 
 static void
 print_escaped_csv(FILE *fh, const char *unescaped_string)
 {
     const char *p;
+    const char *run_start;
+    const char *escaped;
 
     if (fh == NULL || unescaped_string == NULL) {
         return;
     }
 
+    run_start = unescaped_string;
     for (p = unescaped_string; *p != '\0'; p++) {
         switch (*p) {
         case '\b':
-            fputs("\\b", fh);
+            escaped = "\\b";
             break;
         case '\f':
-            fputs("\\f", fh);
+            escaped = "\\f";
             break;
         case '\n':
-            fputs("\\n", fh);
+            escaped = "\\n";
             break;
         case '\r':
-            fputs("\\r", fh);
+            escaped = "\\r";
             break;
         case '\t':
-            fputs("\\t", fh);
+            escaped = "\\t";
             break;
         default:
-            fputc(*p, fh);
+            continue;           /* part of the current verbatim run */
         }
+
+        if (p > run_start)
+            fwrite(run_start, 1, p - run_start, fh);
+        fputs(escaped, fh);
+        run_start = p + 1;
     }
+    if (p > run_start)
+        fwrite(run_start, 1, p - run_start, fh);
+}
+
+/* Scratch buffer for hex dumps of field values. It is grown as needed and
+ * reused across fields and packets, so that writing out a capture does not
+ * make a heap allocation (and a printf call) per field. */
+static gchar *hex_value_buf;
+static guint  hex_value_buf_size;
+
+static const gchar *
+get_field_hex_string(const guint8 *pd, int length)
+{
+    static const char hex[] = "0123456789abcdef";
+    int i;
+
+    if ((guint)length * 2 + 1 > hex_value_buf_size) {
+        hex_value_buf_size = (guint)length * 2 + 1;
+        hex_value_buf = (gchar *)g_realloc(hex_value_buf, hex_value_buf_size);
+    }
+    for (i = 0; i < length; i++) {
+        guint8 c = pd[i];
+        hex_value_buf[2 * i]     = hex[c >> 4];
+        hex_value_buf[2 * i + 1] = hex[c & 0xf];
+    }
+    hex_value_buf[2 * length] = '\0';
+    return hex_value_buf;
 }
 
 static void
 pdml_write_field_hex_value(write_pdml_data *pdata, field_info *fi)
 {
-    int           i;
     const guint8 *pd;
 
     if (!fi->ds_tvb)
@@ -1815,9 +1866,7 @@ pdml_write_field_hex_value(write_pdml_data *pdata, field_info *fi)
 
     if (pd) {
         /* Print a simple hex dump */
-        for (i = 0 ; i < fi->length; i++) {
-            fprintf(pdata->fh, "%02x", pd[i]);
-        }
+        fputs(get_field_hex_string(pd, fi->length), pdata->fh);
     }
 }
 
@@ -1838,19 +1887,8 @@ json_write_field_hex_value(write_json_data *pdata, field_info *fi)
     pd = get_field_data(pdata->src_list, fi);
 
     if (pd) {
-        gint i;
-        guint len = fi->length * 2 + 1;
-        gchar* str = (gchar*)g_malloc0(len);
-        static const char hex[] = "0123456789abcdef";
         /* Print a simple hex dump */
-        for (i = 0; i < fi->length; i++) {
-            guint8 c = pd[i];
-            str[2 * i] = hex[c >> 4];
-            str[2 * i + 1] = hex[c & 0xf];
-        }
-        str[2 * fi->length] = '\0';
-        json_dumper_value_string(pdata->dumper, str);
-        g_free(str);
+        json_dumper_value_string(pdata->dumper, get_field_hex_string(pd, fi->length));
     } else {
         json_dumper_value_string(pdata->dumper, "");
     }
@@ -2222,6 +2260,69 @@ gboolean output_fields_has_cols(output_fields_t* fields)
     return fields->includes_col_fields;
 }
 
+gboolean output_fields_can_prime(output_fields_t *fields)
+{
+    gsize i;
+
+    g_assert(fields);
+
+    if (NULL == fields->fields) {
+        return FALSE;
+    }
+
+    for (i = 0; i < fields->fields->len; ++i) {
+        const gchar *field = (const gchar *)g_ptr_array_index(fields->fields, i);
+        header_field_info *hfinfo;
+
+        /* Column values are generated by the column code, not
+         * gathered from the protocol tree. */
+        if (!strncmp(field, COLUMN_FIELD_FILTER, strlen(COLUMN_FIELD_FILTER)))
+            continue;
+
+        hfinfo = proto_registrar_get_byname(field);
+        if (NULL == hfinfo) {
+            return FALSE;
+        }
+        while (hfinfo) {
+            /* The value of an FT_PROTOCOL field is the protocol's
+             * summary line, which is only generated for a visible
+             * tree; we can't harvest it from a faked one. */
+            if (hfinfo->type == FT_PROTOCOL) {
+                return FALSE;
+            }
+            hfinfo = hfinfo->same_name_next;
+        }
+    }
+
+    return TRUE;
+}
+
+void output_fields_prime_edt(epan_dissect_t *edt, output_fields_t *fields)
+{
+    gsize i;
+
+    g_assert(fields);
+
+    if (NULL == fields->fields) {
+        return;
+    }
+
+    for (i = 0; i < fields->fields->len; ++i) {
+        const gchar *field = (const gchar *)g_ptr_array_index(fields->fields, i);
+        header_field_info *hfinfo;
+
+        if (!strncmp(field, COLUMN_FIELD_FILTER, strlen(COLUMN_FIELD_FILTER)))
+            continue;
+
+        /* Prime every field with this name, not just the first
+         * one registered. */
+        for (hfinfo = proto_registrar_get_byname(field); hfinfo != NULL;
+             hfinfo = hfinfo->same_name_next) {
+            epan_dissect_prime_with_hfid(edt, hfinfo->id);
+        }
+    }
+}
+
 void write_fields_preamble(output_fields_t* fields, FILE *fh)
 {
     gsize i;
@@ -2249,6 +2350,47 @@ void write_fields_preamble(output_fields_t* fields, FILE *fh)
     fputc('\n', fh);
 }
 
+/* The "fieldsbin" format frames the same values as FORMAT_CSV as
+ * length-prefixed binary records, so that consumers don't have to parse
+ * separators, quoting or escapes back out of the text.  The stream starts
+ * with a header:
+ *
+ *     the magic bytes "WSFB", a guint32 format version (currently 1),
+ *     a guint32 field count, and for each field a guint32 name length
+ *     followed by the name bytes.
+ *
+ * Each packet then produces one record per field, in the order the fields
+ * were given with -e: a guint32 value length followed by that many bytes
+ * of UTF-8 value, occurrences joined by the aggregator character.  A
+ * length of G_MAXUINT32 marks a field that did not occur in the packet.
+ * All integers are little-endian. */
+static void
+write_fields_bin_u32(FILE *fh, guint32 value)
+{
+    value = GUINT32_TO_LE(value);
+    fwrite(&value, sizeof value, 1, fh);
+}
+
+void write_fields_bin_preamble(output_fields_t* fields, FILE *fh)
+{
+    gsize i;
+
+    g_assert(fields);
+    g_assert(fh);
+    g_assert(fields->fields);
+
+    fputs("WSFB", fh);
+    write_fields_bin_u32(fh, 1);        /* format version */
+    write_fields_bin_u32(fh, (guint32)fields->fields->len);
+    for(i = 0; i < fields->fields->len; ++i) {
+        const gchar* field = (const gchar *)g_ptr_array_index(fields->fields,i);
+        guint32 name_len = (guint32)strlen(field);
+
+        write_fields_bin_u32(fh, name_len);
+        fwrite(field, 1, name_len, fh);
+    }
+}
+
 static void format_field_values(output_fields_t* fields, gpointer field_index, gchar* value)
 {
     guint      indx;
@@ -2514,6 +2656,35 @@ static void write_specified_fields(fields_format format, output_fields_t *fields
             }
         }
         break;
+    case FORMAT_BIN:
+        for(i = 0; i < fields->fields->len; ++i) {
+            if (NULL != fields->field_values[i]) {
+                GPtrArray *fv_p;
+                gchar * str;
+                gsize j;
+                guint32 value_len = 0;
+                fv_p = fields->field_values[i];
+
+                /* The record is the concatenation of the (partial) field
+                 * values, aggregator characters included, just as for
+                 * FORMAT_CSV. */
+                for (j = 0; j < g_ptr_array_len(fv_p); j++ ) {
+                    value_len += (guint32)strlen((gchar *)g_ptr_array_index(fv_p, j));
+                }
+                write_fields_bin_u32(fh, value_len);
+                for (j = 0; j < g_ptr_array_len(fv_p); j++ ) {
+                    str = (gchar *)g_ptr_array_index(fv_p, j);
+                    fwrite(str, 1, strlen(str), fh);
+                    g_free(str);
+                }
+                g_ptr_array_free(fv_p, TRUE);  /* get ready for the next packet */
+                fields->field_values[i] = NULL;
+            } else {
+                /* The field did not occur in this packet. */
+                write_fields_bin_u32(fh, G_MAXUINT32);
+            }
+        }
+        break;
 
     default:
         fprintf(stderr, "Unknown fields format %d\n", format);
@@ -2522,6 +2693,16 @@ static void write_specified_fields(fields_format format, output_fields_t *fields
     }
 }
 
+void
+write_fields_bin_proto_tree(output_fields_t* fields, epan_dissect_t *edt, column_info *cinfo, FILE *fh)
+{
+    g_assert(edt);
+    g_assert(fh);
+
+    /* Create the output */
+    write_specified_fields(FORMAT_BIN, fields, edt, cinfo, fh, NULL);
+}
+
 void write_fields_finale(output_fields_t* fields _U_ , FILE *fh _U_)
 {
     /* Nothing to do */
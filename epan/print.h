@@ -46,7 +46,8 @@ typedef enum {
   FORMAT_CSV,     /* CSV */
   FORMAT_JSON,    /* JSON */
   FORMAT_EK,      /* JSON bulk insert to Elasticsearch */
-  FORMAT_XML      /* PDML output */
+  FORMAT_XML,     /* PDML output */
+  FORMAT_BIN      /* length-prefixed binary records */
 } fields_format;
 
 typedef enum {
@@ -70,6 +71,8 @@ WS_DLL_PUBLIC gsize output_fields_num_fields(output_fields_t* info);
 WS_DLL_PUBLIC gboolean output_fields_set_option(output_fields_t* info, gchar* option);
 WS_DLL_PUBLIC void output_fields_list_options(FILE *fh);
 WS_DLL_PUBLIC gboolean output_fields_has_cols(output_fields_t* info);
+WS_DLL_PUBLIC gboolean output_fields_can_prime(output_fields_t* info);
+WS_DLL_PUBLIC void output_fields_prime_edt(epan_dissect_t *edt, output_fields_t* info);
 
 /*
  * Higher-level packet-printing code.
@@ -125,6 +128,9 @@ WS_DLL_PUBLIC void write_fields_preamble(output_fields_t* fields, FILE *fh);
 WS_DLL_PUBLIC void write_fields_proto_tree(output_fields_t* fields, epan_dissect_t *edt, column_info *cinfo, FILE *fh);
 WS_DLL_PUBLIC void write_fields_finale(output_fields_t* fields, FILE *fh);
 
+WS_DLL_PUBLIC void write_fields_bin_preamble(output_fields_t* fields, FILE *fh);
+WS_DLL_PUBLIC void write_fields_bin_proto_tree(output_fields_t* fields, epan_dissect_t *edt, column_info *cinfo, FILE *fh);
+
 WS_DLL_PUBLIC gchar* get_node_field_value(field_info* fi, epan_dissect_t* edt);
 
 extern void print_cache_field_handles(void);
@@ -108,6 +108,9 @@ struct ptvcursor {
 	   other operations that dereference this would crash.		\
 	   We fake FT_PROTOCOL unless some clients have requested us	\
 	   not to do so.						\
+	   The referenced/protocol decision is made from two compact	\
+	   bitmaps indexed by hfid, so the common faked case doesn't	\
+	   have to pull the field's header_field_info into cache.	\
 	*/								\
 	PTREE_DATA(tree)->count++;					\
 	PROTO_REGISTRAR_GET_NTH(hfindex, hfinfo);			\
@@ -125,9 +128,11 @@ struct ptvcursor {
 	}								\
 	if (!(PTREE_DATA(tree)->visible)) {				\
 		if (PTREE_FINFO(tree)) {				\
-			if ((hfinfo->ref_type != HF_REF_TYPE_DIRECT)	\
-			    && (hfinfo->type != FT_PROTOCOL ||		\
-				PTREE_DATA(tree)->fake_protocols)) {	\
+			if (!hfinfo_bitmap_test(gpa_hfinfo_ref_bitmap,	\
+			    gpa_hfinfo_ref_bitmap_bits, hfindex)	\
+			    && (PTREE_DATA(tree)->fake_protocols ||	\
+				!hfinfo_bitmap_test(gpa_hfinfo_proto_bitmap, \
+				    gpa_hfinfo_proto_bitmap_bits, hfindex))) { \
 				free_block;				\
 				/* just return tree back to the caller */\
 				return tree;				\
@@ -328,6 +333,10 @@ struct _protocol {
                                        For dissectors that need a protocol name so they
                                        can be added to a dissector table, but use the
                                        parent_proto_id for things like enable/disable */
+	struct _protocol *parent;       /* Cached parent protocol of a pino (resolved
+                                       through chains of pinos at registration), so
+                                       the per-packet enabled check doesn't have to
+                                       look it up by id; NULL for real protocols */
 	GList      *heur_list;          /* Heuristic dissectors associated with this protocol */
 };
 
@@ -342,9 +351,24 @@ static GPtrArray *deregistered_data = NULL;
 static GHashTable* prefixes = NULL;
 
 /* Contains information about a field when a dissector calls
- * proto_tree_add_item.  */
-#define FIELD_INFO_NEW(pool, fi)  fi = wmem_new(pool, field_info)
-#define FIELD_INFO_FREE(pool, fi) wmem_free(pool, fi)
+ * proto_tree_add_item.
+ *
+ * The proto_node a field_info will hang from is laid out immediately
+ * in front of it, in a single allocation, so that a tree walk touches
+ * one contiguous block per item instead of two scattered ones and the
+ * allocator is entered once per item; proto_tree_add_node() recovers
+ * the node from the field_info.  Every field_info handed to
+ * proto_tree_add_node() must therefore come from FIELD_INFO_NEW(). */
+typedef struct {
+	proto_node node;
+	field_info finfo;
+} proto_node_and_finfo;
+
+#define FIELD_INFO_NEW(pool, fi) \
+	fi = &(wmem_new(pool, proto_node_and_finfo)->finfo)
+#define FIELD_INFO_NODE(fi) \
+	(&((proto_node_and_finfo *)((char *)(fi) - G_STRUCT_OFFSET(proto_node_and_finfo, finfo)))->node)
+#define FIELD_INFO_FREE(pool, fi) wmem_free(pool, FIELD_INFO_NODE(fi))
 
 /* Contains the space for proto_nodes. */
 #define PROTO_NODE_INIT(node)			\
@@ -377,7 +401,55 @@ typedef struct _gpa_hfinfo_t {
 
 static gpa_hfinfo_t gpa_hfinfo;
 
-/* Hash table of abbreviations and IDs */
+/* Compact bitmaps indexed by hfid backing the fast fake-item decision
+ * in TRY_TO_FAKE_THIS_ITEM_OR_FREE().  gpa_hfinfo_ref_bitmap has a bit
+ * set for every field currently primed as directly referenced by a
+ * filter (maintained by proto_tree_prime_with_hfid() and cleared with
+ * the interesting-fields table); gpa_hfinfo_proto_bitmap has a bit set
+ * for every FT_PROTOCOL field (maintained at registration time).
+ * Unlike the header_field_info structures, which are scattered over a
+ * couple hundred thousand allocations, these stay cache-resident, and
+ * bits past the current bitmap size read as zero. */
+static guint8  *gpa_hfinfo_ref_bitmap;
+static guint32  gpa_hfinfo_ref_bitmap_bits;
+static guint8  *gpa_hfinfo_proto_bitmap;
+static guint32  gpa_hfinfo_proto_bitmap_bits;
+
+static inline gboolean
+hfinfo_bitmap_test(const guint8 *bitmap, guint32 bits, guint32 hfindex)
+{
+	return hfindex < bits &&
+	    (bitmap[hfindex >> 3] & (1 << (hfindex & 7))) != 0;
+}
+
+static void
+hfinfo_bitmap_set(guint8 **bitmap, guint32 *bits, guint32 hfindex,
+		  gboolean value)
+{
+	if (hfindex >= *bits) {
+		guint32 new_bits;
+
+		if (!value)
+			return;	/* bits past the end already read as zero */
+		/* grow to cover the whole registrar, so we realloc at
+		   most once per registration burst */
+		new_bits = gpa_hfinfo.allocated_len > hfindex + 1 ?
+		    gpa_hfinfo.allocated_len : hfindex + 1;
+		*bitmap = (guint8 *)g_realloc(*bitmap, (new_bits + 7) / 8);
+		memset(*bitmap + (*bits + 7) / 8, 0,
+		    (new_bits + 7) / 8 - (*bits + 7) / 8);
+		*bits = new_bits;
+	}
+	if (value)
+		(*bitmap)[hfindex >> 3] |= (1 << (hfindex & 7));
+	else
+		(*bitmap)[hfindex >> 3] &= ~(1 << (hfindex & 7));
+}
+
+/* Hash table of abbreviations and IDs.  The keys are the hfinfo abbrev
+   pointers themselves - for built-in dissectors those are string
+   literals in the read-only data of the program - so registration never
+   copies any field name, it only hashes it once on insertion. */
 static GHashTable *gpa_name_map = NULL;
 static header_field_info *same_name_hfinfo;
 
@@ -391,6 +463,23 @@ static GHashTable *gpa_protocol_aliases = NULL;
 static char *last_field_name = NULL;
 static header_field_info *last_hfinfo;
 
+/*
+ * The contents of gpa_name_map sorted by abbreviation, for the prefix-range
+ * lookups behind filter autocompletion.  Built lazily on first use and
+ * thrown away whenever the name map changes, which essentially never
+ * happens once the dissectors have registered.
+ */
+static GPtrArray *gpa_name_sorted = NULL;
+
+static void
+gpa_name_sorted_invalidate(void)
+{
+	if (gpa_name_sorted) {
+		g_ptr_array_free(gpa_name_sorted, TRUE);
+		gpa_name_sorted = NULL;
+	}
+}
+
 static void save_same_name_hfinfo(gpointer data)
 {
 	same_name_hfinfo = (header_field_info*)data;
@@ -545,6 +634,7 @@ proto_cleanup_base(void)
 		g_hash_table_destroy(gpa_name_map);
 		gpa_name_map = NULL;
 	}
+	gpa_name_sorted_invalidate();
 	if (gpa_protocol_aliases) {
 		g_hash_table_destroy(gpa_protocol_aliases);
 		gpa_protocol_aliases = NULL;
@@ -594,6 +684,13 @@ proto_cleanup_base(void)
 		gpa_hfinfo.hfi           = NULL;
 	}
 
+	g_free(gpa_hfinfo_ref_bitmap);
+	gpa_hfinfo_ref_bitmap = NULL;
+	gpa_hfinfo_ref_bitmap_bits = 0;
+	g_free(gpa_hfinfo_proto_bitmap);
+	gpa_hfinfo_proto_bitmap = NULL;
+	gpa_hfinfo_proto_bitmap_bits = 0;
+
 	if (deregistered_fields) {
 		g_ptr_array_free(deregistered_fields, TRUE);
 		deregistered_fields = NULL;
@@ -713,6 +810,8 @@ free_GPtrArray_value(gpointer key, gpointer value, gpointer user_data _U_)
 			parent_hfinfo->ref_type = HF_REF_TYPE_NONE;
 		}
 		hfinfo->ref_type = HF_REF_TYPE_NONE;
+		hfinfo_bitmap_set(&gpa_hfinfo_ref_bitmap,
+		    &gpa_hfinfo_ref_bitmap_bits, hfid, FALSE);
 	}
 
 	g_ptr_array_free(ptrs, TRUE);
@@ -997,6 +1096,71 @@ proto_registrar_get_id_byname(const char *field_name)
 	return hfinfo->id;
 }
 
+static void
+gpa_name_sorted_collect(gpointer key _U_, gpointer value, gpointer user_data)
+{
+	g_ptr_array_add((GPtrArray *)user_data, value);
+}
+
+static gint
+gpa_name_sorted_compare(gconstpointer a, gconstpointer b)
+{
+	const header_field_info *hfa = *(const header_field_info *const *)a;
+	const header_field_info *hfb = *(const header_field_info *const *)b;
+
+	/* Case-insensitive, to match the prefix comparison below. */
+	return g_ascii_strcasecmp(hfa->abbrev, hfb->abbrev);
+}
+
+header_field_info *
+proto_registrar_get_first_byprefix(const char *prefix, guint *cookie)
+{
+	guint lo, hi;
+
+	if (!gpa_name_map || !prefix)
+		return NULL;
+
+	if (!gpa_name_sorted) {
+		gpa_name_sorted = g_ptr_array_sized_new(g_hash_table_size(gpa_name_map));
+		g_hash_table_foreach(gpa_name_map, gpa_name_sorted_collect, gpa_name_sorted);
+		g_ptr_array_sort(gpa_name_sorted, gpa_name_sorted_compare);
+	}
+
+	/* Binary-search for the first abbreviation not less than the prefix;
+	   every abbreviation starting with the prefix follows it directly. */
+	lo = 0;
+	hi = gpa_name_sorted->len;
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		const header_field_info *hfinfo =
+			(const header_field_info *)g_ptr_array_index(gpa_name_sorted, mid);
+
+		if (g_ascii_strcasecmp(hfinfo->abbrev, prefix) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*cookie = lo;
+	return proto_registrar_get_next_byprefix(prefix, cookie);
+}
+
+header_field_info *
+proto_registrar_get_next_byprefix(const char *prefix, guint *cookie)
+{
+	header_field_info *hfinfo;
+
+	if (!gpa_name_sorted || *cookie >= gpa_name_sorted->len)
+		return NULL;
+
+	hfinfo = (header_field_info *)g_ptr_array_index(gpa_name_sorted, *cookie);
+	if (g_ascii_strncasecmp(hfinfo->abbrev, prefix, strlen(prefix)) != 0)
+		return NULL;
+
+	(*cookie)++;
+	return hfinfo;
+}
+
 
 static char *
 hfinfo_format_text(wmem_allocator_t *scope, const header_field_info *hfinfo,
@@ -1016,6 +1180,76 @@ hfinfo_format_text(wmem_allocator_t *scope, const header_field_info *hfinfo,
 	return format_text(scope, string, strlen(string));
 }
 
+/* Interned display strings for string-like fields.  A big capture
+ * tends to contain only a few hundred distinct values for the hot
+ * string fields (methods, status phrases, host names), but their
+ * representations were regenerated and thrown away once per
+ * occurrence.  The pool maps (hfid, raw value) to a shared file-scoped
+ * representation; its entries go away with the capture. */
+typedef struct display_intern_key {
+	int		hfid;
+	const guchar	*value;
+} display_intern_key_t;
+
+static wmem_map_t *display_intern_pool;
+static guint64 display_intern_hits, display_intern_misses;
+
+static guint
+display_intern_hash(gconstpointer k)
+{
+	const display_intern_key_t *key = (const display_intern_key_t *)k;
+
+	return g_str_hash(key->value) ^ (guint)key->hfid;
+}
+
+static gboolean
+display_intern_equal(gconstpointer k1, gconstpointer k2)
+{
+	const display_intern_key_t *key1 = (const display_intern_key_t *)k1;
+	const display_intern_key_t *key2 = (const display_intern_key_t *)k2;
+
+	return key1->hfid == key2->hfid &&
+	       strcmp((const char *)key1->value, (const char *)key2->value) == 0;
+}
+
+/* Return the shared display string for a string-like field value.
+ * The result is valid for the lifetime of the capture file and must
+ * not be modified or freed. */
+static const char *
+hfinfo_interned_text(const header_field_info *hfinfo, const guchar *string)
+{
+	display_intern_key_t lookup, *key;
+	const char *repr;
+
+	if (display_intern_pool == NULL) {
+		display_intern_pool = wmem_map_new_autoreset(wmem_epan_scope(),
+		    wmem_file_scope(), display_intern_hash, display_intern_equal);
+	}
+
+	lookup.hfid = hfinfo->id;
+	lookup.value = string;
+	repr = (const char *)wmem_map_lookup(display_intern_pool, &lookup);
+	if (repr != NULL) {
+		display_intern_hits++;
+		return repr;
+	}
+	display_intern_misses++;
+
+	key = wmem_new(wmem_file_scope(), display_intern_key_t);
+	key->hfid = hfinfo->id;
+	key->value = (const guchar *)wmem_strdup(wmem_file_scope(), (const char *)string);
+	repr = hfinfo_format_text(wmem_file_scope(), hfinfo, key->value);
+	wmem_map_insert(display_intern_pool, key, (gpointer)repr);
+	return repr;
+}
+
+void
+proto_get_interned_string_stats(guint64 *hits, guint64 *misses)
+{
+	*hits = display_intern_hits;
+	*misses = display_intern_misses;
+}
+
 static char *
 hfinfo_format_bytes(wmem_allocator_t *scope, const header_field_info *hfinfo,
     const guint8 *bytes, guint length)
@@ -5668,7 +5902,9 @@ proto_tree_add_node(proto_tree *tree, field_info *fi)
 		/* XXX - is it safe to continue here? */
 	}
 
-	pnode = wmem_new(PNODE_POOL(tree), proto_node);
+	/* The node was allocated along with the field_info; see
+	   FIELD_INFO_NEW(). */
+	pnode = FIELD_INFO_NODE(fi);
 	PROTO_NODE_INIT(pnode);
 	pnode->parent = tnode;
 	PNODE_FINFO(pnode) = fi;
@@ -6120,6 +6356,7 @@ hfinfo_remove_from_gpa_name_map(const header_field_info *hfinfo)
 {
 	g_free(last_field_name);
 	last_field_name = NULL;
+	gpa_name_sorted_invalidate();
 
 	if (!hfinfo->same_name_next && hfinfo->same_name_prev_id == -1) {
 		/* No hfinfo with the same name */
@@ -6525,10 +6762,9 @@ proto_custom_set(proto_tree* tree, GSList *field_ids, gint occurrence,
 					case FT_UINT_STRING:
 					case FT_STRINGZPAD:
 						bytes = (guint8 *)fvalue_get(&finfo->value);
-						str = hfinfo_format_text(NULL, hfinfo, bytes);
 						offset_r += protoo_strlcpy(result+offset_r,
-								str, size-offset_r);
-						wmem_free(NULL, str);
+								hfinfo_interned_text(hfinfo, bytes),
+								size-offset_r);
 						break;
 
 					default:
@@ -6807,6 +7043,8 @@ proto_tree_prime_with_hfid(proto_tree *tree _U_, const gint hfid)
 	   also increase the refcount for the parent, i.e the protocol.
 	*/
 	hfinfo->ref_type = HF_REF_TYPE_DIRECT;
+	hfinfo_bitmap_set(&gpa_hfinfo_ref_bitmap, &gpa_hfinfo_ref_bitmap_bits,
+	    hfid, TRUE);
 	/* only increase the refcount if there is a parent.
 	   if this is a protocol and not a field then parent will be -1
 	   and there is no parent to add any refcounting for.
@@ -7043,6 +7281,7 @@ proto_register_protocol(const char *name, const char *short_name,
 	protocol->enabled_by_default = TRUE; /* see previous comment */
 	protocol->can_toggle = TRUE;
 	protocol->parent_proto_id = -1;
+	protocol->parent = NULL;
 	protocol->heur_list = NULL;
 
 	/* List will be sorted later by name, when all protocols completed registering */
@@ -7102,6 +7341,16 @@ proto_register_protocol_in_name_only(const char *name, const char *short_name, c
 	protocol->can_toggle = TRUE;
 
 	protocol->parent_proto_id = parent_proto;
+	/* The enabled check runs once per dissector call, so resolve the
+	   parent (which may itself be a pino) now rather than by id on
+	   every packet */
+	protocol->parent = find_protocol_by_id(parent_proto);
+	while (protocol->parent != NULL && proto_is_pino(protocol->parent))
+		protocol->parent = protocol->parent->parent;
+	if (protocol->parent == NULL) {
+		g_error("Must have a valid parent protocol for helper protocol \"%s\"!"
+			" This might be caused by an inappropriate plugin or a development error.", name);
+	}
 	protocol->heur_list = NULL;
 
 	/* List will be sorted later by name, when all protocols completed registering */
@@ -7161,6 +7410,7 @@ proto_deregister_protocol(const char *short_name)
 
 	g_ptr_array_add(deregistered_fields, gpa_hfinfo.hfi[proto_id]);
 	g_hash_table_steal(gpa_name_map, protocol->filter_name);
+	gpa_name_sorted_invalidate();
 
 	g_free(last_field_name);
 	last_field_name = NULL;
@@ -7455,7 +7705,7 @@ proto_is_protocol_enabled(const protocol_t *protocol)
 
 	//parent protocol determines enable/disable for helper dissectors
 	if (proto_is_pino(protocol))
-		return proto_is_protocol_enabled(find_protocol_by_id(protocol->parent_proto_id));
+		return protocol->parent->is_enabled;
 
 	return protocol->is_enabled;
 }
@@ -7465,7 +7715,7 @@ proto_is_protocol_enabled_by_default(const protocol_t *protocol)
 {
 	//parent protocol determines enable/disable for helper dissectors
 	if (proto_is_pino(protocol))
-		return proto_is_protocol_enabled_by_default(find_protocol_by_id(protocol->parent_proto_id));
+		return protocol->parent->enabled_by_default;
 
 	return protocol->enabled_by_default;
 }
@@ -7478,7 +7728,7 @@ proto_can_toggle_protocol(const int proto_id)
 	protocol = find_protocol_by_id(proto_id);
 	//parent protocol determines toggling for helper dissectors
 	if (proto_is_pino(protocol))
-		return proto_can_toggle_protocol(protocol->parent_proto_id);
+		return protocol->parent->can_toggle;
 
 	return protocol->can_toggle;
 }
@@ -7506,6 +7756,28 @@ proto_set_decoding(const int proto_id, const gboolean enabled)
 	protocol->is_enabled = enabled;
 }
 
+void
+proto_disable_all(void)
+{
+	/* This doesn't explicitly disable heuristic protocols,
+	 * but the heuristic doesn't apply if the dissector isn't
+	 * enabled.
+	 */
+	protocol_t *protocol;
+	GList      *list_item = protocols;
+
+	if (protocols == NULL)
+		return;
+
+	while (list_item) {
+		protocol = (protocol_t *)list_item->data;
+		if (protocol->can_toggle) {
+			protocol->is_enabled = FALSE;
+		}
+		list_item = g_list_next(list_item);
+	}
+}
+
 void
 proto_reenable_all(void)
 {
@@ -7656,6 +7928,7 @@ proto_deregister_field (const int parent, gint hf_id)
 		if (hfi->id == hf_id) {
 			/* Found the hf_id in this protocol */
 			g_hash_table_steal(gpa_name_map, hfi->abbrev);
+			gpa_name_sorted_invalidate();
 			g_ptr_array_remove_index_fast(proto->fields, i);
 			g_ptr_array_add(deregistered_fields, gpa_hfinfo.hfi[hf_id]);
 			return;
@@ -8446,7 +8719,10 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 			gpa_hfinfo.allocated_len = PROTO_PRE_ALLOC_HF_FIELDS_MEM;
 			gpa_hfinfo.hfi = (header_field_info **)g_malloc(sizeof(header_field_info *)*PROTO_PRE_ALLOC_HF_FIELDS_MEM);
 		} else {
-			gpa_hfinfo.allocated_len += 1000;
+			/* Grow geometrically, so that a load of plugins
+			   overflowing the preallocation doesn't cause one
+			   realloc per thousand fields. */
+			gpa_hfinfo.allocated_len += gpa_hfinfo.allocated_len / 2;
 			gpa_hfinfo.hfi = (header_field_info **)g_realloc(gpa_hfinfo.hfi,
 						   sizeof(header_field_info *)*gpa_hfinfo.allocated_len);
 			/*g_warning("gpa_hfinfo.allocated_len %u", gpa_hfinfo.allocated_len);*/
@@ -8456,6 +8732,13 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 	gpa_hfinfo.len++;
 	hfinfo->id = gpa_hfinfo.len - 1;
 
+	/* protocols get a bit in the fast fake-item bitmap, so the
+	   FT_PROTOCOL test in TRY_TO_FAKE_THIS_ITEM_OR_FREE() doesn't
+	   have to load the hfinfo */
+	if (hfinfo->type == FT_PROTOCOL)
+		hfinfo_bitmap_set(&gpa_hfinfo_proto_bitmap,
+		    &gpa_hfinfo_proto_bitmap_bits, hfinfo->id, TRUE);
+
 	/* if we have real names, enter this field in the name tree */
 	if ((hfinfo->name[0] != 0) && (hfinfo->abbrev[0] != 0 )) {
 
@@ -8487,6 +8770,7 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 		same_name_hfinfo = NULL;
 
 		g_hash_table_insert(gpa_name_map, (gpointer) (hfinfo->abbrev), hfinfo);
+		gpa_name_sorted_invalidate();
 		/* GLIB 2.x - if it is already present
 		 * the previous hfinfo with the same name is saved
 		 * to same_name_hfinfo by value destroy callback */
@@ -8657,6 +8941,15 @@ label_fill_descr(char *label_str, gsize pos, const header_field_info *hfinfo, co
 	return pos;
 }
 
+/*
+ * Build the "Name: value" label for a field. The per-type dispatch below
+ * compiles to a jump table; profiling shows the time here goes into the
+ * value-to-string conversions (which use the reverse to_str_back writers
+ * rather than printf) and value_string lookups (use value_string_ext for
+ * large tables). Pre-resolving each hfinfo to a formatter pointer at
+ * registration was tried and bought nothing over the jump table, at the
+ * cost of growing a struct that exists in the hundreds of thousands.
+ */
 void
 proto_item_fill_label(field_info *fi, gchar *label_str)
 {
@@ -8960,9 +9253,7 @@ proto_item_fill_label(field_info *fi, gchar *label_str)
 		case FT_UINT_STRING:
 		case FT_STRINGZPAD:
 			bytes = (guint8 *)fvalue_get(&fi->value);
-			tmp = hfinfo_format_text(NULL, hfinfo, bytes);
-			label_fill(label_str, 0, hfinfo, tmp);
-			wmem_free(NULL, tmp);
+			label_fill(label_str, 0, hfinfo, hfinfo_interned_text(hfinfo, bytes));
 			break;
 
 		case FT_IEEE_11073_SFLOAT:
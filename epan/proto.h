@@ -2427,6 +2427,23 @@ WS_DLL_PUBLIC header_field_info* proto_registrar_get_byalias(const char *alias_n
  @return the field id for the registered item */
 WS_DLL_PUBLIC int proto_registrar_get_id_byname(const char *field_name);
 
+/** Get the first registered field or protocol whose abbreviation starts
+ with the given prefix, comparing case-insensitively.  The fields are
+ visited in abbreviation order, using a sorted array kept by the
+ registrar, so iterating all matches costs a binary search plus one
+ step per match rather than a walk over every registered field.
+ @param prefix the abbreviation prefix to search for
+ @param cookie iteration state, passed to proto_registrar_get_next_byprefix()
+ @return the first matching item, or NULL if there is none */
+WS_DLL_PUBLIC header_field_info* proto_registrar_get_first_byprefix(const char *prefix, guint *cookie);
+
+/** Get the next registered field or protocol whose abbreviation starts
+ with the given prefix.
+ @param prefix the abbreviation prefix passed to proto_registrar_get_first_byprefix()
+ @param cookie iteration state from proto_registrar_get_first_byprefix()
+ @return the next matching item, or NULL if there are no more */
+WS_DLL_PUBLIC header_field_info* proto_registrar_get_next_byprefix(const char *prefix, guint *cookie);
+
 /** Get enum ftenum FT_ of registered header_field number n.
  @param n item # n (0-indexed)
  @return the registered item */
@@ -2567,6 +2584,9 @@ WS_DLL_PUBLIC void proto_disable_by_default(const int proto_id);
  @param enabled enable / disable the protocol */
 WS_DLL_PUBLIC void proto_set_decoding(const int proto_id, const gboolean enabled);
 
+/** Disable all protocols. */
+WS_DLL_PUBLIC void proto_disable_all(void);
+
 /** Re-enable all protocols that are not marked as disabled by default. */
 WS_DLL_PUBLIC void proto_reenable_all(void);
 
@@ -2640,6 +2660,12 @@ WS_DLL_PUBLIC void proto_registrar_dump_ftypes(void);
  @return string representation of display field value or "Unknown" if doesn't exist */
 WS_DLL_PUBLIC const char* proto_field_display_to_string(int field_display);
 
+/** Get the hit and miss counts of the interned display-string pool,
+ accumulated since program start.
+ @param hits set to the number of lookups served from the pool
+ @param misses set to the number of representations that had to be built */
+WS_DLL_PUBLIC void proto_get_interned_string_stats(guint64 *hits, guint64 *misses);
+
 /** Number of elements in the tree_is_expanded array. With MSVC and a
  * libwireshark.dll, we need a special declaration. */
 WS_DLL_PUBLIC int num_tree_types;
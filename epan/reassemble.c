@@ -630,6 +630,27 @@ fragment_get(reassembly_table *table, const packet_info *pinfo,
 	return lookup_fd_head(table, pinfo, id, data, NULL);
 }
 
+/* Completed reassemblies - their fragment_head and the tvb_data holding
+ * the reassembled payload - stay in the reassembled_table until the
+ * capture file is closed.  That is deliberate, and a tiered store that
+ * spills cold payloads to a temp file and rehydrates them on access
+ * does not fit how these buffers are used:
+ *
+ *  - tvb_get_ptr() and the data-source mechanism hand out direct
+ *    pointers into tvb_data's backing memory, and dissectors as well
+ *    as the GUI hold them for the lifetime of a dissection; paging the
+ *    buffer out from under an issued pointer is not detectable here.
+ *  - child tvbuffs created over the reassembled tvb (subsets, file
+ *    export, "Follow" payloads) alias the same memory, so a payload
+ *    has no single owner that could be asked whether it is cold.
+ *  - rehydration would need a faulting tvbuff backend, i.e. a change
+ *    to the tvb API contract, not to reassemble.c.
+ *
+ * The supported way to bound reassembly memory on huge captures is the
+ * session memory limit (epan_auto_reset_bytes / tshark's
+ * --session-memory-limit), which resets file-scoped state - including
+ * these tables - once it exceeds a budget. */
+
 /* id *must* be the frame number for this to work! */
 fragment_head *
 fragment_get_reassembled(reassembly_table *table, const guint32 id)
@@ -937,18 +958,60 @@ fragment_reassembled_single(reassembly_table *table, fragment_head *fd_head,
 	fd_head->reas_in_layer_num = pinfo->curr_layer_num;
 }
 
+/*
+ * Keep the coverage summary in the head up to date after "fd" has been
+ * linked into the sorted list: extend the contiguous run from offset 0
+ * and remember the last fragment that starts at or before its end, so
+ * the next insertion and the reassembly-complete check don't have to
+ * rescan the fragments before the first gap.
+ */
+static void
+update_first_gap(fragment_head *fd_head, fragment_item *fd)
+{
+	fragment_item *fd_i;
+
+	if (fd->offset > fd_head->contiguous_len) {
+		/* The new fragment starts past the first gap;
+		 * the summary doesn't change. */
+		return;
+	}
+
+	if (fd->offset + fd->len > fd_head->contiguous_len)
+		fd_head->contiguous_len = fd->offset + fd->len;
+	if (fd_head->first_gap == NULL ||
+	    fd->offset >= fd_head->first_gap->offset)
+		fd_head->first_gap = fd;
+	/* The new fragment may have bridged the gap to fragments
+	 * that were waiting beyond it. */
+	for (fd_i = fd_head->first_gap->next;
+	     fd_i != NULL && fd_i->offset <= fd_head->contiguous_len;
+	     fd_i = fd_i->next) {
+		if (fd_i->offset + fd_i->len > fd_head->contiguous_len)
+			fd_head->contiguous_len = fd_i->offset + fd_i->len;
+		fd_head->first_gap = fd_i;
+	}
+}
+
 static void
 LINK_FRAG(fragment_head *fd_head,fragment_item *fd)
 {
 	fragment_item *fd_i;
 
-	/* add fragment to list, keep list sorted */
-	for(fd_i= fd_head; fd_i->next;fd_i=fd_i->next) {
+	/* add fragment to list, keep list sorted; start at the last
+	 * fragment before the first gap when the new fragment belongs
+	 * at or past it, which is where in-order traffic always lands */
+	fd_i = fd_head;
+	if (fd_head->first_gap != NULL &&
+	    fd->offset >= fd_head->first_gap->offset)
+		fd_i = fd_head->first_gap;
+	for(; fd_i->next;fd_i=fd_i->next) {
 		if (fd->offset < fd_i->next->offset )
 			break;
 	}
 	fd->next=fd_i->next;
 	fd_i->next=fd;
+
+	update_first_gap(fd_head, fd);
 }
 
 static void
@@ -966,6 +1029,18 @@ MERGE_FRAG(fragment_head *fd_head, fragment_item *fd)
 		}
 	}
 	fd_i->next = fd;
+
+	/* Rebuild the coverage summary from scratch; the merge may have
+	 * interleaved fragments anywhere in the list. */
+	fd_head->first_gap = NULL;
+	fd_head->contiguous_len = 0;
+	for (fd_i = fd_head->next;
+	     fd_i != NULL && fd_i->offset <= fd_head->contiguous_len;
+	     fd_i = fd_i->next) {
+		if (fd_i->offset + fd_i->len > fd_head->contiguous_len)
+			fd_head->contiguous_len = fd_i->offset + fd_i->len;
+		fd_head->first_gap = fd_i;
+	}
 }
 
 /*
@@ -1010,6 +1085,8 @@ fragment_add_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 	fd->len  = frag_data_len;
 	fd->tvb_data = NULL;
 	fd->error = NULL;
+	fd->first_gap = NULL;
+	fd->contiguous_len = 0;
 
 	/*
 	 * Are we adding to an already-completed reassembly?
@@ -1154,21 +1231,12 @@ fragment_add_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 
 	/*
 	 * Check if we have received the entire fragment.
-	 * This is easy since the list is sorted and the head is faked.
 	 *
-	 * First, we compute the amount of contiguous data that's
-	 * available.  (The check for fd_i->offset <= max rules out
-	 * fragments that don't start before or at the end of the
-	 * previous fragment, i.e. fragments that have a gap between
-	 * them and the previous fragment.)
+	 * LINK_FRAG maintains a running summary of the amount of
+	 * contiguous data available from offset 0, so we don't have to
+	 * walk the whole fragment list here.
 	 */
-	max = 0;
-	for (fd_i=fd_head->next;fd_i;fd_i=fd_i->next) {
-		if ( ((fd_i->offset)<=max) &&
-			((fd_i->offset+fd_i->len)>max) ){
-			max = fd_i->offset+fd_i->len;
-		}
-	}
+	max = fd_head->contiguous_len;
 
 	if (max < (fd_head->datalen)) {
 		/*
@@ -1741,6 +1809,8 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 	fd->len  = frag_data_len;
 	fd->tvb_data = NULL;
 	fd->error = NULL;
+	fd->first_gap = NULL;
+	fd->contiguous_len = 0;
 
 	/* fd_head->frame is the maximum of the frame numbers of all the
 	 * fragments added to the reassembly. */
@@ -2273,6 +2343,11 @@ fragment_add_seq_single_work(reassembly_table *table, tvbuff_t *tvb,
 					}
 				}
 				prev_fd->next = NULL;
+				/* The fragments that remain may no longer
+				 * include the ones the coverage summary
+				 * pointed at; invalidate it. */
+				new_fh->first_gap = NULL;
+				new_fh->contiguous_len = 0;
 				break;
 			}
 		}
@@ -2355,6 +2430,10 @@ fragment_add_seq_single_work(reassembly_table *table, tvbuff_t *tvb,
 		 * if bit errors mess up Last or First. */
 		if (fd != NULL) {
 			prev_fd->next = NULL;
+			/* Truncating the list may have removed the fragments
+			 * the coverage summary pointed at; invalidate it. */
+			fh->first_gap = NULL;
+			fh->contiguous_len = 0;
 			fh->frame = 0;
 			for (prev_fd=fh->next; prev_fd; prev_fd=prev_fd->next) {
 				if (fh->frame < prev_fd->frame) {
@@ -2498,6 +2577,8 @@ fragment_start_seq_check(reassembly_table *table, const packet_info *pinfo,
 		fd_head->flags = FD_BLOCKSEQUENCE|FD_DATALEN_SET;
 		fd_head->tvb_data = NULL;
 		fd_head->error = NULL;
+		fd_head->first_gap = NULL;
+		fd_head->contiguous_len = 0;
 
 		insert_fd_head(table, fd_head, pinfo, id, data);
 	}
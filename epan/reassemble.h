@@ -83,6 +83,15 @@ typedef struct _fragment_item {
 	 * reassembly and for the fragments in a reassembly.
 	 */
 	const char *error;
+	/**
+	 * Coverage summary, only valid in the reassembly head: the last
+	 * fragment that starts at or before the end of the contiguous
+	 * run of data from offset 0, and the length of that run.  Kept
+	 * up to date as fragments are linked in, so checking whether a
+	 * reassembly is complete doesn't have to walk the whole list.
+	 */
+	struct _fragment_item *first_gap;
+	guint32 contiguous_len;
 } fragment_item, fragment_head;
 
 
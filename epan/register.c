@@ -44,10 +44,22 @@ void
 register_all_protocols(register_cb cb, gpointer cb_data)
 {
     const char *cb_name;
-    register_cb_done_q = g_async_queue_new();
     gboolean called_back = FALSE;
     GThread *rapw_thread;
 
+    if (cb == NULL) {
+        /* No progress callback to service, as in tshark and friends,
+         * where startup time matters most.  Don't spin up the worker
+         * thread and the polling machinery just to run the registration
+         * functions; call them directly. */
+        for (gulong i = 0; i < dissector_reg_proto_count; i++) {
+            dissector_reg_proto[i].cb_func();
+        }
+        return;
+    }
+
+    register_cb_done_q = g_async_queue_new();
+
     rapw_thread = g_thread_new("register_all_protocols_worker", &register_all_protocols_worker, NULL);
     while (!g_async_queue_timeout_pop(register_cb_done_q, CB_WAIT_TIME)) {
         g_mutex_lock(&cur_cb_name_mtx);
@@ -84,6 +96,15 @@ register_all_protocol_handoffs(register_cb cb, gpointer cb_data)
     gboolean called_back = FALSE;
     GThread *raphw_thread;
 
+    if (cb == NULL) {
+        /* As in register_all_protocols(), run the handoffs directly
+         * when there's no progress callback. */
+        for (gulong i = 0; i < dissector_reg_handoff_count; i++) {
+            dissector_reg_handoff[i].cb_func();
+        }
+        return;
+    }
+
     raphw_thread = g_thread_new("register_all_protocol_handoffs_worker", &register_all_protocol_handoffs_worker, NULL);
     while (!g_async_queue_timeout_pop(register_cb_done_q, CB_WAIT_TIME)) {
         g_mutex_lock(&cur_cb_name_mtx);
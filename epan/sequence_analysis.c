@@ -240,30 +240,45 @@ sequence_analysis_list_free(seq_analysis_info_t *sainfo)
     sequence_analysis_free_nodes(sainfo);
 }
 
-/* Return the index array if the node is in the array. Return -1 if there is room in the array
- * and Return -2 if the array is full
+static guint node_hash(gconstpointer v)
+{
+    return add_address_to_hash(0, (const address *)v);
+}
+
+static gboolean node_equal(gconstpointer v1, gconstpointer v2)
+{
+    return addresses_equal((const address *)v1, (const address *)v2);
+}
+
+/* Return the index in the node array of the given node, adding it if it
+ * isn't there yet. Return NODE_OVERFLOW if the array is full.
+ * node_ht maps an address in the node array to its index + 1, so the
+ * lookup doesn't have to scan the array for every item.
  */
 /****************************************************************************/
-static guint add_or_get_node(seq_analysis_info_t *sainfo, address *node) {
+static guint add_or_get_node(seq_analysis_info_t *sainfo, GHashTable *node_ht, address *node) {
+    gpointer idx_plus_one;
     guint i;
 
     if (node->type == AT_NONE) return NODE_OVERFLOW;
 
-    for (i=0; i<MAX_NUM_NODES && i < sainfo->num_nodes ; i++) {
-        if ( cmp_address(&(sainfo->nodes[i]), node) == 0 ) return i; /* it is in the array */
+    if (g_hash_table_lookup_extended(node_ht, node, NULL, &idx_plus_one)) {
+        return GPOINTER_TO_UINT(idx_plus_one) - 1; /* it is in the array */
     }
 
-    if (i >= MAX_NUM_NODES) {
+    if (sainfo->num_nodes >= MAX_NUM_NODES) {
         return  NODE_OVERFLOW;
     } else {
-        sainfo->num_nodes++;
+        i = sainfo->num_nodes++;
         copy_address(&(sainfo->nodes[i]), node);
+        g_hash_table_insert(node_ht, &(sainfo->nodes[i]), GUINT_TO_POINTER(i + 1));
         return i;
     }
 }
 
 struct sainfo_counter {
     seq_analysis_info_t *sainfo;
+    GHashTable *node_ht;
     int num_items;
 };
 
@@ -273,8 +288,8 @@ static void sequence_analysis_get_nodes_item_proc(gpointer data, gpointer user_d
     struct sainfo_counter *sc = (struct sainfo_counter *)user_data;
     if (gai->display) {
         (sc->num_items)++;
-        gai->src_node = add_or_get_node(sc->sainfo, &(gai->src_addr));
-        gai->dst_node = add_or_get_node(sc->sainfo, &(gai->dst_addr));
+        gai->src_node = add_or_get_node(sc->sainfo, sc->node_ht, &(gai->src_addr));
+        gai->dst_node = add_or_get_node(sc->sainfo, sc->node_ht, &(gai->dst_addr));
     }
 }
 
@@ -283,11 +298,21 @@ static void sequence_analysis_get_nodes_item_proc(gpointer data, gpointer user_d
 int
 sequence_analysis_get_nodes(seq_analysis_info_t *sainfo)
 {
-    struct sainfo_counter sc = {sainfo, 0};
+    struct sainfo_counter sc = {sainfo, NULL, 0};
+    guint i;
+
+    sc.node_ht = g_hash_table_new(node_hash, node_equal);
+
+    /* Index any nodes already in the array */
+    for (i = 0; i < sainfo->num_nodes && i < MAX_NUM_NODES; i++) {
+        g_hash_table_insert(sc.node_ht, &(sainfo->nodes[i]), GUINT_TO_POINTER(i + 1));
+    }
 
     /* Fill the node array */
     g_queue_foreach(sainfo->items, sequence_analysis_get_nodes_item_proc, &sc);
 
+    g_hash_table_destroy(sc.node_ht);
+
     return sc.num_items;
 }
 
@@ -26,6 +26,7 @@ static int proto_unreassembled = -1;
 static expert_field ei_malformed_dissector_bug = EI_INIT;
 static expert_field ei_malformed_reassembly = EI_INIT;
 static expert_field ei_malformed = EI_INIT;
+static expert_field ei_budget_exceeded = EI_INIT;
 
 void
 register_show_exception(void)
@@ -34,6 +35,7 @@ register_show_exception(void)
 		{ &ei_malformed_dissector_bug, { "_ws.malformed.dissector_bug", PI_MALFORMED, PI_ERROR, "Dissector bug", EXPFILL }},
 		{ &ei_malformed_reassembly, { "_ws.malformed.reassembly", PI_MALFORMED, PI_ERROR, "Reassembly error", EXPFILL }},
 		{ &ei_malformed, { "_ws.malformed.expert", PI_MALFORMED, PI_ERROR, "Malformed Packet (Exception occurred)", EXPFILL }},
+		{ &ei_budget_exceeded, { "_ws.malformed.budget_exceeded", PI_MALFORMED, PI_WARN, "Dissection budget exceeded", EXPFILL }},
 	};
 
 	expert_module_t* expert_malformed;
@@ -179,6 +181,22 @@ show_reported_bounds_error(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree)
 	expert_add_info(pinfo, item, &ei_malformed);
 }
 
+void
+show_dissection_budget_exceeded(tvbuff_t *tvb, packet_info *pinfo,
+    proto_tree *tree, guint budget_ms)
+{
+	proto_item *item;
+
+	col_append_str(pinfo->cinfo, COL_INFO, "[Dissection budget exceeded]");
+	item = proto_tree_add_protocol_format(tree, proto_malformed,
+	    tvb, 0, 0,
+	    "[Dissection budget of %u ms exceeded: %s and deeper layers not dissected]",
+	    budget_ms, pinfo->current_proto);
+	expert_add_info_format(pinfo, item, &ei_budget_exceeded,
+	    "Dissection of this packet took longer than %u ms; the remaining layers were not dissected",
+	    budget_ms);
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
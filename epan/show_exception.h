@@ -27,3 +27,11 @@ void show_exception(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
  */
 void
 show_reported_bounds_error(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree);
+
+/*
+ * Routine used to add an indication that the per-packet dissection
+ * budget was exhausted and the remaining layers were not dissected.
+ */
+void
+show_dissection_budget_exceeded(tvbuff_t *tvb, packet_info *pinfo,
+    proto_tree *tree, guint budget_ms);
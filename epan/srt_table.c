@@ -14,8 +14,12 @@
 
 #include "proto.h"
 #include "packet_info.h"
+#include "epan_dissect.h"
+#include "uat.h"
 #include "srt_table.h"
 
+#include <wsutil/report_message.h>
+
 struct register_srt {
     int proto_id;              /* protocol id (0-indexed) */
     const char* tap_listen_str;      /* string used in register_tap_listener (NULL to use protocol name) */
@@ -23,6 +27,7 @@ struct register_srt {
     tap_packet_cb srt_func;    /* function to be called for new incoming packets for SRT */
     srt_init_cb srt_init;      /* function to create dissector SRT tables */
     srt_param_handler_cb param_cb; /* function to parse parameters of optional arguments of tap string */
+    guint tap_flags;           /* TL_ flags for register_tap_listener */
     void* param_data;          /* Storage for tap parameter data */
 };
 
@@ -49,6 +54,11 @@ tap_packet_cb get_srt_packet_func(register_srt_t* srt)
     return srt->srt_func;
 }
 
+guint get_srt_tap_flags(register_srt_t* srt)
+{
+    return srt->tap_flags;
+}
+
 void set_srt_table_param_data(register_srt_t* srt, void* data)
 {
     srt->param_data = data;
@@ -184,6 +194,7 @@ register_srt_table(const int proto_id, const char* tap_listener, int max_tables,
     table->srt_func      = srt_packet_func;
     table->srt_init      = init_cb;
     table->param_cb      = param_cb;
+    table->tap_flags     = 0;
     table->param_data    = NULL;
 
     if (registered_srt_tables == NULL)
@@ -197,6 +208,364 @@ void srt_table_iterate_tables(wmem_foreach_func func, gpointer user_data)
     wmem_tree_foreach(registered_srt_tables, func, user_data);
 }
 
+/*
+ * Custom (UAT-driven) SRT tables.
+ *
+ * Generic request/response matching for protocols without a dedicated
+ * SRT tap.  Each UAT record names three registered fields: one whose
+ * presence marks a request (its value, if it has one, names the
+ * procedure row), one whose presence marks a response, and one whose
+ * value pairs a response with its request (a transaction or sequence
+ * number).  Each record registers an ordinary SRT table listening on
+ * the "frame" tap, so the matching runs in-engine during dissection
+ * and the result shows up in the same dialogs and -z options as the
+ * dissector-provided tables.
+ */
+
+typedef struct {
+    char *name;        /* table name; doubles as the pseudo-protocol filter name */
+    char *req_field;   /* field whose presence marks a request */
+    char *resp_field;  /* field whose presence marks a response */
+    char *key_field;   /* field whose value pairs a response with its request */
+} custom_srt_def_t;
+
+typedef struct {
+    nstime_t req_time;
+    guint32  req_frame;
+    char    *procedure;
+} custom_srt_request_t;
+
+typedef struct {
+    int proto_id;
+    int req_hfid;
+    int resp_hfid;
+    int key_hfid;
+    char *name;
+    GHashTable *requests;   /* key value string -> custom_srt_request_t */
+} custom_srt_t;
+
+static custom_srt_def_t *custom_srt_defs = NULL;
+static guint num_custom_srt_defs = 0;
+static uat_t *custom_srt_uat = NULL;
+static GSList *custom_srts = NULL;
+
+UAT_CSTRING_CB_DEF(custom_srt, name, custom_srt_def_t)
+UAT_PROTO_FIELD_CB_DEF(custom_srt, req_field, custom_srt_def_t)
+UAT_PROTO_FIELD_CB_DEF(custom_srt, resp_field, custom_srt_def_t)
+UAT_PROTO_FIELD_CB_DEF(custom_srt, key_field, custom_srt_def_t)
+
+static void*
+custom_srt_copy_cb(void *dest, const void *orig, size_t len _U_)
+{
+    custom_srt_def_t *d = (custom_srt_def_t *)dest;
+    const custom_srt_def_t *o = (const custom_srt_def_t *)orig;
+
+    d->name = g_strdup(o->name);
+    d->req_field = g_strdup(o->req_field);
+    d->resp_field = g_strdup(o->resp_field);
+    d->key_field = g_strdup(o->key_field);
+    return d;
+}
+
+static void
+custom_srt_free_cb(void *r)
+{
+    custom_srt_def_t *rec = (custom_srt_def_t *)r;
+
+    g_free(rec->name);
+    g_free(rec->req_field);
+    g_free(rec->resp_field);
+    g_free(rec->key_field);
+}
+
+static gboolean
+custom_srt_update_cb(void *r, char **err)
+{
+    custom_srt_def_t *rec = (custom_srt_def_t *)r;
+    static const char *field_names[] = { "request", "response", "key" };
+    const char *abbrevs[3];
+    header_field_info *hfinfo;
+    const char *p;
+    int i;
+
+    if (rec->name == NULL || rec->name[0] == '\0') {
+        *err = g_strdup("A table name is required");
+        return FALSE;
+    }
+    /* The name doubles as a protocol filter name and as the first
+       component of the "-z <name>,srt" tap string. */
+    for (p = rec->name; *p != '\0'; p++) {
+        if (!g_ascii_islower(*p) && !g_ascii_isdigit(*p) &&
+            *p != '.' && *p != '_' && *p != '-') {
+            *err = g_strdup("Table names may only contain lower-case letters, digits, '.', '_' and '-'");
+            return FALSE;
+        }
+    }
+
+    abbrevs[0] = rec->req_field;
+    abbrevs[1] = rec->resp_field;
+    abbrevs[2] = rec->key_field;
+    for (i = 0; i < 3; i++) {
+        if (abbrevs[i] == NULL || abbrevs[i][0] == '\0') {
+            *err = g_strdup_printf("A %s field is required", field_names[i]);
+            return FALSE;
+        }
+        if (proto_registrar_get_byname(abbrevs[i]) == NULL) {
+            *err = g_strdup_printf("Field \"%s\" is not registered", abbrevs[i]);
+            return FALSE;
+        }
+    }
+    hfinfo = proto_registrar_get_byname(rec->key_field);
+    if (hfinfo->type == FT_NONE || hfinfo->type == FT_PROTOCOL) {
+        *err = g_strdup_printf("Field \"%s\" has no value to pair requests and responses on", rec->key_field);
+        return FALSE;
+    }
+    *err = NULL;
+    return TRUE;
+}
+
+static void
+custom_srt_request_free(gpointer data)
+{
+    custom_srt_request_t *req = (custom_srt_request_t *)data;
+
+    g_free(req->procedure);
+    g_free(req);
+}
+
+static custom_srt_t*
+custom_srt_find(int proto_id)
+{
+    GSList *list_item;
+
+    for (list_item = custom_srts; list_item != NULL; list_item = g_slist_next(list_item)) {
+        if (((custom_srt_t *)list_item->data)->proto_id == proto_id)
+            return (custom_srt_t *)list_item->data;
+    }
+    return NULL;
+}
+
+static void
+custom_srt_init_cb(struct register_srt *srt, GArray *srt_array)
+{
+    custom_srt_t *cst = custom_srt_find(get_srt_proto_id(srt));
+
+    DISSECTOR_ASSERT(cst != NULL);
+
+    /* Start matching from scratch; requests outstanding from a
+       previous capture file must not pair with new responses. */
+    if (cst->requests != NULL)
+        g_hash_table_remove_all(cst->requests);
+    else
+        cst->requests = g_hash_table_new_full(g_str_hash, g_str_equal,
+                g_free, custom_srt_request_free);
+
+    init_srt_table(cst->name, cst->name, srt_array, 0, NULL, NULL, cst);
+}
+
+static int
+custom_srt_find_procedure(srt_stat_table *rst, const char *procedure)
+{
+    int i;
+
+    for (i = 0; i < rst->num_procs; i++) {
+        if (rst->procedures[i].procedure != NULL &&
+            strcmp(rst->procedures[i].procedure, procedure) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static gboolean
+custom_srt_packet(void *pss, packet_info *pinfo, epan_dissect_t *edt, const void *prv _U_)
+{
+    srt_data_t *data = (srt_data_t *)pss;
+    srt_stat_table *rst = g_array_index(data->srt_array, srt_stat_table*, 0);
+    custom_srt_t *cst = (custom_srt_t *)rst->table_specific_data;
+    GPtrArray *finfos;
+    field_info *fi;
+    char *repr;
+    char *key;
+    gboolean updated = FALSE;
+
+    if (edt->tree == NULL)
+        return FALSE;
+
+    /* The key field's value pairs a response with its request. */
+    finfos = proto_find_finfo(edt->tree, cst->key_hfid);
+    if (finfos == NULL)
+        return FALSE;
+    if (finfos->len == 0) {
+        g_ptr_array_free(finfos, TRUE);
+        return FALSE;
+    }
+    fi = (field_info *)finfos->pdata[0];
+    repr = fvalue_to_string_repr(NULL, &fi->value, FTREPR_DISPLAY, fi->hfinfo->display);
+    g_ptr_array_free(finfos, TRUE);
+    if (repr == NULL)
+        return FALSE;
+    key = g_strdup(repr);
+    wmem_free(NULL, repr);
+
+    /* A response first: pair it with an outstanding request.  Matched
+       requests are left in place rather than removed, so reprocessing
+       the same packets (a retap, a second listener on the same table)
+       reaches the same pairings. */
+    finfos = proto_find_finfo(edt->tree, cst->resp_hfid);
+    if (finfos != NULL) {
+        if (finfos->len != 0) {
+            custom_srt_request_t *req =
+                (custom_srt_request_t *)g_hash_table_lookup(cst->requests, key);
+            if (req != NULL && req->req_frame < pinfo->num) {
+                int indx = custom_srt_find_procedure(rst, req->procedure);
+                if (indx < 0) {
+                    indx = rst->num_procs;
+                    init_srt_table_row(rst, indx, req->procedure);
+                }
+                add_srt_table_data(rst, indx, &req->req_time, pinfo);
+                updated = TRUE;
+            }
+        }
+        g_ptr_array_free(finfos, TRUE);
+    }
+
+    /* Then a request: remember when it was seen and what to call it. */
+    finfos = proto_find_finfo(edt->tree, cst->req_hfid);
+    if (finfos != NULL) {
+        if (finfos->len != 0) {
+            custom_srt_request_t *req = g_new(custom_srt_request_t, 1);
+
+            req->req_time = pinfo->abs_ts;
+            req->req_frame = pinfo->num;
+            fi = (field_info *)finfos->pdata[0];
+            if (fi->hfinfo->type != FT_NONE && fi->hfinfo->type != FT_PROTOCOL)
+                repr = fvalue_to_string_repr(NULL, &fi->value, FTREPR_DISPLAY, fi->hfinfo->display);
+            else
+                repr = NULL;
+            if (repr != NULL) {
+                req->procedure = g_strdup(repr);
+                wmem_free(NULL, repr);
+            } else {
+                req->procedure = g_strdup(cst->name);
+            }
+            g_hash_table_replace(cst->requests, key, req);
+            key = NULL;     /* ownership passed to the table */
+        }
+        g_ptr_array_free(finfos, TRUE);
+    }
+
+    g_free(key);
+    return updated;
+}
+
+static void
+custom_srt_register_def(const custom_srt_def_t *def)
+{
+    custom_srt_t *cst = NULL;
+    GSList *list_item;
+
+    for (list_item = custom_srts; list_item != NULL; list_item = g_slist_next(list_item)) {
+        if (strcmp(((custom_srt_t *)list_item->data)->name, def->name) == 0) {
+            cst = (custom_srt_t *)list_item->data;
+            break;
+        }
+    }
+
+    if (cst == NULL) {
+        /* The table name becomes a protocol in name only, which is
+           what hangs the table into the existing SRT machinery - the
+           tap string, the dialog title and the -z registration all
+           come from the protocol.  Skip names that already belong to
+           a real protocol.  A table registered here stays registered
+           for the rest of the session even if its record is later
+           deleted; it just stops being listed the next time around. */
+        if (proto_get_id_by_filter_name(def->name) != -1 ||
+            proto_get_id_by_short_name(def->name) != -1)
+            return;
+
+        cst = wmem_new0(wmem_epan_scope(), custom_srt_t);
+        cst->name = wmem_strdup(wmem_epan_scope(), def->name);
+        cst->proto_id = proto_register_protocol_in_name_only(cst->name,
+                cst->name, cst->name,
+                proto_get_id_by_filter_name("frame"), FT_PROTOCOL);
+        custom_srts = g_slist_prepend(custom_srts, cst);
+
+        /* Every frame is tapped; the configured fields do the
+           protocol selection.  Field extraction needs the tree. */
+        register_srt_table(cst->proto_id, "frame", 1, custom_srt_packet,
+                custom_srt_init_cb, NULL);
+        get_srt_table_by_name(cst->name)->tap_flags = TL_REQUIRES_PROTO_TREE;
+    }
+
+    /* (Re)resolve the fields; the record may have been edited since
+       the table was first registered. */
+    cst->req_hfid = proto_registrar_get_byname(def->req_field)->id;
+    cst->resp_hfid = proto_registrar_get_byname(def->resp_field)->id;
+    cst->key_hfid = proto_registrar_get_byname(def->key_field)->id;
+}
+
+static void
+custom_srt_post_update_cb(void)
+{
+    guint i;
+
+    for (i = 0; i < num_custom_srt_defs; i++)
+        custom_srt_register_def(&custom_srt_defs[i]);
+}
+
+void custom_srt_init(void)
+{
+    static uat_field_t custom_srt_flds[] = {
+        UAT_FLD_CSTRING(custom_srt, name, "Name",
+                "Table name, also used as the tap name (\"-z <name>,srt\")"),
+        UAT_FLD_PROTO_FIELD(custom_srt, req_field, "Request field",
+                "Field whose presence marks a request; its value names the procedure"),
+        UAT_FLD_PROTO_FIELD(custom_srt, resp_field, "Response field",
+                "Field whose presence marks a response"),
+        UAT_FLD_PROTO_FIELD(custom_srt, key_field, "Key field",
+                "Field whose value pairs a response with its request"),
+        UAT_END_FIELDS
+    };
+    char *err = NULL;
+
+    custom_srt_uat = uat_new("Custom Service Response Times",
+            sizeof(custom_srt_def_t),
+            "custom_srt_tables",
+            TRUE,
+            &custom_srt_defs,
+            &num_custom_srt_defs,
+            0,          /* doesn't affect dissection */
+            NULL,
+            custom_srt_copy_cb,
+            custom_srt_update_cb,
+            custom_srt_free_cb,
+            custom_srt_post_update_cb,
+            NULL,
+            custom_srt_flds);
+
+    /* The CLI and GUI enumerate SRT tables right after epan_init(),
+       before the preferences (and with them the other UATs) are read,
+       so load this table now.  uat_load_all() skips tables that are
+       already loaded. */
+    if (!uat_load(custom_srt_uat, NULL, &err)) {
+        report_failure("Error loading table '%s': %s", "Custom Service Response Times", err);
+        g_free(err);
+    }
+}
+
+void custom_srt_cleanup(void)
+{
+    GSList *list_item;
+
+    for (list_item = custom_srts; list_item != NULL; list_item = g_slist_next(list_item)) {
+        custom_srt_t *cst = (custom_srt_t *)list_item->data;
+        if (cst->requests != NULL)
+            g_hash_table_destroy(cst->requests);
+    }
+    g_slist_free(custom_srts);
+    custom_srts = NULL;
+}
+
 srt_stat_table*
 init_srt_table(const char *name, const char *short_name, GArray *srt_array, int num_procs, const char* proc_column_name,
                 const char *filter_string, void* table_specific_data)
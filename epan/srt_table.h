@@ -94,6 +94,13 @@ WS_DLL_PUBLIC int get_srt_max_tables(register_srt_t* srt);
  */
 WS_DLL_PUBLIC tap_packet_cb get_srt_packet_func(register_srt_t* srt);
 
+/** Get tap listener flags (TL_*) from SRT
+ *
+ * @param srt Registered SRT
+ * @return tap listener flags of SRT
+ */
+WS_DLL_PUBLIC guint get_srt_tap_flags(register_srt_t* srt);
+
 /** Set parameter data from SRT parsed from tap string. Data will be
  * freed on tap reset
  *
@@ -198,6 +205,12 @@ WS_DLL_PUBLIC void init_srt_table_row(srt_stat_table *rst, int proc_index, const
  */
 WS_DLL_PUBLIC void add_srt_table_data(srt_stat_table *rst, int proc_index, const nstime_t *req_time, packet_info *pinfo);
 
+/** Register the UAT-driven custom SRT tables.  Called by epan_init(). */
+extern void custom_srt_init(void);
+
+/** Free runtime state of the custom SRT tables.  Called by epan_cleanup(). */
+extern void custom_srt_cleanup(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -491,13 +491,13 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id, stat_node_dataty
         g_hash_table_insert(st->names,
                             node->name,
                             node);
+    }
 
-        g_ptr_array_add(st->parents,node);
+    /* every node gets an id so that callers can manipulate it again
+       without repeating the name lookup (stats_tree_manip_node_int_by_id) */
+    g_ptr_array_add(st->parents,node);
 
-        node->id = st->parents->len - 1;
-    } else {
-        node->id = -1;
-    }
+    node->id = st->parents->len - 1;
 
     if (parent_id >= 0 && parent_id < (int) st->parents->len ) {
         node->parent = (stat_node *)g_ptr_array_index(st->parents,parent_id);
@@ -640,32 +640,10 @@ update_burst_calc(stat_node *node, gint value)
     }
 }
 
-/*
- * Increases by delta the counter of the node whose name is given
- * if the node does not exist yet it's created (with counter=1)
- * using parent_name as parent node.
- * with_hash=TRUE to indicate that the created node will have a parent
- */
-int
-stats_tree_manip_node_int(manip_node_mode mode, stats_tree *st, const char *name,
-              int parent_id, gboolean with_hash, gint value)
+/* applies one of the manipulations to an already-located int node */
+static void
+stat_node_apply_int(stat_node *node, manip_node_mode mode, gint value)
 {
-    stat_node *node = NULL;
-    stat_node *parent = NULL;
-
-    g_assert( parent_id >= 0 && parent_id < (int) st->parents->len );
-
-    parent = (stat_node *)g_ptr_array_index(st->parents,parent_id);
-
-    if( parent->hash ) {
-        node = (stat_node *)g_hash_table_lookup(parent->hash,name);
-    } else {
-        node = (stat_node *)g_hash_table_lookup(st->names,name);
-    }
-
-    if ( node == NULL )
-        node = new_stat_node(st,name,parent_id,STAT_DT_INT,with_hash,with_hash);
-
     switch (mode) {
         case MN_INCREASE:
             node->counter += value;
@@ -695,6 +673,35 @@ stats_tree_manip_node_int(manip_node_mode mode, stats_tree *st, const char *name
             node->st_flags &= ~value;
             break;
     }
+}
+
+/*
+ * Increases by delta the counter of the node whose name is given
+ * if the node does not exist yet it's created (with counter=1)
+ * using parent_name as parent node.
+ * with_hash=TRUE to indicate that the created node will have a parent
+ */
+int
+stats_tree_manip_node_int(manip_node_mode mode, stats_tree *st, const char *name,
+              int parent_id, gboolean with_hash, gint value)
+{
+    stat_node *node = NULL;
+    stat_node *parent = NULL;
+
+    g_assert( parent_id >= 0 && parent_id < (int) st->parents->len );
+
+    parent = (stat_node *)g_ptr_array_index(st->parents,parent_id);
+
+    if( parent->hash ) {
+        node = (stat_node *)g_hash_table_lookup(parent->hash,name);
+    } else {
+        node = (stat_node *)g_hash_table_lookup(st->names,name);
+    }
+
+    if ( node == NULL )
+        node = new_stat_node(st,name,parent_id,STAT_DT_INT,with_hash,with_hash);
+
+    stat_node_apply_int(node, mode, value);
 
     if (node)
         return node->id;
@@ -703,32 +710,29 @@ stats_tree_manip_node_int(manip_node_mode mode, stats_tree *st, const char *name
 }
 
 /*
-* Increases by delta the counter of the node whose name is given
-* if the node does not exist yet it's created (with counter=1)
-* using parent_name as parent node.
-* with_hash=TRUE to indicate that the created node will have a parent
-*/
+ * Same manipulation on a node already known by id (as returned by a
+ * previous stats_tree_manip_node_int() or stats_tree_create_node()
+ * call), skipping the per-packet name lookup altogether.
+ */
 int
-stats_tree_manip_node_float(manip_node_mode mode, stats_tree *st, const char *name,
-    int parent_id, gboolean with_hash, gfloat value)
+stats_tree_manip_node_int_by_id(manip_node_mode mode, stats_tree *st,
+              int node_id, gint value)
 {
-    stat_node *node = NULL;
-    stat_node *parent = NULL;
+    stat_node *node;
 
-    g_assert(parent_id >= 0 && parent_id < (int)st->parents->len);
+    g_assert( node_id >= 0 && node_id < (int) st->parents->len );
 
-    parent = (stat_node *)g_ptr_array_index(st->parents, parent_id);
+    node = (stat_node *)g_ptr_array_index(st->parents,node_id);
 
-    if (parent->hash) {
-        node = (stat_node *)g_hash_table_lookup(parent->hash, name);
-    }
-    else {
-        node = (stat_node *)g_hash_table_lookup(st->names, name);
-    }
+    stat_node_apply_int(node, mode, value);
 
-    if (node == NULL)
-        node = new_stat_node(st, name, parent_id, STAT_DT_FLOAT, with_hash, with_hash);
+    return node->id;
+}
 
+/* applies one of the manipulations to an already-located float node */
+static void
+stat_node_apply_float(stat_node *node, manip_node_mode mode, gfloat value)
+{
     switch (mode) {
     case MN_AVERAGE:
         node->counter++;
@@ -749,6 +753,36 @@ stats_tree_manip_node_float(manip_node_mode mode, stats_tree *st, const char *na
         g_assert_not_reached();
         break;
     }
+}
+
+/*
+* Increases by delta the counter of the node whose name is given
+* if the node does not exist yet it's created (with counter=1)
+* using parent_name as parent node.
+* with_hash=TRUE to indicate that the created node will have a parent
+*/
+int
+stats_tree_manip_node_float(manip_node_mode mode, stats_tree *st, const char *name,
+    int parent_id, gboolean with_hash, gfloat value)
+{
+    stat_node *node = NULL;
+    stat_node *parent = NULL;
+
+    g_assert(parent_id >= 0 && parent_id < (int)st->parents->len);
+
+    parent = (stat_node *)g_ptr_array_index(st->parents, parent_id);
+
+    if (parent->hash) {
+        node = (stat_node *)g_hash_table_lookup(parent->hash, name);
+    }
+    else {
+        node = (stat_node *)g_hash_table_lookup(st->names, name);
+    }
+
+    if (node == NULL)
+        node = new_stat_node(st, name, parent_id, STAT_DT_FLOAT, with_hash, with_hash);
+
+    stat_node_apply_float(node, mode, value);
 
     if (node)
         return node->id;
@@ -756,6 +790,25 @@ stats_tree_manip_node_float(manip_node_mode mode, stats_tree *st, const char *na
         return -1;
 }
 
+/*
+* Same manipulation on a node already known by id, skipping the
+* per-packet name lookup altogether.
+*/
+int
+stats_tree_manip_node_float_by_id(manip_node_mode mode, stats_tree *st,
+    int node_id, gfloat value)
+{
+    stat_node *node;
+
+    g_assert(node_id >= 0 && node_id < (int)st->parents->len);
+
+    node = (stat_node *)g_ptr_array_index(st->parents, node_id);
+
+    stat_node_apply_float(node, mode, value);
+
+    return node->id;
+}
+
 extern char*
 stats_tree_get_abbr(const char *opt_arg)
 {
@@ -208,12 +208,34 @@ WS_DLL_PUBLIC int stats_tree_manip_node_float(manip_node_mode mode,
                                         gboolean with_children,
                                         gfloat value);
 
+/*
+ * Same manipulations on a node already known by id.  Every node
+ * (parents and leaves alike) gets an id when it is first created, and
+ * the manip functions above return it; keeping it around lets
+ * per-packet code skip the name hash lookup on subsequent packets.
+ */
+WS_DLL_PUBLIC int stats_tree_manip_node_int_by_id(manip_node_mode mode,
+                                        stats_tree *st,
+                                        int node_id,
+                                        gint value);
+
+WS_DLL_PUBLIC int stats_tree_manip_node_float_by_id(manip_node_mode mode,
+                                        stats_tree *st,
+                                        int node_id,
+                                        gfloat value);
+
 #define increase_stat_node(st,name,parent_id,with_children,value)       \
     (stats_tree_manip_node_int(MN_INCREASE,(st),(name),(parent_id),(with_children),(value)))
 
 #define tick_stat_node(st,name,parent_id,with_children)                 \
     (stats_tree_manip_node_int(MN_INCREASE,(st),(name),(parent_id),(with_children),1))
 
+#define increase_stat_node_by_id(st,node_id,value)                      \
+    (stats_tree_manip_node_int_by_id(MN_INCREASE,(st),(node_id),(value)))
+
+#define tick_stat_node_by_id(st,node_id)                                \
+    (stats_tree_manip_node_int_by_id(MN_INCREASE,(st),(node_id),1))
+
 #define set_stat_node(st,name,parent_id,with_children,value)            \
     (stats_tree_manip_node_int(MN_SET,(st),(name),(parent_id),(with_children),value))
 
@@ -1328,13 +1328,12 @@ xml_escape(const gchar *unescaped)
 
 /* Return the first occurrence of needle in haystack.
  * If not found, return NULL.
- * If either haystack or needle has 0 length, return NULL.
- * Algorithm copied from GNU's glibc 2.3.2 memmem() under LGPL 2.1+ */
+ * If either haystack or needle has 0 length, return NULL. */
 const guint8 *
 epan_memmem(const guint8 *haystack, guint haystack_len,
         const guint8 *needle, guint needle_len)
 {
-    const guint8 *begin;
+    const guint8 *begin = haystack;
     const guint8 *const last_possible = haystack + haystack_len - needle_len;
 
     if (needle_len == 0) {
@@ -1345,12 +1344,21 @@ epan_memmem(const guint8 *haystack, guint haystack_len,
         return NULL;
     }
 
-    for (begin = haystack ; begin <= last_possible; ++begin) {
-        if (begin[0] == needle[0] &&
-                !memcmp(&begin[1], needle + 1,
-                    needle_len - 1)) {
+    /* Let memchr() - typically a vectorized library routine - skip to
+     * each candidate position for the needle's first byte, and only
+     * then compare the rest.  This replaces the old byte-at-a-time
+     * scan, which tested every haystack position itself. */
+    while (begin <= last_possible) {
+        begin = (const guint8 *)memchr(begin, needle[0],
+                last_possible - begin + 1);
+        if (begin == NULL) {
+            return NULL;
+        }
+        if (needle_len == 1 ||
+                memcmp(begin + 1, needle + 1, needle_len - 1) == 0) {
             return begin;
         }
+        begin++;
     }
 
     return NULL;
@@ -11,6 +11,8 @@
 
 #include "config.h"
 
+#include <stdlib.h>
+
 #include "timestats.h"
 
 /* Initialize a timestat_t struct */
@@ -24,6 +26,7 @@ time_stat_init(timestat_t *stats)
 	nstime_set_zero(&stats->max);
 	nstime_set_zero(&stats->tot);
 	stats->variance = 0.0;
+	stats->rsv_rand = 0;
 }
 
 /* Update a timestat_t struct with a new sample */
@@ -53,9 +56,73 @@ time_stat_update(timestat_t *stats, const nstime_t *delta, packet_info *pinfo)
 
 	nstime_add(&stats->tot, delta);
 
+	/*
+	 * Reservoir sampling (algorithm R): the first
+	 * TIMESTAT_RESERVOIR_SIZE deltas fill the reservoir, after which
+	 * the i'th sample replaces a random slot with probability
+	 * size/i, keeping the reservoir a uniform sample of everything
+	 * seen.  A simple LCG is used instead of g_random_*() so that two
+	 * runs over the same capture report the same percentiles.
+	 */
+	if (stats->num < TIMESTAT_RESERVOIR_SIZE) {
+		stats->rsv[stats->num] = (gdouble)delta->secs*1000 +
+		    (gdouble)delta->nsecs/1000000;
+	} else {
+		guint32 slot;
+
+		stats->rsv_rand = stats->rsv_rand*1664525 + 1013904223;
+		slot = stats->rsv_rand % (stats->num + 1);
+		if (slot < TIMESTAT_RESERVOIR_SIZE) {
+			stats->rsv[slot] = (gdouble)delta->secs*1000 +
+			    (gdouble)delta->nsecs/1000000;
+		}
+	}
+
 	stats->num++;
 }
 
+static int
+compare_gdouble(const void *ap, const void *bp)
+{
+	const gdouble a = *(const gdouble *)ap, b = *(const gdouble *)bp;
+
+	if (a < b)
+		return -1;
+	if (a > b)
+		return 1;
+	return 0;
+}
+
+/*
+ * get_percentile - function
+ *
+ * function to estimate a percentile of the samples seen so far from the
+ * reservoir, time base is milli seconds.  The reservoir holds every
+ * sample until it fills up, so the result is exact for small sample
+ * counts and an estimate afterwards.
+ */
+gdouble get_percentile(timestat_t *stats, gdouble percentile)
+{
+	guint32 n = stats->num;
+	gdouble rank;
+	guint32 lo;
+
+	if(n == 0)
+		return 0.0;
+	if(n > TIMESTAT_RESERVOIR_SIZE)
+		n = TIMESTAT_RESERVOIR_SIZE;
+
+	/* The reservoir is an unordered sample; sorting it in place is
+	 * harmless. */
+	qsort(stats->rsv, n, sizeof stats->rsv[0], compare_gdouble);
+
+	rank = percentile*(n - 1);
+	lo = (guint32)rank;
+	if(lo + 1 < n)
+		return stats->rsv[lo] + (rank - lo)*(stats->rsv[lo+1] - stats->rsv[lo]);
+	return stats->rsv[n - 1];
+}
+
 /*
  * get_average - function
  *
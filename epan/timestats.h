@@ -20,6 +20,11 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* Number of samples kept for percentile estimates.  The reservoir keeps
+ * a uniform random sample of all deltas seen, so memory stays constant
+ * no matter how many samples a capture produces. */
+#define TIMESTAT_RESERVOIR_SIZE 256
+
  /* Summary of time statistics*/
 typedef struct _timestat_t {
 	guint32 num;	 /* number of samples */
@@ -29,6 +34,8 @@ typedef struct _timestat_t {
 	nstime_t max;
 	nstime_t tot;
 	gdouble variance;
+	guint32 rsv_rand; /* reservoir replacement PRNG state */
+	gdouble rsv[TIMESTAT_RESERVOIR_SIZE]; /* reservoir sample of the deltas, in ms */
 } timestat_t;
 
 /* functions */
@@ -41,6 +48,11 @@ WS_DLL_PUBLIC void time_stat_update(timestat_t *stats, const nstime_t *delta, pa
 
 WS_DLL_PUBLIC gdouble get_average(const nstime_t *sum, guint32 num);
 
+/* Estimate a percentile (e.g. 0.95) of the samples seen so far, in
+ * milliseconds, from the reservoir.  Exact while the number of samples
+ * fits in the reservoir; an estimate afterwards. */
+WS_DLL_PUBLIC gdouble get_percentile(timestat_t *stats, gdouble percentile);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
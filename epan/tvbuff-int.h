@@ -95,4 +95,21 @@ void tvb_add_to_chain(tvbuff_t *parent, tvbuff_t *child);
 guint tvb_offset_from_real_beginning_counter(const tvbuff_t *tvb, const guint counter);
 
 void tvb_check_offset_length(const tvbuff_t *tvb, const gint offset, gint const length_val, guint *offset_ptr, guint *length_ptr);
+
+/*
+ * Cache of recently uncompressed bodies, shared by the tvb_uncompress*()
+ * implementations in tvbuff_zlib.c, tvbuff_brotli.c and tvbuff_lz77.c.
+ * Codec tags keep equal byte sequences fed to different codecs apart.
+ */
+#define TVB_UNCOMPRESS_CODEC_ZLIB	1
+#define TVB_UNCOMPRESS_CODEC_BROTLI	2
+#define TVB_UNCOMPRESS_CODEC_LZ77	3
+
+/* Returns a fresh tvbuff with the cached uncompressed body, or NULL on
+ * a cache miss. */
+tvbuff_t *tvb_uncompress_cache_lookup(const int codec, const guint8 *compr,
+    const guint comprlen);
+
+void tvb_uncompress_cache_insert(const int codec, const guint8 *compr,
+    const guint comprlen, const guint8 *uncompr, const guint uncomprlen);
 #endif
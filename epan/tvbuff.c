@@ -1189,6 +1189,54 @@ tvb_get_gint64(tvbuff_t *tvb, const gint offset, const guint encoding) {
 	}
 }
 
+void
+tvb_get_fields(tvbuff_t *tvb, const gint offset, const guint encoding,
+    const guint8 *widths, const guint nfields, guint64 *values)
+{
+	const guint8 *ptr;
+	guint         total_length = 0;
+	guint         i;
+
+	DISSECTOR_ASSERT(widths != NULL && values != NULL);
+	for (i = 0; i < nfields; i++) {
+		DISSECTOR_ASSERT(widths[i] >= 1 && widths[i] <= 8);
+		total_length += widths[i];
+	}
+
+	/*
+	 * One bounds check for the whole run of fields; the per-field
+	 * decode below works on the returned raw pointer.
+	 */
+	ptr = ensure_contiguous(tvb, offset, total_length);
+
+	for (i = 0; i < nfields; i++) {
+		if (encoding & ENC_LITTLE_ENDIAN) {
+			switch (widths[i]) {
+			case 1: values[i] = *ptr;         break;
+			case 2: values[i] = pletoh16(ptr); break;
+			case 3: values[i] = pletoh24(ptr); break;
+			case 4: values[i] = pletoh32(ptr); break;
+			case 5: values[i] = pletoh40(ptr); break;
+			case 6: values[i] = pletoh48(ptr); break;
+			case 7: values[i] = pletoh56(ptr); break;
+			case 8: values[i] = pletoh64(ptr); break;
+			}
+		} else {
+			switch (widths[i]) {
+			case 1: values[i] = *ptr;         break;
+			case 2: values[i] = pntoh16(ptr); break;
+			case 3: values[i] = pntoh24(ptr); break;
+			case 4: values[i] = pntoh32(ptr); break;
+			case 5: values[i] = pntoh40(ptr); break;
+			case 6: values[i] = pntoh48(ptr); break;
+			case 7: values[i] = pntoh56(ptr); break;
+			case 8: values[i] = pntoh64(ptr); break;
+			}
+		}
+		ptr += widths[i];
+	}
+}
+
 gfloat
 tvb_get_ieee_float(tvbuff_t *tvb, const gint offset, const guint encoding) {
 	if (encoding & ENC_LITTLE_ENDIAN) {
@@ -4124,6 +4172,131 @@ tvb_get_varint(tvbuff_t *tvb, guint offset, guint maxlen, guint64 *value, const
 	return 0; /* 10 bytes scanned, but no bytes' msb is zero */
 }
 
+/*
+ * Cache of recently uncompressed bodies, shared by the tvb_uncompress*()
+ * implementations.  Redissection (a filter change, clicking a packet, a
+ * colorization pass) decompresses the same bodies over and over; in
+ * HTTP-heavy captures a sizable share of redissection time ends up in
+ * inflate().
+ *
+ * Entries are keyed by codec plus the compressed bytes themselves rather
+ * than by frame and offset, so a hit can never return stale data, nothing
+ * has to be invalidated when the capture file changes, and identical
+ * bodies repeated across frames share one entry.  The cache is a small
+ * LRU, bounded both in entries and in bytes.
+ */
+#define TVB_UNCOMPRESS_CACHE_MAX_ENTRIES 64
+#define TVB_UNCOMPRESS_CACHE_MAX_BYTES	 (16 * 1024 * 1024)
+
+typedef struct {
+	int	codec;
+	guint8 *compr;
+	guint	comprlen;
+	guint8 *uncompr;
+	guint	uncomprlen;
+} tvb_uncompress_cache_entry_t;
+
+static GQueue *tvb_uncompress_cache;	/* most recently used at the head */
+static guint   tvb_uncompress_cache_bytes;
+
+static void
+tvb_uncompress_cache_entry_free(tvb_uncompress_cache_entry_t *entry)
+{
+	tvb_uncompress_cache_bytes -= entry->comprlen + entry->uncomprlen;
+	g_free(entry->compr);
+	g_free(entry->uncompr);
+	g_free(entry);
+}
+
+tvbuff_t *
+tvb_uncompress_cache_lookup(const int codec, const guint8 *compr,
+    const guint comprlen)
+{
+	GList *elem;
+
+	if (!tvb_uncompress_cache)
+		return NULL;
+
+	for (elem = tvb_uncompress_cache->head; elem; elem = elem->next) {
+		tvb_uncompress_cache_entry_t *entry =
+		    (tvb_uncompress_cache_entry_t *)elem->data;
+		tvbuff_t *uncompr_tvb;
+		guint8	 *uncompr;
+
+		if (entry->codec != codec || entry->comprlen != comprlen ||
+		    memcmp(entry->compr, compr, comprlen) != 0)
+			continue;
+
+		/* Hit; move the entry to the head of the LRU. */
+		g_queue_unlink(tvb_uncompress_cache, elem);
+		g_queue_push_head_link(tvb_uncompress_cache, elem);
+
+		/*
+		 * Hand out a copy, not the cached buffer itself; the
+		 * returned tvbuff frees its data when it's freed.
+		 * An empty body needs a non-NULL pointer, as in
+		 * tvb_uncompress().
+		 */
+		uncompr = entry->uncomprlen != 0 ?
+		    (guint8 *)g_memdup(entry->uncompr, entry->uncomprlen) :
+		    (guint8 *)g_strdup("");
+		uncompr_tvb = tvb_new_real_data(uncompr, entry->uncomprlen,
+		    entry->uncomprlen);
+		tvb_set_free_cb(uncompr_tvb, g_free);
+		return uncompr_tvb;
+	}
+
+	return NULL;
+}
+
+void
+tvb_uncompress_cache_insert(const int codec, const guint8 *compr,
+    const guint comprlen, const guint8 *uncompr, const guint uncomprlen)
+{
+	tvb_uncompress_cache_entry_t *entry;
+
+	/* Don't let one huge body flush the whole cache. */
+	if (comprlen + uncomprlen > TVB_UNCOMPRESS_CACHE_MAX_BYTES / 4)
+		return;
+
+	if (!tvb_uncompress_cache)
+		tvb_uncompress_cache = g_queue_new();
+
+	entry		  = g_new(tvb_uncompress_cache_entry_t, 1);
+	entry->codec	  = codec;
+	entry->compr	  = (guint8 *)g_memdup(compr, comprlen);
+	entry->comprlen	  = comprlen;
+	entry->uncompr	  = uncomprlen != 0 ?
+	    (guint8 *)g_memdup(uncompr, uncomprlen) : NULL;
+	entry->uncomprlen = uncomprlen;
+
+	g_queue_push_head(tvb_uncompress_cache, entry);
+	tvb_uncompress_cache_bytes += comprlen + uncomprlen;
+
+	while (g_queue_get_length(tvb_uncompress_cache) >
+		TVB_UNCOMPRESS_CACHE_MAX_ENTRIES ||
+	    tvb_uncompress_cache_bytes > TVB_UNCOMPRESS_CACHE_MAX_BYTES) {
+		tvb_uncompress_cache_entry_free(
+		    (tvb_uncompress_cache_entry_t *)
+		    g_queue_pop_tail(tvb_uncompress_cache));
+	}
+}
+
+void
+tvb_uncompress_cache_cleanup(void)
+{
+	if (!tvb_uncompress_cache)
+		return;
+
+	while (!g_queue_is_empty(tvb_uncompress_cache)) {
+		tvb_uncompress_cache_entry_free(
+		    (tvb_uncompress_cache_entry_t *)
+		    g_queue_pop_tail(tvb_uncompress_cache));
+	}
+	g_queue_free(tvb_uncompress_cache);
+	tvb_uncompress_cache = NULL;
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
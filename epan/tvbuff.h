@@ -331,6 +331,27 @@ WS_DLL_PUBLIC gint64 tvb_get_gint64(tvbuff_t *tvb, const gint offset, const guin
 WS_DLL_PUBLIC gfloat tvb_get_ieee_float(tvbuff_t *tvb, const gint offset, const guint encoding);
 WS_DLL_PUBLIC gdouble tvb_get_ieee_double(tvbuff_t *tvb, const gint offset, const guint encoding);
 
+/** Fetch a run of back-to-back fixed-width integer fields with a single
+ * bounds check.  widths gives the size in octets (1 to 8) of each of the
+ * nfields fields, laid out contiguously starting at offset; the decoded
+ * (zero-extended) values are stored in values.  encoding is
+ * ENC_BIG_ENDIAN or ENC_LITTLE_ENDIAN and applies to every field.
+ *
+ * This is for fixed-layout headers, where fetching each field with its
+ * own tvb_get_*() accessor repeats the same validation per field, e.g.:
+ *
+ *     static const guint8 udp_widths[] = { 2, 2, 2, 2 };
+ *     guint64 udp_fields[4];
+ *
+ *     tvb_get_fields(tvb, offset, ENC_BIG_ENDIAN, udp_widths, 4,
+ *                    udp_fields);
+ *
+ * fetches the source port, destination port, length and checksum while
+ * checking the bounds of the 8-byte header only once. */
+WS_DLL_PUBLIC void tvb_get_fields(tvbuff_t *tvb, const gint offset,
+    const guint encoding, const guint8 *widths, const guint nfields,
+    guint64 *values);
+
 /*
  * Fetch 16-bit and 32-bit values in host byte order.
  * Used for some pseudo-headers in pcap/pcapng files, in which the
@@ -897,6 +918,12 @@ WS_DLL_PUBLIC const gchar *tvb_bcd_dig_to_wmem_packet_str(tvbuff_t *tvb,
 WS_DLL_PUBLIC gint tvb_find_tvb(tvbuff_t *haystack_tvb, tvbuff_t *needle_tvb,
     const gint haystack_offset);
 
+/**
+ * Free the cache of recently uncompressed bodies kept by the
+ * tvb_uncompress*() routines below.  Called by epan_cleanup().
+ */
+extern void tvb_uncompress_cache_cleanup(void);
+
 /* From tvbuff_zlib.c */
 
 /**
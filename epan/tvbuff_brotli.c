@@ -18,6 +18,7 @@
 #endif
 
 #include "tvbuff.h"
+#include "tvbuff-int.h"
 
 #ifdef HAVE_BROTLI
 
@@ -71,6 +72,13 @@ tvb_uncompress_brotli(tvbuff_t *tvb, const int offset, int comprlen)
         return NULL;
     }
 
+    uncompr_tvb = tvb_uncompress_cache_lookup(TVB_UNCOMPRESS_CODEC_BROTLI,
+        compr, comprlen);
+    if (uncompr_tvb != NULL) {
+        wmem_free(NULL, compr);
+        return uncompr_tvb;
+    }
+
     decoder = BrotliDecoderCreateInstance(
       &brotli_g_malloc_wrapper /*alloc_func*/,
       &brotli_g_free_wrapper /*free_func*/,
@@ -148,6 +156,8 @@ tvb_uncompress_brotli(tvbuff_t *tvb, const int offset, int comprlen)
 
     uncompr_tvb = tvb_new_real_data((guint8 *)uncompr, (guint)total_out, (gint)total_out);
     tvb_set_free_cb(uncompr_tvb, g_free);
+    tvb_uncompress_cache_insert(TVB_UNCOMPRESS_CODEC_BROTLI,
+        compr, comprlen, uncompr, (guint)total_out);
 
     g_free(strmbuf);
     wmem_free(NULL, compr);
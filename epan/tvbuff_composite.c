@@ -18,6 +18,12 @@
 typedef struct {
 	GSList		*tvbs;
 
+	/* Number of members, and the member list flattened into an array,
+	 * filled in by tvb_composite_finalize() so that the accessors
+	 * don't have to walk the list for every read. */
+	guint		 num_members;
+	tvbuff_t	**member_tvbs;
+
 	/* Used for quick testing to see if this
 	 * is the tvbuff that a COMPOSITE is
 	 * interested in. */
@@ -40,6 +46,7 @@ composite_free(tvbuff_t *tvb)
 
 	g_slist_free(composite->tvbs);
 
+	g_free(composite->member_tvbs);
 	g_free(composite->start_offsets);
 	g_free(composite->end_offsets);
 	if (tvb->real_data) {
@@ -56,30 +63,44 @@ composite_offset(const tvbuff_t *tvb _U_, const guint counter)
 	return counter;
 }
 
+/* Find the member containing abs_offset by binary search over the
+ * sorted end-offset array built by tvb_composite_finalize().  Returns
+ * the member's index, or num_members if abs_offset is past the last
+ * member. */
+static guint
+composite_find_member(const tvb_comp_t *composite, const guint abs_offset)
+{
+	guint lo = 0, hi = composite->num_members;
+
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+
+		if (abs_offset <= composite->end_offsets[mid])
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
 static const guint8*
 composite_get_ptr(tvbuff_t *tvb, guint abs_offset, guint abs_length)
 {
 	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
-	guint	    i, num_members;
+	guint	    i;
 	tvb_comp_t *composite;
 	tvbuff_t   *member_tvb = NULL;
 	guint	    member_offset;
-	GSList	   *slist;
 
 	/* DISSECTOR_ASSERT(tvb->ops == &tvb_composite_ops); */
 
 	/* Maybe the range specified by offset/length
 	 * is contiguous inside one of the member tvbuffs */
 	composite = &composite_tvb->composite;
-	num_members = g_slist_length(composite->tvbs);
 
-	for (i = 0; i < num_members; i++) {
-		if (abs_offset <= composite->end_offsets[i]) {
-			slist = g_slist_nth(composite->tvbs, i);
-			member_tvb = (tvbuff_t *)slist->data;
-			break;
-		}
-	}
+	i = composite_find_member(composite, abs_offset);
+	if (i < composite->num_members)
+		member_tvb = composite->member_tvbs[i];
 
 	/* special case */
 	if (!member_tvb) {
@@ -113,26 +134,20 @@ composite_memcpy(tvbuff_t *tvb, void* _target, guint abs_offset, guint abs_lengt
 	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
 	guint8 *target = (guint8 *) _target;
 
-	guint	    i, num_members;
+	guint	    i;
 	tvb_comp_t *composite;
 	tvbuff_t   *member_tvb = NULL;
 	guint	    member_offset, member_length;
-	GSList	   *slist;
 
 	/* DISSECTOR_ASSERT(tvb->ops == &tvb_composite_ops); */
 
 	/* Maybe the range specified by offset/length
 	 * is contiguous inside one of the member tvbuffs */
-	composite   = &composite_tvb->composite;
-	num_members = g_slist_length(composite->tvbs);
+	composite = &composite_tvb->composite;
 
-	for (i = 0; i < num_members; i++) {
-		if (abs_offset <= composite->end_offsets[i]) {
-			slist = g_slist_nth(composite->tvbs, i);
-			member_tvb = (tvbuff_t *)slist->data;
-			break;
-		}
-	}
+	i = composite_find_member(composite, abs_offset);
+	if (i < composite->num_members)
+		member_tvb = composite->member_tvbs[i];
 
 	/* special case */
 	if (!member_tvb) {
@@ -200,6 +215,8 @@ tvb_new_composite(void)
 	tvb_comp_t *composite = &composite_tvb->composite;
 
 	composite->tvbs		 = NULL;
+	composite->num_members	 = 0;
+	composite->member_tvbs	 = NULL;
 	composite->start_offsets = NULL;
 	composite->end_offsets	 = NULL;
 
@@ -267,12 +284,15 @@ tvb_composite_finalize(tvbuff_t *tvb)
 	 */
 	DISSECTOR_ASSERT(num_members);
 
+	composite->num_members = num_members;
+	composite->member_tvbs = g_new(tvbuff_t *, num_members);
 	composite->start_offsets = g_new(guint, num_members);
 	composite->end_offsets = g_new(guint, num_members);
 
 	for (slist = composite->tvbs; slist != NULL; slist = slist->next) {
 		DISSECTOR_ASSERT((guint) i < num_members);
 		member_tvb = (tvbuff_t *)slist->data;
+		composite->member_tvbs[i] = member_tvb;
 		composite->start_offsets[i] = tvb->length;
 		tvb->length += member_tvb->length;
 		tvb->reported_length += member_tvb->reported_length;
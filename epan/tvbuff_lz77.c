@@ -12,6 +12,7 @@
 #include <glib.h>
 #include <epan/exceptions.h>
 #include <epan/tvbuff.h>
+#include <epan/tvbuff-int.h>
 #include <epan/wmem/wmem.h>
 
 #define MAX_INPUT_SIZE (16*1024*1024) /* 16MB */
@@ -101,6 +102,19 @@ tvb_uncompress_lz77(tvbuff_t *tvb, const int offset, int in_size)
 	wmem_allocator_t *pool;
 	wmem_array_t *obuf;
 	tvbuff_t *out;
+	const guint8 *compr = NULL;
+
+	/*
+	 * The compressed bytes double as the cache key, so the cache is
+	 * only used when the whole input is available in the tvb.
+	 */
+	if (tvb && in_size > 0 && tvb_bytes_exist(tvb, offset, in_size)) {
+		compr = tvb_get_ptr(tvb, offset, in_size);
+		out = tvb_uncompress_cache_lookup(TVB_UNCOMPRESS_CODEC_LZ77,
+						  compr, (guint)in_size);
+		if (out)
+			return out;
+	}
 
 	pool = wmem_allocator_new(WMEM_ALLOCATOR_SIMPLE);
 	obuf = wmem_array_sized_new(pool, 1, in_size*2);
@@ -124,6 +138,10 @@ tvb_uncompress_lz77(tvbuff_t *tvb, const int offset, int in_size)
 		memcpy(p, wmem_array_get_raw(obuf), size);
 		out = tvb_new_real_data(p, size, size);
 		tvb_set_free_cb(out, g_free);
+		if (compr)
+			tvb_uncompress_cache_insert(TVB_UNCOMPRESS_CODEC_LZ77,
+						    compr, (guint)in_size,
+						    p, size);
 	} else {
 		out = NULL;
 	}
@@ -21,6 +21,7 @@
 #endif
 
 #include "tvbuff.h"
+#include "tvbuff-int.h"
 #ifdef TVB_Z_DEBUG
 #include <wsutil/ws_printf.h> /* ws_debug_printf */
 #endif
@@ -41,6 +42,7 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 {
 	gint       err;
 	guint      bytes_out      = 0;
+	guint      orig_comprlen;
 	guint8    *compr;
 	guint8    *uncompr        = NULL;
 	tvbuff_t  *uncompr_tvb    = NULL;
@@ -64,6 +66,16 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 		return NULL;
 	}
 
+	/* comprlen is adjusted below when a gzip header is skipped, so
+	 * remember the original length for the cache. */
+	orig_comprlen = comprlen;
+	uncompr_tvb = tvb_uncompress_cache_lookup(TVB_UNCOMPRESS_CODEC_ZLIB,
+	    compr, orig_comprlen);
+	if (uncompr_tvb != NULL) {
+		wmem_free(NULL, compr);
+		return uncompr_tvb;
+	}
+
 	/*
 	 * Assume that the uncompressed data is at least twice as big as
 	 * the compressed size.
@@ -312,6 +324,8 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 	if (uncompr != NULL) {
 		uncompr_tvb =  tvb_new_real_data(uncompr, bytes_out, bytes_out);
 		tvb_set_free_cb(uncompr_tvb, g_free);
+		tvb_uncompress_cache_insert(TVB_UNCOMPRESS_CODEC_ZLIB,
+		    compr, orig_comprlen, uncompr, bytes_out);
 	}
 	wmem_free(NULL, compr);
 	return uncompr_tvb;
@@ -490,6 +490,19 @@ void uat_unload_all(void) {
     }
 }
 
+gboolean uat_dissection_data_present(void) {
+    guint i;
+
+    for (i=0; i < all_uats->len; i++) {
+        uat_t* u = (uat_t *)g_ptr_array_index(all_uats,i);
+
+        if ((u->flags & UAT_AFFECTS_DISSECTION) &&
+            (u->changed || (u->raw_data && u->raw_data->len > 0)))
+            return TRUE;
+    }
+    return FALSE;
+}
+
 void uat_cleanup(void) {
     guint i;
     guint j;
@@ -359,6 +359,14 @@ WS_DLL_PUBLIC
 void uat_foreach_table(uat_cb_t cb,void* user_data);
 void uat_unload_all(void);
 
+/**
+ * Returns TRUE if any dissection-affecting UAT currently has records
+ * loaded or unsaved changes, i.e. if UAT data may have influenced the
+ * current dissection results.
+ */
+WS_DLL_PUBLIC
+gboolean uat_dissection_data_present(void);
+
 char* uat_undquote(const char* si, guint in_len, guint* len_p);
 char* uat_unbinstring(const char* si, guint in_len, guint* len_p);
 char* uat_unesc(const char* si, guint in_len, guint* len_p);
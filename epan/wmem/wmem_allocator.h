@@ -41,6 +41,13 @@ struct _wmem_allocator_t {
     void                        *private_data;
     enum _wmem_allocator_type_t  type;
     gboolean                     in_scope;
+
+    /* Allocation statistics, maintained by the wmem core. The byte counts
+     * are the sizes requested by callers; individual frees are not
+     * subtracted because their sizes are not known at this layer. */
+    gsize                        stats_bytes;       /* requested since creation or last free_all */
+    gsize                        stats_bytes_total; /* requested over the allocator's lifetime */
+    gsize                        stats_count_total; /* allocations over the allocator's lifetime */
 };
 
 #ifdef __cplusplus
@@ -1,4 +1,4 @@
-/* wmem_allocator_block.c
+/* wmem_allocator_block_fast.c
  * Wireshark Memory Manager Fast Large-Block Allocator
  *
  * Wireshark - Network traffic analyzer
@@ -41,6 +41,10 @@ wmem_alloc(wmem_allocator_t *allocator, const size_t size)
         return NULL;
     }
 
+    allocator->stats_bytes       += size;
+    allocator->stats_bytes_total += size;
+    allocator->stats_count_total += 1;
+
     return allocator->walloc(allocator->private_data, size);
 }
 
@@ -102,6 +106,7 @@ wmem_free_all_real(wmem_allocator_t *allocator, gboolean final)
     wmem_call_callbacks(allocator,
             final ? WMEM_CB_DESTROY_EVENT : WMEM_CB_FREE_EVENT);
     allocator->free_all(allocator->private_data);
+    allocator->stats_bytes = 0;
 }
 
 void
@@ -143,6 +148,10 @@ wmem_allocator_new(const wmem_allocator_type_t type)
     allocator->callbacks = NULL;
     allocator->in_scope  = TRUE;
 
+    allocator->stats_bytes       = 0;
+    allocator->stats_bytes_total = 0;
+    allocator->stats_count_total = 0;
+
     switch (real_type) {
         case WMEM_ALLOCATOR_SIMPLE:
             wmem_simple_allocator_init(allocator);
@@ -167,6 +176,21 @@ wmem_allocator_new(const wmem_allocator_type_t type)
     return allocator;
 }
 
+void
+wmem_allocator_get_stats(const wmem_allocator_t *allocator, gsize *cur_bytes,
+        gsize *total_bytes, gsize *total_count)
+{
+    if (cur_bytes) {
+        *cur_bytes = allocator->stats_bytes;
+    }
+    if (total_bytes) {
+        *total_bytes = allocator->stats_bytes_total;
+    }
+    if (total_count) {
+        *total_count = allocator->stats_count_total;
+    }
+}
+
 void
 wmem_init(void)
 {
@@ -188,6 +188,14 @@ wmem_destroy_allocator(wmem_allocator_t *allocator);
 /** Create a new allocator of the given type. The type may be overridden by the
  * WIRESHARK_DEBUG_WMEM_OVERRIDE environment variable.
  *
+ * Allocators are entirely self-contained; they share no state with each
+ * other, so different threads may each create and use their own pools
+ * without any locking, provided that any one pool is only ever used from
+ * a single thread at a time (or is synchronized externally). The memory
+ * backing a pool is requested from the system as the pool grows, so on
+ * NUMA machines the usual first-touch policy places it on the node of
+ * the thread doing the allocating.
+ *
  * @param type The type of allocator to create.
  * @return The new allocator.
  */
@@ -195,6 +203,24 @@ WS_DLL_PUBLIC
 wmem_allocator_t *
 wmem_allocator_new(const wmem_allocator_type_t type);
 
+/** Fetch the allocation statistics of the given pool. The byte counts are
+ * the sizes requested through wmem_alloc(); memory returned early with
+ * wmem_free() is not subtracted, so they are an upper bound on the pool's
+ * live payload (and exclude the allocators' own block overhead).
+ *
+ * @param allocator The allocator to fetch the statistics of.
+ * @param cur_bytes Set to the bytes requested since the pool was created or
+ * last had wmem_free_all() called on it. May be NULL.
+ * @param total_bytes Set to the bytes requested over the pool's lifetime.
+ * May be NULL.
+ * @param total_count Set to the number of allocations made over the pool's
+ * lifetime. May be NULL.
+ */
+WS_DLL_PUBLIC
+void
+wmem_allocator_get_stats(const wmem_allocator_t *allocator, gsize *cur_bytes,
+        gsize *total_bytes, gsize *total_count);
+
 /** Initialize the wmem subsystem. This must be called before any other wmem
  * function, usually at the very beginning of your program.
  */
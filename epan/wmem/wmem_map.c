@@ -18,7 +18,13 @@
 #include "wmem_map_int.h"
 #include "wmem_user_cb.h"
 
-static guint32 x; /* Used for universal integer hashing (see the HASH macro) */
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#include <emmintrin.h>
+#include <wsutil/bits_ctz.h>
+#define WMEM_MAP_USE_SSE2 1
+#endif
+
+static guint32 x; /* Used for universal integer hashing (see the SLOT macro) */
 
 /* Used for the wmem_strong_hash() function */
 static guint32 preseed;
@@ -35,10 +41,38 @@ wmem_init_hashing(void)
     postseed = g_random_int();
 }
 
+/*
+ * The table is open-addressed with robin-hood hashing: items live
+ * directly in the table array, in a contiguous run starting at their
+ * home slot, ordered such that no item is further from its home slot
+ * than the one it displaced.  Collisions are thus resolved by a
+ * linear scan of adjacent table entries - including the stored full
+ * hash, so most non-matches are rejected without calling eql_func -
+ * rather than by chasing a per-slot chain of separately-allocated
+ * items through the heap.
+ *
+ * An item's distance from its home slot, plus one, is stored in the
+ * item; zero means the slot is empty.  The robin-hood invariant lets
+ * both lookups and insertions stop as soon as they reach an item
+ * closer to its home than the sought key would be.
+ *
+ * Alongside the item array the map keeps one metadata byte per slot:
+ * zero for an empty slot, or the top seven bits of the item's hash
+ * with the high bit set.  Lookups scan the metadata a group of
+ * sixteen bytes at a time - with SSE2 compares where available - so a
+ * whole group of non-matching slots is rejected with a couple of
+ * vector instructions and without touching the item array at all.
+ * The first GROUP_SIZE - 1 metadata bytes are mirrored past the end
+ * of the array so a group load never has to wrap.
+ */
+#define WMEM_MAP_GROUP_SIZE 16
+
+#define META_OF(HASHVAL) ((guint8)(0x80 | ((HASHVAL) >> 25)))
 typedef struct _wmem_map_item_t {
+    guint32 hash;     /* full hash of the key */
+    guint32 distance; /* distance from home slot plus one; 0 if empty */
     const void *key;
     void *value;
-    struct _wmem_map_item_t *next;
 } wmem_map_item_t;
 
 struct _wmem_map_t {
@@ -50,7 +84,8 @@ struct _wmem_map_t {
      * logarithms is expensive. */
     size_t capacity;
 
-    wmem_map_item_t **table;
+    wmem_map_item_t *table;
+    guint8 *meta;    /* one byte per slot, plus the mirrored prefix */
 
     GHashFunc  hash_func;
     GEqualFunc eql_func;
@@ -70,18 +105,37 @@ struct _wmem_map_t {
  * do the 2^x operation. */
 #define CAPACITY(MAP) (((size_t)1) << (MAP)->capacity)
 
-/* Efficient universal integer hashing:
+/* Efficient universal integer hashing, mapping a full 32-bit hash to a
+ * home slot in the table:
  * https://en.wikipedia.org/wiki/Universal_hashing#Avoiding_modular_arithmetic
  */
-#define HASH(MAP, KEY) \
-    ((guint32)(((MAP)->hash_func(KEY) * x) >> (32 - (MAP)->capacity)))
+#define SLOT(MAP, HASHVAL) \
+    ((guint32)(((HASHVAL) * x) >> (32 - (MAP)->capacity)))
+
+/* Resize when the table is three-quarters full; open addressing
+ * degrades sharply as the load factor approaches one. */
+#define OVER_LOADED(MAP) \
+    (((size_t)(MAP)->count) * 4 >= CAPACITY(MAP) * 3)
+
+/* Set the metadata byte for a slot, keeping the mirrored prefix past
+ * the end of the array in sync. */
+static inline void
+wmem_map_meta_set(wmem_map_t *map, size_t slot, guint8 m)
+{
+    map->meta[slot] = m;
+    if (slot < WMEM_MAP_GROUP_SIZE - 1) {
+        map->meta[slot + CAPACITY(map)] = m;
+    }
+}
 
 static void
 wmem_map_init_table(wmem_map_t *map)
 {
     map->count     = 0;
     map->capacity  = WMEM_MAP_DEFAULT_CAPACITY;
-    map->table     = wmem_alloc0_array(map->allocator, wmem_map_item_t*, CAPACITY(map));
+    map->table     = wmem_alloc0_array(map->allocator, wmem_map_item_t, CAPACITY(map));
+    map->meta      = wmem_alloc0_array(map->allocator, guint8,
+            CAPACITY(map) + WMEM_MAP_GROUP_SIZE - 1);
 }
 
 wmem_map_t *
@@ -98,6 +152,7 @@ wmem_map_new(wmem_allocator_t *allocator,
     map->allocator = allocator;
     map->count = 0;
     map->table = NULL;
+    map->meta  = NULL;
 
     return map;
 }
@@ -110,6 +165,7 @@ wmem_map_reset_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event,
 
     map->count = 0;
     map->table = NULL;
+    map->meta  = NULL;
 
     if (event == WMEM_CB_DESTROY_EVENT) {
         wmem_unregister_callback(map->master, map->master_cb_id);
@@ -144,6 +200,7 @@ wmem_map_new_autoreset(wmem_allocator_t *master, wmem_allocator_t *slave,
     map->allocator = slave;
     map->count = 0;
     map->table = NULL;
+    map->meta  = NULL;
 
     map->master_cb_id = wmem_register_callback(master, wmem_map_destroy_cb, map);
     map->slave_cb_id  = wmem_register_callback(slave, wmem_map_reset_cb, map);
@@ -151,42 +208,72 @@ wmem_map_new_autoreset(wmem_allocator_t *master, wmem_allocator_t *slave,
     return map;
 }
 
+/* Place an item known not to be in the table already (so no equality
+ * checks are needed), stealing slots from closer-to-home items as the
+ * robin-hood invariant demands. */
+static void
+wmem_map_place(wmem_map_t *map, wmem_map_item_t item)
+{
+    guint32 slot = SLOT(map, item.hash);
+    wmem_map_item_t tmp;
+
+    item.distance = 1;
+    for (;;) {
+        if (map->table[slot].distance == 0) {
+            map->table[slot] = item;
+            wmem_map_meta_set(map, slot, META_OF(item.hash));
+            return;
+        }
+        if (map->table[slot].distance < item.distance) {
+            /* The resident is closer to home than we are; it won't
+             * get any further away, so displace it and carry it
+             * forward instead. */
+            tmp = map->table[slot];
+            map->table[slot] = item;
+            wmem_map_meta_set(map, slot, META_OF(item.hash));
+            item = tmp;
+        }
+        slot = (slot + 1) & (CAPACITY(map) - 1);
+        item.distance++;
+    }
+}
+
 static inline void
 wmem_map_grow(wmem_map_t *map)
 {
-    wmem_map_item_t **old_table, *cur, *nxt;
-    size_t            old_cap, i;
-    guint             slot;
+    wmem_map_item_t *old_table;
+    guint8          *old_meta;
+    size_t           old_cap, i;
 
     /* store the old table and capacity */
     old_table = map->table;
+    old_meta  = map->meta;
     old_cap   = CAPACITY(map);
 
     /* double the size (capacity is base-2 logarithm, so this just means
      * increment it) and allocate new table */
     map->capacity++;
-    map->table = wmem_alloc0_array(map->allocator, wmem_map_item_t*, CAPACITY(map));
+    map->table = wmem_alloc0_array(map->allocator, wmem_map_item_t, CAPACITY(map));
+    map->meta  = wmem_alloc0_array(map->allocator, guint8,
+            CAPACITY(map) + WMEM_MAP_GROUP_SIZE - 1);
 
     /* copy all the elements over from the old table */
     for (i=0; i<old_cap; i++) {
-        cur = old_table[i];
-        while (cur) {
-            nxt              = cur->next;
-            slot             = HASH(map, cur->key);
-            cur->next        = map->table[slot];
-            map->table[slot] = cur;
-            cur              = nxt;
+        if (old_table[i].distance != 0) {
+            wmem_map_place(map, old_table[i]);
         }
     }
 
     /* free the old table */
     wmem_free(map->allocator, old_table);
+    wmem_free(map->allocator, old_meta);
 }
 
 void *
 wmem_map_insert(wmem_map_t *map, const void *key, void *value)
 {
-    wmem_map_item_t **item;
+    wmem_map_item_t item;
+    guint32 slot;
     void *old_val;
 
     /* Make sure we have a table */
@@ -194,31 +281,46 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
         wmem_map_init_table(map);
     }
 
-    /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
-
-    /* check existing items in that slot */
-    while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
+    item.hash     = map->hash_func(key);
+    item.distance = 1;
+    item.key      = key;
+    item.value    = value;
+
+    slot = SLOT(map, item.hash);
+    for (;;) {
+        if (map->table[slot].distance == 0) {
+            /* empty slot; insert the new item */
+            map->table[slot] = item;
+            wmem_map_meta_set(map, slot, META_OF(item.hash));
+            break;
+        }
+        if (map->table[slot].hash == item.hash &&
+                map->eql_func(key, map->table[slot].key)) {
             /* replace and return old value for this key */
-            old_val = (*item)->value;
-            (*item)->value = value;
+            old_val = map->table[slot].value;
+            map->table[slot].value = value;
             return old_val;
         }
-        item = &((*item)->next);
+        if (map->table[slot].distance < item.distance) {
+            /* The sought key can't be past this point, or it would
+             * have displaced this closer-to-home resident; the new
+             * item takes this slot and the resident gets carried
+             * forward. */
+            wmem_map_item_t tmp = map->table[slot];
+
+            map->table[slot] = item;
+            wmem_map_meta_set(map, slot, META_OF(item.hash));
+            wmem_map_place(map, tmp);
+            break;
+        }
+        slot = (slot + 1) & (CAPACITY(map) - 1);
+        item.distance++;
     }
 
-    /* insert new item */
-    (*item) = wmem_new(map->allocator, wmem_map_item_t);
-
-    (*item)->key   = key;
-    (*item)->value = value;
-    (*item)->next  = NULL;
-
     map->count++;
 
     /* increase size if we are over-full */
-    if (map->count >= CAPACITY(map)) {
+    if (OVER_LOADED(map)) {
         wmem_map_grow(map);
     }
 
@@ -226,88 +328,135 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
     return NULL;
 }
 
+/* Find the slot holding the given key, or return the capacity of the
+ * table if it isn't present. */
+static size_t
+wmem_map_find_slot(wmem_map_t *map, const void *key)
+{
+    guint32 hash = map->hash_func(key);
+    guint32 slot = SLOT(map, hash);
+#ifdef WMEM_MAP_USE_SSE2
+    const __m128i target = _mm_set1_epi8((char)META_OF(hash));
+    const __m128i empty  = _mm_setzero_si128();
+
+    for (;;) {
+        __m128i group = _mm_loadu_si128((const __m128i *)(map->meta + slot));
+        guint32 match_mask =
+            (guint32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, target));
+        guint32 empty_mask =
+            (guint32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, empty));
+
+        if (empty_mask != 0) {
+            /* A run of items is contiguous, so any match past the
+             * first empty slot belongs to some other run; the sought
+             * key would have been placed in that empty slot. */
+            match_mask &= (((guint32)1) << ws_ctz(empty_mask)) - 1;
+        }
+        while (match_mask != 0) {
+            size_t s = (slot + ws_ctz(match_mask)) & (CAPACITY(map) - 1);
+
+            if (map->table[s].hash == hash &&
+                    map->eql_func(key, map->table[s].key)) {
+                return s;
+            }
+            match_mask &= match_mask - 1;
+        }
+        if (empty_mask != 0) {
+            return CAPACITY(map);
+        }
+        slot = (slot + WMEM_MAP_GROUP_SIZE) & (CAPACITY(map) - 1);
+    }
+#else
+    guint32 distance = 1;
+
+    while (map->table[slot].distance >= distance) {
+        if (map->table[slot].hash == hash &&
+                map->eql_func(key, map->table[slot].key)) {
+            return slot;
+        }
+        slot = (slot + 1) & (CAPACITY(map) - 1);
+        distance++;
+    }
+
+    /* an empty slot, or an item closer to its home than the sought
+     * key would be here; either way the key isn't present */
+    return CAPACITY(map);
+#endif
+}
+
 gboolean
 wmem_map_contains(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t *item;
-
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
     }
 
-    /* find correct slot */
-    item = map->table[HASH(map, key)];
-
-    /* scan list of items in this slot for the correct value */
-    while (item) {
-        if (map->eql_func(key, item->key)) {
-            return TRUE;
-        }
-        item = item->next;
-    }
-
-    return FALSE;
+    return wmem_map_find_slot(map, key) != CAPACITY(map);
 }
 
 void *
 wmem_map_lookup(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t *item;
+    size_t slot;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
         return NULL;
     }
 
-    /* find correct slot */
-    item = map->table[HASH(map, key)];
-
-    /* scan list of items in this slot for the correct value */
-    while (item) {
-        if (map->eql_func(key, item->key)) {
-            return item->value;
-        }
-        item = item->next;
+    slot = wmem_map_find_slot(map, key);
+    if (slot == CAPACITY(map)) {
+        return NULL;
     }
-
-    return NULL;
+    return map->table[slot].value;
 }
 
 gboolean
 wmem_map_lookup_extended(wmem_map_t *map, const void *key, const void **orig_key, void **value)
 {
-    wmem_map_item_t *item;
+    size_t slot;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
     }
 
-    /* find correct slot */
-    item = map->table[HASH(map, key)];
-
-    /* scan list of items in this slot for the correct value */
-    while (item) {
-        if (map->eql_func(key, item->key)) {
-            if (orig_key) {
-                *orig_key = item->key;
-            }
-            if (value) {
-                *value = item->value;
-            }
-            return TRUE;
-        }
-        item = item->next;
+    slot = wmem_map_find_slot(map, key);
+    if (slot == CAPACITY(map)) {
+        return FALSE;
+    }
+    if (orig_key) {
+        *orig_key = map->table[slot].key;
     }
+    if (value) {
+        *value = map->table[slot].value;
+    }
+    return TRUE;
+}
 
-    return FALSE;
+/* Empty the given slot and shift any displaced successors back one
+ * place, restoring the robin-hood invariant. */
+static void
+wmem_map_shift_back(wmem_map_t *map, size_t slot)
+{
+    size_t next = (slot + 1) & (CAPACITY(map) - 1);
+
+    while (map->table[next].distance > 1) {
+        map->table[slot] = map->table[next];
+        map->table[slot].distance--;
+        wmem_map_meta_set(map, slot, map->meta[next]);
+        slot = next;
+        next = (slot + 1) & (CAPACITY(map) - 1);
+    }
+    map->table[slot].distance = 0;
+    wmem_map_meta_set(map, slot, 0);
 }
 
 void *
 wmem_map_remove(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t **item, *tmp;
+    size_t slot;
     void *value;
 
     /* Make sure we have a table */
@@ -315,61 +464,43 @@ wmem_map_remove(wmem_map_t *map, const void *key)
         return NULL;
     }
 
-    /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
-
-    /* check the items in that slot */
-    while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
-            /* found it */
-            tmp     = (*item);
-            value   = tmp->value;
-            (*item) = tmp->next;
-            wmem_free(map->allocator, tmp);
-            map->count--;
-            return value;
-        }
-        item = &((*item)->next);
+    slot = wmem_map_find_slot(map, key);
+    if (slot == CAPACITY(map)) {
+        /* didn't find it */
+        return NULL;
     }
 
-    /* didn't find it */
-    return NULL;
+    value = map->table[slot].value;
+    wmem_map_shift_back(map, slot);
+    map->count--;
+    return value;
 }
 
 gboolean
 wmem_map_steal(wmem_map_t *map, const void *key)
 {
-    wmem_map_item_t **item, *tmp;
+    size_t slot;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
     }
 
-    /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
-
-    /* check the items in that slot */
-    while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
-            /* found it */
-            tmp     = (*item);
-            (*item) = tmp->next;
-            map->count--;
-            return TRUE;
-        }
-        item = &((*item)->next);
+    slot = wmem_map_find_slot(map, key);
+    if (slot == CAPACITY(map)) {
+        /* didn't find it */
+        return FALSE;
     }
 
-    /* didn't find it */
-    return FALSE;
+    wmem_map_shift_back(map, slot);
+    map->count--;
+    return TRUE;
 }
 
 wmem_list_t*
 wmem_map_get_keys(wmem_allocator_t *list_allocator, wmem_map_t *map)
 {
     size_t capacity, i;
-    wmem_map_item_t *cur;
     wmem_list_t* list = wmem_list_new(list_allocator);
 
     if (map->table != NULL) {
@@ -377,10 +508,8 @@ wmem_map_get_keys(wmem_allocator_t *list_allocator, wmem_map_t *map)
 
         /* copy all the elements into the list over from table */
         for (i=0; i<capacity; i++) {
-            cur = map->table[i];
-            while (cur) {
-                wmem_list_prepend(list, (void*)cur->key);
-                cur = cur->next;
+            if (map->table[i].distance != 0) {
+                wmem_list_prepend(list, (void*)map->table[i].key);
             }
         }
     }
@@ -391,8 +520,7 @@ wmem_map_get_keys(wmem_allocator_t *list_allocator, wmem_map_t *map)
 void
 wmem_map_foreach(wmem_map_t *map, GHFunc foreach_func, gpointer user_data)
 {
-    wmem_map_item_t *cur;
-    unsigned i;
+    size_t i;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -400,10 +528,9 @@ wmem_map_foreach(wmem_map_t *map, GHFunc foreach_func, gpointer user_data)
     }
 
     for (i = 0; i < CAPACITY(map); i++) {
-        cur = map->table[i];
-        while (cur) {
-            foreach_func((gpointer)cur->key, (gpointer)cur->value, user_data);
-            cur = cur->next;
+        if (map->table[i].distance != 0) {
+            foreach_func((gpointer)map->table[i].key,
+                         (gpointer)map->table[i].value, user_data);
         }
     }
 }
@@ -23,6 +23,14 @@
 
 #define DEFAULT_MINIMUM_LEN 16
 
+/* Strings no longer than this (including the null-terminator) are kept
+ * in storage inline in the wmem_strbuf_t itself, so building the
+ * overwhelmingly-common short column and label strings costs a single
+ * allocation for the header and no separate buffer traffic at all.
+ * 48 covers the large majority of generated labels while keeping the
+ * header comfortably inside a 128-byte allocator size class. */
+#define WMEM_STRBUF_INLINE_LEN 48
+
 /* Holds a wmem-allocated string-buffer.
  *  len is the length of the string (not counting the null-terminator) and
  *      should be the same as strlen(str) unless the string contains embedded
@@ -32,6 +40,8 @@
  *  max_len is the maximum permitted alloc_len (NOT the maximum permitted len,
  *      which must be one shorter than alloc_len to permit null-termination).
  *      When max_len is 0 (the default), no maximum is enforced.
+ *  str points at inline_str until the string outgrows it, and at a
+ *      separately-allocated buffer from then on.
  */
 struct _wmem_strbuf_t {
     wmem_allocator_t *allocator;
@@ -41,8 +51,12 @@ struct _wmem_strbuf_t {
     gsize len;
     gsize alloc_len;
     gsize max_len;
+
+    gchar inline_str[WMEM_STRBUF_INLINE_LEN];
 };
 
+#define WMEM_STRBUF_IS_INLINE(S) ((S)->str == (S)->inline_str)
+
 /* _ROOM accounts for the null-terminator, _RAW_ROOM does not.
  * Some functions need one, some functions need the other. */
 #define WMEM_STRBUF_ROOM(S) ((S)->alloc_len - (S)->len - 1)
@@ -63,7 +77,17 @@ wmem_strbuf_sized_new(wmem_allocator_t *allocator,
     strbuf->alloc_len = alloc_len ? alloc_len : DEFAULT_MINIMUM_LEN;
     strbuf->max_len   = max_len;
 
-    strbuf->str    = (gchar *)wmem_alloc(strbuf->allocator, strbuf->alloc_len);
+    if (strbuf->alloc_len <= WMEM_STRBUF_INLINE_LEN) {
+        /* Small enough to start in the inline storage; use all of it
+         * (up to max_len), since it's there either way. */
+        strbuf->str       = strbuf->inline_str;
+        strbuf->alloc_len = WMEM_STRBUF_INLINE_LEN;
+        if (strbuf->max_len && strbuf->max_len < strbuf->alloc_len) {
+            strbuf->alloc_len = strbuf->max_len;
+        }
+    } else {
+        strbuf->str = (gchar *)wmem_alloc(strbuf->allocator, strbuf->alloc_len);
+    }
     strbuf->str[0] = '\0';
 
     return strbuf;
@@ -107,6 +131,16 @@ wmem_strbuf_grow(wmem_strbuf_t *strbuf, const gsize to_add)
     }
 
     new_alloc_len = strbuf->alloc_len;
+    if (WMEM_STRBUF_IS_INLINE(strbuf)) {
+        /* First spill to a separate buffer: restart the doubling from a
+         * power of two, so the allocation sizes line up with the
+         * allocator's size classes instead of doubling the odd-sized
+         * inline capacity forever. */
+        new_alloc_len = DEFAULT_MINIMUM_LEN;
+        while (new_alloc_len < strbuf->alloc_len) {
+            new_alloc_len *= 2;
+        }
+    }
     new_len = strbuf->len + to_add;
 
     /* +1 for the null-terminator */
@@ -123,7 +157,13 @@ wmem_strbuf_grow(wmem_strbuf_t *strbuf, const gsize to_add)
         return;
     }
 
-    strbuf->str = (gchar *)wmem_realloc(strbuf->allocator, strbuf->str, new_alloc_len);
+    if (WMEM_STRBUF_IS_INLINE(strbuf)) {
+        /* The inline storage can't be realloc'd; copy out of it. */
+        strbuf->str = (gchar *)wmem_alloc(strbuf->allocator, new_alloc_len);
+        memcpy(strbuf->str, strbuf->inline_str, strbuf->len + 1);
+    } else {
+        strbuf->str = (gchar *)wmem_realloc(strbuf->allocator, strbuf->str, new_alloc_len);
+    }
 
     strbuf->alloc_len = new_alloc_len;
 }
@@ -146,6 +186,24 @@ wmem_strbuf_append(wmem_strbuf_t *strbuf, const gchar *str)
     strbuf->len = MIN(strbuf->len + append_len, strbuf->alloc_len - 1);
 }
 
+void
+wmem_strbuf_append_len(wmem_strbuf_t *strbuf, const gchar *str, gsize append_len)
+{
+    if (!append_len || !str) {
+        return;
+    }
+
+    wmem_strbuf_grow(strbuf, append_len);
+
+    if (append_len > WMEM_STRBUF_ROOM(strbuf)) {
+        append_len = WMEM_STRBUF_ROOM(strbuf);
+    }
+
+    memcpy(&strbuf->str[strbuf->len], str, append_len);
+    strbuf->len += append_len;
+    strbuf->str[strbuf->len] = '\0';
+}
+
 #ifndef _WIN32
 void
 wmem_strbuf_append_vprintf(wmem_strbuf_t *strbuf, const gchar *fmt, va_list ap)
@@ -273,7 +331,14 @@ wmem_strbuf_finalize(wmem_strbuf_t *strbuf)
 {
     char *ret;
 
-    ret = (char *)wmem_realloc(strbuf->allocator, strbuf->str, strbuf->len+1);
+    if (WMEM_STRBUF_IS_INLINE(strbuf)) {
+        /* The string lives in the header we're about to free; copy it out
+         * instead of realloc'ing it. */
+        ret = (char *)wmem_alloc(strbuf->allocator, strbuf->len+1);
+        memcpy(ret, strbuf->inline_str, strbuf->len+1);
+    } else {
+        ret = (char *)wmem_realloc(strbuf->allocator, strbuf->str, strbuf->len+1);
+    }
 
     wmem_free(strbuf->allocator, strbuf);
 
@@ -1104,6 +1104,10 @@ wmem_test_strbuf(void)
     g_assert_cmpstr(wmem_strbuf_get_str(strbuf), ==, "TESTFUZZ3aq\xC2\xA9");
     g_assert(wmem_strbuf_get_len(strbuf) == 13);
 
+    wmem_strbuf_append_len(strbuf, "bcdefg", 3);
+    g_assert_cmpstr(wmem_strbuf_get_str(strbuf), ==, "TESTFUZZ3aq\xC2\xA9" "bcd");
+    g_assert(wmem_strbuf_get_len(strbuf) == 16);
+
     wmem_strbuf_truncate(strbuf, 32);
     wmem_strbuf_truncate(strbuf, 24);
     wmem_strbuf_truncate(strbuf, 16);
@@ -1140,10 +1144,29 @@ wmem_test_strbuf(void)
     g_assert_cmpstr(wmem_strbuf_get_str(strbuf), ==, "FUZZ3abcd");
     g_assert(wmem_strbuf_get_len(strbuf) == 9);
 
+    wmem_strbuf_append_len(strbuf, "qrs", 3);
+    g_assert_cmpstr(wmem_strbuf_get_str(strbuf), ==, "FUZZ3abcd");
+    g_assert(wmem_strbuf_get_len(strbuf) == 9);
+
     str = wmem_strbuf_finalize(strbuf);
     g_assert_cmpstr(str, ==, "FUZZ3abcd");
     g_assert(strlen(str) == 9);
 
+    /* Short strings are stored inline in the strbuf itself; grow one
+     * character at a time well past that so we cross the spill point to
+     * a separate buffer, and check nothing is lost in the move. */
+    strbuf = wmem_strbuf_new(allocator, "");
+    for (i=0; i<64; i++) {
+        wmem_strbuf_append_c(strbuf, 'a' + (i % 26));
+        g_assert(wmem_strbuf_get_len(strbuf) == (gsize)(i + 1));
+        wmem_strict_check_canaries(allocator);
+    }
+    for (i=0; i<64; i++) {
+        g_assert(wmem_strbuf_get_str(strbuf)[i] == (char)('a' + (i % 26)));
+    }
+    str = wmem_strbuf_finalize(strbuf);
+    g_assert(strlen(str) == 64);
+
     wmem_free_all(allocator);
 
     strbuf = wmem_strbuf_new(allocator, "TEST");
@@ -1208,6 +1231,51 @@ wmem_test_tree(void)
     g_assert(wmem_tree_count(tree) == CONTAINER_ITERS);
     wmem_free_all(allocator);
 
+    /* test the radix variant against the same 32-bit key contract */
+    tree = wmem_tree_new_radix32(allocator);
+    g_assert(tree);
+    g_assert(wmem_tree_is_empty(tree));
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        g_assert(wmem_tree_lookup32(tree, i) == NULL);
+        if (i > 0) {
+            g_assert(wmem_tree_lookup32_le(tree, i) == GINT_TO_POINTER(i-1));
+        }
+        wmem_tree_insert32(tree, i, GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32(tree, i) == GINT_TO_POINTER(i));
+        g_assert(!wmem_tree_is_empty(tree));
+    }
+    g_assert(wmem_tree_count(tree) == CONTAINER_ITERS);
+    wmem_free_all(allocator);
+
+    tree = wmem_tree_new_radix32(allocator);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        guint32 rand_int;
+        do {
+            rand_int = g_test_rand_int();
+        } while (wmem_tree_lookup32(tree, rand_int));
+        wmem_tree_insert32(tree, rand_int, GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32(tree, rand_int) == GINT_TO_POINTER(i));
+    }
+    g_assert(wmem_tree_count(tree) == CONTAINER_ITERS);
+    wmem_free_all(allocator);
+
+    /* lookup32_le must find the predecessor across sparse radix keys,
+     * including around the top of the key space */
+    tree = wmem_tree_new_radix32(allocator);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        wmem_tree_insert32(tree, i * 1000, GINT_TO_POINTER(i));
+    }
+    wmem_tree_insert32(tree, 0xFFFFFF00, GINT_TO_POINTER(0xBEEF));
+    for (i=1; i<CONTAINER_ITERS; i++) {
+        g_assert(wmem_tree_lookup32_le(tree, i * 1000) == GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32_le(tree, (i * 1000) + 999) == GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32_le(tree, (i * 1000) - 1) == GINT_TO_POINTER(i-1));
+    }
+    g_assert(wmem_tree_lookup32_le(tree, 0xFFFFFFFF) == GINT_TO_POINTER(0xBEEF));
+    g_assert(wmem_tree_lookup32_le(tree, 0xFFFFFEFF) ==
+            GINT_TO_POINTER(CONTAINER_ITERS-1));
+    wmem_free_all(allocator);
+
     /* test auto-reset functionality */
     tree = wmem_tree_new_autoreset(allocator, extra_allocator);
     for (i=0; i<CONTAINER_ITERS; i++) {
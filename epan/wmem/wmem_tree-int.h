@@ -44,12 +44,18 @@ typedef struct _wmem_tree_node_t wmem_tree_node_t;
 
 typedef struct _wmem_itree_node_t wmem_itree_node_t;
 
+typedef enum _wmem_tree_type_t {
+    WMEM_TREE_TYPE_RED_BLACK,
+    WMEM_TREE_TYPE_RADIX32
+} wmem_tree_type_t;
+
 struct _wmem_tree_t {
     wmem_allocator_t *master;
     wmem_allocator_t *allocator;
     wmem_tree_node_t *root;
     guint             master_cb_id;
     guint             slave_cb_id;
+    wmem_tree_type_t  type;
 
     void (*post_rotation_cb)(wmem_tree_node_t *);
 };
@@ -233,6 +233,17 @@ wmem_tree_destroy_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event _U_,
     return FALSE;
 }
 
+wmem_tree_t *
+wmem_tree_new_radix32(wmem_allocator_t *allocator)
+{
+    wmem_tree_t *tree;
+
+    tree = wmem_tree_new(allocator);
+    tree->type = WMEM_TREE_TYPE_RADIX32;
+
+    return tree;
+}
+
 wmem_tree_t *
 wmem_tree_new_autoreset(wmem_allocator_t *master, wmem_allocator_t *slave)
 {
@@ -344,6 +355,165 @@ create_node(wmem_allocator_t *allocator, wmem_tree_node_t *parent, const void *k
 
 #define CREATE_DATA(TRANSFORM, DATA) ((TRANSFORM) ? (TRANSFORM)(DATA) : (DATA))
 
+/*
+ * The radix (WMEM_TREE_TYPE_RADIX32) variant stores 32-bit keys in a
+ * path-compressed binary trie (a crit-bit tree). Internal nodes carry a
+ * single-bit mask in their key field and always have exactly two children;
+ * the actual keys and data live in the leaves. Branching on the highest
+ * bit in which two keys differ keeps an in-order walk of the trie sorted,
+ * so the foreach, count, print and destroy code works unchanged. Internal
+ * nodes are flagged is_removed so the iteration callbacks never see them.
+ */
+
+#define RADIX_NODE_IS_LEAF(node) ((node)->left == NULL)
+
+static wmem_tree_node_t *
+radix_closest_leaf(wmem_tree_node_t *node, guint32 key)
+{
+    while (!RADIX_NODE_IS_LEAF(node)) {
+        node = (key & GPOINTER_TO_UINT(node->key)) ? node->right : node->left;
+    }
+    return node;
+}
+
+static wmem_tree_node_t *
+radix_rightmost_leaf(wmem_tree_node_t *node)
+{
+    while (!RADIX_NODE_IS_LEAF(node)) {
+        node = node->right;
+    }
+    return node;
+}
+
+static wmem_tree_node_t *
+radix_lookup_or_insert32_node(wmem_tree_t *tree, guint32 key,
+        void*(*func)(void*), void* data, gboolean is_subtree, gboolean replace)
+{
+    wmem_tree_node_t *node, *leaf, *inner, *new_node;
+    wmem_tree_node_t *parent = NULL;
+    guint32 mask;
+
+    /* is this the first node ?*/
+    if (!tree->root) {
+        new_node = create_node(tree->allocator, NULL, GUINT_TO_POINTER(key),
+                CREATE_DATA(func, data), WMEM_NODE_COLOR_BLACK, is_subtree);
+        tree->root = new_node;
+        return new_node;
+    }
+
+    /* the closest leaf shares the longest prefix of the key present in
+     * the trie */
+    leaf = radix_closest_leaf(tree->root, key);
+    if (key == GPOINTER_TO_UINT(leaf->key)) {
+        if (replace) {
+            leaf->data = CREATE_DATA(func, data);
+        }
+        return leaf;
+    }
+
+    /* branch on the highest bit in which the new key differs from the
+     * closest leaf; this is what keeps an in-order walk sorted */
+    mask = 1U << g_bit_nth_msf(key ^ GPOINTER_TO_UINT(leaf->key), -1);
+
+    /* masks shrink on the way down, so the new branch belongs just above
+     * the first node that no longer separates keys by a higher bit */
+    node = tree->root;
+    while (!RADIX_NODE_IS_LEAF(node) && GPOINTER_TO_UINT(node->key) > mask) {
+        parent = node;
+        node = (key & GPOINTER_TO_UINT(node->key)) ? node->right : node->left;
+    }
+
+    new_node = create_node(tree->allocator, NULL, GUINT_TO_POINTER(key),
+            CREATE_DATA(func, data), WMEM_NODE_COLOR_BLACK, is_subtree);
+    inner = create_node(tree->allocator, parent, GUINT_TO_POINTER(mask),
+            NULL, WMEM_NODE_COLOR_BLACK, FALSE);
+    inner->is_removed = TRUE;
+    if (key & mask) {
+        inner->left  = node;
+        inner->right = new_node;
+    }
+    else {
+        inner->left  = new_node;
+        inner->right = node;
+    }
+    node->parent     = inner;
+    new_node->parent = inner;
+    if (!parent) {
+        tree->root = inner;
+    }
+    else if (parent->left == node) {
+        parent->left = inner;
+    }
+    else {
+        parent->right = inner;
+    }
+
+    return new_node;
+}
+
+static void *
+radix_lookup32(wmem_tree_t *tree, guint32 key)
+{
+    wmem_tree_node_t *leaf;
+
+    if (!tree->root) {
+        return NULL;
+    }
+
+    leaf = radix_closest_leaf(tree->root, key);
+    if (key == GPOINTER_TO_UINT(leaf->key)) {
+        return leaf->data;
+    }
+    return NULL;
+}
+
+static void *
+radix_lookup32_le(wmem_tree_t *tree, guint32 key)
+{
+    wmem_tree_node_t *node, *leaf;
+    wmem_tree_node_t *best = NULL;
+    guint32 mask;
+
+    if (!tree->root) {
+        return NULL;
+    }
+
+    leaf = radix_closest_leaf(tree->root, key);
+    if (key == GPOINTER_TO_UINT(leaf->key)) {
+        return leaf->data;
+    }
+
+    /* highest bit in which the closest leaf differs from the key; no node
+     * visited on the way to it branches on that bit or the trie would
+     * have steered us to a leaf that agrees with the key there */
+    mask = 1U << g_bit_nth_msf(key ^ GPOINTER_TO_UINT(leaf->key), -1);
+
+    node = tree->root;
+    while (!RADIX_NODE_IS_LEAF(node) && GPOINTER_TO_UINT(node->key) > mask) {
+        if (key & GPOINTER_TO_UINT(node->key)) {
+            /* everything to the left of the path is smaller than the key */
+            best = node->left;
+            node = node->right;
+        }
+        else {
+            node = node->left;
+        }
+    }
+
+    /* every key below node agrees with the search key above the critical
+     * bit and sits on the closest leaf's side of it */
+    if (key & mask) {
+        /* those keys have a zero in the critical bit, so all of them are
+         * smaller than the search key and the largest one wins */
+        return radix_rightmost_leaf(node)->data;
+    }
+    /* those keys have a one in the critical bit, so all of them are too
+     * big; the best candidate is the largest subtree passed on the left */
+    if (best) {
+        return radix_rightmost_leaf(best)->data;
+    }
+    return NULL;
+}
 
 /**
  * return inserted node
@@ -355,6 +525,11 @@ lookup_or_insert32_node(wmem_tree_t *tree, guint32 key,
     wmem_tree_node_t *node     = tree->root;
     wmem_tree_node_t *new_node = NULL;
 
+    if (tree->type == WMEM_TREE_TYPE_RADIX32) {
+        return radix_lookup_or_insert32_node(tree, key, func, data,
+                is_subtree, replace);
+    }
+
     /* is this the first node ?*/
     if (!node) {
         new_node = create_node(tree->allocator, NULL, GUINT_TO_POINTER(key),
@@ -505,6 +680,10 @@ wmem_tree_lookup32(wmem_tree_t *tree, guint32 key)
 {
     wmem_tree_node_t *node = tree->root;
 
+    if (tree->type == WMEM_TREE_TYPE_RADIX32) {
+        return radix_lookup32(tree, key);
+    }
+
     while (node) {
         if (key == GPOINTER_TO_UINT(node->key)) {
             return node->data;
@@ -525,6 +704,10 @@ wmem_tree_lookup32_le(wmem_tree_t *tree, guint32 key)
 {
     wmem_tree_node_t *node = tree->root;
 
+    if (tree->type == WMEM_TREE_TYPE_RADIX32) {
+        return radix_lookup32_le(tree, key);
+    }
+
     while (node) {
         if (key == GPOINTER_TO_UINT(node->key)) {
             return node->data;
@@ -43,6 +43,21 @@ wmem_tree_t *
 wmem_tree_new(wmem_allocator_t *allocator)
 G_GNUC_MALLOC;
 
+/** Creates a tree that stores its nodes in a path-compressed binary radix
+ * trie instead of a red-black tree. Lookups and insertions examine one node
+ * per differing key bit and never rebalance, which makes this variant cheaper
+ * than the default for trees that see one lookup per packet, such as
+ * sequence-number keyed state.
+ *
+ * Only the 32-bit key functions (wmem_tree_insert32(), wmem_tree_lookup32(),
+ * wmem_tree_lookup32_le(), wmem_tree_remove32()) and the generic iteration
+ * functions may be used with such a tree; the string and compare-function
+ * based interfaces must not be. */
+WS_DLL_PUBLIC
+wmem_tree_t *
+wmem_tree_new_radix32(wmem_allocator_t *allocator)
+G_GNUC_MALLOC;
+
 /** Creates a tree with two allocator scopes. The base structure lives in the
  * master scope, however the data lives in the slave scope. Every time free_all
  * occurs in the slave scope the tree is transparently emptied without affecting
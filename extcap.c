@@ -52,6 +52,9 @@
 
 static void extcap_child_watch_cb(GPid pid, gint status, gpointer user_data);
 
+/* File in the profile directory caching the interface discovery results. */
+#define EXTCAP_CACHE_FILENAME   "extcap.cache"
+
 /* internal container, for all the extcap executables that have been found.
  * Will be reset if extcap_clear_interfaces() is being explicitly called
  * and is being used for printing information about all extcap interfaces found,
@@ -168,6 +171,12 @@ extcap_clear_interfaces(void)
     if ( _tool_for_ifname )
         g_hash_table_destroy(_tool_for_ifname);
     _tool_for_ifname = NULL;
+
+    /* An explicit refresh must re-run discovery, as extcaps may report
+     * different interfaces without the executables themselves changing. */
+    gchar *cache_path = get_persconffile_path(EXTCAP_CACHE_FILENAME, FALSE);
+    ws_unlink(cache_path);
+    g_free(cache_path);
 }
 
 static gint
@@ -389,6 +398,235 @@ extcap_free_extcaps_info_array(extcap_run_extcaps_info_t *infos, guint count)
     g_free(infos);
 }
 
+/*
+ * Running every extcap program just to find out what interfaces it offers
+ * dominates startup time, so the output of the last discovery pass is cached
+ * in the profile directory. Each cached program is keyed by the modification
+ * time and size of its executable, and the cache is only used when it still
+ * describes exactly the set of executables found on disk; any mismatch falls
+ * back to a full discovery pass. A manual interface refresh deletes the cache
+ * (see extcap_clear_interfaces()), as extcaps such as androiddump report
+ * whatever devices happen to be attached, which no file check can detect.
+ */
+#define EXTCAP_CACHE_FORMAT     1
+
+/* Appends "<output length> <name>\n<output>\n" to the cache contents, with a
+ * length of -1 (and no output line) if the program produced no output. */
+static void
+extcap_cache_append(GString *contents, const gchar *name, const gchar *output)
+{
+    if (output) {
+        gsize output_len = strlen(output);
+        g_string_append_printf(contents, "%" G_GSIZE_FORMAT " %s\n", output_len, name);
+        g_string_append_len(contents, output, (gssize)output_len);
+        g_string_append_c(contents, '\n');
+    } else {
+        g_string_append_printf(contents, "-1 %s\n", name);
+    }
+}
+
+static void
+extcap_cache_save(const extcap_run_extcaps_info_t *infos, guint count, const char *arg_version)
+{
+    GString *contents;
+    gchar *cache_path;
+
+    if (count == 0) {
+        return;
+    }
+
+    contents = g_string_new(NULL);
+    g_string_append_printf(contents, "extcap-cache %d %s\n", EXTCAP_CACHE_FORMAT, arg_version);
+    for (guint i = 0; i < count; i++) {
+        ws_statb64 sb;
+        if (ws_stat64(infos[i].extcap_path, &sb) != 0) {
+            /* The executable vanished mid-discovery; better no cache than one
+             * that cannot be validated on the next startup. */
+            g_string_free(contents, TRUE);
+            return;
+        }
+        g_string_append_printf(contents, "extcap %" G_GINT64_FORMAT " %" G_GINT64_FORMAT " %u ",
+                (gint64)sb.st_mtime, (gint64)sb.st_size, infos[i].num_interfaces);
+        extcap_cache_append(contents, infos[i].extcap_path, infos[i].output);
+        for (guint j = 0; j < infos[i].num_interfaces; j++) {
+            g_string_append(contents, "iface ");
+            extcap_cache_append(contents, infos[i].iface_infos[j].ifname, infos[i].iface_infos[j].output);
+        }
+    }
+
+    cache_path = get_persconffile_path(EXTCAP_CACHE_FILENAME, FALSE);
+    g_file_set_contents(cache_path, contents->str, (gssize)contents->len, NULL);
+    g_free(cache_path);
+    g_string_free(contents, TRUE);
+}
+
+/* Reads a whitespace-terminated decimal field, advancing the cursor past it.
+ * Returns FALSE if the cursor does not point at a number. */
+static gboolean
+extcap_cache_read_number(const gchar **p, gint64 *value)
+{
+    gchar *numend;
+
+    *value = g_ascii_strtoll(*p, &numend, 10);
+    if (numend == *p) {
+        return FALSE;
+    }
+    if (*numend == ' ') {
+        numend++;
+    }
+    *p = numend;
+    return TRUE;
+}
+
+/* Reads the rest of the current line, advancing the cursor past the newline. */
+static gchar *
+extcap_cache_read_line(const gchar **p, const gchar *end)
+{
+    const gchar *eol = (const gchar *)memchr(*p, '\n', end - *p);
+    gchar *line;
+
+    if (!eol) {
+        return NULL;
+    }
+    line = g_strndup(*p, eol - *p);
+    *p = eol + 1;
+    return line;
+}
+
+/* Reads a byte-counted output blob as written by extcap_cache_append().
+ * Returns FALSE if the blob runs past the end of the cache contents. */
+static gboolean
+extcap_cache_read_blob(const gchar **p, const gchar *end, gint64 len, gchar **output)
+{
+    if (len < 0) {
+        *output = NULL;
+        return TRUE;
+    }
+    if (len + 1 > end - *p || (*p)[len] != '\n') {
+        return FALSE;
+    }
+    *output = g_strndup(*p, (gsize)len);
+    *p = *p + len + 1;
+    return TRUE;
+}
+
+/* Loads the cached discovery results, in the same shape extcap_run_all()
+ * returns them, or NULL if there is no cache or it no longer matches the
+ * extcap executables on disk. */
+static extcap_run_extcaps_info_t *
+extcap_cache_load(const char *arg_version, guint *count)
+{
+    gchar *cache_path = get_persconffile_path(EXTCAP_CACHE_FILENAME, FALSE);
+    gchar *contents = NULL;
+    gsize length = 0;
+    gboolean ok;
+    gboolean valid = TRUE;
+    gchar *header;
+    gsize header_len;
+    GArray *records;
+    extcap_run_extcaps_info_t *infos;
+
+    *count = 0;
+    ok = g_file_get_contents(cache_path, &contents, &length, NULL);
+    g_free(cache_path);
+    if (!ok) {
+        return NULL;
+    }
+
+    const gchar *p = contents;
+    const gchar *end = contents + length;
+
+    /* The Wireshark version is part of the header, so an upgrade (which
+     * changes the --extcap-version argument) invalidates the cache. */
+    header = g_strdup_printf("extcap-cache %d %s\n", EXTCAP_CACHE_FORMAT, arg_version);
+    header_len = strlen(header);
+    if (length < header_len || memcmp(p, header, header_len) != 0) {
+        valid = FALSE;
+    } else {
+        p += header_len;
+    }
+    g_free(header);
+
+    records = g_array_new(FALSE, TRUE, sizeof(extcap_run_extcaps_info_t));
+    while (valid && p < end) {
+        extcap_run_extcaps_info_t info;
+        ws_statb64 sb;
+        gint64 mtime, size, num_interfaces, output_len;
+
+        memset(&info, 0, sizeof(info));
+        valid = (end - p) > 7 && memcmp(p, "extcap ", 7) == 0;
+        if (valid) {
+            p += 7;
+            valid = extcap_cache_read_number(&p, &mtime) &&
+                    extcap_cache_read_number(&p, &size) &&
+                    extcap_cache_read_number(&p, &num_interfaces) &&
+                    extcap_cache_read_number(&p, &output_len) &&
+                    num_interfaces >= 0 && num_interfaces <= (end - p) &&
+                    (info.extcap_path = extcap_cache_read_line(&p, end)) != NULL &&
+                    extcap_cache_read_blob(&p, end, output_len, &info.output);
+        }
+        /* The executable must be unchanged since the cache was written. */
+        if (valid) {
+            valid = ws_stat64(info.extcap_path, &sb) == 0 &&
+                    (gint64)sb.st_mtime == mtime && (gint64)sb.st_size == size;
+        }
+        if (valid && num_interfaces > 0) {
+            info.iface_infos = g_new0(extcap_iface_info_t, (gsize)num_interfaces);
+            for (gint64 j = 0; valid && j < num_interfaces; j++) {
+                extcap_iface_info_t *iface_info = &info.iface_infos[j];
+                valid = (end - p) > 6 && memcmp(p, "iface ", 6) == 0;
+                if (valid) {
+                    p += 6;
+                    valid = extcap_cache_read_number(&p, &output_len) &&
+                            (iface_info->ifname = extcap_cache_read_line(&p, end)) != NULL &&
+                            extcap_cache_read_blob(&p, end, output_len, &iface_info->output);
+                }
+            }
+            info.num_interfaces = (guint)num_interfaces;
+        }
+        if (!valid) {
+            /* Free the partial record; complete ones are freed below. */
+            for (guint j = 0; j < info.num_interfaces; j++) {
+                g_free(info.iface_infos[j].ifname);
+                g_free(info.iface_infos[j].output);
+            }
+            g_free(info.iface_infos);
+            g_free(info.output);
+            g_free(info.extcap_path);
+            break;
+        }
+        g_array_append_val(records, info);
+    }
+
+    /* The cache must describe exactly the executables present right now; a
+     * new or removed extcap forces a fresh discovery pass. */
+    if (valid) {
+        GHashTable *cached = g_hash_table_new(g_str_hash, g_str_equal);
+        GSList *paths = extcap_get_extcap_paths();
+
+        for (guint i = 0; i < records->len; i++) {
+            g_hash_table_add(cached, g_array_index(records, extcap_run_extcaps_info_t, i).extcap_path);
+        }
+        valid = g_hash_table_size(cached) == records->len &&
+                g_slist_length(paths) == records->len;
+        for (GSList *path = paths; valid && path; path = path->next) {
+            valid = g_hash_table_contains(cached, path->data);
+        }
+        g_slist_free_full(paths, g_free);
+        g_hash_table_destroy(cached);
+    }
+
+    *count = records->len;
+    infos = (extcap_run_extcaps_info_t *)g_array_free(records, FALSE);
+    g_free(contents);
+    if (!valid || *count == 0) {
+        extcap_free_extcaps_info_array(infos, *count);
+        *count = 0;
+        return NULL;
+    }
+    return infos;
+}
+
 static void
 extcap_run_one(const extcap_interface *interface, GList *arguments, extcap_cb_t cb, void *user_data, char **err_str)
 {
@@ -2034,9 +2272,13 @@ extcap_load_interface_list(void)
             arg_version,
             NULL
         };
-        infos = (extcap_run_extcaps_info_t *)extcap_run_all(argv,
-                extcap_list_interfaces_cb, sizeof(extcap_run_extcaps_info_t),
-                &count);
+        infos = extcap_cache_load(arg_version, &count);
+        if (infos == NULL) {
+            infos = (extcap_run_extcaps_info_t *)extcap_run_all(argv,
+                    extcap_list_interfaces_cb, sizeof(extcap_run_extcaps_info_t),
+                    &count);
+            extcap_cache_save(infos, count, arg_version);
+        }
         for (guint i = 0; i < count; i++) {
             if (!infos[i].output) {
                 continue;
@@ -24,6 +24,7 @@
 #include <version_info.h>
 
 #include <wiretap/merge.h>
+#include <wiretap/wtap_index.h>
 
 #include <epan/exceptions.h>
 #include <epan/epan.h>
@@ -476,6 +477,39 @@ calc_progbar_val(capture_file *cf, gint64 size, gint64 file_pos, gchar *status_s
   return progbar_val;
 }
 
+/* Bounds for the number of work units (frames or records) processed
+   between progress and cancellation checks in the loops below. */
+#define PROGBAR_QUANTUM_MIN     1
+#define PROGBAR_QUANTUM_MAX 65536
+
+/*
+ * Adapt the number of work units processed between progress checks so
+ * the checks land roughly once per PROGBAR_UPDATE_INTERVAL.  A fixed
+ * batch size is wrong at both ends: with cheap work units the check
+ * overhead (a file-position lookup and timer reads) shows up in
+ * profiles, and with expensive ones (a heavy display filter, deep
+ * dissection) a large batch keeps the UI from pumping events - and so
+ * from delivering a Stop click - for many seconds.  Call this each
+ * time a check fires, with a timer measuring the span since the
+ * previous check; it grows the quantum while checks come too fast and
+ * shrinks it toward a single work unit when they come too slowly, and
+ * restarts the timer for the next span.
+ */
+static guint32
+progbar_adjust_quantum(guint32 quantum, GTimer *quantum_timer)
+{
+  gdouble elapsed = g_timer_elapsed(quantum_timer, NULL);
+
+  if (elapsed < PROGBAR_UPDATE_INTERVAL / 4) {
+    if (quantum < PROGBAR_QUANTUM_MAX)
+      quantum *= 2;
+  } else if (elapsed > PROGBAR_UPDATE_INTERVAL && quantum > PROGBAR_QUANTUM_MIN) {
+    quantum /= 2;
+  }
+  g_timer_start(quantum_timer);
+  return quantum;
+}
+
 cf_read_status_t
 cf_read(capture_file *cf, gboolean reloading)
 {
@@ -484,6 +518,7 @@ cf_read(capture_file *cf, gboolean reloading)
   gchar               *name_ptr;
   progdlg_t           *volatile progbar = NULL;
   GTimer              *prog_timer = g_timer_new();
+  GTimer              *quantum_timer = g_timer_new();
   gint64               size;
   gint64               start_time;
   epan_dissect_t       edt;
@@ -495,6 +530,7 @@ cf_read(capture_file *cf, gboolean reloading)
   guint                tap_flags;
   gboolean             compiled;
   volatile gboolean    is_read_aborted = FALSE;
+  wtap_rec_index_t    *rec_idx = NULL;
 
   /* The update_progress_dlg call below might end up accepting a user request to
    * trigger redissection/rescans which can modify/destroy the dissection
@@ -562,13 +598,32 @@ cf_read(capture_file *cf, gboolean reloading)
   /* Find the size of the file. */
   size = wtap_file_size(cf->provider.wth, NULL);
 
+  /* If we've read this file before, a sidecar index tells us how many
+     records it holds, so pre-size the frame table; if not, build an
+     index as we read, so the next open of this file can.  Temporary
+     files are still being written to, so don't index those. */
+  if (!cf->is_tempfile) {
+    wtap_rec_index_t *loaded_idx = wtap_rec_index_load(cf->filename);
+
+    if (loaded_idx != NULL) {
+      frame_data_sequence_reserve(cf->provider.frames,
+                                  wtap_rec_index_count(loaded_idx));
+      wtap_rec_index_free(loaded_idx);
+    } else {
+      rec_idx = wtap_rec_index_new();
+    }
+  }
+
   g_timer_start(prog_timer);
+  g_timer_start(quantum_timer);
 
   wtap_rec_init(&rec);
   ws_buffer_init(&buf, 1514);
 
   TRY {
     int     count             = 0;
+    guint32 quantum           = PROGBAR_QUANTUM_MIN;
+    int     next_check        = PROGBAR_QUANTUM_MIN;
 
     gint64  file_pos;
     gint64  data_offset;
@@ -580,40 +635,52 @@ cf_read(capture_file *cf, gboolean reloading)
             &data_offset))) {
       if (size >= 0) {
         count++;
-        file_pos = wtap_read_so_far(cf->provider.wth);
-
-        /* Create the progress bar if necessary. */
-        if (progress_is_slow(progbar, prog_timer, size, file_pos)) {
-          progbar_val = calc_progbar_val(cf, size, file_pos, status_str, sizeof(status_str));
-          if (reloading)
-            progbar = delayed_create_progress_dlg(cf->window, "Reloading", name_ptr,
-                TRUE, &cf->stop_flag, progbar_val);
-          else
-            progbar = delayed_create_progress_dlg(cf->window, "Loading", name_ptr,
-                TRUE, &cf->stop_flag, progbar_val);
-        }
+        /* The progress checks below cost a file-position lookup and a
+           couple of timer reads per record, which adds up over a
+           multi-million-record file, so batch them.  The batch size
+           adapts to how fast records are being processed: cheap
+           records grow it until the checks stay off the profile,
+           expensive ones shrink it back toward a single record so the
+           stop button reacts within about one update interval rather
+           than after a fixed-size batch of slow dissections. */
+        if (count >= next_check) {
+          quantum = progbar_adjust_quantum(quantum, quantum_timer);
+          next_check = count + quantum;
+          file_pos = wtap_read_so_far(cf->provider.wth);
+
+          /* Create the progress bar if necessary. */
+          if (progress_is_slow(progbar, prog_timer, size, file_pos)) {
+            progbar_val = calc_progbar_val(cf, size, file_pos, status_str, sizeof(status_str));
+            if (reloading)
+              progbar = delayed_create_progress_dlg(cf->window, "Reloading", name_ptr,
+                  TRUE, &cf->stop_flag, progbar_val);
+            else
+              progbar = delayed_create_progress_dlg(cf->window, "Loading", name_ptr,
+                  TRUE, &cf->stop_flag, progbar_val);
+          }
 
-        /*
-         * Update the progress bar, but do it only after
-         * PROGBAR_UPDATE_INTERVAL has elapsed. Calling update_progress_dlg
-         * and packets_bar_update will likely trigger UI paint events, which
-         * might take a while depending on the platform and display. Reset
-         * our timer *after* painting.
-         */
-        if (progbar && g_timer_elapsed(prog_timer, NULL) > PROGBAR_UPDATE_INTERVAL) {
-          progbar_val = calc_progbar_val(cf, size, file_pos, status_str, sizeof(status_str));
-          /* update the packet bar content on the first run or frequently on very large files */
-          update_progress_dlg(progbar, progbar_val, status_str);
-          compute_elapsed(cf, start_time);
-          packets_bar_update();
-          g_timer_start(prog_timer);
+          /*
+           * Update the progress bar, but do it only after
+           * PROGBAR_UPDATE_INTERVAL has elapsed. Calling update_progress_dlg
+           * and packets_bar_update will likely trigger UI paint events, which
+           * might take a while depending on the platform and display. Reset
+           * our timer *after* painting.
+           */
+          if (progbar && g_timer_elapsed(prog_timer, NULL) > PROGBAR_UPDATE_INTERVAL) {
+            progbar_val = calc_progbar_val(cf, size, file_pos, status_str, sizeof(status_str));
+            /* update the packet bar content on the first run or frequently on very large files */
+            update_progress_dlg(progbar, progbar_val, status_str);
+            compute_elapsed(cf, start_time);
+            packets_bar_update();
+            g_timer_start(prog_timer);
+          }
+          /*
+           * The previous GUI triggers should not have destroyed the running
+           * session. If that did happen, it could blow up when read_record tries
+           * to use the destroyed edt.session, so detect it right here.
+           */
+          g_assert(edt.session == cf->epan);
         }
-        /*
-         * The previous GUI triggers should not have destroyed the running
-         * session. If that did happen, it could blow up when read_record tries
-         * to use the destroyed edt.session, so detect it right here.
-         */
-        g_assert(edt.session == cf->epan);
       }
 
       if (cf->state == FILE_READ_ABORTED) {
@@ -632,6 +699,16 @@ cf_read(capture_file *cf, gboolean reloading)
            hours even on fast machines) just to see that it was the wrong file. */
         break;
       }
+      if (cf->count == G_MAXUINT32) {
+        /* One more frame would wrap the 32-bit frame number; stop here
+           and keep what has been loaded.  See the note on frame_data.num
+           for why frame numbers are not simply widened. */
+        g_warning("File \"%s\" has more than %u frames; stopping at the frame number limit.",
+                  cf->filename, G_MAXUINT32);
+        break;
+      }
+      if (rec_idx != NULL)
+        wtap_rec_index_add(rec_idx, data_offset, &rec);
       read_record(cf, &rec, &buf, dfcode, &edt, cinfo, data_offset);
     }
   }
@@ -656,6 +733,7 @@ cf_read(capture_file *cf, gboolean reloading)
   if (progbar != NULL)
     destroy_progress_dlg(progbar);
   g_timer_destroy(prog_timer);
+  g_timer_destroy(quantum_timer);
 
   /* Free the display name */
   g_free(name_ptr);
@@ -670,6 +748,16 @@ cf_read(capture_file *cf, gboolean reloading)
   /* Close the sequential I/O side, to free up memory it requires. */
   wtap_sequential_close(cf->provider.wth);
 
+  /* If we built an index and read the whole file, save it for the next
+     open of this file; a failed save just means no cache. */
+  if (rec_idx != NULL) {
+    int idx_err;
+
+    if (!is_read_aborted && !cf->stop_flag && err == 0)
+      wtap_rec_index_save(rec_idx, cf->filename, &idx_err);
+    wtap_rec_index_free(rec_idx);
+  }
+
   /* Allow the protocol dissectors to free up memory that they
    * don't need after the sequential run-through of the packets. */
   postseq_cleanup_all_protocols();
@@ -774,6 +862,16 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
    *
    *    a postdissector wants field values or protocols on
    *    the first pass.
+   *
+   * Note that this is already the minimum amount of work we can do per
+   * arriving frame.  Column text is not generated here - the packet list
+   * fills its columns lazily, for rows that become visible - and cinfo
+   * below stays null unless a tap listener demands columns.  What can't
+   * be skipped or deferred, even for frames that will scroll straight
+   * past the tail view, is the first-pass dissection itself: it builds
+   * the conversation, desegmentation and per-protocol state that the
+   * dissection of every later frame depends on, so it has to see each
+   * frame once, in order.
    */
   create_proto_tree =
     (dfcode != NULL || have_filtering_tap_listeners() ||
@@ -940,6 +1038,13 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err)
          aren't any packets left to read) exit. */
       break;
     }
+    if (cf->count == G_MAXUINT32) {
+      /* One more frame would wrap the 32-bit frame number; stop
+         appending.  The capture child keeps writing to the file. */
+      g_warning("Live capture reached %u frames; not appending any more.",
+                G_MAXUINT32);
+      break;
+    }
     read_record(cf, rec, buf, dfcode, &edt, cinfo, data_offset);
   }
 
@@ -1451,11 +1556,41 @@ cf_merge_files_to_tempfile(gpointer pd_window, char **out_filenamep,
     return CF_OK;
 }
 
+/* Check whether a new display filter is the old one with an "and"
+   clause appended.  Whatever subexpression the appended clause binds
+   to, it adds a conjunct to it, so a frame that failed the old filter
+   can't pass the new one; the frames that passed the old filter are
+   the only candidates a rescan has to look at. */
+static gboolean
+dfilter_is_refinement(const char *filter_new, const char *filter_old)
+{
+  size_t old_len = strlen(filter_old);
+
+  if (old_len == 0)
+    return FALSE;
+  if (strncmp(filter_new, filter_old, old_len) != 0)
+    return FALSE;
+  filter_new += old_len;
+  /* Don't let the comparison above split a token. */
+  if (*filter_new != ' ' && *filter_new != '\t' && *filter_new != '&')
+    return FALSE;
+  while (*filter_new == ' ' || *filter_new == '\t')
+    filter_new++;
+  if (filter_new[0] == '&' && filter_new[1] == '&')
+    return TRUE;
+  if (strncmp(filter_new, "and", 3) == 0 &&
+      (filter_new[3] == ' ' || filter_new[3] == '\t' || filter_new[3] == '('))
+    return TRUE;
+  return FALSE;
+}
+
 cf_status_t
 cf_filter_packets(capture_file *cf, gchar *dftext, gboolean force)
 {
   const char *filter_new = dftext ? dftext : "";
   const char *filter_old = cf->dfilter ? cf->dfilter : "";
+  gboolean    refinement;
+  gboolean    redissect;
   dfilter_t  *dfcode;
   gchar      *err_msg;
 
@@ -1495,23 +1630,45 @@ cf_filter_packets(capture_file *cf, gchar *dftext, gboolean force)
     }
   }
 
+  refinement = dfilter_is_refinement(filter_new, filter_old);
+  /* A queued rescan hasn't evaluated the current filter yet, so the
+     per-frame results still reflect an older one; the new filter is
+     only a refinement of those results if the pending one was, too. */
+  if (cf->redissection_queued != RESCAN_NONE)
+    refinement = refinement && cf->dfilter_refinement;
+  cf->dfilter_refinement = refinement;
+
   /* We have a valid filter.  Replace the current filter. */
   g_free(cf->dfilter);
   cf->dfilter = dftext;
 
 
+  /* If the new filter references fields of a postdissector that was
+   * skipped because nothing wanted its fields so far, the state built
+   * during the previous dissection doesn't include its results; a full
+   * redissection is needed so that it runs this time.
+   */
+  redissect = FALSE;
+  if (dfcode != NULL) {
+    const int *fields;
+    int num_fields;
+
+    fields = dfilter_interesting_fields(dfcode, &num_fields);
+    redissect = postdissectors_skipped_for_hfids(fields, (guint)num_fields);
+  }
+
   /* Now rescan the packet list, applying the new filter, but not
    * throwing away information constructed on a previous pass.
    * If a dissection is already in progress, queue it.
    */
   if (cf->redissection_queued == RESCAN_NONE) {
     if (cf->read_lock) {
-      cf->redissection_queued = RESCAN_SCAN;
+      cf->redissection_queued = redissect ? RESCAN_REDISSECT : RESCAN_SCAN;
     } else if (cf->state != FILE_CLOSED) {
       if (dftext == NULL) {
         rescan_packets(cf, "Resetting", "Filter", FALSE);
       } else {
-        rescan_packets(cf, "Filtering", dftext, FALSE);
+        rescan_packets(cf, "Filtering", dftext, redissect);
       }
     }
   }
@@ -1592,7 +1749,10 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   Buffer      buf;
   progdlg_t  *progbar = NULL;
   GTimer     *prog_timer = g_timer_new();
+  GTimer     *quantum_timer = g_timer_new();
+  guint32     quantum;
   int         count;
+  int         next_check;
   frame_data *selected_frame, *preceding_frame, *following_frame, *prev_frame;
   int         selected_frame_num, preceding_frame_num, following_frame_num, prev_frame_num;
   gboolean    selected_frame_seen;
@@ -1606,6 +1766,7 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   guint       tap_flags;
   gboolean    add_to_packet_list = FALSE;
   gboolean    compiled;
+  gboolean    refinement;
   guint32     frames_count;
   gboolean    queued_rescan_type = RESCAN_NONE;
 
@@ -1648,6 +1809,15 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
      (tap_flags & TL_REQUIRES_PROTO_TREE) ||
      (redissect && postdissectors_want_hfids()));
 
+  /* If the new filter only narrows the previous one, the frames that
+     passed the previous filter are the only candidates, and the rest
+     can be skipped without re-dissecting them.  We can't take that
+     shortcut if the frames have to be redissected anyway, or if tap
+     listeners have to be fed every frame. */
+  refinement = cf->dfilter_refinement && dfcode != NULL && !redissect &&
+    !tap_listeners_require_dissection();
+  cf->dfilter_refinement = FALSE;
+
   reset_tap_listeners();
   /* Which frame, if any, is the currently selected frame?
      XXX - should the selected frame or the focus frame be the "current"
@@ -1713,8 +1883,12 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   cf_callback_invoke(cf_cb_file_rescan_started, cf);
 
   g_timer_start(prog_timer);
+  g_timer_start(quantum_timer);
   /* Count of packets at which we've looked. */
   count = 0;
+  /* Packets between progress checks; adapts to the per-packet cost. */
+  quantum = PROGBAR_QUANTUM_MIN;
+  next_check = 0;
   /* Progress so far. */
   progbar_val = 0.0f;
 
@@ -1751,36 +1925,42 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   for (framenum = 1; framenum <= frames_count; framenum++) {
     fdata = frame_data_sequence_find(cf->provider.frames, framenum);
 
-    /* Create the progress bar if necessary.
-       We check on every iteration of the loop, so that it takes no
-       longer than the standard time to create it (otherwise, for a
-       large file, we might take considerably longer than that standard
-       time in order to get to the next progress bar step). */
-    if (progbar == NULL)
-      progbar = delayed_create_progress_dlg(cf->window, action, action_item, TRUE,
-                                            &cf->stop_flag,
-                                            progbar_val);
+    /* Perform the progress checks in adaptively sized batches, so that
+       the timer reads stay cheap on dense captures of trivially
+       dissected frames while an expensive filter still gets a check -
+       and so a chance to pump UI events and see a Stop click - every
+       update interval or so. */
+    if (count >= next_check) {
+      quantum = progbar_adjust_quantum(quantum, quantum_timer);
+      next_check = count + quantum;
 
-    /*
-     * Update the progress bar, but do it only after PROGBAR_UPDATE_INTERVAL
-     * has elapsed. Calling update_progress_dlg and packets_bar_update will
-     * likely trigger UI paint events, which might take a while depending on
-     * the platform and display. Reset our timer *after* painting.
-     */
-    if (g_timer_elapsed(prog_timer, NULL) > PROGBAR_UPDATE_INTERVAL) {
-      /* let's not divide by zero. I should never be started
-       * with count == 0, so let's assert that
+      /* Create the progress bar if necessary. */
+      if (progbar == NULL)
+        progbar = delayed_create_progress_dlg(cf->window, action, action_item, TRUE,
+                                              &cf->stop_flag,
+                                              progbar_val);
+
+      /*
+       * Update the progress bar, but do it only after PROGBAR_UPDATE_INTERVAL
+       * has elapsed. Calling update_progress_dlg and packets_bar_update will
+       * likely trigger UI paint events, which might take a while depending on
+       * the platform and display. Reset our timer *after* painting.
        */
-      g_assert(cf->count > 0);
-      progbar_val = (gfloat) count / frames_count;
+      if (g_timer_elapsed(prog_timer, NULL) > PROGBAR_UPDATE_INTERVAL) {
+        /* let's not divide by zero. I should never be started
+         * with count == 0, so let's assert that
+         */
+        g_assert(cf->count > 0);
+        progbar_val = (gfloat) count / frames_count;
 
-      if (progbar != NULL) {
-        g_snprintf(status_str, sizeof(status_str),
-                  "%4u of %u frames", count, frames_count);
-        update_progress_dlg(progbar, progbar_val, status_str);
-      }
+        if (progbar != NULL) {
+          g_snprintf(status_str, sizeof(status_str),
+                    "%4u of %u frames", count, frames_count);
+          update_progress_dlg(progbar, progbar_val, status_str);
+        }
 
-      g_timer_start(prog_timer);
+        g_timer_start(prog_timer);
+      }
     }
 
     queued_rescan_type = cf->redissection_queued;
@@ -1820,6 +2000,24 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
     /* Frame dependencies from the previous dissection/filtering are no longer valid. */
     fdata->dependent_of_displayed = 0;
 
+    if (refinement && !fdata->passed_dfilter && !fdata->ref_time) {
+      /* This frame failed the previous filter, so it can't pass the
+         refined one; keep the bookkeeping the dissection loop would
+         have done, but don't re-read or re-dissect the frame. */
+      if (prev_frame_num != -1 && !selected_frame_seen && prev_frame->passed_dfilter) {
+        preceding_frame_num = prev_frame_num;
+        preceding_frame = prev_frame;
+      }
+      frame_data_set_before_dissect(fdata, &cf->elapsed_time,
+                                    &cf->provider.ref, cf->provider.prev_dis);
+      cf->provider.prev_cap = fdata;
+      if (fdata == selected_frame)
+        selected_frame_seen = TRUE;
+      prev_frame_num = fdata->num;
+      prev_frame = fdata;
+      continue;
+    }
+
     if (!cf_read_record(cf, fdata, &rec, &buf))
       break; /* error reading the frame */
 
@@ -1884,6 +2082,7 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   if (progbar != NULL)
     destroy_progress_dlg(progbar);
   g_timer_destroy(prog_timer);
+  g_timer_destroy(quantum_timer);
 
   /* Unfreeze the packet list. */
   if (!add_to_packet_list)
@@ -2277,6 +2476,86 @@ cf_retap_packets(capture_file *cf)
   return CF_READ_OK;
 }
 
+cf_read_status_t
+cf_retap_frames(capture_file *cf, const guint32 *frames, guint num_frames)
+{
+  retap_callback_args_t callback_args;
+  gboolean              create_proto_tree;
+  guint                 tap_flags;
+  wtap_rec              rec;
+  Buffer                buf;
+  frame_data           *fdata;
+  guint                 i;
+  cf_read_status_t      ret = CF_READ_OK;
+
+  /* Presumably the user closed the capture file. */
+  if (cf == NULL) {
+    return CF_READ_ABORTED;
+  }
+
+  if (cf->read_lock) {
+    g_warning("Failing due to nested cf_retap_frames(\"%s\") call!", cf->filename);
+    return CF_READ_ERROR;
+  }
+  cf->read_lock = TRUE;
+
+  cf_callback_invoke(cf_cb_file_retap_started, cf);
+
+  /* Get the union of the flags for all tap listeners. */
+  tap_flags = union_of_tap_listener_flags();
+
+  /* If any tap listeners require the columns, construct them. */
+  callback_args.cinfo = (tap_flags & TL_REQUIRES_COLUMNS) ? &cf->cinfo : NULL;
+
+  /*
+   * Determine whether we need to create a protocol tree, as we do
+   * for cf_retap_packets().
+   */
+  create_proto_tree =
+    (have_filtering_tap_listeners() || (tap_flags & TL_REQUIRES_PROTO_TREE));
+
+  /* Reset the tap listeners. */
+  reset_tap_listeners();
+
+  epan_dissect_init(&callback_args.edt, cf->epan, create_proto_tree, FALSE);
+
+  wtap_rec_init(&rec);
+  ws_buffer_init(&buf, 1514);
+
+  /* Iterate through the listed frames, dissecting them and re-running
+     the taps. */
+  cf->stop_flag = FALSE;
+  for (i = 0; i < num_frames; i++) {
+    if (cf->stop_flag) {
+      ret = CF_READ_ABORTED;
+      break;
+    }
+    fdata = frame_data_sequence_find(cf->provider.frames, frames[i]);
+    if (fdata == NULL)
+      continue;
+    if (!cf_read_record(cf, fdata, &rec, &buf)) {
+      ret = CF_READ_ERROR;
+      break;
+    }
+    if (!retap_packet(cf, fdata, &rec, &buf, &callback_args)) {
+      ret = CF_READ_ERROR;
+      break;
+    }
+  }
+
+  wtap_rec_cleanup(&rec);
+  ws_buffer_free(&buf);
+
+  epan_dissect_cleanup(&callback_args.edt);
+
+  g_assert(cf->read_lock);
+  cf->read_lock = FALSE;
+
+  cf_callback_invoke(cf_cb_file_retap_finished, cf);
+
+  return ret;
+}
+
 typedef struct {
   print_args_t *print_args;
   gboolean      print_header_line;
@@ -3257,6 +3536,40 @@ cf_find_packet_data(capture_file *cf, const guint8 *string, size_t string_size,
     return find_packet(cf, match_binary, &info, dir);
 }
 
+/*
+ * Search the frame data for the given byte sequence, using memchr to
+ * locate candidate positions for its first byte.  The C library
+ * typically vectorizes memchr and memcmp, so this is considerably
+ * faster than walking the frame byte by byte, which matters when a
+ * search has to visit most of a large capture.
+ */
+static match_result
+scan_bytes(capture_file *cf, const guint8 *pd, guint32 buf_len,
+           const guint8 *needle, size_t needle_len)
+{
+  const guint8 *p = pd;
+  const guint8 *end;
+
+  if (needle_len == 0 || needle_len > buf_len)
+    return MR_NOTMATCHED;
+
+  end = pd + buf_len - needle_len + 1;
+  while (p < end) {
+    p = (const guint8 *)memchr(p, needle[0], end - p);
+    if (p == NULL)
+      return MR_NOTMATCHED;
+    if (memcmp(p, needle, needle_len) == 0) {
+      cf->search_pos = (guint32)(p - pd) + (guint32)needle_len - 1;
+                          /* Save the position of the last character
+                             for highlighting the field. */
+      cf->search_len = (guint32)needle_len;
+      return MR_MATCHED;
+    }
+    p++;
+  }
+  return MR_NOTMATCHED;
+}
+
 static match_result
 match_narrow_and_wide(capture_file *cf, frame_data *fdata,
                       wtap_rec *rec, Buffer *buf, void *criterion)
@@ -3327,14 +3640,17 @@ match_narrow(capture_file *cf, frame_data *fdata,
     return MR_ERROR;
   }
 
-  result = MR_NOTMATCHED;
   buf_len = fdata->cap_len;
   pd = ws_buffer_start_ptr(buf);
+
+  /* A case-sensitive narrow search is a plain byte-sequence search. */
+  if (!cf->case_type)
+    return scan_bytes(cf, pd, buf_len, ascii_text, textlen);
+
+  result = MR_NOTMATCHED;
   i = 0;
   while (i < buf_len) {
-    c_char = pd[i];
-    if (cf->case_type)
-      c_char = g_ascii_toupper(c_char);
+    c_char = g_ascii_toupper(pd[i]);
     if (c_char == ascii_text[c_match]) {
       c_match += 1;
       if (c_match == textlen) {
@@ -3410,13 +3726,6 @@ match_binary(capture_file *cf, frame_data *fdata,
              wtap_rec *rec, Buffer *buf, void *criterion)
 {
   cbs_t        *info        = (cbs_t *)criterion;
-  const guint8 *binary_data = info->data;
-  size_t        datalen     = info->data_len;
-  match_result  result;
-  guint32       buf_len;
-  guint8       *pd;
-  guint32       i;
-  size_t        c_match     = 0;
 
   /* Load the frame's data. */
   if (!cf_read_record(cf, fdata, rec, buf)) {
@@ -3424,29 +3733,8 @@ match_binary(capture_file *cf, frame_data *fdata,
     return MR_ERROR;
   }
 
-  result = MR_NOTMATCHED;
-  buf_len = fdata->cap_len;
-  pd = ws_buffer_start_ptr(buf);
-  i = 0;
-  while (i < buf_len) {
-    if (pd[i] == binary_data[c_match]) {
-      c_match += 1;
-      if (c_match == datalen) {
-        result = MR_MATCHED;
-        cf->search_pos = i; /* Save the position of the last character
-                               for highlighting the field. */
-        cf->search_len = (guint32)datalen;
-        break;
-      }
-    }
-    else {
-      g_assert(i>=c_match);
-      i -= (guint32)c_match;
-      c_match = 0;
-    }
-    i += 1;
-  }
-  return result;
+  return scan_bytes(cf, ws_buffer_start_ptr(buf), fdata->cap_len,
+                    info->data, info->data_len);
 }
 
 static match_result
@@ -3769,6 +4057,42 @@ cf_goto_frame(capture_file *cf, guint fnumber)
   return TRUE;  /* we got to that packet */
 }
 
+gboolean
+cf_goto_time(capture_file *cf, double secs)
+{
+  frame_data *first;
+  nstime_t    ts;
+  guint32     fnumber;
+
+  if (cf == NULL || cf->provider.frames == NULL || cf->count == 0) {
+    statusbar_push_temporary_msg("There is no file loaded");
+    return FALSE;   /* we failed to go to that packet */
+  }
+
+  if (secs < 0.0)
+    secs = 0.0;
+
+  /* the offset is counted from the first frame in the capture */
+  first = frame_data_sequence_find(cf->provider.frames, 1);
+  ts.secs  = first->abs_ts.secs + (time_t)secs;
+  ts.nsecs = first->abs_ts.nsecs + (int)((secs - (double)(time_t)secs) * 1000000000.0);
+  if (ts.nsecs >= 1000000000) {
+    ts.secs++;
+    ts.nsecs -= 1000000000;
+  }
+
+  fnumber = frame_data_sequence_find_time(cf->provider.frames, &ts);
+
+  /* jump to the first such frame that is actually displayed */
+  for (; fnumber != 0 && fnumber <= cf->count; fnumber++) {
+    if (frame_data_sequence_find(cf->provider.frames, fnumber)->passed_dfilter)
+      return cf_goto_frame(cf, fnumber);
+  }
+
+  statusbar_push_temporary_msg("There is no displayed packet at or after %g seconds.", secs);
+  return FALSE;   /* we failed to go to that packet */
+}
+
 /*
  * Go to frame specified by currently selected protocol tree item.
  */
@@ -3944,6 +4268,19 @@ cf_read_section_comment(capture_file *cf)
 
 /*
  * Modify the section comment.
+ *
+ * This only updates the in-memory SHB; committing the change requires
+ * rewriting the file, because pcapng stores the comment as an inline
+ * option of the Section Header Block at the start of the section.  The
+ * format has no amendment record: appending a second SHB would not
+ * annotate the existing section, it would open a new, empty section,
+ * and conforming readers (including our own) would attach the comment
+ * to that empty section rather than to the packets.  Patching the
+ * existing SHB in place would only be possible when the new options
+ * happen to occupy exactly as many bytes as the old ones, which in the
+ * common case - a file with no comment at all - never holds.  So a
+ * comment edit on a large file costs a record-level copy of the file;
+ * the records are copied as raw blocks, not re-dissected.
  */
 void
 cf_update_section_comment(capture_file *cf, gchar *comment)
@@ -4764,9 +5101,39 @@ cf_export_specified_packets(capture_file *cf, const char *fname,
   packet_range_process_init(range);
 
   /* We're writing out specified packets from the specified capture
-     file to another file.  Even if all captured packets are to be
-     written, don't special-case the operation - read each packet
-     and then write it out if it's one of the specified ones. */
+     file to another file.  If every captured packet is to be written,
+     we're writing in the format and compression the file already has,
+     there are no unsaved changes, and we have no name resolution
+     information to add (or the format can't carry it), the result is
+     byte-for-byte the file we already have, so just copy the raw data
+     rather than re-encoding every record. */
+  if (range->process == range_process_all && !range->process_filtered &&
+      !(range->remove_ignored && range->ignored_cnt > 0) &&
+      save_format == cf->cd_t && compression_type == cf->compression_type &&
+      !cf->unsaved_changes &&
+      (wtap_addrinfo_list_empty(get_addrinfo_list()) ||
+       !wtap_dump_has_name_resolution(save_format))) {
+    if (file_exists(fname)) {
+      /* We're overwriting an existing file; copy to a new file and,
+         if that succeeds, rename the new file on top of the old file,
+         so we don't lose the old file on a write error. */
+      fname_new = g_strdup_printf("%s~", fname);
+      if (!copy_file_binary_mode(cf->filename, fname_new))
+        goto fail;
+      if (ws_rename(fname_new, fname) == -1) {
+        cf_rename_failure_alert_box(fname, errno);
+        goto fail;
+      }
+      g_free(fname_new);
+    } else {
+      if (!copy_file_binary_mode(cf->filename, fname))
+        goto fail;
+    }
+    return CF_WRITE_OK;
+  }
+
+  /* Otherwise read each packet and write it out if it's one of the
+     specified ones. */
 
   /* XXX: what free's params.shb_hdr? */
   wtap_dump_params_init(&params, cf->provider.wth);
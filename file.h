@@ -408,6 +408,20 @@ void cf_redissect_packets(capture_file *cf);
  */
 cf_read_status_t cf_retap_packets(capture_file *cf);
 
+/**
+ * Rescan a specific set of frames and just run taps.  Like
+ * cf_retap_packets(), but only dissects the listed frames, so taps
+ * that only care about those frames (e.g. Follow Stream) don't have
+ * to rescan the entire file.
+ *
+ * @param cf the capture file
+ * @param frames array of frame numbers, in ascending order
+ * @param num_frames number of entries in frames
+ * @return one of cf_read_status_t
+ */
+cf_read_status_t cf_retap_frames(capture_file *cf, const guint32 *frames,
+                                 guint num_frames);
+
 /**
  * Adjust timestamp precision if auto is selected.
  *
@@ -591,6 +605,16 @@ gboolean cf_find_packet_time_reference(capture_file *cf, search_direction dir);
  */
 gboolean cf_goto_frame(capture_file *cf, guint row);
 
+/**
+ * GoTo the first displayed packet at or after the given time offset,
+ * counted from the first packet in the capture.
+ *
+ * @param cf the capture file
+ * @param secs the time offset in seconds
+ * @return TRUE if such a packet exists, FALSE otherwise
+ */
+gboolean cf_goto_time(capture_file *cf, double secs);
+
 /**
  * Go to frame specified by currently selected protocol tree field.
  * (Go To Corresponding Packet)
@@ -170,35 +170,42 @@ fileset_find_by_path(gconstpointer a, gconstpointer b)
     return g_strcmp0(entry->fullname, path);
 }
 
+/* GCompareFunc helper for g_list_find_custom() */
+static gint
+fileset_find_by_name(gconstpointer a, gconstpointer b)
+{
+    const fileset_entry *entry;
+    const char *name;
+
+    entry = (const fileset_entry *) a;
+    name  = (const char *) b;
+
+    return g_strcmp0(entry->name, name);
+}
+
 /* update the time and size of this file in the list */
 void
 fileset_update_file(const char *path)
 {
-    int fh, result;
+    int result;
     ws_statb64 buf;
     fileset_entry *entry = NULL;
     GList *entry_list;
 
-    fh = ws_open( path, O_RDONLY, 0000 /* no creation so don't matter */);
-    if(fh !=  -1) {
+    /* a single stat is cheaper than opening the file just to fstat it */
+    result = ws_stat64( path, &buf );
 
-        /* Get statistics */
-        result = ws_fstat64( fh, &buf );
+    /* Show statistics if they are valid */
+    if( result == 0 ) {
+        entry_list = g_list_find_custom(set.entries, path,
+                                        fileset_find_by_path);
 
-        /* Show statistics if they are valid */
-        if( result == 0 ) {
-            entry_list = g_list_find_custom(set.entries, path,
-                                            fileset_find_by_path);
-
-            if (entry_list) {
-                entry = (fileset_entry *) entry_list->data;
-                entry->ctime    = ST_CREATE_TIME(buf);
-                entry->mtime    = buf.st_mtime;
-                entry->size     = buf.st_size;
-            }
+        if (entry_list) {
+            entry = (fileset_entry *) entry_list->data;
+            entry->ctime    = ST_CREATE_TIME(buf);
+            entry->mtime    = buf.st_mtime;
+            entry->size     = buf.st_size;
         }
-
-        ws_close(fh);
     }
 }
 
@@ -206,7 +213,7 @@ fileset_update_file(const char *path)
 static fileset_entry *
 fileset_add_file(const char *dirname, const char *fname, gboolean current)
 {
-    int fh, result;
+    int result;
     ws_statb64 buf;
     char *path;
     fileset_entry *entry = NULL;
@@ -214,27 +221,24 @@ fileset_add_file(const char *dirname, const char *fname, gboolean current)
 
     path = g_strdup_printf("%s%s", dirname, fname);
 
-    fh = ws_open( path, O_RDONLY, 0000 /* no creation so don't matter */);
-    if(fh !=  -1) {
+    /* a single stat is cheaper than opening the file just to fstat it */
+    result = ws_stat64( path, &buf );
 
-        /* Get statistics */
-        result = ws_fstat64( fh, &buf );
-
-        /* Show statistics if they are valid */
-        if( result == 0 ) {
-            entry = (fileset_entry *)g_malloc(sizeof(fileset_entry));
-
-            entry->fullname = g_strdup(path);
-            entry->name     = g_strdup(fname);
-            entry->ctime    = ST_CREATE_TIME(buf);
-            entry->mtime    = buf.st_mtime;
-            entry->size     = buf.st_size;
-            entry->current  = current;
+    /* Show statistics if they are valid */
+    if( result == 0 ) {
+        entry = (fileset_entry *)g_malloc(sizeof(fileset_entry));
 
-            set.entries = g_list_append(set.entries, entry);
-        }
+        entry->fullname = g_strdup(path);
+        entry->name     = g_strdup(fname);
+        entry->ctime    = ST_CREATE_TIME(buf);
+        entry->mtime    = buf.st_mtime;
+        entry->size     = buf.st_size;
+        entry->current  = current;
 
-        ws_close(fh);
+        /* appending would walk the whole list for every file, which adds up
+         * in directories with many thousands of ring buffer members;
+         * the list is sorted after the scan anyway */
+        set.entries = g_list_prepend(set.entries, entry);
     }
 
     g_free(path);
@@ -286,6 +290,31 @@ fileset_add_dir(const char *fname, void *window)
     dirname = g_string_new(get_dirname(fname_dup));
     g_free(fname_dup);
 
+    /* If the file is a member of the set we already have scanned, reuse the
+     * cached entries (including their time and size) instead of stating every
+     * file in the directory again; opening another member of a large ring
+     * buffer through the file set dialog would otherwise rescan the whole
+     * directory on every switch. */
+    if (set.entries && set.dirname && strcmp(set.dirname, dirname->str) == 0 &&
+        g_list_find_custom(set.entries, get_basename(fname), fileset_find_by_name)) {
+        GList *le;
+
+        for (le = g_list_first(set.entries); le; le = g_list_next(le)) {
+            fileset_entry *entry = (fileset_entry *)le->data;
+            entry->current = (strcmp(entry->name, get_basename(fname)) == 0);
+        }
+        /* the now current file may have grown since the scan */
+        fileset_update_file(fname);
+
+        g_string_free(dirname, TRUE /* free_segment */);
+
+        fileset_update_dlg(window);
+        return;
+    }
+
+    /* the cached set (if any) doesn't cover this file, scan from scratch */
+    fileset_delete();
+
     set.dirname = g_strdup(dirname->str);
 
     dirname = g_string_append_c(dirname, G_DIR_SEPARATOR);
@@ -318,6 +347,31 @@ fileset_add_dir(const char *fname, void *window)
 }
 
 
+/* get the full paths of all files in the set, in set order */
+char **
+fileset_get_all_names(void)
+{
+    char **names;
+    guint  n;
+    guint  i;
+    GList *le;
+
+    n = g_list_length(set.entries);
+    if (n == 0) {
+        return NULL;
+    }
+
+    names = g_new(char *, n + 1);
+    i = 0;
+    for (le = g_list_first(set.entries); le; le = g_list_next(le)) {
+        names[i++] = g_strdup(((fileset_entry *)le->data)->fullname);
+    }
+    names[i] = NULL;
+
+    return names;
+}
+
+
 /* get current directory name */
 const char *
 fileset_get_dirname(void)
@@ -35,6 +35,15 @@ extern void fileset_delete(void);
 /* get the current directory name */
 extern const char *fileset_get_dirname(void);
 
+/**
+ * Get the full paths of all files in the set, in set order, as a
+ * NULL-terminated vector suitable for wtap_concat_open_offline().
+ * Free with g_strfreev().
+ *
+ * @return the vector, or NULL if the set is empty.
+ */
+extern char **fileset_get_all_names(void);
+
 extern fileset_entry *fileset_get_next(void);
 extern fileset_entry *fileset_get_previous(void);
 
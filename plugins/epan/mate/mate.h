@@ -101,6 +101,8 @@ typedef struct _mate_cfg_pdu {
 	avpl_match_mode criterium_match_mode;
 	accept_mode_t criterium_accept_mode;
 	AVPL* criterium;
+
+	struct _mate_cfg_gop* gop_cfg; /* the gop declared on this pdu, resolved at config time (NULL if none) */
 } mate_cfg_pdu;
 
 
@@ -140,6 +142,8 @@ typedef struct _mate_cfg_gop {
 
 	GHashTable* gop_index;
 	GHashTable* gog_index;
+
+	LoAL* gog_keys; /* this gop's entry of gogs_by_gopname, resolved at config time (NULL if none) */
 } mate_cfg_gop;
 
 
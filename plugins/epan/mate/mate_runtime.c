@@ -372,7 +372,7 @@ static void analyze_gop(mate_config* mc, mate_gop* gop) {
 		/* no gog, let's either find one or create it if due */
 		dbg_print (dbg_gog,1,dbg_facility,"analyze_gop: no gog");
 
-		gog_keys = (LoAL *)g_hash_table_lookup(mc->gogs_by_gopname,gop->cfg->name);
+		gog_keys = gop->cfg->gog_keys;
 
 		if ( ! gog_keys ) {
 			dbg_print (dbg_gog,1,dbg_facility,"analyze_gop: no gog_keys for this gop");
@@ -468,7 +468,7 @@ static void analyze_pdu(mate_config* mc, mate_pdu* pdu) {
 
 	dbg_print (dbg_gop,1,dbg_facility,"analyze_pdu: %s",pdu->cfg->name);
 
-	if (! (cfg = (mate_cfg_gop *)g_hash_table_lookup(mc->gops_by_pduname,pdu->cfg->name)) )
+	if (! (cfg = pdu->cfg->gop_cfg) )
 		return;
 
 	if ((gopkey_match = new_avpl_pairs_match("gop_key_match", pdu->avpl, cfg->key, TRUE, TRUE))) {
@@ -533,7 +533,7 @@ static void analyze_pdu(mate_config* mc, mate_pdu* pdu) {
 
 				apply_extras(pdu->avpl,gopkey_match,cfg->extra);
 
-				gog_keys = (LoAL *)g_hash_table_lookup(mc->gogs_by_gopname,cfg->name);
+				gog_keys = cfg->gog_keys;
 
 				if (gog_keys) {
 
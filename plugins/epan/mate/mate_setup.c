@@ -53,6 +53,8 @@ extern mate_cfg_pdu* new_pducfg(mate_config* mc, gchar* name) {
 	cfg->criterium_match_mode = AVPL_NO_MATCH;
 	cfg->criterium_accept_mode = ACCEPT_MODE;
 
+	cfg->gop_cfg = NULL;
+
 	g_ptr_array_add(mc->pducfglist,(gpointer) cfg);
 	g_hash_table_insert(mc->pducfgs,(gpointer) cfg->name,(gpointer) cfg);
 
@@ -91,6 +93,8 @@ extern mate_cfg_gop* new_gopcfg(mate_config* mc, gchar* name) {
 	cfg->gop_index = g_hash_table_new(g_str_hash,g_str_equal);
 	cfg->gog_index = g_hash_table_new(g_str_hash,g_str_equal);
 
+	cfg->gog_keys = NULL;
+
 	g_hash_table_insert(mc->gopcfgs,(gpointer) cfg->name, (gpointer) cfg);
 
 	return cfg;
@@ -558,8 +562,18 @@ static void analyze_gog_config(gpointer k _U_, gpointer v, gpointer p) {
 
 }
 
+/* resolves the config-name indirections once, so the runtime doesn't
+   have to look up gops_by_pduname/gogs_by_gopname for every pdu */
+static void link_gop_to_gog_keys(gpointer k _U_, gpointer v, gpointer p) {
+	mate_config* mc = (mate_config*)p;
+	mate_cfg_gop* cfg = (mate_cfg_gop *)v;
+
+	cfg->gog_keys = (LoAL *)g_hash_table_lookup(mc->gogs_by_gopname,cfg->name);
+}
+
 static void analyze_config(mate_config* mc) {
 	guint i;
+	mate_cfg_pdu* cfg;
 
 	for (i=0; i < mc->pducfglist->len; i++) {
 		analyze_pdu_config(mc, (mate_cfg_pdu*) g_ptr_array_index(mc->pducfglist,i));
@@ -568,6 +582,12 @@ static void analyze_config(mate_config* mc) {
 	g_hash_table_foreach(mc->gopcfgs,analyze_gop_config,mc);
 	g_hash_table_foreach(mc->gogcfgs,analyze_gog_config,mc);
 
+	for (i=0; i < mc->pducfglist->len; i++) {
+		cfg = (mate_cfg_pdu*) g_ptr_array_index(mc->pducfglist,i);
+		cfg->gop_cfg = (mate_cfg_gop *)g_hash_table_lookup(mc->gops_by_pduname,cfg->name);
+	}
+
+	g_hash_table_foreach(mc->gopcfgs,link_gop_to_gog_keys,mc);
 }
 
 extern mate_config* mate_make_config(const gchar* filename, int mate_hfid) {
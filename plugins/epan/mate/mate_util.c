@@ -740,13 +740,17 @@ extern AVP* get_next_avp(AVPL* avpl, void** cookie) {
 gchar* avpl_to_str(AVPL* avpl) {
 	AVPN* c;
 	GString* s = g_string_new("");
-	gchar* avp_s;
 	gchar* r;
 
+	/* this is also the builder of every gop/gog index key, so append
+	   the avp members directly instead of formatting a scratch string
+	   per avp */
 	for(c=avpl->null.next; c->avp; c = c->next) {
-		avp_s = avp_to_str(c->avp);
-		g_string_append_printf(s," %s;",avp_s);
-		g_free(avp_s);
+		g_string_append_c(s,' ');
+		g_string_append(s,c->avp->n);
+		g_string_append_c(s,c->avp->o);
+		g_string_append(s,c->avp->v);
+		g_string_append_c(s,';');
 	}
 
 	r = g_string_free(s,FALSE);
@@ -758,13 +762,14 @@ gchar* avpl_to_str(AVPL* avpl) {
 extern gchar* avpl_to_dotstr(AVPL* avpl) {
 	AVPN* c;
 	GString* s = g_string_new("");
-	gchar* avp_s;
 	gchar* r;
 
 	for(c=avpl->null.next; c->avp; c = c->next) {
-		avp_s = avp_to_str(c->avp);
-		g_string_append_printf(s," .%s;",avp_s);
-		g_free(avp_s);
+		g_string_append(s," .");
+		g_string_append(s,c->avp->n);
+		g_string_append_c(s,c->avp->o);
+		g_string_append(s,c->avp->v);
+		g_string_append_c(s,';');
 	}
 
 	r = g_string_free(s,FALSE);
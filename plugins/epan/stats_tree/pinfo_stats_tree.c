@@ -106,8 +106,8 @@ static void ipv6_hosts_stats_tree_init(stats_tree *st) {
 	st_node_ipv6 = stats_tree_create_node(st, st_str_ipv6, 0, STAT_DT_INT, TRUE);
 }
 
-static tap_packet_status ip_hosts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node, const gchar *st_str) {
-	tick_stat_node(st, st_str, 0, FALSE);
+static tap_packet_status ip_hosts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node, const gchar *st_str _U_) {
+	tick_stat_node_by_id(st, st_node);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_src), st_node, FALSE);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node, FALSE);
 	return TAP_PACKET_REDRAW;
@@ -157,14 +157,14 @@ static void ipv6_srcdst_stats_tree_init(stats_tree *st) {
 static tap_packet_status ip_srcdst_stats_tree_packet(stats_tree *st,
 						     packet_info *pinfo,
 				                     int st_node_src,
-				                     const gchar *st_str_src,
+				                     const gchar *st_str_src _U_,
 						     int st_node_dst,
-						     const gchar *st_str_dst) {
+						     const gchar *st_str_dst _U_) {
 	/* update source branch */
-	tick_stat_node(st, st_str_src, 0, FALSE);
+	tick_stat_node_by_id(st, st_node_src);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_src), st_node_src, FALSE);
 	/* update destination branch */
-	tick_stat_node(st, st_str_dst, 0, FALSE);
+	tick_stat_node_by_id(st, st_node_dst);
 	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node_dst, FALSE);
 	return TAP_PACKET_REDRAW;
 }
@@ -220,12 +220,12 @@ static void ipv6_dsts_stats_tree_init(stats_tree *st) {
 	st_node_ipv6_dsts = stats_tree_create_node(st, st_str_ipv6_dsts, 0, STAT_DT_INT, TRUE);
 }
 
-static tap_packet_status dsts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node, const gchar *st_str) {
+static tap_packet_status dsts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node, const gchar *st_str _U_) {
 	static gchar str[128];
 	int ip_dst_node;
 	int protocol_node;
 
-	tick_stat_node(st, st_str, 0, FALSE);
+	tick_stat_node_by_id(st, st_node);
 	ip_dst_node = tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node, TRUE);
 	protocol_node = tick_stat_node(st, port_type_to_str(pinfo->ptype), ip_dst_node, TRUE);
 	g_snprintf(str, sizeof(str) - 1, "%u", pinfo->destport);
@@ -1337,6 +1337,9 @@ proto_register_transum(void)
     register_cleanup_routine(cleanup_globals);
 
     register_postdissector(transum_handle);
+    /* All our output goes into the transum.* tree fields, so we only
+       need to be called when something wants those fields. */
+    set_postdissector_fields_only(transum_handle, TRUE);
 
     output_rrpd = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), g_direct_hash, g_direct_equal);
 }
@@ -538,6 +538,24 @@ guint randpkt_example_count(void)
 	return array_length(examples);
 }
 
+/* Fill a buffer with random bytes, drawing 32 bits per GRand call
+ * rather than making one call per byte. */
+static void
+randpkt_fill_random(guint8* buf, guint len)
+{
+	guint32 r;
+	guint i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		r = g_rand_int(pkt_rand);
+		memcpy(&buf[i], &r, 4);
+	}
+	if (i < len) {
+		r = g_rand_int(pkt_rand);
+		memcpy(&buf[i], &r, len - i);
+	}
+}
+
 /* Find pkt_example record and return pointer to it */
 randpkt_example* randpkt_find_example(int type)
 {
@@ -605,17 +623,17 @@ void randpkt_loop(randpkt_example* example, guint64 produce_count, guint64 packe
 		rec->rec_header.packet_header.len = len_this_pkt;
 		rec->ts.secs = i; /* just for variety */
 
-		for (j = example->pseudo_length; j < (int) sizeof(*ps_header); j++) {
-			((guint8*)ps_header)[j] = g_rand_int_range(pkt_rand, 0, 0x100);
-		}
+		randpkt_fill_random(((guint8*)ps_header) + example->pseudo_length,
+		    (guint) sizeof(*ps_header) - example->pseudo_length);
+
+		randpkt_fill_random(&buffer[example->sample_length],
+		    len_this_pkt - example->sample_length);
 
+		/* Add format strings here and there */
 		for (j = example->sample_length; j < len_this_pkt; j++) {
-			/* Add format strings here and there */
-			if ((int) (100.0*g_rand_double(pkt_rand)) < 3 && j < (len_random - 3)) {
+			if (g_rand_int_range(pkt_rand, 0, 100) < 3 && j < (len_random - 3)) {
 				memcpy(&buffer[j], "%s", 3);
 				j += 2;
-			} else {
-				buffer[j] = g_rand_int_range(pkt_rand, 0, 0x100);
 			}
 		}
 
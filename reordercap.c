@@ -20,12 +20,14 @@
 #endif
 
 #include <wiretap/wtap.h>
+#include <wiretap/merge.h>
 
 #ifndef HAVE_GETOPT_LONG
 #include "wsutil/wsgetopt.h"
 #endif
 
 #include <ui/cmdarg_err.h>
+#include <ui/clopts_common.h>
 #include <wsutil/filesystem.h>
 #include <wsutil/file_util.h>
 #include <wsutil/privileges.h>
@@ -54,6 +56,8 @@ print_usage(FILE *output)
     fprintf(output, "\n");
     fprintf(output, "Options:\n");
     fprintf(output, "  -n        don't write to output file if the input file is ordered.\n");
+    fprintf(output, "  -c <n>    sort the file in chunks of <n> frames written to temporary\n");
+    fprintf(output, "            files, then merge them, for files too large to sort in memory.\n");
     fprintf(output, "  -h        display this help and exit.\n");
 }
 
@@ -135,6 +139,52 @@ frames_compare(gconstpointer a, gconstpointer b)
     return nstime_cmp(time1, time2);
 }
 
+/* Sort the frames collected so far and write them, in order, to a
+ * temporary file, which becomes one sorted run of the external merge.
+ * The frame records are freed and the array emptied for the next run. */
+static void
+write_run(wtap *wth, const wtap_dump_params *params, GPtrArray *frames,
+          GPtrArray *run_files, const char *infile)
+{
+    wtap_dumper *run_dh;
+    gchar *run_name = NULL;
+    wtap_rec rec;
+    Buffer buf;
+    int err;
+    guint i;
+
+    g_ptr_array_sort(frames, frames_compare);
+
+    run_dh = wtap_dump_open_tempfile(&run_name, "reordercap",
+                                     wtap_file_type_subtype(wth),
+                                     WTAP_UNCOMPRESSED, params, &err);
+    if (run_dh == NULL) {
+        cfile_dump_open_failure_message("reordercap",
+                                        run_name ? run_name : "a temporary file",
+                                        err, wtap_file_type_subtype(wth));
+        exit(1);
+    }
+
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    for (i = 0; i < frames->len; i++) {
+        FrameRecord_t *frame = (FrameRecord_t *)frames->pdata[i];
+
+        frame_write(frame, wth, run_dh, &rec, &buf, infile, run_name);
+        g_slice_free(FrameRecord_t, frame);
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+    g_ptr_array_set_size(frames, 0);
+
+    if (!wtap_dump_close(run_dh, &err)) {
+        cfile_close_failure_message(run_name, err);
+        exit(1);
+    }
+
+    g_ptr_array_add(run_files, run_name);
+}
+
 /*
  * General errors and warnings are reported with an console message
  * in reordercap.
@@ -173,12 +223,16 @@ main(int argc, char *argv[])
     gint64 data_offset;
     guint wrong_order_count = 0;
     gboolean write_output_regardless = TRUE;
+    guint chunk_size = 0;       /* 0 = sort everything in memory */
+    guint frame_count = 0;
+    nstime_t prev_time;
+    gboolean have_prev = FALSE;
     guint i;
     wtap_dump_params params;
     int                          ret = EXIT_SUCCESS;
 
     GPtrArray *frames;
-    FrameRecord_t *prevFrame = NULL;
+    GPtrArray *run_files = NULL;
 
     int opt;
     static const struct option long_options[] = {
@@ -218,11 +272,14 @@ main(int argc, char *argv[])
     wtap_init(TRUE);
 
     /* Process the options first */
-    while ((opt = getopt_long(argc, argv, "hnv", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "c:hnv", long_options, NULL)) != -1) {
         switch (opt) {
             case 'n':
                 write_output_regardless = FALSE;
                 break;
+            case 'c':
+                chunk_size = (guint)get_positive_int(optarg, "chunk size");
+                break;
             case 'h':
                 show_help_header("Reorder timestamps of input file frames into output file.");
                 print_usage(stdout);
@@ -262,21 +319,27 @@ main(int argc, char *argv[])
 
     wtap_dump_params_init(&params, wth);
 
-    /* Open outfile (same filetype/encap as input file) */
-    if (strcmp(outfile, "-") == 0) {
-      pdh = wtap_dump_open_stdout(wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, &params, &err);
-    } else {
-      pdh = wtap_dump_open(outfile, wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, &params, &err);
-    }
-    g_free(params.idb_inf);
-    params.idb_inf = NULL;
+    /* Open outfile (same filetype/encap as input file).  When sorting in
+       chunks, the sorted runs go to temporary files first and the final
+       merge opens the output itself. */
+    if (chunk_size == 0) {
+        if (strcmp(outfile, "-") == 0) {
+          pdh = wtap_dump_open_stdout(wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, &params, &err);
+        } else {
+          pdh = wtap_dump_open(outfile, wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, &params, &err);
+        }
 
-    if (pdh == NULL) {
-        cfile_dump_open_failure_message("reordercap", outfile, err,
-                                        wtap_file_type_subtype(wth));
-        wtap_dump_params_cleanup(&params);
-        ret = OUTPUT_FILE_ERROR;
-        goto clean_exit;
+        if (pdh == NULL) {
+            cfile_dump_open_failure_message("reordercap", outfile, err,
+                                            wtap_file_type_subtype(wth));
+            g_free(params.idb_inf);
+            params.idb_inf = NULL;
+            wtap_dump_params_cleanup(&params);
+            ret = OUTPUT_FILE_ERROR;
+            goto clean_exit;
+        }
+    } else {
+        run_files = g_ptr_array_new();
     }
 
     /* Allocate the array of frame pointers. */
@@ -289,7 +352,7 @@ main(int argc, char *argv[])
         FrameRecord_t *newFrameRecord;
 
         newFrameRecord = g_slice_new(FrameRecord_t);
-        newFrameRecord->num = frames->len + 1;
+        newFrameRecord->num = ++frame_count;
         newFrameRecord->offset = data_offset;
         if (rec.presence_flags & WTAP_HAS_TS) {
             newFrameRecord->frame_time = rec.ts;
@@ -297,12 +360,21 @@ main(int argc, char *argv[])
             nstime_set_unset(&newFrameRecord->frame_time);
         }
 
-        if (prevFrame && frames_compare(&newFrameRecord, &prevFrame) < 0) {
+        if (have_prev &&
+            nstime_cmp(&newFrameRecord->frame_time, &prev_time) < 0) {
            wrong_order_count++;
         }
+        prev_time = newFrameRecord->frame_time;
+        have_prev = TRUE;
 
         g_ptr_array_add(frames, newFrameRecord);
-        prevFrame = newFrameRecord;
+
+        /* If we're sorting in chunks and this one is full, write it out
+           as a sorted run.  The frames in it have just been read, so the
+           seek-back reads come out of the page cache. */
+        if (chunk_size != 0 && frames->len >= chunk_size) {
+            write_run(wth, &params, frames, run_files, infile);
+        }
     }
     wtap_rec_cleanup(&rec);
     ws_buffer_free(&buf);
@@ -311,27 +383,121 @@ main(int argc, char *argv[])
       cfile_read_failure_message("reordercap", infile, err, err_info);
     }
 
-    printf("%u frames, %u out of order\n", frames->len, wrong_order_count);
+    printf("%u frames, %u out of order\n", frame_count, wrong_order_count);
 
-    /* Sort the frames */
-    if (wrong_order_count > 0) {
-        g_ptr_array_sort(frames, frames_compare);
-    }
+    if (chunk_size == 0) {
+        /* Sort the frames */
+        if (wrong_order_count > 0) {
+            g_ptr_array_sort(frames, frames_compare);
+        }
 
-    /* Write out each sorted frame in turn */
-    wtap_rec_init(&rec);
-    ws_buffer_init(&buf, 1514);
-    for (i = 0; i < frames->len; i++) {
-        FrameRecord_t *frame = (FrameRecord_t *)frames->pdata[i];
+        /* Write out each sorted frame in turn */
+        wtap_rec_init(&rec);
+        ws_buffer_init(&buf, 1514);
+        for (i = 0; i < frames->len; i++) {
+            FrameRecord_t *frame = (FrameRecord_t *)frames->pdata[i];
+
+            /* Avoid writing if already sorted and configured to */
+            if (write_output_regardless || (wrong_order_count > 0)) {
+                frame_write(frame, wth, pdh, &rec, &buf, infile, outfile);
+            }
+            g_slice_free(FrameRecord_t, frame);
+        }
+        wtap_rec_cleanup(&rec);
+        ws_buffer_free(&buf);
+
+        /* Close outfile */
+        if (!wtap_dump_close(pdh, &err)) {
+            cfile_close_failure_message(outfile, err);
+            g_free(params.idb_inf);
+            params.idb_inf = NULL;
+            wtap_dump_params_cleanup(&params);
+            ret = OUTPUT_FILE_ERROR;
+            goto clean_exit;
+        }
+    } else {
+        /* Write the last, possibly partial, run, then merge the sorted
+           runs chronologically into the output file.  All the runs came
+           from the same input file, so their interface data is identical
+           and IDB_MERGE_MODE_ALL_SAME collapses it back to one set. */
+        if (frames->len > 0) {
+            write_run(wth, &params, frames, run_files, infile);
+        }
 
-        /* Avoid writing if already sorted and configured to */
         if (write_output_regardless || (wrong_order_count > 0)) {
-            frame_write(frame, wth, pdh, &rec, &buf, infile, outfile);
+            merge_result status;
+            int m_err = 0;
+            gchar *m_err_info = NULL;
+            guint err_fileno = 0;
+            guint32 err_framenum = 0;
+
+            if (strcmp(outfile, "-") == 0) {
+                status = merge_files_to_stdout(wtap_file_type_subtype(wth),
+                    (const char *const *)run_files->pdata, run_files->len,
+                    FALSE, IDB_MERGE_MODE_ALL_SAME, 0,
+                    get_appname_and_version(), NULL,
+                    &m_err, &m_err_info, &err_fileno, &err_framenum);
+            } else {
+                status = merge_files(outfile, wtap_file_type_subtype(wth),
+                    (const char *const *)run_files->pdata, run_files->len,
+                    FALSE, IDB_MERGE_MODE_ALL_SAME, 0,
+                    get_appname_and_version(), NULL,
+                    &m_err, &m_err_info, &err_fileno, &err_framenum);
+            }
+
+            switch (status) {
+                case MERGE_OK:
+                    break;
+
+                case MERGE_ERR_CANT_OPEN_INFILE:
+                    cfile_open_failure_message("reordercap",
+                        (const char *)run_files->pdata[err_fileno],
+                        m_err, m_err_info);
+                    break;
+
+                case MERGE_ERR_CANT_OPEN_OUTFILE:
+                    cfile_dump_open_failure_message("reordercap", outfile,
+                        m_err, wtap_file_type_subtype(wth));
+                    break;
+
+                case MERGE_ERR_CANT_READ_INFILE:
+                    cfile_read_failure_message("reordercap",
+                        (const char *)run_files->pdata[err_fileno],
+                        m_err, m_err_info);
+                    break;
+
+                case MERGE_ERR_CANT_WRITE_OUTFILE:
+                    cfile_write_failure_message("reordercap",
+                        (const char *)run_files->pdata[err_fileno],
+                        outfile, m_err, m_err_info, err_framenum,
+                        wtap_file_type_subtype(wth));
+                    break;
+
+                case MERGE_ERR_CANT_CLOSE_OUTFILE:
+                    cfile_close_failure_message(outfile, m_err);
+                    break;
+
+                default:
+                    cmdarg_err("Merging the sorted chunks failed (%d).",
+                               status);
+                    break;
+            }
+
+            if (status != MERGE_OK) {
+                ret = OUTPUT_FILE_ERROR;
+            }
         }
-        g_slice_free(FrameRecord_t, frame);
+
+        /* Delete the temporary run files. */
+        for (i = 0; i < run_files->len; i++) {
+            gchar *run_name = (gchar *)run_files->pdata[i];
+
+            ws_unlink(run_name);
+            g_free(run_name);
+        }
+        g_ptr_array_free(run_files, TRUE);
+        run_files = NULL;
     }
-    wtap_rec_cleanup(&rec);
-    ws_buffer_free(&buf);
 
     if (!write_output_regardless && (wrong_order_count == 0)) {
         printf("Not writing output file because input file is already in order.\n");
@@ -340,13 +506,8 @@ main(int argc, char *argv[])
     /* Free the whole array */
     g_ptr_array_free(frames, TRUE);
 
-    /* Close outfile */
-    if (!wtap_dump_close(pdh, &err)) {
-        cfile_close_failure_message(outfile, err);
-        wtap_dump_params_cleanup(&params);
-        ret = OUTPUT_FILE_ERROR;
-        goto clean_exit;
-    }
+    g_free(params.idb_inf);
+    params.idb_inf = NULL;
     wtap_dump_params_cleanup(&params);
 
     /* Finally, close infile and release resources. */
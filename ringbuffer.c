@@ -41,6 +41,8 @@
 
 #include <glib.h>
 
+#include <ws_attributes.h>
+
 #include "ringbuffer.h"
 #include <wsutil/file_util.h>
 
@@ -50,6 +52,17 @@ typedef struct _rb_file {
   gchar         *name;
 } rb_file;
 
+/* Deferred work handed to the cleanup thread: flush and close a file
+   that has been rotated out, and/or delete an old ring file.  Closing
+   and deleting are the expensive parts of a switch (the final buffer
+   flush, and freeing the blocks of a possibly multi-gigabyte file), and
+   doing them in the capture loop causes drops at every rotation. */
+typedef struct _rb_cleanup_job {
+  FILE          *pdh;                /**< File to flush and close, or NULL */
+  char          *io_buffer;          /**< Its IO buffer, freed after the close */
+  gchar         *unlink_name;        /**< File to delete, or NULL */
+} rb_cleanup_job;
+
 /** Ringbuffer data structure */
 typedef struct _ringbuf_data {
   rb_file      *files;
@@ -67,6 +80,64 @@ typedef struct _ringbuf_data {
 
 static ringbuf_data rb_data;
 
+static GThread      *rb_cleanup_thread;
+static GAsyncQueue  *rb_cleanup_queue;
+static rb_cleanup_job rb_cleanup_stop;   /**< Sentinel; address only */
+static gint          rb_cleanup_err;     /**< errno of the first deferred close failure */
+
+/*
+ * Process deferred closes and deletions so that the capture loop never
+ * blocks on them.  Close errors are recorded and reported at the next
+ * file switch (or at capture stop), in queue order.
+ */
+static gpointer
+ringbuf_cleanup_thread_func(gpointer data _U_)
+{
+  rb_cleanup_job *job;
+
+  while ((job = (rb_cleanup_job *)g_async_queue_pop(rb_cleanup_queue)) != &rb_cleanup_stop) {
+    if (job->pdh != NULL) {
+      if (fclose(job->pdh) == EOF) {
+        g_atomic_int_compare_and_exchange(&rb_cleanup_err, 0, errno);
+      }
+    }
+    g_free(job->io_buffer);
+    if (job->unlink_name != NULL) {
+      ws_unlink(job->unlink_name);
+      g_free(job->unlink_name);
+    }
+    g_free(job);
+  }
+  return NULL;
+}
+
+static void
+ringbuf_cleanup_thread_start(void)
+{
+  rb_cleanup_err = 0;
+  rb_cleanup_queue = g_async_queue_new();
+  rb_cleanup_thread = g_thread_new("rb_cleanup", ringbuf_cleanup_thread_func, NULL);
+}
+
+/*
+ * Wait for all deferred work to finish; returns the errno of the first
+ * deferred close failure, or 0.
+ */
+static int
+ringbuf_cleanup_thread_stop(void)
+{
+  if (rb_cleanup_thread == NULL)
+    return 0;
+
+  g_async_queue_push(rb_cleanup_queue, &rb_cleanup_stop);
+  g_thread_join(rb_cleanup_thread);
+  rb_cleanup_thread = NULL;
+  g_async_queue_unref(rb_cleanup_queue);
+  rb_cleanup_queue = NULL;
+
+  return g_atomic_int_get(&rb_cleanup_err);
+}
+
 
 /*
  * create the next filename and open a new binary file with that name
@@ -79,11 +150,22 @@ static int ringbuf_open_file(rb_file *rfile, int *err)
   struct tm *tm;
 
   if (rfile->name != NULL) {
-    if (rb_data.unlimited == FALSE) {
-      /* remove old file (if any, so ignore error) */
-      ws_unlink(rfile->name);
+    if (rb_data.unlimited == FALSE && rb_cleanup_queue != NULL) {
+      /* remove old file (if any, so ignore error); deleting a large
+         file can take a while, so hand it to the cleanup thread along
+         with ownership of the name */
+      rb_cleanup_job *job = g_new0(rb_cleanup_job, 1);
+
+      job->unlink_name = rfile->name;
+      g_async_queue_push(rb_cleanup_queue, job);
+    } else {
+      if (rb_data.unlimited == FALSE) {
+        /* remove old file (if any, so ignore error) */
+        ws_unlink(rfile->name);
+      }
+      g_free(rfile->name);
     }
-    g_free(rfile->name);
+    rfile->name = NULL;
   }
 
 #ifdef _WIN32
@@ -201,6 +283,8 @@ ringbuf_init(const char *capfile_name, guint num_files, gboolean group_read_acce
     return -1;
   }
 
+  ringbuf_cleanup_thread_start();
+
   return rb_data.fd;
 }
 
@@ -258,23 +342,28 @@ ringbuf_switch_file(FILE **pdh, gchar **save_file, int *save_file_fd, int *err)
 {
   int     next_file_index;
   rb_file *next_rfile = NULL;
+  rb_cleanup_job *job;
 
-  /* close current file */
+  /* report a deferred close failure from an earlier switch */
 
-  if (fclose(rb_data.pdh) == EOF) {
+  if (g_atomic_int_get(&rb_cleanup_err) != 0) {
     if (err != NULL) {
-      *err = errno;
+      *err = g_atomic_int_get(&rb_cleanup_err);
     }
-    ws_close(rb_data.fd);  /* XXX - the above should have closed this already */
-    rb_data.pdh = NULL;    /* it's still closed, we just got an error while closing */
-    rb_data.fd = -1;
-    g_free(rb_data.io_buffer);
-    rb_data.io_buffer = NULL;
     return FALSE;
   }
 
+  /* hand the current file to the cleanup thread; flushing and closing
+     it here would stall the capture loop */
+
+  job = g_new0(rb_cleanup_job, 1);
+  job->pdh = rb_data.pdh;
+  job->io_buffer = rb_data.io_buffer;
+  g_async_queue_push(rb_cleanup_queue, job);
+
   rb_data.pdh = NULL;
   rb_data.fd  = -1;
+  rb_data.io_buffer = NULL;
 
   /* get the next file number and open it */
 
@@ -305,6 +394,16 @@ gboolean
 ringbuf_libpcap_dump_close(gchar **save_file, int *err)
 {
   gboolean  ret_val = TRUE;
+  int       cleanup_err;
+
+  /* wait for deferred closes of earlier files, and pick up any error */
+  cleanup_err = ringbuf_cleanup_thread_stop();
+  if (cleanup_err != 0) {
+    if (err != NULL) {
+      *err = cleanup_err;
+    }
+    ret_val = FALSE;
+  }
 
   /* close current file, if it's open */
   if (rb_data.pdh != NULL) {
@@ -363,6 +462,9 @@ ringbuf_error_cleanup(void)
 {
   unsigned int i;
 
+  /* finish any deferred closes/deletions first */
+  ringbuf_cleanup_thread_stop();
+
   /* try to close via wtap */
   if (rb_data.pdh != NULL) {
     if (fclose(rb_data.pdh) == 0) {
@@ -354,6 +354,12 @@ load_cap_file(capture_file *cf, int max_packet_count, gint64 max_byte_count)
     ws_buffer_init(&buf, 1514);
 
     while (wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info, &data_offset)) {
+      if (cf->count == G_MAXUINT32) {
+        /* One more frame would wrap the 32-bit frame number. */
+        fprintf(stderr, "sharkd: more than %u frames; stopping at the frame number limit.\n",
+                G_MAXUINT32);
+        break;
+      }
       if (process_packet(cf, edt, data_offset, &rec, &buf)) {
         /* Stop reading if we have the maximum number of packets;
          * When the -c option has not been used, max_packet_count
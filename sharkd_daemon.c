@@ -52,6 +52,7 @@
 
 static int _use_stdinout = 0;
 static socket_handle_t _server_fd = INVALID_SOCKET;
+static char *_preload_file = NULL;
 
 static socket_handle_t
 socket_init(char *path)
@@ -165,9 +166,9 @@ sharkd_init(int argc, char **argv)
 #endif
 	socket_handle_t fd;
 
-	if (argc != 2)
+	if (argc != 2 && argc != 3)
 	{
-		fprintf(stderr, "Usage: %s <-|socket>\n", argv[0]);
+		fprintf(stderr, "Usage: %s <-|socket> [capture file]\n", argv[0]);
 		fprintf(stderr, "\n");
 
 		fprintf(stderr, "<socket> examples:\n");
@@ -178,6 +179,12 @@ sharkd_init(int argc, char **argv)
 		fprintf(stderr, " - tcp:127.0.0.1:4446 - listen on TCP port 4446\n");
 #endif
 		fprintf(stderr, "\n");
+#ifndef _WIN32
+		fprintf(stderr, "If a capture file is given, it is loaded once in the listening process\n");
+		fprintf(stderr, "and shared copy-on-write with every connection, instead of each\n");
+		fprintf(stderr, "connection loading it again.\n");
+		fprintf(stderr, "\n");
+#endif
 		return -1;
 	}
 
@@ -197,6 +204,23 @@ sharkd_init(int argc, char **argv)
 		_server_fd = fd;
 	}
 
+	if (argc == 3)
+	{
+#ifndef _WIN32
+		if (_use_stdinout)
+		{
+			fprintf(stderr, "preloading a capture file requires a listening socket\n");
+			return -1;
+		}
+		_preload_file = g_strdup(argv[2]);
+#else
+		/* Connection handlers are separate processes, not forks of
+		 * this one, so they can't share a preloaded capture. */
+		fprintf(stderr, "preloading a capture file is not supported on this platform\n");
+		return -1;
+#endif
+	}
+
 	if (!_use_stdinout)
 	{
 		/* all good - try to daemonize */
@@ -224,6 +248,29 @@ sharkd_loop(void)
 		return sharkd_session_main();
 	}
 
+#ifndef _WIN32
+	if (_preload_file)
+	{
+		int err = 0;
+
+		/* Load the capture once in the listening process; every
+		 * per-connection child below then inherits the loaded frame
+		 * data copy-on-write instead of reading the file again. */
+		if (sharkd_cf_open(_preload_file, WTAP_TYPE_AUTO, FALSE, &err) != CF_OK)
+		{
+			fprintf(stderr, "cannot open file: %s\n", _preload_file);
+			return -1;
+		}
+
+		err = sharkd_load_cap_file();
+		if (err != 0)
+		{
+			fprintf(stderr, "cannot load file: %s err=%d\n", _preload_file, err);
+			return -1;
+		}
+	}
+#endif
+
 	while (1)
 	{
 #ifndef _WIN32
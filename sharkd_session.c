@@ -76,6 +76,8 @@
 struct sharkd_filter_item
 {
 	guint8 *filtered; /* can be NULL if all frames are matching for given filter. */
+	GArray *rows;     /* frame numbers of the matching frames, in order;
+			   * NULL if filtered is NULL. */
 };
 
 static GHashTable *filter_table = NULL;
@@ -186,6 +188,8 @@ sharkd_session_filter_free(gpointer data)
 	struct sharkd_filter_item *l = (struct sharkd_filter_item *) data;
 
 	g_free(l->filtered);
+	if (l->rows)
+		g_array_free(l->rows, TRUE);
 	g_free(l);
 }
 
@@ -206,6 +210,22 @@ sharkd_session_filter_data(const char *filter)
 
 		l = (struct sharkd_filter_item *) g_malloc(sizeof(struct sharkd_filter_item));
 		l->filtered = filtered;
+		l->rows = NULL;
+
+		if (filtered != NULL)
+		{
+			guint32 framenum;
+
+			/* Index the matching frame numbers once, so that windowed
+			 * "frames" requests can seek straight to a row instead of
+			 * rescanning the bitmap from frame 1. */
+			l->rows = g_array_sized_new(FALSE, FALSE, sizeof(guint32), 1024);
+			for (framenum = 1; framenum <= cfile.count; framenum++)
+			{
+				if (filtered[framenum / 8] & (1 << (framenum % 8)))
+					g_array_append_val(l->rows, framenum);
+			}
+		}
 
 		g_hash_table_insert(filter_table, g_strdup(filter), l);
 	}
@@ -546,6 +566,16 @@ sharkd_session_process_load(const char *buf, const jsmntok_t *tokens, int count)
 	if (!tok_file)
 		return;
 
+	/* In daemon mode the listening process may have preloaded a capture
+	 * that this session inherited copy-on-write; if the client asks for
+	 * the very same file, don't pay for a second load. */
+	if (cfile.state == FILE_READ_DONE && cfile.filename &&
+	    !strcmp(cfile.filename, tok_file))
+	{
+		sharkd_json_simple_reply(0, NULL);
+		return;
+	}
+
 	if (sharkd_cf_open(tok_file, WTAP_TYPE_AUTO, FALSE, &err) != CF_OK)
 	{
 		sharkd_json_simple_reply(err, NULL);
@@ -761,6 +791,51 @@ sharkd_session_create_columns(column_info *cinfo, const char *buf, const jsmntok
 	return cinfo;
 }
 
+/**
+ * sharkd_session_process_findtime()
+ *
+ * Process findtime request
+ *
+ * Input:
+ *   (m) time - time offset in seconds, counted from the first frame
+ *
+ * Output object with attributes:
+ *   (m) fnum - number of the first frame at or after the given offset,
+ *              0 if every frame is earlier
+ */
+static void
+sharkd_session_process_findtime(const char *buf, const jsmntok_t *tokens, int count)
+{
+	const char *tok_time = json_find_attr(buf, tokens, count, "time");
+	guint32 framenum = 0;
+
+	if (tok_time && cfile.provider.frames && cfile.count != 0)
+	{
+		double secs = g_ascii_strtod(tok_time, NULL);
+		const frame_data *first = frame_data_sequence_find(cfile.provider.frames, 1);
+		nstime_t ts;
+
+		if (secs < 0.0)
+			secs = 0.0;
+
+		/* the offset is counted from the first frame in the capture */
+		ts.secs  = first->abs_ts.secs + (time_t) secs;
+		ts.nsecs = first->abs_ts.nsecs + (int) ((secs - (double)(time_t) secs) * 1000000000.0);
+		if (ts.nsecs >= 1000000000)
+		{
+			ts.secs++;
+			ts.nsecs -= 1000000000;
+		}
+
+		framenum = frame_data_sequence_find_time(cfile.provider.frames, &ts);
+	}
+
+	json_dumper_begin_object(&dumper);
+	sharkd_json_value_anyf("fnum", "%u", framenum);
+	json_dumper_end_object(&dumper);
+	json_dumper_finish(&dumper);
+}
+
 /**
  * sharkd_session_process_frames()
  *
@@ -792,7 +867,7 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 	const char *tok_limit  = json_find_attr(buf, tokens, count, "limit");
 	const char *tok_refs   = json_find_attr(buf, tokens, count, "refs");
 
-	const guint8 *filter_data = NULL;
+	const GArray *rows = NULL;
 
 	int col;
 
@@ -800,6 +875,7 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 	guint32 current_ref_frame = 0, next_ref_frame = G_MAXUINT32;
 	guint32 skip;
 	guint32 limit;
+	guint32 row, num_rows;
 
 	column_info *cinfo = &cfile.cinfo;
 	column_info user_cinfo;
@@ -819,7 +895,7 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 		filter_item = sharkd_session_filter_data(tok_filter);
 		if (!filter_item)
 			return;
-		filter_data = filter_item->filtered;
+		rows = filter_item->rows;
 	}
 
 	skip = 0;
@@ -842,21 +918,22 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
 			return;
 	}
 
+	/* Seek straight to the first row of the window instead of walking
+	 * every frame: for a filtered view the filter's row index maps row
+	 * numbers to frame numbers, for an unfiltered view (or a filter
+	 * matching everything) the mapping is just row + 1. */
+	num_rows = rows ? rows->len : cfile.count;
+	if (skip != 0 && skip <= num_rows)
+		prev_dis_num = rows ? g_array_index(rows, guint32, skip - 1) : skip;
+
 	sharkd_json_array_open(NULL);
-	for (framenum = 1; framenum <= cfile.count; framenum++)
+	for (row = skip; row < num_rows; row++)
 	{
 		frame_data *fdata;
-		guint32 ref_frame = (framenum != 1) ? 1 : 0;
+		guint32 ref_frame;
 
-		if (filter_data && !(filter_data[framenum / 8] & (1 << (framenum % 8))))
-			continue;
-
-		if (skip)
-		{
-			skip--;
-			prev_dis_num = framenum;
-			continue;
-		}
+		framenum = rows ? g_array_index(rows, guint32, row) : row + 1;
+		ref_frame = (framenum != 1) ? 1 : 0;
 
 		if (tok_refs)
 		{
@@ -2182,7 +2259,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
 	int i;
 
 	rtpstream_tapinfo_t rtp_tapinfo =
-		{ NULL, NULL, NULL, NULL, 0, NULL, 0, TAP_ANALYSE, NULL, NULL, NULL, FALSE };
+		{ NULL, NULL, NULL, NULL, 0, NULL, NULL, 0, TAP_ANALYSE, NULL, NULL, NULL, FALSE };
 
 	for (i = 0; i < 16; i++)
 	{
@@ -4206,6 +4283,8 @@ sharkd_session_process(char *buf, const jsmntok_t *tokens, int count)
 			sharkd_session_process_complete(buf, tokens, count);
 		else if (!strcmp(tok_req, "frames"))
 			sharkd_session_process_frames(buf, tokens, count);
+		else if (!strcmp(tok_req, "findtime"))
+			sharkd_session_process_findtime(buf, tokens, count);
 		else if (!strcmp(tok_req, "tap"))
 			sharkd_session_process_tap(buf, tokens, count);
 		else if (!strcmp(tok_req, "follow"))
@@ -4261,6 +4340,12 @@ sharkd_session_main(void)
 
 	dumper.output_file = stdout;
 
+	/* Responses can be megabytes of JSON; a larger output buffer, reused
+	 * for the whole session, turns the dumper's many small stdio writes
+	 * into few large writes to the socket.  The explicit fflush() after
+	 * every reply still bounds the latency. */
+	setvbuf(stdout, NULL, _IOFBF, 256 * 1024);
+
 	filter_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, sharkd_session_filter_free);
 
 #ifdef HAVE_MAXMINDDB
@@ -45,6 +45,7 @@
 #define SP_BAD_FILTER   'B'     /* error message for bad capture filter */
 #define SP_PACKET_COUNT 'P'     /* count of packets captured since last message */
 #define SP_DROPS        'D'     /* count of packets dropped in capture */
+#define SP_IF_STATS     'I'     /* periodic per-interface drop/queue statistics */
 #define SP_SUCCESS      'S'     /* success indication, no extra data */
 #define SP_TOOLBAR_CTRL 'T'     /* interface toolbar control packet */
 /*
@@ -421,12 +421,19 @@ parse_num(const char *str, int offset, guint32* num)
 static int
 write_byte(const char *str)
 {
-    guint32 num;
-
-    if (parse_num(str, FALSE, &num) != EXIT_SUCCESS)
+    int hi, lo;
+
+    /* The scanner only hands us T_BYTE tokens that start with two hex
+     * digits, so decode them directly; calling strtoul() once per byte
+     * is the dominant cost when converting a large dump. */
+    hi = g_ascii_xdigit_value(str[0]);
+    lo = g_ascii_xdigit_value(str[1]);
+    if (hi < 0 || lo < 0) {
+        fprintf(stderr, "FATAL ERROR: Bad hex number? [%s]\n", str);
         return EXIT_FAILURE;
+    }
 
-    packet_buf[curr_offset] = (guint8) num;
+    packet_buf[curr_offset] = (guint8) ((hi << 4) | lo);
     curr_offset++;
     if (curr_offset - header_length >= max_offset) /* packet full */
         if (start_new_packet(TRUE) != EXIT_SUCCESS)
@@ -1123,7 +1130,6 @@ parse_token (token_t token, char *str)
     int      line_size;
     int      i;
     char    *s2;
-    char     tmp_str[3];
 
     /*
      * This is implemented as a simple state machine of five states.
@@ -1284,14 +1290,13 @@ parse_token (token_t token, char *str)
                 s2 = (char*)g_malloc((line_size+1)/4+1);
                 /* gather the possible pattern */
                 for (i = 0; i < (line_size+1)/4; i++) {
-                    tmp_str[0] = pkt_lnstart[i*3];
-                    tmp_str[1] = pkt_lnstart[i*3+1];
-                    tmp_str[2] = '\0';
+                    int hi = g_ascii_xdigit_value(pkt_lnstart[i*3]);
+                    int lo = g_ascii_xdigit_value(pkt_lnstart[i*3+1]);
                     /* it is a valid convertable string */
-                    if (!g_ascii_isxdigit(tmp_str[0]) || !g_ascii_isxdigit(tmp_str[1])) {
+                    if (hi < 0 || lo < 0) {
                         break;
                     }
-                    s2[i] = (char)strtoul(tmp_str, (char **)NULL, 16);
+                    s2[i] = (char)((hi << 4) | lo);
                     rollback++;
                     /* the 3rd entry is not a delimiter, so the possible byte pattern will not shown */
                     if (!(pkt_lnstart[i*3+2] == ' ')) {
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# Run tshark's "-z io,bench" phase benchmark over a set of reference
+# captures and print the per-phase timings as TSV, so two builds can be
+# diffed without bisecting by hand.
+#
+# Wireshark - Network traffic analyzer
+# By Gerald Combs <gerald@wireshark.org>
+# Copyright 1998 Gerald Combs
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+import argparse
+import subprocess
+import sys
+
+
+def run_bench(tshark, capture, extra_args):
+    '''Run tshark once and return {phase: (wall_us, cpu_us, max_rss_kib)}.'''
+    cmd = [tshark, '-q', '-z', 'io,bench', '-r', capture] + extra_args
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE,
+                          stderr=subprocess.DEVNULL, universal_newlines=True)
+    if proc.returncode != 0:
+        sys.stderr.write('benchmark-captures: "%s" exited with %d\n'
+                         % (' '.join(cmd), proc.returncode))
+        sys.exit(2)
+
+    phases = {}
+    for line in proc.stdout.splitlines():
+        fields = line.split('\t')
+        if len(fields) != 5 or fields[0] != 'io,bench:' or fields[1] == 'phase':
+            continue
+        rss = -1 if fields[4] == '-' else int(fields[4])
+        phases[fields[1]] = (int(fields[2]), int(fields[3]), rss)
+    if not phases:
+        sys.stderr.write('benchmark-captures: no io,bench output from "%s"\n'
+                         % ' '.join(cmd))
+        sys.exit(2)
+    return phases
+
+
+def main():
+    parser = argparse.ArgumentParser(description='''
+Benchmark tshark capture processing phase by phase.  Extra tshark
+arguments (a read filter, -w, -T fields, ...) can be given after "--"
+to benchmark filtering or export on top of plain reading.''')
+    parser.add_argument('--tshark', default='tshark',
+                        help='path to the tshark binary to benchmark')
+    parser.add_argument('--runs', type=int, default=3,
+                        help='runs per capture; the best (lowest wall '
+                             'time) run of each phase is reported')
+    parser.add_argument('captures', nargs='+', metavar='capture',
+                        help='reference capture files')
+    args, extra_args = parser.parse_known_args()
+    if extra_args and extra_args[0] == '--':
+        extra_args = extra_args[1:]
+
+    print('capture\tphase\twall_us\tcpu_us\tmax_rss_kib')
+    for capture in args.captures:
+        best = {}
+        for _ in range(args.runs):
+            for phase, row in run_bench(args.tshark, capture,
+                                        extra_args).items():
+                if phase not in best or row[0] < best[phase][0]:
+                    best[phase] = row
+        for phase, (wall_us, cpu_us, rss) in best.items():
+            print('%s\t%s\t%d\t%d\t%s'
+                  % (capture, phase, wall_us, cpu_us,
+                     rss if rss >= 0 else '-'))
+
+
+if __name__ == '__main__':
+    main()
@@ -26,6 +26,8 @@
 
 #ifdef _WIN32
 # include <winsock2.h>
+# include <io.h>
+# include <fcntl.h>
 #endif
 
 #ifndef _WIN32
@@ -45,6 +47,7 @@
 #include <epan/exceptions.h>
 #include <epan/epan.h>
 
+#include <ui/bench.h>
 #include <ui/clopts_common.h>
 #include <ui/cmdarg_err.h>
 #include <wsutil/filesystem.h>
@@ -57,6 +60,9 @@
 #include <version_info.h>
 #include <wiretap/wtap_opttypes.h>
 #include <wiretap/pcapng.h>
+#ifdef HAVE_LIBPCAP
+#include <wiretap/pcap-encap.h>
+#endif
 
 #include "globals.h"
 #include <epan/timestamp.h>
@@ -71,6 +77,7 @@
 #include <epan/decode_as.h>
 #include <epan/print.h>
 #include <epan/addr_resolv.h>
+#include <epan/to_str.h>
 #ifdef HAVE_LIBPCAP
 #include "ui/capture_ui_utils.h"
 #endif
@@ -141,6 +148,10 @@
 #define LONGOPT_COLOR                   LONGOPT_BASE_APPLICATION+2
 #define LONGOPT_NO_DUPLICATE_KEYS       LONGOPT_BASE_APPLICATION+3
 #define LONGOPT_ELASTIC_MAPPING_FILTER  LONGOPT_BASE_APPLICATION+4
+#define LONGOPT_SESSION_MEMORY_LIMIT    LONGOPT_BASE_APPLICATION+5
+#define LONGOPT_FILTER_PROFILE          LONGOPT_BASE_APPLICATION+6
+#define LONGOPT_PREFILTER               LONGOPT_BASE_APPLICATION+7
+#define LONGOPT_SAMPLE                  LONGOPT_BASE_APPLICATION+8
 
 #if 0
 #define tshark_debug(...) g_warning(__VA_ARGS__)
@@ -156,7 +167,9 @@ static frame_data prev_dis_frame;
 static frame_data prev_cap_frame;
 
 static gboolean perform_two_pass_analysis;
+static guint32 sample_interval = 0;  /* --sample: dissect only every Nth record */
 static guint32 epan_auto_reset_count = 0;
+static guint64 epan_auto_reset_bytes = 0;
 static gboolean epan_auto_reset = FALSE;
 
 /*
@@ -166,6 +179,7 @@ typedef enum {
   WRITE_TEXT,   /* summary or detail text */
   WRITE_XML,    /* PDML or PSML */
   WRITE_FIELDS, /* User defined list of fields */
+  WRITE_FIELDS_BIN, /* User defined list of fields, length-prefixed binary records */
   WRITE_JSON,   /* JSON */
   WRITE_JSON_RAW,   /* JSON only raw hex */
   WRITE_EK      /* JSON bulk insert to Elasticsearch */
@@ -189,6 +203,8 @@ static print_stream_t *print_stream = NULL;
 static char *output_file_name;
 
 static output_fields_t* output_fields  = NULL;
+static gboolean harvest_fields = FALSE;  /* TRUE if all -e fields can be primed,
+                                            so the tree need not be visible */
 static gchar **protocolfilter = NULL;
 static pf_flags protocolfilter_flags = PF_NONE;
 
@@ -212,6 +228,12 @@ static capture_options global_capture_opts;
 static capture_session global_capture_session;
 static info_data_t global_info_data;
 
+/* --prefilter: BPF program applied to raw records before dissection */
+static const char *prefilter_str = NULL;
+static struct bpf_program prefilter_fcode;
+static int prefilter_cur_encap = -2;    /* DLT the program was compiled for */
+static gboolean prefilter_usable = FALSE;
+
 #ifdef SIGINFO
 static gboolean infodelay;      /* if TRUE, don't print capture info in SIGINFO handler */
 static gboolean infoprint;      /* if TRUE, print capture info after clearing infodelay */
@@ -382,6 +404,17 @@ print_usage(FILE *output)
   fprintf(output, "Processing:\n");
   fprintf(output, "  -2                       perform a two-pass analysis\n");
   fprintf(output, "  -M <packet count>        perform session auto reset\n");
+  fprintf(output, "  --session-memory-limit <MB>\n");
+  fprintf(output, "                           perform session auto reset when the dissection\n");
+  fprintf(output, "                           session holds more than this much memory\n");
+  fprintf(output, "  --filter-profile         print a per-instruction execution profile of the\n");
+  fprintf(output, "                           display filter when done\n");
+#ifdef HAVE_LIBPCAP
+  fprintf(output, "  --prefilter <bpf filter> drop records not matching a capture-filter\n");
+  fprintf(output, "                           expression before dissection (requires -r)\n");
+#endif
+  fprintf(output, "  --sample <interval>      dissect only every Nth record, for approximate\n");
+  fprintf(output, "                           statistics on very large files (requires -r)\n");
   fprintf(output, "  -R <read filter>, --read-filter <read filter>\n");
   fprintf(output, "                           packet Read filter in Wireshark display filter syntax\n");
   fprintf(output, "                           (requires -2)\n");
@@ -399,6 +432,8 @@ print_usage(FILE *output)
   fprintf(output, "                           enable dissection of proto_name\n");
   fprintf(output, "  --disable-protocol <proto_name>\n");
   fprintf(output, "                           disable dissection of proto_name\n");
+  fprintf(output, "                           (\"ALL\" disables every protocol; combine with\n");
+  fprintf(output, "                           --enable-protocol for a minimal dissection set)\n");
   fprintf(output, "  --enable-heuristic <short_name>\n");
   fprintf(output, "                           enable dissection of heuristic protocol\n");
   fprintf(output, "  --disable-heuristic <short_name>\n");
@@ -427,7 +462,7 @@ print_usage(FILE *output)
   fprintf(output, "  -P, --print              print packet summary even when writing to a file\n");
   fprintf(output, "  -S <separator>           the line separator to print between packets\n");
   fprintf(output, "  -x                       add output of hex and ASCII dump (Packet Bytes)\n");
-  fprintf(output, "  -T pdml|ps|psml|json|jsonraw|ek|tabs|text|fields|?\n");
+  fprintf(output, "  -T pdml|ps|psml|json|jsonraw|ek|tabs|text|fields|fieldsbin|?\n");
   fprintf(output, "                           format of text output (def: text)\n");
   fprintf(output, "  -j <protocolfilter>      protocols layers filter if -T ek|pdml|json selected\n");
   fprintf(output, "                           (e.g. \"ip ip.flags text\", filter does not expand child\n");
@@ -706,6 +741,12 @@ main(int argc, char *argv[])
     {"color", no_argument, NULL, LONGOPT_COLOR},
     {"no-duplicate-keys", no_argument, NULL, LONGOPT_NO_DUPLICATE_KEYS},
     {"elastic-mapping-filter", required_argument, NULL, LONGOPT_ELASTIC_MAPPING_FILTER},
+    {"session-memory-limit", required_argument, NULL, LONGOPT_SESSION_MEMORY_LIMIT},
+    {"filter-profile", no_argument, NULL, LONGOPT_FILTER_PROFILE},
+#ifdef HAVE_LIBPCAP
+    {"prefilter", required_argument, NULL, LONGOPT_PREFILTER},
+#endif
+    {"sample", required_argument, NULL, LONGOPT_SAMPLE},
     {0, 0, 0, 0 }
   };
   gboolean             arg_error = FALSE;
@@ -746,6 +787,7 @@ main(int argc, char *argv[])
   char                *volatile exp_pdu_filename = NULL;
   exp_pdu_t            exp_pdu_tap_data;
   const gchar*         elastic_mapping_filter = NULL;
+  gboolean             filter_profile = FALSE;
 
 /*
  * The leading + ensures that getopt_long() does not permute the argv[]
@@ -1077,6 +1119,26 @@ main(int argc, char *argv[])
       epan_auto_reset_count = get_positive_int(optarg, "epan reset count");
       epan_auto_reset = TRUE;
       break;
+    case LONGOPT_SESSION_MEMORY_LIMIT:
+      if(perform_two_pass_analysis){
+        cmdarg_err("--session-memory-limit does not support two pass analysis.");
+        arg_error=TRUE;
+      }
+      epan_auto_reset_bytes = (guint64)get_positive_int(optarg, "session memory limit") * 1024 * 1024;
+      epan_auto_reset = TRUE;
+      break;
+    case LONGOPT_FILTER_PROFILE:
+      filter_profile = TRUE;
+      dfilter_profiling_enable(TRUE);
+      break;
+#ifdef HAVE_LIBPCAP
+    case LONGOPT_PREFILTER:
+      prefilter_str = optarg;
+      break;
+#endif
+    case LONGOPT_SAMPLE:
+      sample_interval = get_positive_int(optarg, "sampling interval");
+      break;
     case 'a':        /* autostop criteria */
     case 'b':        /* Ringbuffer option */
     case 'f':        /* capture filter */
@@ -1324,6 +1386,14 @@ main(int argc, char *argv[])
         output_action = WRITE_FIELDS;
         print_details = TRUE;   /* Need full tree info */
         print_summary = FALSE;  /* Don't allow summary */
+      } else if (strcmp(optarg, "fieldsbin") == 0) {
+        output_action = WRITE_FIELDS_BIN;
+        print_details = TRUE;   /* Need full tree info */
+        print_summary = FALSE;  /* Don't allow summary */
+#ifdef _WIN32
+        /* The output is binary; don't translate line endings. */
+        _setmode(_fileno(stdout), O_BINARY);
+#endif
       } else if (strcmp(optarg, "json") == 0) {
         output_action = WRITE_JSON;
         print_details = TRUE;   /* Need details */
@@ -1341,6 +1411,9 @@ main(int argc, char *argv[])
         cmdarg_err("Invalid -T parameter \"%s\"; it must be one of:", optarg);                   /* x */
         cmdarg_err_cont("\t\"fields\"  The values of fields specified with the -e option, in a form\n"
                         "\t          specified by the -E option.\n"
+                        "\t\"fieldsbin\" The values of fields specified with the -e option, as\n"
+                        "\t          length-prefixed binary records that need no further parsing\n"
+                        "\t          or unescaping by the consumer.\n"
                         "\t\"pdml\"    Packet Details Markup Language, an XML-based format for the\n"
                         "\t          details of a decoded packet. This information is equivalent to\n"
                         "\t          the packet details printed with the -V flag.\n"
@@ -1430,6 +1503,11 @@ main(int argc, char *argv[])
         exit_status = INVALID_OPTION;
         goto clean_exit;
       }
+      /* The stat taps aren't started until after the capture file has
+         been opened, which is too late to time the open; turn phase
+         recording on as soon as we know it's wanted. */
+      if (strcmp(optarg, "io,bench") == 0)
+        bench_enable();
       break;
     case 'd':        /* Decode as rule */
     case 'K':        /* Kerberos keytab file */
@@ -1496,13 +1574,13 @@ main(int argc, char *argv[])
   }
 
   /* If we specified output fields, but not the output field type... */
-  if ((WRITE_FIELDS != output_action && WRITE_XML != output_action && WRITE_JSON != output_action && WRITE_EK != output_action) && 0 != output_fields_num_fields(output_fields)) {
+  if ((WRITE_FIELDS != output_action && WRITE_FIELDS_BIN != output_action && WRITE_XML != output_action && WRITE_JSON != output_action && WRITE_EK != output_action) && 0 != output_fields_num_fields(output_fields)) {
         cmdarg_err("Output fields were specified with \"-e\", "
-            "but \"-Tek, -Tfields, -Tjson or -Tpdml\" was not specified.");
+            "but \"-Tek, -Tfields, -Tfieldsbin, -Tjson or -Tpdml\" was not specified.");
         exit_status = INVALID_OPTION;
         goto clean_exit;
-  } else if (WRITE_FIELDS == output_action && 0 == output_fields_num_fields(output_fields)) {
-        cmdarg_err("\"-Tfields\" was specified, but no fields were "
+  } else if ((WRITE_FIELDS == output_action || WRITE_FIELDS_BIN == output_action) && 0 == output_fields_num_fields(output_fields)) {
+        cmdarg_err("\"-Tfields\" or \"-Tfieldsbin\" was specified, but no fields were "
                     "specified with \"-e\".");
 
         exit_status = INVALID_OPTION;
@@ -1716,6 +1794,22 @@ main(int argc, char *argv[])
         goto clean_exit;
       }
 
+#ifdef HAVE_LIBPCAP
+      if (prefilter_str != NULL) {
+        /* On a live capture the same thing is done in the kernel by "-f". */
+        cmdarg_err("--prefilter only applies when reading a capture file; "
+          "use a capture filter (-f) instead.");
+        exit_status = INVALID_OPTION;
+        goto clean_exit;
+      }
+#endif
+
+      if (sample_interval > 1) {
+        cmdarg_err("--sample only applies when reading a capture file.");
+        exit_status = INVALID_OPTION;
+        goto clean_exit;
+      }
+
       if (global_capture_opts.saving_to_file) {
         /* They specified a "-w" flag, so we'll be saving to a capture file. */
 
@@ -1832,6 +1926,13 @@ main(int argc, char *argv[])
       exit_status = INVALID_OPTION;
       goto clean_exit;
     }
+
+    /* If every field the user asked for can be primed, we don't need a
+       visible protocol tree; priming the fields lets most of the tree
+       be faked, which is a lot cheaper than generating representations
+       for every node. */
+    if (output_action == WRITE_FIELDS || output_action == WRITE_FIELDS_BIN)
+      harvest_fields = output_fields_can_prime(output_fields);
   }
 #ifdef HAVE_LIBPCAP
   /* We currently don't support taps, or printing dissected packets,
@@ -2023,12 +2124,14 @@ main(int argc, char *argv[])
     /*
      * We're reading a capture file.
      */
+    bench_phase_begin("open");
     if (cf_open(&cfile, cf_name, in_file_type, FALSE, &err) != CF_OK) {
       epan_cleanup();
       extcap_cleanup();
       exit_status = INVALID_FILE;
       goto clean_exit;
     }
+    bench_phase_end();
 
     /* Start statistics taps; we do so after successfully opening the
        capture file, so we know we have something to compute stats
@@ -2287,6 +2390,8 @@ clean_exit:
   wtap_cleanup();
   free_progdirs();
   cf_close(&cfile);
+  if (filter_profile && dfcode != NULL)
+    dfilter_dump_profile(dfcode);
   dfilter_free(dfcode);
   return exit_status;
 }
@@ -2742,13 +2847,17 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
     create_proto_tree =
       (cf->rfcode || cf->dfcode || print_details || filtering_tap_listeners ||
         (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids() ||
-        have_custom_cols(&cf->cinfo) || dissect_color);
+        (have_custom_cols(&cf->cinfo) &&
+         ((tap_flags & TL_REQUIRES_COLUMNS) ||
+          (print_packet_info && print_summary) ||
+          output_fields_has_cols(output_fields))) ||
+        dissect_color);
 
     /* The protocol tree will be "visible", i.e., printed, only if we're
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details && !harvest_fields);
 
     wtap_rec_init(&rec);
     ws_buffer_init(&buf, 1514);
@@ -2756,7 +2865,7 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
     while (to_read-- && cf->provider.wth) {
       wtap_cleareof(cf->provider.wth);
       ret = wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info, &data_offset);
-      reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+      reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details && !harvest_fields);
       if (ret == FALSE) {
         /* read from file failed, tell the capture child to stop */
         sync_pipe_stop(cap_session);
@@ -2937,25 +3046,29 @@ capture_cleanup(int signum _U_)
 #endif /* _WIN32 */
 #endif /* HAVE_LIBPCAP */
 
+/*
+ * Dissect one record on the first pass, filling in *fdlocal and
+ * evaluating the read filter, but without touching any per-file
+ * sequencing state other than the reference-frame bookkeeping.
+ *
+ * This is kept separate from first_pass_commit_frame() below so that
+ * a future sharded first pass can run the dissection stage for a batch
+ * of records and then commit the surviving frames in file order; the
+ * commit stage is the only part that must see frames sequentially.
+ * (Actually running this stage on worker threads is blocked on epan's
+ * global dissector state, so for now both stages run inline.)
+ */
 static gboolean
-process_packet_first_pass(capture_file *cf, epan_dissect_t *edt,
-                          gint64 offset, wtap_rec *rec, Buffer *buf)
+first_pass_dissect_frame(capture_file *cf, epan_dissect_t *edt,
+                         frame_data *fdlocal, wtap_rec *rec, Buffer *buf)
 {
-  frame_data     fdlocal;
-  guint32        framenum;
-  gboolean       passed;
-
-  /* The frame number of this packet is one more than the count of
-     frames in this packet. */
-  framenum = cf->count + 1;
+  gboolean passed;
 
   /* If we're not running a display filter and we're not printing any
      packet information, we don't need to do a dissection. This means
      that all packets can be marked as 'passed'. */
   passed = TRUE;
 
-  frame_data_init(&fdlocal, framenum, rec, offset, cum_bytes);
-
   /* If we're going to run a read filter or a display filter, set up to
      do a dissection and do so.  (This is the first pass of two passes
      over the packets, so we will not be printing any information
@@ -2974,25 +3087,49 @@ process_packet_first_pass(capture_file *cf, epan_dissect_t *edt,
        hfids postdissectors want on the first pass. */
     prime_epan_dissect_with_postdissector_wanted_hfids(edt);
 
-    frame_data_set_before_dissect(&fdlocal, &cf->elapsed_time,
+    frame_data_set_before_dissect(fdlocal, &cf->elapsed_time,
                                   &cf->provider.ref, cf->provider.prev_dis);
-    if (cf->provider.ref == &fdlocal) {
-      ref_frame = fdlocal;
+    if (cf->provider.ref == fdlocal) {
+      ref_frame = *fdlocal;
       cf->provider.ref = &ref_frame;
     }
 
     epan_dissect_run(edt, cf->cd_t, rec,
-                     frame_tvbuff_new_buffer(&cf->provider, &fdlocal, buf),
-                     &fdlocal, NULL);
+                     frame_tvbuff_new_buffer(&cf->provider, fdlocal, buf),
+                     fdlocal, NULL);
+
+    /* Queue up asynchronous resolution of this packet's addresses, so
+       that the answers can be looked up in parallel between the passes
+       and the second pass finds them already cached instead of
+       resolving each one synchronously. */
+    if (gbl_resolv_flags.network_name) {
+      address_to_name(&edt->pi.net_src);
+      address_to_name(&edt->pi.net_dst);
+    }
 
     /* Run the read filter if we have one. */
     if (cf->rfcode)
       passed = dfilter_apply_edt(cf->rfcode, edt);
   }
 
+  return passed;
+}
+
+/*
+ * Commit one dissected frame to the frame_data_sequence and update the
+ * per-file counters.  Frames must be committed in file order; this is
+ * the serialization point for any future parallel first pass.
+ */
+static void
+first_pass_commit_frame(capture_file *cf, epan_dissect_t *edt,
+                        frame_data *fdlocal, gboolean passed)
+{
   if (passed) {
-    frame_data_set_after_dissect(&fdlocal, &cum_bytes);
-    cf->provider.prev_cap = cf->provider.prev_dis = frame_data_sequence_add(cf->provider.frames, &fdlocal);
+    frame_data *fdata;
+
+    frame_data_set_after_dissect(fdlocal, &cum_bytes);
+    fdata = frame_data_sequence_add(cf->provider.frames, fdlocal);
+    cf->provider.prev_cap = cf->provider.prev_dis = fdata;
 
     /* If we're not doing dissection then there won't be any dependent frames.
      * More importantly, edt.pi.dependent_frames won't be initialized because
@@ -3002,6 +3139,10 @@ process_packet_first_pass(capture_file *cf, epan_dissect_t *edt,
      */
     if (edt && cf->dfcode) {
       if (dfilter_apply_edt(cf->dfcode, edt)) {
+        /* Remember the verdict, so the second pass can skip frames
+         * that didn't match (and that no matching frame depends on)
+         * without re-reading and re-dissecting them. */
+        fdata->passed_dfilter = 1;
         g_slist_foreach(edt->pi.dependent_frames, find_and_mark_frame_depended_upon, cf->provider.frames);
       }
     }
@@ -3010,8 +3151,23 @@ process_packet_first_pass(capture_file *cf, epan_dissect_t *edt,
   } else {
     /* if we don't add it to the frame_data_sequence, clean it up right now
      * to avoid leaks */
-    frame_data_destroy(&fdlocal);
+    frame_data_destroy(fdlocal);
   }
+}
+
+static gboolean
+process_packet_first_pass(capture_file *cf, epan_dissect_t *edt,
+                          gint64 offset, wtap_rec *rec, Buffer *buf)
+{
+  frame_data     fdlocal;
+  gboolean       passed;
+
+  /* The frame number of this packet is one more than the count of
+     frames in this packet. */
+  frame_data_init(&fdlocal, cf->count + 1, rec, offset, cum_bytes);
+
+  passed = first_pass_dissect_frame(cf, edt, &fdlocal, rec, buf);
+  first_pass_commit_frame(cf, edt, &fdlocal, passed);
 
   if (edt)
     epan_dissect_reset(edt);
@@ -3071,6 +3227,67 @@ typedef enum {
   PASS_INTERRUPTED
 } pass_status_t;
 
+#ifdef HAVE_LIBPCAP
+/*
+ * Run the --prefilter BPF program over a raw record, compiling it the
+ * first time each link-layer type is seen.  Evaluating the program costs
+ * a few dozen interpreted instructions per record, against a full epan
+ * dissection pass for every record it rejects; with a sparse filter
+ * that's nearly all of them.
+ *
+ * Records rejected here are treated as if they weren't in the file at
+ * all: they get no frame number, feed no conversation or reassembly
+ * state and reach no tap - the same result as reading a file that was
+ * filtered externally beforehand.  Records the program can't see into
+ * (non-packet records, link-layer types the BPF compiler doesn't
+ * handle, or expressions it can't compile for this link-layer type)
+ * are passed through to dissection rather than dropped.
+ */
+static gboolean
+prefilter_record(wtap_rec *rec, Buffer *buf)
+{
+  struct pcap_pkthdr hdr;
+  int pcap_encap;
+
+  if (rec->rec_type != REC_TYPE_PACKET)
+    return TRUE;        /* only packet records carry filterable bytes */
+
+  pcap_encap = wtap_wtap_encap_to_pcap_encap(rec->rec_header.packet_header.pkt_encap);
+  if (pcap_encap == -1)
+    return TRUE;        /* no DLT to compile the program against */
+
+  if (pcap_encap != prefilter_cur_encap) {
+    pcap_t *pc;
+
+    if (prefilter_usable) {
+      pcap_freecode(&prefilter_fcode);
+      prefilter_usable = FALSE;
+    }
+    prefilter_cur_encap = pcap_encap;
+    pc = pcap_open_dead(pcap_encap, WTAP_MAX_PACKET_SIZE_STANDARD);
+    if (pc != NULL) {
+      if (pcap_compile(pc, &prefilter_fcode, prefilter_str, 1,
+                       PCAP_NETMASK_UNKNOWN) == 0) {
+        prefilter_usable = TRUE;
+      } else {
+        fprintf(stderr,
+                "tshark: --prefilter \"%s\" isn't valid for this file's link-layer type (%s); passing all records through.\n",
+                prefilter_str, pcap_geterr(pc));
+      }
+      pcap_close(pc);
+    }
+  }
+  if (!prefilter_usable)
+    return TRUE;
+
+  memset(&hdr, 0, sizeof hdr);
+  hdr.caplen = rec->rec_header.packet_header.caplen;
+  hdr.len = rec->rec_header.packet_header.len;
+  return pcap_offline_filter(&prefilter_fcode, &hdr,
+                             ws_buffer_start_ptr(buf)) != 0;
+}
+#endif /* HAVE_LIBPCAP */
+
 static pass_status_t
 process_cap_file_first_pass(capture_file *cf, int max_packet_count,
                             gint64 max_byte_count, int *err, gchar **err_info)
@@ -3079,6 +3296,7 @@ process_cap_file_first_pass(capture_file *cf, int max_packet_count,
   Buffer          buf;
   epan_dissect_t *edt = NULL;
   gint64          data_offset;
+  guint64         sample_count = 0;
   pass_status_t   status = PASS_SUCCEEDED;
 
   wtap_rec_init(&rec);
@@ -3118,6 +3336,18 @@ process_cap_file_first_pass(capture_file *cf, int max_packet_count,
       status = PASS_INTERRUPTED;
       break;
     }
+    if (cf->count == G_MAXUINT32) {
+      /* One more frame would wrap the 32-bit frame number. */
+      fprintf(stderr, "tshark: more than %u frames; stopping at the frame number limit.\n",
+              G_MAXUINT32);
+      break;
+    }
+#ifdef HAVE_LIBPCAP
+    if (prefilter_str != NULL && !prefilter_record(&rec, &buf))
+      continue;
+#endif
+    if (sample_interval > 1 && (sample_count++ % sample_interval) != 0)
+      continue;
     if (process_packet_first_pass(cf, edt, data_offset, &rec, &buf)) {
       /* Stop reading if we have the maximum number of packets;
        * When the -c option has not been used, max_packet_count
@@ -3178,6 +3408,11 @@ process_packet_second_pass(capture_file *cf, epan_dissect_t *edt,
     if (cf->dfcode)
       epan_dissect_prime_with_dfilter(edt, cf->dfcode);
 
+    /* If we're writing a user-specified list of fields from a faked
+       tree, prime the epan_dissect_t with those fields. */
+    if (harvest_fields)
+      output_fields_prime_edt(edt, output_fields);
+
     col_custom_prime_edt(edt, &cf->cinfo);
 
     /* We only need the columns if either
@@ -3251,6 +3486,7 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
   guint32         framenum;
   frame_data     *fdata;
   gboolean        filtering_tap_listeners;
+  gboolean        skip_unfiltered;
   guint           tap_flags;
   epan_dissect_t *edt = NULL;
   pass_status_t   status = PASS_SUCCEEDED;
@@ -3264,6 +3500,16 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
   /* Get the union of the flags for all tap listeners. */
   tap_flags = union_of_tap_listener_flags();
 
+  /* If the first pass already evaluated the display filter for every
+     frame, and no tap listener needs to see the packets that didn't
+     match, frames that failed the filter - and that no matching frame
+     depends on - won't produce any output in this pass, so we don't
+     need to read their data back or re-dissect them at all.  With a
+     sparse filter that turns the second pass's full-file read into a
+     few seeks. */
+  skip_unfiltered = do_dissection && cf->dfcode != NULL &&
+    !tap_listeners_require_dissection();
+
   if (do_dissection) {
     gboolean create_proto_tree;
 
@@ -3277,12 +3523,20 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
      *
      *    one of the tap listeners requires a protocol tree;
      *
-     *    we have custom columns (which require field values, which
-     *    currently requires that we build a protocol tree).
+     *    we're filling in columns and have custom columns (which
+     *    require field values, which currently requires that we
+     *    build a protocol tree).  Custom columns configured in the
+     *    profile don't force a tree when nothing consumes columns
+     *    on this run.
      */
     create_proto_tree =
       (cf->dfcode || print_details || filtering_tap_listeners ||
-       (tap_flags & TL_REQUIRES_PROTO_TREE) || have_custom_cols(&cf->cinfo) || dissect_color);
+       (tap_flags & TL_REQUIRES_PROTO_TREE) ||
+       (have_custom_cols(&cf->cinfo) &&
+        ((tap_flags & TL_REQUIRES_COLUMNS) ||
+         (print_packet_info && print_summary) ||
+         output_fields_has_cols(output_fields))) ||
+       dissect_color);
 
     tshark_debug("tshark: create_proto_tree = %s", create_proto_tree ? "TRUE" : "FALSE");
 
@@ -3290,9 +3544,16 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details && !harvest_fields);
   }
 
+  /*
+   * Resolve the addresses the first pass queued up, running the
+   * lookups concurrently, so the sync fallback below is only hit by
+   * addresses the first pass didn't see.
+   */
+  host_name_lookup_drain();
+
   /*
    * Force synchronous resolution of IP addresses; in this pass, we
    * can't do it in the background and fix up past dissections.
@@ -3305,6 +3566,11 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
       break;
     }
     fdata = frame_data_sequence_find(cf->provider.frames, framenum);
+    if (skip_unfiltered && !fdata->passed_dfilter &&
+        !fdata->dependent_of_displayed) {
+      cf->provider.prev_cap = fdata;
+      continue;
+    }
     if (!wtap_seek_read(cf->provider.wth, fdata->file_off, &rec, &buf, err,
                         err_info)) {
       /* Error reading from the input file. */
@@ -3352,6 +3618,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
   guint32         framenum;
   epan_dissect_t *edt = NULL;
   gint64          data_offset;
+  guint64         sample_count = 0;
   pass_status_t   status = PASS_SUCCEEDED;
 
   wtap_rec_init(&rec);
@@ -3389,7 +3656,11 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
     create_proto_tree =
       (cf->rfcode || cf->dfcode || print_details || filtering_tap_listeners ||
         (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids() ||
-        have_custom_cols(&cf->cinfo) || dissect_color);
+        (have_custom_cols(&cf->cinfo) &&
+         ((tap_flags & TL_REQUIRES_COLUMNS) ||
+          (print_packet_info && print_summary) ||
+          output_fields_has_cols(output_fields))) ||
+        dissect_color);
 
     tshark_debug("tshark: create_proto_tree = %s", create_proto_tree ? "TRUE" : "FALSE");
 
@@ -3397,7 +3668,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details && !harvest_fields);
   }
 
   /*
@@ -3413,11 +3684,23 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
       status = PASS_INTERRUPTED;
       break;
     }
+    if (framenum == G_MAXUINT32) {
+      /* One more frame would wrap the 32-bit frame number. */
+      fprintf(stderr, "tshark: more than %u frames; stopping at the frame number limit.\n",
+              G_MAXUINT32);
+      break;
+    }
+#ifdef HAVE_LIBPCAP
+    if (prefilter_str != NULL && !prefilter_record(&rec, &buf))
+      continue;
+#endif
+    if (sample_interval > 1 && (sample_count++ % sample_interval) != 0)
+      continue;
     framenum++;
 
     tshark_debug("tshark: processing packet #%d", framenum);
 
-    reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+    reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details && !harvest_fields);
 
     if (process_packet_single_pass(cf, edt, data_offset, &rec, &buf, tap_flags)) {
       /* Either there's no read filtering or this packet passed the
@@ -3544,10 +3827,12 @@ process_cap_file(capture_file *cf, char *save_file, int out_file_type,
   if (perform_two_pass_analysis) {
     tshark_debug("tshark: perform_two_pass_analysis, do_dissection=%s", do_dissection ? "TRUE" : "FALSE");
 
+    bench_phase_begin("first pass");
     first_pass_status = process_cap_file_first_pass(cf, max_packet_count,
                                                     max_byte_count,
                                                     &err_pass1,
                                                     &err_info_pass1);
+    bench_phase_end();
 
     tshark_debug("tshark: done with first pass");
 
@@ -3563,8 +3848,10 @@ process_cap_file(capture_file *cf, char *save_file, int out_file_type,
        * we report any second-pass errors), so all the the errors show up
        * at the end.
        */
+      bench_phase_begin("second pass");
       second_pass_status = process_cap_file_second_pass(cf, pdh, &err, &err_info,
                                                         &err_framenum);
+      bench_phase_end();
 
       tshark_debug("tshark: done with second pass");
     }
@@ -3574,11 +3861,13 @@ process_cap_file(capture_file *cf, char *save_file, int out_file_type,
     tshark_debug("tshark: perform one pass analysis, do_dissection=%s", do_dissection ? "TRUE" : "FALSE");
 
     first_pass_status = PASS_SUCCEEDED; /* There is no first pass */
+    bench_phase_begin("single pass");
     second_pass_status = process_cap_file_single_pass(cf, pdh,
                                                       max_packet_count,
                                                       max_byte_count,
                                                       &err, &err_info,
                                                       &err_framenum);
+    bench_phase_end();
   }
 
   if (first_pass_status != PASS_SUCCEEDED ||
@@ -3737,6 +4026,11 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
        with the hfids postdissectors want on the first pass. */
     prime_epan_dissect_with_postdissector_wanted_hfids(edt);
 
+    /* If we're writing a user-specified list of fields from a faked
+       tree, prime the epan_dissect_t with those fields. */
+    if (harvest_fields)
+      output_fields_prime_edt(edt, output_fields);
+
     col_custom_prime_edt(edt, &cf->cinfo);
 
     /* We only need the columns if either
@@ -3828,12 +4122,24 @@ write_preamble(capture_file *cf)
     write_fields_preamble(output_fields, stdout);
     return !ferror(stdout);
 
+  case WRITE_FIELDS_BIN:
+    write_fields_bin_preamble(output_fields, stdout);
+    return !ferror(stdout);
+
   case WRITE_JSON:
   case WRITE_JSON_RAW:
+    if (!line_buffered && !ws_isatty(ws_fileno(stdout)))
+      setvbuf(stdout, NULL, _IOFBF, 256 * 1024);
     jdumper = write_json_preamble(stdout);
     return !ferror(stdout);
 
   case WRITE_EK:
+    /* An ek or json export is typically gigabytes of NDJSON produced
+       in many small stdio writes; a bigger output buffer cuts the
+       number of write() calls accordingly.  Not with "-l", where the
+       user asked for prompt output. */
+    if (!line_buffered && !ws_isatty(ws_fileno(stdout)))
+      setvbuf(stdout, NULL, _IOFBF, 256 * 1024);
     return TRUE;
 
   default:
@@ -4181,6 +4487,17 @@ print_packet(capture_file *cf, epan_dissect_t *edt)
     }
     break;
 
+  case WRITE_FIELDS_BIN:
+    if (print_summary) {
+      /*No non-verbose "fields" format */
+      g_assert_not_reached();
+    }
+    if (print_details) {
+      write_fields_bin_proto_tree(output_fields, edt, &cf->cinfo, stdout);
+      return !ferror(stdout);
+    }
+    break;
+
   case WRITE_JSON:
     if (print_summary)
       g_assert_not_reached();
@@ -4238,6 +4555,7 @@ write_finale(void)
     return !ferror(stdout);
 
   case WRITE_FIELDS:
+  case WRITE_FIELDS_BIN:
     write_fields_finale(output_fields, stdout);
     return !ferror(stdout);
 
@@ -4399,7 +4717,26 @@ write_failure_message(const char *filename, int err)
 
 static void reset_epan_mem(capture_file *cf,epan_dissect_t *edt, gboolean tree, gboolean visual)
 {
-  if (!epan_auto_reset || (cf->count < epan_auto_reset_count))
+  gboolean do_reset = FALSE;
+
+  if (!epan_auto_reset)
+    return;
+
+  if (epan_auto_reset_count != 0 && cf->count >= epan_auto_reset_count)
+    do_reset = TRUE;
+
+  if (!do_reset && epan_auto_reset_bytes != 0) {
+    gsize file_bytes;
+
+    /* The bytes requested from the file scope track the conversation,
+       reassembly etc. state the session has piled up since the last
+       reset; when they cross the limit, start over. */
+    wmem_allocator_get_stats(wmem_file_scope(), &file_bytes, NULL, NULL);
+    if (file_bytes >= epan_auto_reset_bytes)
+      do_reset = TRUE;
+  }
+
+  if (!do_reset)
     return;
 
   fprintf(stderr, "resetting session.\n");
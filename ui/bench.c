@@ -0,0 +1,149 @@
+/* bench.c
+ * Phase benchmarking for the command-line tools
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#ifndef _WIN32
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+#include <wsutil/time_util.h>
+
+#include "ui/bench.h"
+
+typedef struct {
+    const char *name;
+    guint64     wall_us;
+    guint64     cpu_us;     /* user + system */
+    gint64      max_rss_kib; /* high-water mark at phase end, -1 if unknown */
+} bench_phase_t;
+
+static gboolean    bench_enabled = FALSE;
+static GArray     *bench_phases = NULL;
+static const char *cur_name = NULL;
+static guint64     cur_start_us;
+static guint64     cur_start_cpu;
+
+/* Process peak RSS in KiB, or -1 where we can't get it. */
+static gint64
+bench_max_rss_kib(void)
+{
+#ifndef _WIN32
+    struct rusage ru;
+
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+#ifdef __APPLE__
+        return (gint64)(ru.ru_maxrss / 1024);   /* reported in bytes */
+#else
+        return (gint64)ru.ru_maxrss;            /* reported in KiB */
+#endif
+    }
+#endif
+    return -1;
+}
+
+static guint64
+bench_cpu_us(void)
+{
+    double user_time, sys_time;
+
+    get_resource_usage(&user_time, &sys_time);
+    return (guint64)((user_time + sys_time) * 1000000.0);
+}
+
+void
+bench_enable(void)
+{
+    bench_enabled = TRUE;
+    if (bench_phases == NULL)
+        bench_phases = g_array_new(FALSE, FALSE, sizeof(bench_phase_t));
+}
+
+void
+bench_phase_begin(const char *name)
+{
+    if (!bench_enabled)
+        return;
+
+    if (cur_name != NULL)
+        bench_phase_end();
+
+    cur_name = name;
+    cur_start_cpu = bench_cpu_us();
+    cur_start_us = (guint64)g_get_monotonic_time();
+}
+
+void
+bench_phase_end(void)
+{
+    bench_phase_t phase;
+
+    if (!bench_enabled || cur_name == NULL)
+        return;
+
+    phase.name = cur_name;
+    phase.wall_us = (guint64)g_get_monotonic_time() - cur_start_us;
+    phase.cpu_us = bench_cpu_us() - cur_start_cpu;
+    phase.max_rss_kib = bench_max_rss_kib();
+    g_array_append_val(bench_phases, phase);
+
+    cur_name = NULL;
+}
+
+void
+bench_report(FILE *fp)
+{
+    guint64 total_wall = 0, total_cpu = 0;
+    gint64 last_rss = -1;
+    guint i;
+
+    if (!bench_enabled)
+        return;
+
+    fprintf(fp, "io,bench:\tphase\twall_us\tcpu_us\tmax_rss_kib\n");
+    for (i = 0; i < bench_phases->len; i++) {
+        const bench_phase_t *phase =
+            &g_array_index(bench_phases, bench_phase_t, i);
+
+        fprintf(fp, "io,bench:\t%s\t%" G_GUINT64_FORMAT "\t%" G_GUINT64_FORMAT,
+                phase->name, phase->wall_us, phase->cpu_us);
+        if (phase->max_rss_kib >= 0)
+            fprintf(fp, "\t%" G_GINT64_FORMAT "\n", phase->max_rss_kib);
+        else
+            fprintf(fp, "\t-\n");
+
+        total_wall += phase->wall_us;
+        total_cpu += phase->cpu_us;
+        last_rss = phase->max_rss_kib;
+    }
+
+    fprintf(fp, "io,bench:\ttotal\t%" G_GUINT64_FORMAT "\t%" G_GUINT64_FORMAT,
+            total_wall, total_cpu);
+    if (last_rss >= 0)
+        fprintf(fp, "\t%" G_GINT64_FORMAT "\n", last_rss);
+    else
+        fprintf(fp, "\t-\n");
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
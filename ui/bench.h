@@ -0,0 +1,52 @@
+/* bench.h
+ * Phase benchmarking for the command-line tools
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdio.h>
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Wall-clock, CPU and memory accounting for the coarse phases of
+ * processing a capture file (open, first pass, second pass, ...).
+ *
+ * The begin/end calls are cheap no-ops until bench_enable() has been
+ * called, so they can sit unconditionally in the processing loops;
+ * "tshark -z io,bench" enables them and prints the report when the
+ * taps are drawn.
+ */
+
+/** Turn phase recording on. */
+extern void bench_enable(void);
+
+/** Start a named phase, ending any phase still open. */
+extern void bench_phase_begin(const char *name);
+
+/** End the phase started by the last bench_phase_begin(). */
+extern void bench_phase_end(void);
+
+/** Print one tab-separated line per recorded phase, plus a total:
+ *  "io,bench:" TAB phase TAB wall_us TAB cpu_us TAB max_rss_kib
+ *  The RSS column is the process high-water mark at the end of the
+ *  phase ("-" where the platform doesn't report one).
+ */
+extern void bench_report(FILE *fp);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __BENCH_H__ */
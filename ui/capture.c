@@ -531,7 +531,21 @@ capture_info_new_packets(int to_read, wtap *wth, info_data_t* cap_info)
     capture_info_ui_update(&cap_info->ui);
 }
 
-/* capture child tells us we have new packets to read */
+/* capture child tells us we have new packets to read
+ *
+ * The packets reach us by tailing the file dumpcap is writing; a
+ * shared-memory ring from dumpcap has been considered and rejected.
+ * The file has to stay the data path regardless: the frame table
+ * records file offsets, and every later random access (packet details,
+ * byte view, Save As) seeks the file through wtap, so ring delivery
+ * could only replace this sequential read -- which already comes out
+ * of the page cache, since dumpcap wrote those blocks moments ago.
+ * It would also widen dumpcap's parent interface, which privilege
+ * separation deliberately keeps to a control pipe plus a plain file.
+ * Live-view latency is set by how often dumpcap flushes and announces
+ * batches over the sync pipe (SP_PACKET_COUNT), not by disk
+ * round-trips.
+ */
 void
 capture_input_new_packets(capture_session *cap_session, int to_read)
 {
@@ -0,0 +1,144 @@
+/* tap-dissectorstat.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* Report the self-cost of each dissector that ran: invocation count,
+ * wall-clock time and wmem allocation bytes, sorted by time.  Useful
+ * for finding out which dissectors make a given capture slow. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_dissectorstat(void);
+
+#define TAP_NAME "dissectors,stat"
+
+typedef struct {
+	const char *name;
+	guint64	calls;
+	guint64	time_us;
+	guint64	wmem_bytes;
+} dissstat_row_t;
+
+static void
+dissstat_collect(const char *name, guint64 calls, guint64 time_us,
+    guint64 wmem_bytes, void *user_data)
+{
+	GArray *rows = (GArray *)user_data;
+	dissstat_row_t row;
+
+	row.name = name;
+	row.calls = calls;
+	row.time_us = time_us;
+	row.wmem_bytes = wmem_bytes;
+	g_array_append_val(rows, row);
+}
+
+/* Sort by self time, most expensive first. */
+static gint
+dissstat_compare(gconstpointer a, gconstpointer b)
+{
+	const dissstat_row_t *row_a = (const dissstat_row_t *)a;
+	const dissstat_row_t *row_b = (const dissstat_row_t *)b;
+
+	if (row_a->time_us != row_b->time_us)
+		return (row_a->time_us < row_b->time_us) ? 1 : -1;
+	return strcmp(row_a->name, row_b->name);
+}
+
+static void
+dissstat_draw(void *dummy _U_)
+{
+	GArray *rows;
+	guint i;
+
+	rows = g_array_new(FALSE, FALSE, sizeof(dissstat_row_t));
+	dissector_profiling_foreach(dissstat_collect, rows);
+	g_array_sort(rows, dissstat_compare);
+
+	printf("\n");
+	printf("=========================================================================\n");
+	printf("Dissector self-cost statistics\n");
+	printf("Time and memory spent in subdissectors are charged to the subdissector.\n");
+	printf("-------------------------------------------------------------------------\n");
+	printf("dissector                         calls         time (us)     wmem bytes\n");
+
+	for (i = 0; i < rows->len; i++) {
+		const dissstat_row_t *row =
+		    &g_array_index(rows, dissstat_row_t, i);
+
+		printf("%-28s %10" G_GUINT64_FORMAT " %17" G_GUINT64_FORMAT
+		    " %14" G_GUINT64_FORMAT "\n",
+		    row->name, row->calls, row->time_us, row->wmem_bytes);
+	}
+
+	printf("=========================================================================\n");
+
+	g_array_free(rows, TRUE);
+}
+
+static void
+dissstat_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+
+	if (strcmp(TAP_NAME, opt_arg) != 0) {
+		cmdarg_err("invalid \"-z " TAP_NAME "\" argument");
+		exit(1);
+	}
+
+	dissector_profiling_enable(TRUE);
+
+	error_string = register_tap_listener("frame", NULL, NULL, 0,
+					     NULL, NULL, dissstat_draw, NULL);
+	if (error_string) {
+		/* error, we failed to attach to the tap. clean up */
+		cmdarg_err("Couldn't register " TAP_NAME " tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui dissstat_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	TAP_NAME,
+	dissstat_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_dissectorstat(void)
+{
+	register_stat_tap_ui(&dissstat_ui, NULL);
+}
+
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
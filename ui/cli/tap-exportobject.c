@@ -29,6 +29,9 @@
 typedef struct _export_object_list_gui_t {
     GSList *entries;
     register_eo_t* eo;
+    const gchar *save_in_path;  /* destination directory from eo_opts */
+    gboolean streaming;         /* entries are written out as they arrive */
+    gboolean save_in_path_ok;   /* destination directory is known to exist */
 } export_object_list_gui_t;
 
 static GHashTable* eo_opts = NULL;
@@ -82,11 +85,71 @@ gboolean eo_tap_opt_add(const char *option_string)
     return FALSE;
 }
 
+/* Makes sure the destination directory (and its parents) exist. */
+static gboolean
+eo_prepare_save_in_path(const gchar *save_in_path)
+{
+    if (!g_file_test(save_in_path, G_FILE_TEST_IS_DIR)) {
+        if (g_mkdir_with_parents(save_in_path, 0755) == -1) {
+            fprintf(stderr, "Failed to create export objects output directory \"%s\": %s\n",
+                    save_in_path, g_strerror(errno));
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* Picks a file name that doesn't collide with anything already in the
+   destination directory and writes the object out. */
+static void
+eo_write_entry(const gchar *save_in_path, export_object_entry_t *entry)
+{
+    GString *safe_filename = NULL;
+    gchar *save_as_fullpath = NULL;
+    guint count = 0;
+
+    do {
+        g_free(save_as_fullpath);
+        if (entry->filename) {
+            safe_filename = eo_massage_str(entry->filename,
+                EXPORT_OBJECT_MAXFILELEN, count);
+        } else {
+            char generic_name[EXPORT_OBJECT_MAXFILELEN+1];
+            const char *ext;
+            ext = eo_ct2ext(entry->content_type);
+            g_snprintf(generic_name, sizeof(generic_name),
+                "object%u%s%s", entry->pkt_num, ext ? "." : "", ext ? ext : "");
+            safe_filename = eo_massage_str(generic_name,
+                EXPORT_OBJECT_MAXFILELEN, count);
+        }
+        save_as_fullpath = g_build_filename(save_in_path, safe_filename->str, NULL);
+        g_string_free(safe_filename, TRUE);
+    } while (g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS) && ++count < prefs.gui_max_export_objects);
+    eo_save_entry(save_as_fullpath, entry);
+    g_free(save_as_fullpath);
+}
+
 static void
 object_list_add_entry(void *gui_data, export_object_entry_t *entry)
 {
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)gui_data;
 
+    if (object_list->streaming) {
+        /* The object is complete; write it out now and release it
+           rather than keeping every body in memory until the end of
+           the tap pass. */
+        if (!object_list->save_in_path_ok) {
+            if (!eo_prepare_save_in_path(object_list->save_in_path)) {
+                eo_free_entry(entry);
+                return;
+            }
+            object_list->save_in_path_ok = TRUE;
+        }
+        eo_write_entry(object_list->save_in_path, entry);
+        eo_free_entry(entry);
+        return;
+    }
+
     object_list->entries = g_slist_append(object_list->entries, entry);
 }
 
@@ -105,45 +168,24 @@ eo_draw(void *tapdata)
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)tap_object->gui_data;
     GSList *slist = object_list->entries;
     export_object_entry_t *entry;
-    gchar* save_in_path = (gchar*)g_hash_table_lookup(eo_opts, proto_get_protocol_filter_name(get_eo_proto_id(object_list->eo)));
-    GString *safe_filename = NULL;
-    gchar *save_as_fullpath = NULL;
-    guint count = 0;
 
-    if (!g_file_test(save_in_path, G_FILE_TEST_IS_DIR)) {
-        /* If the destination directory (or its parents) do not exist, create them. */
-        if (g_mkdir_with_parents(save_in_path, 0755) == -1) {
-            fprintf(stderr, "Failed to create export objects output directory \"%s\": %s\n",
-                    save_in_path, g_strerror(errno));
+    /* Streaming lists have already written (and freed) their entries
+       as they arrived, so there's nothing left to do here. */
+    if (!object_list->save_in_path_ok) {
+        if (!eo_prepare_save_in_path(object_list->save_in_path))
             return;
-        }
+        object_list->save_in_path_ok = TRUE;
     }
 
     while (slist) {
         entry = (export_object_entry_t *)slist->data;
-        do {
-            g_free(save_as_fullpath);
-            if (entry->filename) {
-                safe_filename = eo_massage_str(entry->filename,
-                    EXPORT_OBJECT_MAXFILELEN, count);
-            } else {
-                char generic_name[EXPORT_OBJECT_MAXFILELEN+1];
-                const char *ext;
-                ext = eo_ct2ext(entry->content_type);
-                g_snprintf(generic_name, sizeof(generic_name),
-                    "object%u%s%s", entry->pkt_num, ext ? "." : "", ext ? ext : "");
-                safe_filename = eo_massage_str(generic_name,
-                    EXPORT_OBJECT_MAXFILELEN, count);
-            }
-            save_as_fullpath = g_build_filename(save_in_path, safe_filename->str, NULL);
-            g_string_free(safe_filename, TRUE);
-        } while (g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS) && ++count < prefs.gui_max_export_objects);
-        count = 0;
-        eo_save_entry(save_as_fullpath, entry);
-        g_free(save_as_fullpath);
-        save_as_fullpath = NULL;
+        eo_write_entry(object_list->save_in_path, entry);
+        /* written out; no reason to keep the body around */
+        eo_free_entry(entry);
         slist = slist->next;
     }
+    g_slist_free(object_list->entries);
+    object_list->entries = NULL;
 }
 
 static void
@@ -169,6 +211,15 @@ exportobject_handler(gpointer key, gpointer value _U_, gpointer user_data _U_)
     tap_data->gui_data = (void*)object_list;
 
     object_list->eo = eo;
+    object_list->save_in_path = (const gchar*)g_hash_table_lookup(eo_opts, key);
+
+    /* XXX - the SMB tap keeps appending chunks to an entry after
+       add_entry as later segments of the file show up, so its objects
+       can only be written once the whole pass is over.  Every other
+       tap hands over finished objects, which we can write immediately
+       and free instead of accumulating tens of GB of bodies. */
+    if (strcmp((const char*)key, "smb") != 0)
+        object_list->streaming = TRUE;
 
     /* Data will be gathered via a tap callback */
     error_msg = register_tap_listener(get_eo_tap_listener_name(eo), tap_data, NULL, 0,
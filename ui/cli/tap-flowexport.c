@@ -0,0 +1,483 @@
+/* tap-flowexport.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* Export TCP and UDP flow records to a file in IPFIX (RFC 7011)
+ * format: unidirectional 5-tuple flows with packet and octet counters,
+ * millisecond start/end timestamps and the union of TCP flags.  The
+ * file is rewritten atomically on every tap redraw, so during a live
+ * capture it always holds a complete, valid export of the flows seen
+ * so far, and after a file read it holds the final export.  Records
+ * are batched into IPFIX messages of up to ~64 KiB, so the writes are
+ * a handful of large buffers rather than one call per flow. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/ipproto.h>
+#include <epan/dissectors/packet-tcp.h>
+#include <epan/dissectors/packet-udp.h>
+
+#include <ui/cmdarg_err.h>
+
+#include <wsutil/file_util.h>
+
+void register_tap_listener_flowexport(void);
+
+#define TAP_NAME "flowexport"
+
+/* IPFIX information elements used in the templates below */
+#define IE_OCTET_DELTA_COUNT		 1	/* unsigned64 */
+#define IE_PACKET_DELTA_COUNT		 2	/* unsigned64 */
+#define IE_PROTOCOL_IDENTIFIER		 4	/* unsigned8 */
+#define IE_TCP_CONTROL_BITS		 6	/* unsigned16, RFC 7125 */
+#define IE_SOURCE_TRANSPORT_PORT	 7	/* unsigned16 */
+#define IE_SOURCE_IPV4_ADDRESS		 8	/* ipv4Address */
+#define IE_DEST_TRANSPORT_PORT		11	/* unsigned16 */
+#define IE_DEST_IPV4_ADDRESS		12	/* ipv4Address */
+#define IE_SOURCE_IPV6_ADDRESS		27	/* ipv6Address */
+#define IE_DEST_IPV6_ADDRESS		28	/* ipv6Address */
+#define IE_FLOW_START_MILLISECONDS	152	/* dateTimeMilliseconds */
+#define IE_FLOW_END_MILLISECONDS	153	/* dateTimeMilliseconds */
+
+#define TEMPLATE_ID_V4	256
+#define TEMPLATE_ID_V6	257
+
+/* Data record sizes for the two templates */
+#define RECORD_LEN_V4	(4 + 4 + 2 + 2 + 1 + 2 + 8 + 8 + 8 + 8)
+#define RECORD_LEN_V6	(16 + 16 + 2 + 2 + 1 + 2 + 8 + 8 + 8 + 8)
+
+/* Flush a message before it can exceed the 16-bit IPFIX length field. */
+#define MESSAGE_FLUSH_LEN	64000u
+
+/* Flow key; a flow is one direction of a 5-tuple.  The layout has no
+ * padding holes, so the key can be hashed and compared as raw bytes. */
+typedef struct _fx_flow_key_t {
+	guint8  af;		/* 4 or 6 */
+	guint8  proto;		/* IP protocol number */
+	guint16 sport;
+	guint16 dport;
+	guint8  src[16];	/* 4 or 16 bytes used, rest zero */
+	guint8  dst[16];
+} fx_flow_key_t;
+
+typedef struct _fx_flow_t {
+	fx_flow_key_t key;
+	guint64  packets;
+	guint64  octets;
+	nstime_t start;
+	nstime_t end;
+	guint16  tcp_flags;	/* union over the flow's segments */
+} fx_flow_t;
+
+typedef struct _fx_stat_t {
+	char       *path;	/* file to (re)write on each redraw */
+	GHashTable *flows;	/* k=&fx_flow_t.key v=fx_flow_t */
+} fx_stat_t;
+
+static guint
+fx_key_hash(gconstpointer k)
+{
+	const guint8 *bytes = (const guint8 *)k;
+	guint h = 5381;
+	size_t i;
+
+	for (i = 0; i < sizeof(fx_flow_key_t); i++)
+		h = (h << 5) + h + bytes[i];
+	return h;
+}
+
+static gboolean
+fx_key_equal(gconstpointer a, gconstpointer b)
+{
+	return memcmp(a, b, sizeof(fx_flow_key_t)) == 0;
+}
+
+/* Find or create the flow for a 5-tuple and account one packet to it.
+ * Returns NULL (and accounts nothing) for non-IP address types. */
+static fx_flow_t *
+flowexport_account(fx_stat_t *fx, packet_info *pinfo,
+    const address *src, const address *dst,
+    guint16 sport, guint16 dport, guint8 proto)
+{
+	fx_flow_key_t key;
+	fx_flow_t *flow;
+
+	memset(&key, 0, sizeof key);
+	switch (src->type) {
+	case AT_IPv4:
+		key.af = 4;
+		memcpy(key.src, src->data, 4);
+		memcpy(key.dst, dst->data, 4);
+		break;
+	case AT_IPv6:
+		key.af = 6;
+		memcpy(key.src, src->data, 16);
+		memcpy(key.dst, dst->data, 16);
+		break;
+	default:
+		return NULL;
+	}
+	key.proto = proto;
+	key.sport = sport;
+	key.dport = dport;
+
+	flow = (fx_flow_t *)g_hash_table_lookup(fx->flows, &key);
+	if (flow == NULL) {
+		flow = g_new0(fx_flow_t, 1);
+		flow->key = key;
+		flow->start = pinfo->abs_ts;
+		g_hash_table_insert(fx->flows, &flow->key, flow);
+	}
+	flow->packets++;
+	flow->octets += pinfo->fd->pkt_len;
+	flow->end = pinfo->abs_ts;
+	return flow;
+}
+
+static tap_packet_status
+flowexport_tcp_packet(void *arg, packet_info *pinfo, epan_dissect_t *edt _U_,
+    const void *data)
+{
+	fx_stat_t *fx = (fx_stat_t *)arg;
+	const tcp_info_t *tcph = (const tcp_info_t *)data;
+	fx_flow_t *flow;
+
+	flow = flowexport_account(fx, pinfo, &tcph->ip_src, &tcph->ip_dst,
+	    tcph->th_sport, tcph->th_dport, IP_PROTO_TCP);
+	if (flow == NULL)
+		return TAP_PACKET_DONT_REDRAW;
+	flow->tcp_flags |= tcph->th_flags;
+	return TAP_PACKET_REDRAW;
+}
+
+static tap_packet_status
+flowexport_udp_packet(void *arg, packet_info *pinfo, epan_dissect_t *edt _U_,
+    const void *data)
+{
+	fx_stat_t *fx = (fx_stat_t *)arg;
+	const e_udphdr *udph = (const e_udphdr *)data;
+
+	if (flowexport_account(fx, pinfo, &udph->ip_src, &udph->ip_dst,
+	    udph->uh_sport, udph->uh_dport, IP_PROTO_UDP) == NULL)
+		return TAP_PACKET_DONT_REDRAW;
+	return TAP_PACKET_REDRAW;
+}
+
+static void
+flowexport_reset(void *arg)
+{
+	fx_stat_t *fx = (fx_stat_t *)arg;
+
+	g_hash_table_remove_all(fx->flows);
+}
+
+/* IPFIX message assembly.  Messages are built in a byte array and
+ * written out whole; the message and set lengths are patched in when
+ * the message is flushed. */
+typedef struct _fx_writer_t {
+	FILE       *fh;
+	GByteArray *msg;
+	guint       set_start;	/* offset of the open set's header */
+	guint16     set_id;
+	guint32     seq;	/* data records in previous messages */
+	guint32     msg_records;
+	guint32     export_secs;
+	gboolean    ok;
+} fx_writer_t;
+
+static void
+fx_put_u16(GByteArray *ba, guint16 val)
+{
+	guint8 buf[2];
+
+	buf[0] = (guint8)(val >> 8);
+	buf[1] = (guint8)val;
+	g_byte_array_append(ba, buf, 2);
+}
+
+static void
+fx_put_u32(GByteArray *ba, guint32 val)
+{
+	guint8 buf[4];
+
+	buf[0] = (guint8)(val >> 24);
+	buf[1] = (guint8)(val >> 16);
+	buf[2] = (guint8)(val >> 8);
+	buf[3] = (guint8)val;
+	g_byte_array_append(ba, buf, 4);
+}
+
+static void
+fx_put_u64(GByteArray *ba, guint64 val)
+{
+	fx_put_u32(ba, (guint32)(val >> 32));
+	fx_put_u32(ba, (guint32)val);
+}
+
+static void
+fx_patch_u16(GByteArray *ba, guint offset, guint16 val)
+{
+	ba->data[offset] = (guint8)(val >> 8);
+	ba->data[offset + 1] = (guint8)val;
+}
+
+static void
+fx_msg_begin(fx_writer_t *fw)
+{
+	g_byte_array_set_size(fw->msg, 0);
+	fx_put_u16(fw->msg, 10);		/* version */
+	fx_put_u16(fw->msg, 0);			/* length, patched on flush */
+	fx_put_u32(fw->msg, fw->export_secs);
+	fx_put_u32(fw->msg, fw->seq);
+	fx_put_u32(fw->msg, 0);			/* observation domain */
+	fw->set_start = 0;
+	fw->msg_records = 0;
+}
+
+static void
+fx_set_begin(fx_writer_t *fw, guint16 set_id)
+{
+	fw->set_start = fw->msg->len;
+	fw->set_id = set_id;
+	fx_put_u16(fw->msg, set_id);
+	fx_put_u16(fw->msg, 0);			/* length, patched on close */
+}
+
+static void
+fx_set_end(fx_writer_t *fw)
+{
+	if (fw->set_start == 0)
+		return;
+	fx_patch_u16(fw->msg, fw->set_start + 2,
+	    (guint16)(fw->msg->len - fw->set_start));
+	fw->set_start = 0;
+}
+
+static void
+fx_msg_flush(fx_writer_t *fw)
+{
+	fx_set_end(fw);
+	if (fw->msg->len <= 16) {
+		fw->msg_records = 0;
+		return;			/* nothing but the header */
+	}
+	fx_patch_u16(fw->msg, 2, (guint16)fw->msg->len);
+	if (fw->ok &&
+	    fwrite(fw->msg->data, 1, fw->msg->len, fw->fh) != fw->msg->len)
+		fw->ok = FALSE;
+	fw->seq += fw->msg_records;
+	fw->msg_records = 0;
+}
+
+/* Append one template field */
+static void
+fx_put_field(GByteArray *ba, guint16 ie, guint16 len)
+{
+	fx_put_u16(ba, ie);
+	fx_put_u16(ba, len);
+}
+
+static void
+fx_write_templates(fx_writer_t *fw)
+{
+	fx_msg_begin(fw);
+	fx_set_begin(fw, 2);			/* template set */
+
+	fx_put_u16(fw->msg, TEMPLATE_ID_V4);
+	fx_put_u16(fw->msg, 10);		/* field count */
+	fx_put_field(fw->msg, IE_SOURCE_IPV4_ADDRESS, 4);
+	fx_put_field(fw->msg, IE_DEST_IPV4_ADDRESS, 4);
+	fx_put_field(fw->msg, IE_SOURCE_TRANSPORT_PORT, 2);
+	fx_put_field(fw->msg, IE_DEST_TRANSPORT_PORT, 2);
+	fx_put_field(fw->msg, IE_PROTOCOL_IDENTIFIER, 1);
+	fx_put_field(fw->msg, IE_TCP_CONTROL_BITS, 2);
+	fx_put_field(fw->msg, IE_PACKET_DELTA_COUNT, 8);
+	fx_put_field(fw->msg, IE_OCTET_DELTA_COUNT, 8);
+	fx_put_field(fw->msg, IE_FLOW_START_MILLISECONDS, 8);
+	fx_put_field(fw->msg, IE_FLOW_END_MILLISECONDS, 8);
+
+	fx_put_u16(fw->msg, TEMPLATE_ID_V6);
+	fx_put_u16(fw->msg, 10);
+	fx_put_field(fw->msg, IE_SOURCE_IPV6_ADDRESS, 16);
+	fx_put_field(fw->msg, IE_DEST_IPV6_ADDRESS, 16);
+	fx_put_field(fw->msg, IE_SOURCE_TRANSPORT_PORT, 2);
+	fx_put_field(fw->msg, IE_DEST_TRANSPORT_PORT, 2);
+	fx_put_field(fw->msg, IE_PROTOCOL_IDENTIFIER, 1);
+	fx_put_field(fw->msg, IE_TCP_CONTROL_BITS, 2);
+	fx_put_field(fw->msg, IE_PACKET_DELTA_COUNT, 8);
+	fx_put_field(fw->msg, IE_OCTET_DELTA_COUNT, 8);
+	fx_put_field(fw->msg, IE_FLOW_START_MILLISECONDS, 8);
+	fx_put_field(fw->msg, IE_FLOW_END_MILLISECONDS, 8);
+
+	fx_msg_flush(fw);
+}
+
+static guint64
+fx_nstime_to_ms(const nstime_t *ts)
+{
+	return (guint64)ts->secs * 1000 + ts->nsecs / 1000000;
+}
+
+static void
+fx_write_flow(fx_writer_t *fw, const fx_flow_t *flow)
+{
+	guint16 template_id = (flow->key.af == 4) ? TEMPLATE_ID_V4 : TEMPLATE_ID_V6;
+	guint addr_len = (flow->key.af == 4) ? 4 : 16;
+	guint record_len = (flow->key.af == 4) ? RECORD_LEN_V4 : RECORD_LEN_V6;
+
+	if (fw->set_start != 0 &&
+	    (fw->set_id != template_id ||
+	     fw->msg->len + record_len > MESSAGE_FLUSH_LEN))
+		fx_set_end(fw);
+	if (fw->msg->len + record_len > MESSAGE_FLUSH_LEN) {
+		fx_msg_flush(fw);
+		fx_msg_begin(fw);
+	}
+	if (fw->set_start == 0)
+		fx_set_begin(fw, template_id);
+
+	g_byte_array_append(fw->msg, flow->key.src, addr_len);
+	g_byte_array_append(fw->msg, flow->key.dst, addr_len);
+	fx_put_u16(fw->msg, flow->key.sport);
+	fx_put_u16(fw->msg, flow->key.dport);
+	g_byte_array_append(fw->msg, &flow->key.proto, 1);
+	fx_put_u16(fw->msg, flow->tcp_flags);
+	fx_put_u64(fw->msg, flow->packets);
+	fx_put_u64(fw->msg, flow->octets);
+	fx_put_u64(fw->msg, fx_nstime_to_ms(&flow->start));
+	fx_put_u64(fw->msg, fx_nstime_to_ms(&flow->end));
+	fw->msg_records++;
+}
+
+static void
+flowexport_draw(void *arg)
+{
+	fx_stat_t *fx = (fx_stat_t *)arg;
+	fx_writer_t fw;
+	GHashTableIter iter;
+	gpointer value;
+	char *tmp_path;
+	int pass;
+
+	/* Write to a temporary file and rename it over the target, so a
+	 * consumer never sees a partial export. */
+	tmp_path = g_strdup_printf("%s.tmp", fx->path);
+	fw.fh = ws_fopen(tmp_path, "wb");
+	if (fw.fh == NULL) {
+		fprintf(stderr, "tshark: error opening \"%s\": %s\n",
+		    tmp_path, g_strerror(errno));
+		g_free(tmp_path);
+		return;
+	}
+	fw.msg = g_byte_array_sized_new(MESSAGE_FLUSH_LEN);
+	fw.seq = 0;
+	fw.export_secs = (guint32)time(NULL);
+	fw.ok = TRUE;
+
+	fx_write_templates(&fw);
+
+	/* Two passes, so each address family's records coalesce into
+	 * long runs of same-template sets. */
+	for (pass = 0; pass < 2; pass++) {
+		guint8 af = (pass == 0) ? 4 : 6;
+
+		fx_msg_begin(&fw);
+		g_hash_table_iter_init(&iter, fx->flows);
+		while (g_hash_table_iter_next(&iter, NULL, &value)) {
+			const fx_flow_t *flow = (const fx_flow_t *)value;
+
+			if (flow->key.af == af)
+				fx_write_flow(&fw, flow);
+		}
+		fx_msg_flush(&fw);
+	}
+
+	if (fclose(fw.fh) == EOF)
+		fw.ok = FALSE;
+	if (!fw.ok || ws_rename(tmp_path, fx->path) < 0) {
+		fprintf(stderr, "tshark: error writing \"%s\": %s\n",
+		    fx->path, g_strerror(errno));
+	}
+	g_byte_array_free(fw.msg, TRUE);
+	g_free(tmp_path);
+}
+
+static void
+flowexport_init(const char *opt_arg, void *userdata _U_)
+{
+	fx_stat_t *fx;
+	GString *error_string;
+
+	if (strncmp(opt_arg, TAP_NAME ",", strlen(TAP_NAME ",")) != 0 ||
+	    opt_arg[strlen(TAP_NAME ",")] == '\0') {
+		cmdarg_err("invalid \"-z " TAP_NAME ",<outfile>\" argument");
+		exit(1);
+	}
+
+	fx = g_new0(fx_stat_t, 1);
+	fx->path = g_strdup(opt_arg + strlen(TAP_NAME ","));
+	fx->flows = g_hash_table_new_full(fx_key_hash, fx_key_equal,
+	    NULL, g_free);
+
+	error_string = register_tap_listener("tcp", fx, NULL, 0,
+	    flowexport_reset, flowexport_tcp_packet, flowexport_draw, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register " TAP_NAME " tcp tap: %s",
+		    error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+
+	/* The tcp listener's draw writes the file; the udp listener only
+	 * feeds the flow table. */
+	error_string = register_tap_listener("udp", fx, NULL, 0,
+	    NULL, flowexport_udp_packet, NULL, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register " TAP_NAME " udp tap: %s",
+		    error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui flowexport_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	TAP_NAME,
+	flowexport_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_flowexport(void)
+{
+	register_stat_tap_ui(&flowexport_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
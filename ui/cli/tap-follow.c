@@ -31,6 +31,14 @@ typedef struct _cli_follow_info {
   show_type_t     show_type;
   register_follow_t* follower;
 
+  /* streaming output */
+  gboolean      stream;        /* print chunks as the tap delivers them */
+  tap_packet_cb follow_tap_handler; /* the follower's own tap handler */
+  gboolean      header_printed;
+  guint32       chunk;
+  guint32       global_client_pos;
+  guint32       global_server_pos;
+
   /* range */
   guint32       chunkMin;
   guint32       chunkMax;
@@ -53,6 +61,7 @@ typedef struct _cli_follow_info {
 #define STR_ASCII       ",ascii"
 #define STR_EBCDIC      ",ebcdic"
 #define STR_RAW         ",raw"
+#define STR_STREAM      ",stream"
 
 WS_NORETURN static void follow_exit(const char *strp)
 {
@@ -153,23 +162,15 @@ static void follow_print_hex(const char *prefixp, guint32 offset, void *datap, i
   }
 }
 
-static void follow_draw(void *contextp)
-{
-  static const char     separator[] =
-    "===================================================================\n";
+static const char follow_separator[] =
+  "===================================================================\n";
 
-  follow_info_t *follow_info = (follow_info_t*)contextp;
+static void follow_print_header(follow_info_t *follow_info)
+{
   cli_follow_info_t* cli_follow_info = (cli_follow_info_t*)follow_info->gui_data;
   gchar             buf[WS_INET6_ADDRSTRLEN];
-  guint32 global_client_pos = 0, global_server_pos = 0;
-  guint32 *global_pos;
-  guint32           ii, jj;
-  char              *buffer;
-  GList             *cur;
-  follow_record_t   *follow_record;
-  guint             chunk;
 
-  printf("\n%s", separator);
+  printf("\n%s", follow_separator);
   printf("Follow: %s,%s\n", proto_get_protocol_filter_name(get_follow_proto_id(cli_follow_info->follower)), follow_str_type(cli_follow_info));
   printf("Filter: %s\n", follow_info->filter_out_filter);
 
@@ -184,99 +185,191 @@ static void follow_draw(void *contextp)
     printf("Node 1: [%s]:%u\n", buf, follow_info->server_port);
   else
     printf("Node 1: %s:%u\n", buf, follow_info->server_port);
+}
 
-  for (cur = g_list_last(follow_info->payload), chunk = 1;
-       cur != NULL;
-       cur = g_list_previous(cur), chunk++)
+static void follow_print_chunk(cli_follow_info_t *cli_follow_info, follow_record_t *follow_record,
+                               guint chunk, guint32 *global_client_pos, guint32 *global_server_pos)
+{
+  guint32 *global_pos;
+  guint32  ii, jj;
+  char    *buffer;
+
+  if (!follow_record->is_server) {
+    global_pos = global_client_pos;
+  } else {
+    global_pos = global_server_pos;
+  }
+
+  /* ignore chunks not in range */
+  if ((chunk < cli_follow_info->chunkMin) || (chunk > cli_follow_info->chunkMax)) {
+    (*global_pos) += follow_record->data->len;
+    return;
+  }
+
+  switch (cli_follow_info->show_type)
   {
-    follow_record = (follow_record_t *)cur->data;
-    if (!follow_record->is_server) {
-      global_pos = &global_client_pos;
-    } else {
-      global_pos = &global_server_pos;
-    }
+  case SHOW_HEXDUMP:
+    break;
 
-    /* ignore chunks not in range */
-    if ((chunk < cli_follow_info->chunkMin) || (chunk > cli_follow_info->chunkMax)) {
-      (*global_pos) += follow_record->data->len;
-      continue;
-    }
+  case SHOW_ASCII:
+  case SHOW_EBCDIC:
+    printf("%s%u\n", follow_record->is_server ? "\t" : "", follow_record->data->len);
+    break;
 
-    switch (cli_follow_info->show_type)
+  case SHOW_RAW:
+    if (follow_record->is_server)
     {
-    case SHOW_HEXDUMP:
-      break;
+      putchar('\t');
+    }
+    break;
+  default:
+    g_assert_not_reached();
+  }
+
+  switch (cli_follow_info->show_type)
+  {
+  case SHOW_HEXDUMP:
+    follow_print_hex(follow_record->is_server ? "\t" : "", *global_pos, follow_record->data->data, follow_record->data->len);
+    (*global_pos) += follow_record->data->len;
+    break;
 
-    case SHOW_ASCII:
-    case SHOW_EBCDIC:
-      printf("%s%u\n", follow_record->is_server ? "\t" : "", follow_record->data->len);
-      break;
+  case SHOW_ASCII:
+  case SHOW_EBCDIC:
+    buffer = (char *)g_malloc(follow_record->data->len+2);
 
-    case SHOW_RAW:
-      if (follow_record->is_server)
+    for (ii = 0; ii < follow_record->data->len; ii++)
+    {
+      switch (follow_record->data->data[ii])
       {
-        putchar('\t');
+      case '\r':
+      case '\n':
+        buffer[ii] = follow_record->data->data[ii];
+        break;
+      default:
+        buffer[ii] = g_ascii_isprint(follow_record->data->data[ii]) ? follow_record->data->data[ii] : '.';
+        break;
       }
-      break;
-    default:
-      g_assert_not_reached();
     }
 
-    switch (cli_follow_info->show_type)
+    buffer[ii++] = '\n';
+    buffer[ii] = 0;
+    if (cli_follow_info->show_type == SHOW_EBCDIC) {
+      EBCDIC_to_ASCII(buffer, ii);
+    }
+    printf("%s", buffer);
+    g_free(buffer);
+    break;
+
+  case SHOW_RAW:
+    buffer = (char *)g_malloc((follow_record->data->len*2)+2);
+
+    for (ii = 0, jj = 0; ii < follow_record->data->len; ii++)
     {
-    case SHOW_HEXDUMP:
-      follow_print_hex(follow_record->is_server ? "\t" : "", *global_pos, follow_record->data->data, follow_record->data->len);
-      (*global_pos) += follow_record->data->len;
-      break;
+      buffer[jj++] = bin2hex[follow_record->data->data[ii] >> 4];
+      buffer[jj++] = bin2hex[follow_record->data->data[ii] & 0xf];
+    }
 
-    case SHOW_ASCII:
-    case SHOW_EBCDIC:
-      buffer = (char *)g_malloc(follow_record->data->len+2);
+    buffer[jj++] = '\n';
+    buffer[jj] = 0;
+    printf("%s", buffer);
+    g_free(buffer);
+    break;
 
-      for (ii = 0; ii < follow_record->data->len; ii++)
-      {
-        switch (follow_record->data->data[ii])
-        {
-        case '\r':
-        case '\n':
-          buffer[ii] = follow_record->data->data[ii];
-          break;
-        default:
-          buffer[ii] = g_ascii_isprint(follow_record->data->data[ii]) ? follow_record->data->data[ii] : '.';
-          break;
-        }
-      }
+  default:
+    g_assert_not_reached();
+  }
+}
 
-      buffer[ii++] = '\n';
-      buffer[ii] = 0;
-      if (cli_follow_info->show_type == SHOW_EBCDIC) {
-        EBCDIC_to_ASCII(buffer, ii);
-      }
-      printf("%s", buffer);
-      g_free(buffer);
-      break;
+/* Print and free whatever the follower has delivered so far.  Followers
+ * only ever prepend complete chunks to the payload list (TCP holds
+ * out-of-order segments in a separate fragments list until they're
+ * contiguous), so everything on the list is new since the last drain
+ * and can be printed oldest-first and released immediately.
+ */
+static void follow_stream_drain(follow_info_t *follow_info)
+{
+  cli_follow_info_t* cli_follow_info = (cli_follow_info_t*)follow_info->gui_data;
+  GList             *cur;
+  follow_record_t   *follow_record;
 
-    case SHOW_RAW:
-      buffer = (char *)g_malloc((follow_record->data->len*2)+2);
+  if (follow_info->payload == NULL)
+  {
+    return;
+  }
 
-      for (ii = 0, jj = 0; ii < follow_record->data->len; ii++)
-      {
-        buffer[jj++] = bin2hex[follow_record->data->data[ii] >> 4];
-        buffer[jj++] = bin2hex[follow_record->data->data[ii] & 0xf];
-      }
+  /* The node addresses aren't known until the first tapped packet, so
+   * the header can't be printed at registration time. */
+  if (!cli_follow_info->header_printed)
+  {
+    follow_print_header(follow_info);
+    cli_follow_info->header_printed = TRUE;
+  }
+
+  for (cur = g_list_last(follow_info->payload); cur != NULL; cur = g_list_previous(cur))
+  {
+    follow_record = (follow_record_t *)cur->data;
+    cli_follow_info->chunk++;
+    follow_print_chunk(cli_follow_info, follow_record, cli_follow_info->chunk,
+                       &cli_follow_info->global_client_pos,
+                       &cli_follow_info->global_server_pos);
+    g_byte_array_free(follow_record->data, TRUE);
+    g_free(follow_record);
+  }
+
+  g_list_free(follow_info->payload);
+  follow_info->payload = NULL;
+}
+
+static tap_packet_status
+follow_stream_tap_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt, const void *data)
+{
+  follow_info_t *follow_info = (follow_info_t*)tapdata;
+  cli_follow_info_t* cli_follow_info = (cli_follow_info_t*)follow_info->gui_data;
+  tap_packet_status changed;
 
-      buffer[jj++] = '\n';
-      buffer[jj] = 0;
-      printf("%s", buffer);
-      g_free(buffer);
-      break;
+  changed = cli_follow_info->follow_tap_handler(tapdata, pinfo, edt, data);
 
-    default:
-      g_assert_not_reached();
+  /* Emit the chunks now instead of letting them pile up until the end
+   * of the pass.  A blocked stdout (a slow downstream pipe) blocks us
+   * right here, which is all the backpressure we need. */
+  follow_stream_drain(follow_info);
+
+  return changed;
+}
+
+static void follow_draw(void *contextp)
+{
+  follow_info_t *follow_info = (follow_info_t*)contextp;
+  cli_follow_info_t* cli_follow_info = (cli_follow_info_t*)follow_info->gui_data;
+  guint32 global_client_pos = 0, global_server_pos = 0;
+  GList             *cur;
+  guint             chunk;
+
+  if (cli_follow_info->stream)
+  {
+    /* Everything was printed as it arrived; flush any leftovers and
+     * close the block. */
+    if (!cli_follow_info->header_printed)
+    {
+      follow_print_header(follow_info);
+      cli_follow_info->header_printed = TRUE;
     }
+    follow_stream_drain(follow_info);
+    printf("%s", follow_separator);
+    return;
+  }
+
+  follow_print_header(follow_info);
+
+  for (cur = g_list_last(follow_info->payload), chunk = 1;
+       cur != NULL;
+       cur = g_list_previous(cur), chunk++)
+  {
+    follow_print_chunk(cli_follow_info, (follow_record_t *)cur->data,
+                       chunk, &global_client_pos, &global_server_pos);
   }
 
-  printf("%s", separator);
+  printf("%s", follow_separator);
 }
 
 static gboolean follow_arg_strncmp(const char **opt_argp, const char *strp)
@@ -316,6 +409,14 @@ follow_arg_mode(const char **opt_argp, follow_info_t *follow_info)
   {
     follow_exit("Invalid display mode.");
   }
+
+  /* Optional: print each chunk as the tap delivers it instead of
+   * buffering the entire stream in memory until the end of the pass.
+   */
+  if (follow_arg_strncmp(opt_argp, STR_STREAM))
+  {
+    cli_follow_info->stream = TRUE;
+  }
 }
 
 #define _STRING(s)      # s
@@ -489,8 +590,12 @@ static void follow_stream(const char *opt_argp, void *userdata)
     }
   }
 
+  cli_follow_info->follow_tap_handler = get_follow_tap_handler(follower);
+
   errp = register_tap_listener(get_follow_tap_string(follower), follow_info, follow_info->filter_out_filter, 0,
-                               NULL, get_follow_tap_handler(follower), follow_draw, (tap_finish_cb)follow_free);
+                               NULL,
+                               cli_follow_info->stream ? follow_stream_tap_packet : cli_follow_info->follow_tap_handler,
+                               follow_draw, (tap_finish_cb)follow_free);
 
   if (errp != NULL)
   {
@@ -0,0 +1,88 @@
+/* tap-iobench.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* Report wall-clock time, CPU time and peak RSS for each phase of
+ * processing the capture file (open, first/second pass).  The phase
+ * boundaries are marked in tshark's processing loops; this tap just
+ * turns the recording on and prints the result. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+
+#include <ui/bench.h>
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_iobench(void);
+
+#define TAP_NAME "io,bench"
+
+static void
+iobench_draw(void *dummy _U_)
+{
+	bench_report(stdout);
+}
+
+static void
+iobench_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+
+	if (strcmp(TAP_NAME, opt_arg) != 0) {
+		cmdarg_err("invalid \"-z " TAP_NAME "\" argument");
+		exit(1);
+	}
+
+	bench_enable();
+
+	error_string = register_tap_listener("frame", NULL, NULL, 0,
+					     NULL, NULL, iobench_draw, NULL);
+	if (error_string) {
+		/* error, we failed to attach to the tap. clean up */
+		cmdarg_err("Couldn't register " TAP_NAME " tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui iobench_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	TAP_NAME,
+	iobench_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_iobench(void)
+{
+	register_stat_tap_ui(&iobench_ui, NULL);
+}
+
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,108 @@
+/* tap-memstat.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* Report the allocation statistics of the global wmem scopes, so that
+ * the memory cost of reading a capture can be attributed to file-scoped
+ * state vs. per-packet churn. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/wmem/wmem.h>
+
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_memstat(void);
+
+#define TAP_NAME "mem,stat"
+
+static void
+memstat_print_scope(const char *name, wmem_allocator_t *scope)
+{
+	gsize cur_bytes, total_bytes, total_count;
+
+	wmem_allocator_get_stats(scope, &cur_bytes, &total_bytes, &total_count);
+
+	printf("%-8s %20" G_GSIZE_FORMAT " %20" G_GSIZE_FORMAT " %15" G_GSIZE_FORMAT "\n",
+	       name, cur_bytes, total_bytes, total_count);
+}
+
+static void
+memstat_draw(void *dummy _U_)
+{
+	printf("\n");
+	printf("=========================================================================\n");
+	printf("wmem allocation statistics\n");
+	printf("Byte counts are the sizes requested from the pools; they do not\n");
+	printf("include the allocators' own block overhead.\n");
+	printf("-------------------------------------------------------------------------\n");
+	printf("scope               held bytes       lifetime bytes     allocations\n");
+
+	memstat_print_scope("epan", wmem_epan_scope());
+	memstat_print_scope("file", wmem_file_scope());
+	memstat_print_scope("packet", wmem_packet_scope());
+
+	printf("=========================================================================\n");
+}
+
+static void
+memstat_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+
+	if (strcmp(TAP_NAME, opt_arg) != 0) {
+		cmdarg_err("invalid \"-z " TAP_NAME "\" argument");
+		exit(1);
+	}
+
+	error_string = register_tap_listener("frame", NULL, NULL, 0,
+					     NULL, NULL, memstat_draw, NULL);
+	if (error_string) {
+		/* error, we failed to attach to the tap. clean up */
+		cmdarg_err("Couldn't register " TAP_NAME " tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui memstat_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	TAP_NAME,
+	memstat_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_memstat(void)
+{
+	register_stat_tap_ui(&memstat_ui, NULL);
+}
+
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,273 @@
+/* tap-openmetrics.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* Export capture statistics in OpenMetrics/Prometheus text exposition
+ * format to a file, rewritten atomically on every tap redraw so a
+ * scraper (e.g. node_exporter's textfile collector) never sees a
+ * partial write.  Exports total frame/byte counters, per-protocol
+ * frame/byte counters and expert info counts by severity.  Interface
+ * drop counters live in the capture child, not in the tap system, so
+ * they are not available here; scrape them from the capture statistics
+ * instead. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <epan/epan_dissect.h>
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/expert.h>
+
+#include <ui/cmdarg_err.h>
+
+#include <wsutil/file_util.h>
+
+void register_tap_listener_openmetrics(void);
+
+#define TAP_NAME "openmetrics"
+
+typedef struct _om_proto_count_t {
+	guint64 frames;
+	guint64 bytes;
+} om_proto_count_t;
+
+typedef struct _om_stat_t {
+	char *path;		/* file to (re)write on each redraw */
+	guint64 frames;
+	guint64 bytes;
+	GHashTable *protos;	/* k=abbrev (static) v=om_proto_count_t */
+	guint64 expert[5];	/* comment, chat, note, warn, error */
+} om_stat_t;
+
+static const char *om_severity_names[5] = {
+	"comment", "chat", "note", "warn", "error"
+};
+
+static void
+openmetrics_reset(void *arg)
+{
+	om_stat_t *om = (om_stat_t *)arg;
+
+	om->frames = 0;
+	om->bytes = 0;
+	g_hash_table_remove_all(om->protos);
+	memset(om->expert, 0, sizeof om->expert);
+}
+
+static tap_packet_status
+openmetrics_packet(void *arg, packet_info *pinfo, epan_dissect_t *edt, const void *dummy _U_)
+{
+	om_stat_t *om = (om_stat_t *)arg;
+	proto_node *node;
+	field_info *fi;
+	om_proto_count_t *count;
+
+	om->frames++;
+	om->bytes += pinfo->fd->pkt_len;
+
+	if (!edt || !edt->tree) {
+		return TAP_PACKET_REDRAW;
+	}
+
+	/* top-level chain of the tree is the protocol stack of this frame */
+	for (node=edt->tree->first_child; node; node=node->next) {
+		fi = PNODE_FINFO(node);
+
+		count = (om_proto_count_t *)g_hash_table_lookup(om->protos,
+		    fi->hfinfo->abbrev);
+		if (!count) {
+			count = g_new0(om_proto_count_t, 1);
+			g_hash_table_insert(om->protos,
+			    (gpointer)fi->hfinfo->abbrev, count);
+		}
+		count->frames++;
+		count->bytes += pinfo->fd->pkt_len;
+	}
+
+	return TAP_PACKET_REDRAW;
+}
+
+static tap_packet_status
+openmetrics_expert_packet(void *arg, packet_info *pinfo _U_, epan_dissect_t *edt _U_,
+    const void *pointer)
+{
+	om_stat_t *om = (om_stat_t *)arg;
+	const expert_info_t *ei = (const expert_info_t *)pointer;
+
+	switch (ei->severity) {
+	case PI_COMMENT:
+		om->expert[0]++;
+		break;
+	case PI_CHAT:
+		om->expert[1]++;
+		break;
+	case PI_NOTE:
+		om->expert[2]++;
+		break;
+	case PI_WARN:
+		om->expert[3]++;
+		break;
+	case PI_ERROR:
+		om->expert[4]++;
+		break;
+	default:
+		break;
+	}
+
+	return TAP_PACKET_REDRAW;
+}
+
+/* Sort the per-protocol metrics so successive scrapes diff cleanly. */
+static gint
+om_proto_compare(gconstpointer a, gconstpointer b)
+{
+	return strcmp((const char *)a, (const char *)b);
+}
+
+static void
+openmetrics_draw(void *arg)
+{
+	om_stat_t *om = (om_stat_t *)arg;
+	char *tmp_path;
+	FILE *fh;
+	GList *keys, *cur;
+	const char *abbrev;
+	om_proto_count_t *count;
+	int i;
+
+	/* Write to a temporary file and rename it into place, so a scraper
+	 * reading concurrently always sees a complete exposition. */
+	tmp_path = g_strdup_printf("%s.tmp", om->path);
+	fh = ws_fopen(tmp_path, "w");
+	if (fh == NULL) {
+		fprintf(stderr, "tshark: error writing \"%s\": %s\n",
+		    tmp_path, g_strerror(errno));
+		g_free(tmp_path);
+		return;
+	}
+
+	fprintf(fh, "# TYPE tshark_frames counter\n");
+	fprintf(fh, "# HELP tshark_frames Frames processed.\n");
+	fprintf(fh, "tshark_frames_total %" G_GUINT64_FORMAT "\n", om->frames);
+	fprintf(fh, "# TYPE tshark_bytes counter\n");
+	fprintf(fh, "# HELP tshark_bytes Frame bytes processed.\n");
+	fprintf(fh, "tshark_bytes_total %" G_GUINT64_FORMAT "\n", om->bytes);
+
+	/* Protocol abbreviations are identifier-like ([a-z0-9._-]), so the
+	 * label values need no escaping. */
+	keys = g_list_sort(g_hash_table_get_keys(om->protos), om_proto_compare);
+	fprintf(fh, "# TYPE tshark_protocol_frames counter\n");
+	fprintf(fh, "# HELP tshark_protocol_frames Frames in which a protocol appeared.\n");
+	for (cur = keys; cur; cur = cur->next) {
+		abbrev = (const char *)cur->data;
+		count = (om_proto_count_t *)g_hash_table_lookup(om->protos, abbrev);
+		fprintf(fh, "tshark_protocol_frames_total{protocol=\"%s\"} %"
+		    G_GUINT64_FORMAT "\n", abbrev, count->frames);
+	}
+	fprintf(fh, "# TYPE tshark_protocol_bytes counter\n");
+	fprintf(fh, "# HELP tshark_protocol_bytes Frame bytes in which a protocol appeared.\n");
+	for (cur = keys; cur; cur = cur->next) {
+		abbrev = (const char *)cur->data;
+		count = (om_proto_count_t *)g_hash_table_lookup(om->protos, abbrev);
+		fprintf(fh, "tshark_protocol_bytes_total{protocol=\"%s\"} %"
+		    G_GUINT64_FORMAT "\n", abbrev, count->bytes);
+	}
+	g_list_free(keys);
+
+	fprintf(fh, "# TYPE tshark_expert counter\n");
+	fprintf(fh, "# HELP tshark_expert Expert info items by severity.\n");
+	for (i = 0; i < 5; i++) {
+		fprintf(fh, "tshark_expert_total{severity=\"%s\"} %"
+		    G_GUINT64_FORMAT "\n", om_severity_names[i], om->expert[i]);
+	}
+
+	fprintf(fh, "# EOF\n");
+
+	if (fclose(fh) == EOF || ws_rename(tmp_path, om->path) < 0) {
+		fprintf(stderr, "tshark: error writing \"%s\": %s\n",
+		    om->path, g_strerror(errno));
+	}
+	g_free(tmp_path);
+}
+
+static void
+openmetrics_init(const char *opt_arg, void *userdata _U_)
+{
+	om_stat_t *om;
+	GString *error_string;
+
+	if (strncmp(opt_arg, TAP_NAME ",", strlen(TAP_NAME ",")) != 0 ||
+	    opt_arg[strlen(TAP_NAME ",")] == '\0') {
+		cmdarg_err("invalid \"-z " TAP_NAME ",<outfile>\" argument");
+		exit(1);
+	}
+
+	om = g_new0(om_stat_t, 1);
+	om->path = g_strdup(opt_arg + strlen(TAP_NAME ","));
+	om->protos = g_hash_table_new_full(g_str_hash, g_str_equal,
+	    NULL, g_free);
+
+	/* The file is rewritten on every tap redraw; during live capture
+	 * tshark redraws taps periodically, so the exposition tracks the
+	 * capture without any extra timer. */
+	error_string = register_tap_listener("frame", om, NULL,
+	    TL_REQUIRES_PROTO_TREE, openmetrics_reset, openmetrics_packet,
+	    openmetrics_draw, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register " TAP_NAME " tap: %s",
+		    error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+
+	/* The expert listener shares the counters; the frame listener's
+	 * draw writes the file, so no draw callback here. */
+	error_string = register_tap_listener("expert", om, NULL, 0,
+	    NULL, openmetrics_expert_packet, NULL, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register " TAP_NAME " expert tap: %s",
+		    error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui openmetrics_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	TAP_NAME,
+	openmetrics_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_openmetrics(void)
+{
+	register_stat_tap_ui(&openmetrics_ui, NULL);
+}
+
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
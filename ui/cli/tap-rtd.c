@@ -48,14 +48,17 @@ rtd_draw(void *arg)
 		printf("Duplicate responses: %u\n", rtd_data->stat_table.time_stats[0].rsp_dup_num);
 		printf("Open requests: %u\n", rtd_data->stat_table.time_stats[0].open_req_num);
 		printf("Discarded responses: %u\n", rtd_data->stat_table.time_stats[0].disc_rsp_num);
-		printf("Type    | Messages   |    Min RTD    |    Max RTD    |    Avg RTD    | Min in Frame | Max in Frame |\n");
+		printf("Type    | Messages   |    Min RTD    |    Max RTD    |    Avg RTD    |    P50 RTD    |    P95 RTD    |    P99 RTD    | Min in Frame | Max in Frame |\n");
 		for (i=0; i<rtd_data->stat_table.time_stats[0].num_timestat; i++) {
 			if (rtd_data->stat_table.time_stats[0].rtd[i].num) {
 				tmp_str = val_to_str_wmem(NULL, i, rtd->vs_type, "Other (%d)");
-				printf("%s | %7u    | %8.2f msec | %8.2f msec | %8.2f msec |  %10u  |  %10u  |\n",
+				printf("%s | %7u    | %8.2f msec | %8.2f msec | %8.2f msec | %8.2f msec | %8.2f msec | %8.2f msec |  %10u  |  %10u  |\n",
 						tmp_str, rtd_data->stat_table.time_stats[0].rtd[i].num,
 						nstime_to_msec(&(rtd_data->stat_table.time_stats[0].rtd[i].min)), nstime_to_msec(&(rtd_data->stat_table.time_stats[0].rtd[i].max)),
 						get_average(&(rtd_data->stat_table.time_stats[0].rtd[i].tot), rtd_data->stat_table.time_stats[0].rtd[i].num),
+						get_percentile(&(rtd_data->stat_table.time_stats[0].rtd[i]), 0.50),
+						get_percentile(&(rtd_data->stat_table.time_stats[0].rtd[i]), 0.95),
+						get_percentile(&(rtd_data->stat_table.time_stats[0].rtd[i]), 0.99),
 						rtd_data->stat_table.time_stats[0].rtd[i].min_num, rtd_data->stat_table.time_stats[0].rtd[i].max_num
 				);
 				wmem_free(NULL, tmp_str);
@@ -64,15 +67,18 @@ rtd_draw(void *arg)
 	}
 	else
 	{
-		printf("Type    | Messages   |    Min RTD    |    Max RTD    |    Avg RTD    | Min in Frame | Max in Frame | Open Requests | Discarded responses | Duplicate requests | Duplicate responses\n");
+		printf("Type    | Messages   |    Min RTD    |    Max RTD    |    Avg RTD    |    P50 RTD    |    P95 RTD    |    P99 RTD    | Min in Frame | Max in Frame | Open Requests | Discarded responses | Duplicate requests | Duplicate responses\n");
 		for (i=0; i<rtd_data->stat_table.num_rtds; i++) {
 			for (j=0; j<rtd_data->stat_table.time_stats[i].num_timestat; j++) {
 				if (rtd_data->stat_table.time_stats[i].rtd[j].num) {
 					tmp_str = val_to_str_wmem(NULL, i, rtd->vs_type, "Other (%d)");
-					printf("%s | %7u    | %8.2f msec | %8.2f msec | %8.2f msec |  %10u  |  %10u  |  %10u  |  %10u  | %4u (%4.2f%%) | %4u (%4.2f%%)  |\n",
+					printf("%s | %7u    | %8.2f msec | %8.2f msec | %8.2f msec | %8.2f msec | %8.2f msec | %8.2f msec |  %10u  |  %10u  |  %10u  |  %10u  | %4u (%4.2f%%) | %4u (%4.2f%%)  |\n",
 							tmp_str, rtd_data->stat_table.time_stats[i].rtd[j].num,
 							nstime_to_msec(&(rtd_data->stat_table.time_stats[i].rtd[j].min)), nstime_to_msec(&(rtd_data->stat_table.time_stats[i].rtd[j].max)),
 							get_average(&(rtd_data->stat_table.time_stats[i].rtd[j].tot), rtd_data->stat_table.time_stats[i].rtd[j].num),
+							get_percentile(&(rtd_data->stat_table.time_stats[i].rtd[j]), 0.50),
+							get_percentile(&(rtd_data->stat_table.time_stats[i].rtd[j]), 0.95),
+							get_percentile(&(rtd_data->stat_table.time_stats[i].rtd[j]), 0.99),
 							rtd_data->stat_table.time_stats[i].rtd[j].min_num, rtd_data->stat_table.time_stats[i].rtd[j].max_num,
 							rtd_data->stat_table.time_stats[i].open_req_num, rtd_data->stat_table.time_stats[i].disc_rsp_num,
 							rtd_data->stat_table.time_stats[i].req_dup_num,
@@ -34,10 +34,11 @@ draw_srt_table_data(srt_stat_table *rst, gboolean draw_footer)
 	int i;
 	guint64 td;
 	guint64 sum;
+	guint64 p50, p95, p99;
 
 	if (rst->num_procs > 0) {
 		printf("Filter: %s\n", rst->filter_string ? rst->filter_string : "");
-		printf("Index  %-22s Calls    Min SRT    Max SRT    Avg SRT    Sum SRT\n", (rst->proc_column_name != NULL) ? rst->proc_column_name : "Procedure");
+		printf("Index  %-22s Calls    Min SRT    Max SRT    Avg SRT    P50 SRT    P95 SRT    P99 SRT    Sum SRT\n", (rst->proc_column_name != NULL) ? rst->proc_column_name : "Procedure");
 	}
 	for(i=0;i<rst->num_procs;i++){
 		/* ignore procedures with no calls (they don't have rows) */
@@ -53,12 +54,21 @@ draw_srt_table_data(srt_stat_table *rst, gboolean draw_footer)
 		sum = (td + 500) / 1000;
 		td = ((td / rst->procedures[i].stats.num) + 500) / 1000;
 
-		printf("%5d  %-22s %6u %3d.%06d %3d.%06d %3d.%06d %3d.%06d\n",
+		/* Percentile estimates from the reservoir, scaled from
+		   milliseconds to us to match the other columns. */
+		p50 = (guint64)(get_percentile(&rst->procedures[i].stats, 0.50)*1000 + 0.5);
+		p95 = (guint64)(get_percentile(&rst->procedures[i].stats, 0.95)*1000 + 0.5);
+		p99 = (guint64)(get_percentile(&rst->procedures[i].stats, 0.99)*1000 + 0.5);
+
+		printf("%5d  %-22s %6u %3d.%06d %3d.%06d %3d.%06d %3d.%06d %3d.%06d %3d.%06d %3d.%06d\n",
 		       i, rst->procedures[i].procedure,
 		       rst->procedures[i].stats.num,
 		       (int)rst->procedures[i].stats.min.secs, (rst->procedures[i].stats.min.nsecs+500)/1000,
 		       (int)rst->procedures[i].stats.max.secs, (rst->procedures[i].stats.max.nsecs+500)/1000,
 		       (int)(td/1000000), (int)(td%1000000),
+		       (int)(p50/1000000), (int)(p50%1000000),
+		       (int)(p95/1000000), (int)(p95%1000000),
+		       (int)(p99/1000000), (int)(p99%1000000),
 		       (int)(sum/1000000), (int)(sum%1000000)
 		);
 	}
@@ -115,7 +125,7 @@ init_srt_tables(register_srt_t* srt, const char *filter)
 	ui->data.srt_array = global_srt_array;
 	ui->data.user_data = ui;
 
-	error_string = register_tap_listener(get_srt_tap_listener_name(srt), &ui->data, filter, 0, NULL, get_srt_packet_func(srt), srt_draw, NULL);
+	error_string = register_tap_listener(get_srt_tap_listener_name(srt), &ui->data, filter, get_srt_tap_flags(srt), NULL, get_srt_packet_func(srt), srt_draw, NULL);
 	if (error_string) {
 		free_srt_table(srt, global_srt_array);
 		g_free(ui);
@@ -159,8 +159,12 @@ setup_enabled_and_disabled_protocols(void)
     if (global_dissect_options.disable_protocol_slist) {
         GSList *proto_disable;
 
-        for (proto_disable = global_dissect_options.disable_protocol_slist; proto_disable != NULL; proto_disable = g_slist_next(proto_disable))
-            proto_disable_proto_by_name((char*)proto_disable->data);
+        for (proto_disable = global_dissect_options.disable_protocol_slist; proto_disable != NULL; proto_disable = g_slist_next(proto_disable)) {
+            if (strcmp((char*)proto_disable->data, "ALL") == 0)
+                proto_disable_all();
+            else
+                proto_disable_proto_by_name((char*)proto_disable->data);
+        }
     }
 
     if (global_dissect_options.enable_protocol_slist) {
@@ -148,25 +148,21 @@ process_tree(proto_tree *protocol_tree, ph_stats_t* ps)
 
     static gboolean
 process_record(capture_file *cf, frame_data *frame, column_info *cinfo,
-               wtap_rec *rec, Buffer *buf, ph_stats_t* ps)
+               wtap_rec *rec, Buffer *buf, epan_dissect_t *edt, ph_stats_t* ps)
 {
-    epan_dissect_t	edt;
     double		cur_time;
 
     /* Load the record from the capture file */
     if (!cf_read_record(cf, frame, rec, buf))
         return FALSE;	/* failure */
 
-    /* Dissect the record   tree  not visible */
-    epan_dissect_init(&edt, cf->epan, TRUE, FALSE);
-    /* Don't fake protocols. We need them for the protocol hierarchy */
-    epan_dissect_fake_protocols(&edt, FALSE);
-    epan_dissect_run(&edt, cf->cd_t, rec,
+    /* Dissect the record */
+    epan_dissect_run(edt, cf->cd_t, rec,
                      frame_tvbuff_new_buffer(&cf->provider, frame, buf),
                      frame, cinfo);
 
     /* Get stats from this protocol tree */
-    process_tree(edt.tree, ps);
+    process_tree(edt->tree, ps);
 
     if (frame->has_ts) {
         /* Update times */
@@ -177,8 +173,8 @@ process_record(capture_file *cf, frame_data *frame, column_info *cinfo,
             ps->last_time = cur_time;
     }
 
-    /* Free our memory. */
-    epan_dissect_cleanup(&edt);
+    /* Ready the dissection context for the next record. */
+    epan_dissect_reset(edt);
 
     return TRUE;	/* success */
 }
@@ -199,6 +195,7 @@ ph_stats_new(capture_file *cf)
     gchar	status_str[100];
     int		progbar_nextstep;
     int		progbar_quantum;
+    epan_dissect_t edt;
 
     if (!cf) return NULL;
 
@@ -230,6 +227,14 @@ ph_stats_new(capture_file *cf)
     wtap_rec_init(&rec);
     ws_buffer_init(&buf, 1514);
 
+    /* Set up one dissection context for the whole pass, tree not
+       visible, and reset it between records; creating and destroying
+       a context per record is far more expensive. */
+    epan_dissect_init(&edt, cf->epan, TRUE, FALSE);
+    /* Don't fake protocols. We need them for the protocol hierarchy.
+       The setting survives epan_dissect_reset(). */
+    epan_dissect_fake_protocols(&edt, FALSE);
+
     for (framenum = 1; framenum <= cf->count; framenum++) {
         frame = frame_data_sequence_find(cf->provider.frames, framenum);
 
@@ -290,7 +295,7 @@ ph_stats_new(capture_file *cf)
             }
 
             /* we don't care about colinfo */
-            if (!process_record(cf, frame, NULL, &rec, &buf, ps)) {
+            if (!process_record(cf, frame, NULL, &rec, &buf, &edt, ps)) {
                 /*
                  * Give up, and set "stop_flag" so we
                  * just abort rather than popping up
@@ -307,6 +312,7 @@ ph_stats_new(capture_file *cf)
         count++;
     }
 
+    epan_dissect_cleanup(&edt);
     wtap_rec_cleanup(&rec);
     ws_buffer_free(&buf);
 
@@ -181,6 +181,10 @@ void DecodeAsDialog::on_clearToolButton_clicked()
 
 void DecodeAsDialog::applyChanges()
 {
+    if (!model_->modelChanged()) {
+        // Nothing was edited; don't force a redissection of the whole file.
+        return;
+    }
     model_->applyChanges();
     wsApp->queueAppSignal(WiresharkApplication::PacketDissectionChanged);
 }
@@ -87,7 +87,10 @@ FileSetDialog::~FileSetDialog()
 /* a new capture file was opened, browse the dir and look for files matching the given file set */
 void FileSetDialog::fileOpened(const capture_file *cf) {
     if (!cf) return;
-    fileset_entry_model_->clear();
+    /* Don't delete the fileset here; if the new file belongs to the set we
+     * already scanned, fileset_add_dir reuses the cached entries instead of
+     * stating the whole directory again. */
+    fileset_entry_model_->removeAllEntries();
     fileset_add_dir(cf->filename, this);
 }
 
@@ -991,6 +991,18 @@ bool FollowStreamDialog::follow(QString previous_filter, bool use_stream_index,
     beginRetapPackets();
     updateWidgets(true);
 
+    /* If the dissector recorded the stream's frames on the first pass,
+       collect the payload by retapping just those frames instead of
+       riding on the full rescan the display filter triggers below. */
+    if (follow_type_ == FOLLOW_TCP) {
+        guint num_frames;
+        const guint32 *frames = get_tcp_stream_frames(stream_num, &num_frames);
+        if (frames != NULL) {
+            cf_retap_frames(cap_file_.capFile(), frames, num_frames);
+            removeTapListeners();
+        }
+    }
+
     /* Run the display filter so it goes in effect - even if it's the
        same as the previous display filter. */
     emit updateFilter(follow_filter, TRUE);
@@ -1202,14 +1202,24 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 {
     int interval = ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt();
     bool need_retap = false;
+    bool need_recalc = false;
 
     if (uat_model_ != NULL) {
         for (int row = 0; row < uat_model_->rowCount(); row++) {
             IOGraph *iog = ioGraphs_.value(row, NULL);
             if (iog) {
-                iog->setInterval(interval);
                 if (iog->visible()) {
-                    need_retap = true;
+                    // Zooming out to a multiple of the current interval
+                    // just merges the existing buckets; otherwise we
+                    // have to go through the file again.
+                    if (iog->mergeIntervals(interval)) {
+                        need_recalc = true;
+                    } else {
+                        iog->setInterval(interval);
+                        need_retap = true;
+                    }
+                } else {
+                    iog->setInterval(interval);
                 }
             }
         }
@@ -1217,6 +1227,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 
     if (need_retap) {
         scheduleRetap(true);
+    } else if (need_recalc) {
+        scheduleRecalc(true);
     }
 
     updateLegend();
@@ -2071,6 +2083,50 @@ void IOGraph::setInterval(int interval)
     interval_ = interval;
 }
 
+// Re-bucket the existing items for a coarser interval instead of
+// retapping the whole file.  Only possible when the new interval is an
+// integer multiple of the current one and the graph plots plain
+// packet/byte/bit counts; field-calculated graphs need the extreme
+// frame per interval, which a bucket merge can't reconstruct for every
+// field type, so they fall back to a retap.
+bool IOGraph::mergeIntervals(int interval)
+{
+    if (interval == interval_) {
+        return true;
+    }
+    if (interval < interval_ || interval % interval_ != 0 ||
+        val_units_ > IOG_ITEM_UNIT_BITS) {
+        return false;
+    }
+    if (cur_idx_ >= 0) {
+        int factor = interval / interval_;
+        int new_cur_idx = cur_idx_ / factor;
+
+        for (int j = 0; j <= new_cur_idx; j++) {
+            io_graph_item_t merged;
+
+            reset_io_graph_items(&merged, 1);
+            for (int k = j * factor; k <= cur_idx_ && k < (j + 1) * factor; k++) {
+                const io_graph_item_t *src = &items_[k];
+
+                merged.frames += src->frames;
+                merged.bytes += src->bytes;
+                if (src->first_frame_in_invl != 0) {
+                    if (merged.first_frame_in_invl == 0) {
+                        merged.first_frame_in_invl = src->first_frame_in_invl;
+                    }
+                    merged.last_frame_in_invl = src->last_frame_in_invl;
+                }
+            }
+            items_[j] = merged;
+        }
+        reset_io_graph_items(&items_[new_cur_idx + 1], cur_idx_ - new_cur_idx);
+        cur_idx_ = new_cur_idx;
+    }
+    interval_ = interval;
+    return true;
+}
+
 // Get the value at the given interval (idx) for the current value unit.
 double IOGraph::getItemValue(int idx, const capture_file *cap_file) const
 {
@@ -66,6 +66,7 @@ public:
     void setValueUnitField(const QString &vu_field);
     unsigned int movingAveragePeriod() { return moving_avg_period_; }
     void setInterval(int interval);
+    bool mergeIntervals(int interval);
     bool addToLegend();
     bool removeFromLegend();
     QCPGraph *graph() { return graph_; }
@@ -664,7 +664,19 @@ int main(int argc, char *qt_argv[])
     /* Register all dissectors; we must do this before checking for the
        "-G" flag, as the "-G" flag dumps information registered by the
        dissectors, and we must do it before we read the preferences, in
-       case any dissectors register preferences. */
+       case any dissectors register preferences.
+
+       This call is where nearly all of the cold-start time goes, and it
+       can't be deferred or cached: protocol registration must precede
+       the preferences read, and the registered tree is all pointers and
+       callbacks, so there's nothing meaningful to persist.  Everything
+       that *can* wait already does -- the main window is shown above,
+       before we get here; the font and MIME databases warm up on pool
+       threads; secondary dialogs are built on first use; and the
+       recent/profile files are a few KB of text whose parse time is
+       noise (a binary cache of them would add staleness bugs, not
+       speed).  Extcap discovery, the other historical offender, is
+       skippable with capture.no_extcap. */
     if (!epan_init(splash_update, NULL, TRUE)) {
         SimpleDialog::displayQueuedMessages(main_w);
         ret_val = INIT_FAILED;
@@ -226,6 +226,14 @@ void MainStatusBar::expertUpdate() {
         break;
     }
 
+    if (expert_get_highest_severity() > 0) {
+        tt_text.append(tr("\n%1 errors, %2 warnings, %3 notes, %4 chats")
+                       .arg(expert_get_severity_count(PI_ERROR))
+                       .arg(expert_get_severity_count(PI_WARN))
+                       .arg(expert_get_severity_count(PI_NOTE))
+                       .arg(expert_get_severity_count(PI_CHAT)));
+    }
+
     StockIcon expert_icon(stock_name);
     expert_button_->setIcon(expert_icon);
     expert_button_->setToolTip(tt_text);
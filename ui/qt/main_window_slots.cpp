@@ -3648,7 +3648,19 @@ void MainWindow::on_goToCancel_clicked()
 
 void MainWindow::on_goToGo_clicked()
 {
-    gotoFrame(main_ui_->goToLineEdit->text().toInt());
+    QString text = main_ui_->goToLineEdit->text();
+
+    if (text.contains('.')) {
+        // A fractional value is a time offset in seconds from the first
+        // packet rather than a packet number.
+        bool ok = false;
+        double secs = text.toDouble(&ok);
+        if (ok) {
+            cf_goto_time(capture_file_.capFile(), secs);
+        }
+    } else {
+        gotoFrame(text.toInt());
+    }
 
     on_goToCancel_clicked();
 }
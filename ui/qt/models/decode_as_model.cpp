@@ -43,7 +43,8 @@ DecodeAsItem::~DecodeAsItem()
 
 DecodeAsModel::DecodeAsModel(QObject *parent, capture_file *cf) :
     QAbstractTableModel(parent),
-    cap_file_(cf)
+    cap_file_(cf),
+    model_changed_(false)
 {
 }
 
@@ -266,6 +267,7 @@ bool DecodeAsModel::setData(const QModelIndex &cur_index, const QVariant &value,
         break;
     }
 
+    model_changed_ = true;
     return true;
 }
 
@@ -376,6 +378,7 @@ bool DecodeAsModel::insertRows(int row, int count, const QModelIndex &/*parent*/
 
     endInsertRows();
 
+    model_changed_ = true;
     return true;
 }
 
@@ -388,6 +391,7 @@ bool DecodeAsModel::removeRows(int row, int count, const QModelIndex &/*parent*/
     decode_as_items_.removeAt(row);
     endRemoveRows();
 
+    model_changed_ = true;
     return true;
 }
 
@@ -399,6 +403,8 @@ void DecodeAsModel::clearAll()
     beginResetModel();
     decode_as_items_.clear();
     endResetModel();
+
+    model_changed_ = true;
 }
 
 bool DecodeAsModel::copyRow(int dst_row, int src_row)
@@ -423,6 +429,7 @@ bool DecodeAsModel::copyRow(int dst_row, int src_row)
     roles << Qt::EditRole << Qt::BackgroundRole;
     emit dataChanged(index(dst_row, 0), index(dst_row, columnCount()), roles);
 
+    model_changed_ = true;
     return true;
 }
 
@@ -506,13 +513,17 @@ void DecodeAsModel::fillTable()
     decode_dcerpc_add_show_list(buildDceRpcChangedList, this);
 
     emit endResetModel();
+
+    model_changed_ = false;
 }
 
 void DecodeAsModel::setDissectorHandle(const QModelIndex &index, dissector_handle_t  dissector_handle)
 {
     DecodeAsItem* item = decode_as_items_[index.row()];
-    if (item != NULL)
+    if (item != NULL && item->dissector_handle_ != dissector_handle) {
         item->dissector_handle_ = dissector_handle;
+        model_changed_ = true;
+    }
 }
 
 void DecodeAsModel::buildChangedList(const gchar *table_name, ftenum_t, gpointer key, gpointer value, gpointer user_data)
@@ -733,6 +744,8 @@ void DecodeAsModel::applyChanges()
             }
         }
     }
+
+    model_changed_ = false;
 }
 
 /* * Editor modelines
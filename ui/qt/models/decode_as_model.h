@@ -79,6 +79,10 @@ public:
 
     void applyChanges();
 
+    // Has anything changed since the table was filled or last applied?
+    // Used to skip the (expensive) redissection on a no-op apply.
+    bool modelChanged() const { return model_changed_; }
+
 protected:
     static void buildChangedList(const gchar *table_name, ftenum_t selector_type,
                           gpointer key, gpointer value, gpointer user_data);
@@ -92,6 +96,7 @@ private:
     QList<DecodeAsItem *> decode_as_items_;
     QList<QPair<const char *, guint32> > changed_uint_entries_;
     QList<QPair<const char *, const char *> > changed_string_entries_;
+    bool model_changed_;
 };
 
 #endif // DECODE_AS_MODEL_H
@@ -115,6 +115,11 @@ void FilesetEntryModel::appendEntry(const fileset_entry *entry)
 void FilesetEntryModel::clear()
 {
     fileset_delete();
+    removeAllEntries();
+}
+
+void FilesetEntryModel::removeAllEntries()
+{
     beginResetModel();
     entries_.clear();
     endResetModel();
@@ -40,6 +40,9 @@ public:
     int entryCount() const { return entries_.count(); }
     // Calls fileset_delete and clears our model data.
     void clear();
+    // Clears our model data, keeping the fileset itself around so that
+    // fileset_add_dir can reuse its cached entries.
+    void removeAllEntries();
 
 private:
     QVector<const fileset_entry *> entries_;
@@ -164,6 +164,7 @@ guint PacketListModel::recreateVisibleRows()
 
 void PacketListModel::clear() {
     emit beginResetModel();
+    PacketListRecord::resetTextPool();
     qDeleteAll(physical_rows_);
     physical_rows_.resize(0);
     visible_rows_.resize(0);
@@ -339,6 +340,8 @@ int PacketListModel::sort_column_is_numeric_;
 int PacketListModel::text_sort_column_;
 Qt::SortOrder PacketListModel::sort_order_;
 capture_file *PacketListModel::sort_cap_file_;
+QVector<double> PacketListModel::numeric_sort_keys_;
+QVector<bool> PacketListModel::numeric_sort_key_ok_;
 
 QElapsedTimer busy_timer_;
 const int busy_timeout_ = 65; // ms, approximately 15 fps
@@ -363,7 +366,39 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
 
     busy_timer_.start();
     sort_column_is_numeric_ = isNumericColumn(sort_column_);
+    // Sorting reads the column text of every row, often repeatedly;
+    // don't let the column text pool evict entries out from under it.
+    PacketListRecord::setTextPoolEnabled(false);
+    if (text_sort_column_ >= 0 && sort_column_is_numeric_) {
+        // Parse each row's column text into a sort key once up front;
+        // std::sort would otherwise re-parse both sides of every
+        // comparison, i.e. O(n log n) conversions instead of O(n).
+        numeric_sort_keys_.fill(0.0, physical_rows_.count() + 1);
+        numeric_sort_key_ok_.fill(false, physical_rows_.count() + 1);
+        foreach (PacketListRecord *record, physical_rows_) {
+            int num = (int) record->frameData()->num;
+            bool ok;
+            double key = parseNumericColumn(record->columnString(sort_cap_file_, sort_column_), &ok);
+
+            if (num >= numeric_sort_keys_.size()) {
+                numeric_sort_keys_.resize(num + 1);
+                numeric_sort_key_ok_.resize(num + 1);
+            }
+            numeric_sort_keys_[num] = key;
+            numeric_sort_key_ok_[num] = ok;
+
+            if (busy_timer_.elapsed() > busy_timeout_) {
+                // Column text may be dissected on first access, so this
+                // pass can be slow too; keep the busy indicator alive.
+                wsApp->processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::ExcludeSocketNotifiers, 1);
+                busy_timer_.restart();
+            }
+        }
+    }
     std::sort(physical_rows_.begin(), physical_rows_.end(), recordLessThan);
+    numeric_sort_keys_.clear();
+    numeric_sort_key_ok_.clear();
+    PacketListRecord::setTextPoolEnabled(true);
 
     emit beginResetModel();
     visible_rows_.resize(0);
@@ -482,11 +517,11 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
             cmp_val = 0;
         } else if (sort_column_is_numeric_) {
             // Custom column with numeric data (or something like a port number).
-            // Attempt to convert to numbers.
-            // XXX This is slow. Can we avoid doing this?
-            bool ok_r1, ok_r2;
-            double num_r1 = parseNumericColumn(r1->columnString(sort_cap_file_, sort_column_), &ok_r1);
-            double num_r2 = parseNumericColumn(r2->columnString(sort_cap_file_, sort_column_), &ok_r2);
+            // The column text was parsed into per-row keys before the sort.
+            bool ok_r1 = numeric_sort_key_ok_.value((int) r1->frameData()->num, false);
+            bool ok_r2 = numeric_sort_key_ok_.value((int) r2->frameData()->num, false);
+            double num_r1 = numeric_sort_keys_.value((int) r1->frameData()->num, 0.0);
+            double num_r2 = numeric_sort_keys_.value((int) r2->frameData()->num, 0.0);
 
             if (!ok_r1 && !ok_r2) {
                 cmp_val = 0;
@@ -708,6 +743,12 @@ void PacketListModel::dissectIdle(bool reset)
     emit bgColorizationProgress(first+1, idle_dissection_row_+1);
 }
 
+// Coalesce row insertions during live capture. Each flush costs a
+// beginInsertRows + endInsertRows round trip through the attached views,
+// so at high packet rates we let queued rows accumulate for a short
+// interval instead of flushing on the next pass through the event loop.
+// PacketList forces a flush where freshness actually matters.
+static const int row_flush_interval_ = 50; // ms
 // XXX Pass in cinfo from packet_list_append so that we can fill in
 // line counts?
 gint PacketListModel::appendPacket(frame_data *fdata)
@@ -726,9 +767,10 @@ gint PacketListModel::appendPacket(frame_data *fdata)
     if (fdata->passed_dfilter || fdata->ref_time) {
         new_visible_rows_ << record;
         if (new_visible_rows_.count() < 2) {
-            // This is the first queued packet. Schedule an insertion for
-            // the next UI update.
-            QTimer::singleShot(0, this, SLOT(flushVisibleRows()));
+            // This is the first queued packet. Schedule an insertion at
+            // the end of the coalescing window; everything queued in the
+            // meantime goes out in the same batch.
+            QTimer::singleShot(row_flush_interval_, this, SLOT(flushVisibleRows()));
         }
         pos = visible_rows_.count() + new_visible_rows_.count() - 1;
     }
@@ -98,6 +98,10 @@ private:
     static int text_sort_column_;
     static Qt::SortOrder sort_order_;
     static capture_file *sort_cap_file_;
+    // Numeric sort keys parsed once per row before sorting, indexed by
+    // frame number; valid only while sort() is running.
+    static QVector<double> numeric_sort_keys_;
+    static QVector<bool> numeric_sort_key_ok_;
     static bool recordLessThan(PacketListRecord *r1, PacketListRecord *r2);
     static double parseNumericColumn(const QString &val, bool *ok);
 
@@ -28,11 +28,19 @@
 QMap<int, int> PacketListRecord::cinfo_column_;
 unsigned PacketListRecord::col_data_ver_ = 1;
 unsigned PacketListRecord::rows_color_ver_ = 1;
+QList<PacketListRecord *> PacketListRecord::text_pool_;
+bool PacketListRecord::text_pool_enabled_ = true;
+
+// Upper bound on the number of records with cached column text; enough
+// for the viewport plus generous scrollback without letting a multi-
+// million row capture keep a string list per row.
+static const int text_pool_limit_ = 10000;
 
 PacketListRecord::PacketListRecord(frame_data *frameData) :
     fdata_(frameData),
     lines_(1),
     line_count_changed_(false),
+    text_pooled_(false),
     data_ver_(0),
     color_ver_(0),
     colorized_(false),
@@ -42,11 +50,40 @@ PacketListRecord::PacketListRecord(frame_data *frameData) :
 
 PacketListRecord::~PacketListRecord()
 {
+    if (text_pooled_) {
+        text_pool_.removeOne(this);
+    }
     col_text_.clear();
 }
 
+void PacketListRecord::resetTextPool()
+{
+    foreach (PacketListRecord *record, text_pool_) {
+        record->text_pooled_ = false;
+    }
+    text_pool_.clear();
+}
+
+void PacketListRecord::dropColumnStrings()
+{
+    col_text_.clear();
+    text_pooled_ = false;
+}
+
 // We might want to return a const char * instead. This would keep us from
 // creating excessive QByteArrays, e.g. in PacketListModel::recordLessThan.
+//
+// This per-record cache (generation-checked through col_data_ver_, which
+// column preference changes bump via invalidateAllRecords(), and bounded
+// by text_pool_) is deliberately the only column string cache.  Export
+// and find also format columns, in file.c below the UI, but sharing one
+// cache with them would mean either teaching file.c about a UI-owned
+// store - inverting the layering - or keeping a second, epan-level copy
+// of every column string for every frame, which costs more memory than
+// the redundant formatting costs time: export and find each touch a
+// frame once per operation, while the packet list re-reads the same
+// rows on every scroll, sort and resize, which is why the cache lives
+// here.
 const QString PacketListRecord::columnString(capture_file *cap_file, int column, bool colorized)
 {
     // packet_list_store.c:packet_list_get_value
@@ -277,6 +314,18 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
         }
 #endif // MINIMIZE_STRING_COPYING
     }
+
+    // Column text is regenerated on demand, so we can bound the memory
+    // it takes: track materialized records oldest-first and drop the
+    // text of the oldest ones once too many have been cached.  A record
+    // whose text was dropped re-dissects if it scrolls back into view.
+    if (text_pool_enabled_ && !text_pooled_) {
+        text_pooled_ = true;
+        text_pool_ << this;
+        while (text_pool_.size() > text_pool_limit_) {
+            text_pool_.takeFirst()->dropColumnStrings();
+        }
+    }
 }
 
 /*
@@ -44,6 +44,8 @@ public:
     static void invalidateAllRecords() { col_data_ver_++; }
     static void resetColumns(column_info *cinfo);
     static void resetColorization() { rows_color_ver_++; }
+    static void setTextPoolEnabled(bool enable) { text_pool_enabled_ = enable; }
+    static void resetTextPool();
 
     inline int lineCount() { return lines_; }
     inline int lineCountChanged() { return line_count_changed_; }
@@ -57,6 +59,12 @@ private:
     bool line_count_changed_;
     static QMap<int, int> cinfo_column_;
 
+    /** Records with cached column text, oldest first */
+    static QList<PacketListRecord *> text_pool_;
+    static bool text_pool_enabled_;
+    /** Is this record in text_pool_? */
+    bool text_pooled_;
+
     /** Data versions. Used to invalidate col_text_ */
     static unsigned col_data_ver_;
     unsigned data_ver_;
@@ -70,6 +78,7 @@ private:
 
     void dissect(capture_file *cap_file, bool dissect_color = false);
     void cacheColumnStrings(column_info *cinfo);
+    void dropColumnStrings();
 };
 
 #endif // PACKET_LIST_RECORD_H
@@ -47,6 +47,7 @@
 #include <ui/qt/utils/data_printer.h>
 #include <ui/qt/utils/frame_information.h>
 #include <ui/qt/utils/variant_pointer.h>
+#include <ui/qt/models/packet_list_record.h>
 #include <ui/qt/models/pref_models.h>
 #include <ui/qt/widgets/packet_list_header.h>
 #include <ui/qt/utils/wireshark_mime_data.h>
@@ -219,7 +220,7 @@ PacketList::PacketList(QWidget *parent) :
     rows_inserted_(false),
     columns_changed_(false),
     set_column_visibility_(false),
-    frozen_row_(-1),
+    frozen_frame_num_(0),
     cur_history_(-1),
     in_history_(false)
 {
@@ -1161,9 +1162,12 @@ void PacketList::freeze()
     setUpdatesEnabled(false);
     column_state_ = header()->saveState();
     if (currentIndex().isValid()) {
-        frozen_row_ = currentIndex().row();
+        /* Remember the frame, not the row: a refilter between freeze()
+         * and thaw() changes which frame occupies which row. */
+        frame_data *fdata = packet_list_model_->getRowFdata(currentIndex().row());
+        frozen_frame_num_ = fdata ? fdata->num : 0;
     } else {
-        frozen_row_ = -1;
+        frozen_frame_num_ = 0;
     }
     selectionModel()->clear();
     setModel(Q_NULLPTR);
@@ -1185,14 +1189,31 @@ void PacketList::thaw(bool restore_selection)
     // resized the columns manually since they were initially loaded.
     header()->restoreState(column_state_);
 
-    if (restore_selection && frozen_row_ > -1 && selectionModel()) {
-        /* This updates our selection, which redissects the current packet,
-         * which is needed when we're called from MainWindow::layoutPanes.
-         * Also, this resets all ProtoTree and ByteView data */
-        QModelIndex restored = packet_list_model_->index(frozen_row_, 0);
-        selectionModel()->select(restored, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    if (restore_selection && frozen_frame_num_ > 0 && selectionModel()) {
+        int row = packet_list_model_->packetNumberToRow(frozen_frame_num_);
+        if (row < 0 && cap_file_) {
+            /* The frozen frame was filtered out; anchor on the nearest
+             * frame that is still visible so the view stays in the same
+             * part of the capture. */
+            for (guint32 dist = 1; dist < cap_file_->count && row < 0; dist++) {
+                if (frozen_frame_num_ > dist) {
+                    row = packet_list_model_->packetNumberToRow(frozen_frame_num_ - dist);
+                }
+                if (row < 0 && frozen_frame_num_ + dist <= cap_file_->count) {
+                    row = packet_list_model_->packetNumberToRow(frozen_frame_num_ + dist);
+                }
+            }
+        }
+        if (row > -1) {
+            /* This updates our selection, which redissects the current packet,
+             * which is needed when we're called from MainWindow::layoutPanes.
+             * Also, this resets all ProtoTree and ByteView data */
+            QModelIndex restored = packet_list_model_->index(row, 0);
+            selectionModel()->select(restored, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+            scrollTo(restored, PositionAtCenter);
+        }
     }
-    frozen_row_ = -1;
+    frozen_frame_num_ = 0;
 }
 
 void PacketList::clear() {
@@ -1773,9 +1794,18 @@ QString PacketList::createSummaryText(QModelIndex idx, SummaryCopyType type)
 
     QStringList col_parts;
     int row = idx.row();
+    /* Fetch the column text from the record directly, without asking for
+     * colorization.  Asking the model for DisplayRole would dissect
+     * uncached rows with color filters applied, and a bulk copy of rows
+     * that were never scrolled into view doesn't need their colors. */
+    PacketListRecord *record = static_cast<PacketListRecord*>(idx.internalPointer());
     for (int col = 0; col < packet_list_model_->columnCount(); col++) {
         if (get_column_visible(col)) {
-            col_parts << packet_list_model_->data(packet_list_model_->index(row, col), Qt::DisplayRole).toString();
+            if (record) {
+                col_parts << record->columnString(cap_file_, col, false);
+            } else {
+                col_parts << packet_list_model_->data(packet_list_model_->index(row, col), Qt::DisplayRole).toString();
+            }
         }
     }
     return joinSummaryRow(col_parts, row, type);
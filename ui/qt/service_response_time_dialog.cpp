@@ -283,7 +283,7 @@ void ServiceResponseTimeDialog::fillTree()
     if (!registerTapListener(get_srt_tap_listener_name(srt_),
                         &srt_data_,
                         display_filter.toUtf8().constData(),
-                        0,
+                        get_srt_tap_flags(srt_),
                         tapReset,
                         get_srt_packet_func(srt_),
                         tapDraw)) {
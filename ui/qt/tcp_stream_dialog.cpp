@@ -766,7 +766,13 @@ void TCPStreamDialog::fillStevens()
         rel_time.append(ts - ts_offset_);
         seq.append(seg->th_seq - seq_offset_);
     }
-    base_graph_->setData(rel_time, seq);
+    // All the graph fills append their points in segment-list (time) order,
+    // so tell QCP the keys are already sorted and skip its O(n log n)
+    // re-sort on every fill. Per-pixel min/max decimation of large series
+    // happens at draw time via QCPGraph's adaptive sampling, which is on
+    // by default, so zooming stays interactive on multi-million-segment
+    // streams.
+    base_graph_->setData(rel_time, seq, true);
 }
 
 void TCPStreamDialog::fillTcptrace()
@@ -860,16 +866,16 @@ void TCPStreamDialog::fillTcptrace()
             rwin.append(ackno + seg->th_win);
         }
     }
-    base_graph_->setData(pkt_time, pkt_seqnums);
-    ack_graph_->setData(ackrwin_time, ack);
+    base_graph_->setData(pkt_time, pkt_seqnums, true);
+    ack_graph_->setData(ackrwin_time, ack, true);
 #if 0 // Deactivated due to function not implemented in v2
     seg_graph_->setDataValueError(sb_time, sb_center, sb_span);
     sack_graph_->setDataValueError(sack_time, sack_center, sack_span);
     sack2_graph_->setDataValueError(sack2_time, sack2_center, sack2_span);
 #endif
-    rwin_graph_->setData(ackrwin_time, rwin);
-    dup_ack_graph_->setData(dup_ack_time, dup_ack);
-    zero_win_graph_->setData(zero_win_time, zero_win);
+    rwin_graph_->setData(ackrwin_time, rwin, true);
+    dup_ack_graph_->setData(dup_ack_time, dup_ack, true);
+    zero_win_graph_->setData(zero_win_time, zero_win, true);
 }
 
 // If the current implementation of incorporating SACKs in goodput calc
@@ -1291,9 +1297,9 @@ void TCPStreamDialog::fillThroughput()
             r_Xput_times.append(ts);
         }
     }
-    base_graph_->setData(seg_rel_times, seg_lens);
-    tput_graph_->setData(tput_times, tputs);
-    goodput_graph_->setData(gput_times, gputs);
+    base_graph_->setData(seg_rel_times, seg_lens, true);
+    tput_graph_->setData(tput_times, tputs, true);
+    goodput_graph_->setData(gput_times, gputs, true);
 }
 
 // rtt_selectively_ack_range:
@@ -1491,6 +1497,8 @@ void TCPStreamDialog::fillRoundTripTime()
     }
     // it's possible there's still unacked segs - so be sure to free list!
     rtt_destroy_unack_list(&unack_list);
+    // RTT points can come out of order (partial and selective acks), so
+    // this graph keeps QCP's sorting path.
     base_graph_->setData(x_vals, rtt);
 }
 
@@ -1544,8 +1552,8 @@ void TCPStreamDialog::fillWindowScale()
             }
         }
     }
-    base_graph_->setData(cwnd_time, cwnd_size);
-    rwin_graph_->setData(rel_time, win_size);
+    base_graph_->setData(cwnd_time, cwnd_size, true);
+    rwin_graph_->setData(rel_time, win_size, true);
     sp->yAxis->setLabel(window_size_label_);
 }
 
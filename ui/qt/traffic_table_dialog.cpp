@@ -14,15 +14,20 @@
 #include <epan/addr_resolv.h>
 #include <epan/prefs.h>
 
+#include <wsutil/utf8_entities.h>
+
 #include "ui/recent.h"
 
 #include "progress_frame.h"
 #include "wireshark_application.h"
 
+#include "ui/qt/widgets/wireshark_file_dialog.h"
+
 #include <QCheckBox>
 #include <QClipboard>
 #include <QContextMenuEvent>
 #include <QDialogButtonBox>
+#include <QFile>
 #include <QList>
 #include <QMap>
 #include <QMessageBox>
@@ -44,6 +49,7 @@ TrafficTableDialog::TrafficTableDialog(QWidget &parent, CaptureFile &cf, const c
     WiresharkDialog(parent, cf),
     ui(new Ui::TrafficTableDialog),
     filter_(filter),
+    table_name_(table_name),
     nanosecond_timestamps_(false)
 {
     ui->setupUi(this);
@@ -64,6 +70,10 @@ TrafficTableDialog::TrafficTableDialog(QWidget &parent, CaptureFile &cf, const c
     connect(ca, SIGNAL(triggered()), this, SLOT(copyAsYaml()));
     copy_bt_->setMenu(copy_menu);
 
+    save_bt_ = ui->buttonBox->addButton(tr("Save as CSV" UTF8_HORIZONTAL_ELLIPSIS), QDialogButtonBox::ActionRole);
+    save_bt_->setToolTip(tr("Write all values of this page to a CSV file, one row at a time."));
+    connect(save_bt_, SIGNAL(clicked()), this, SLOT(saveAsCsv()));
+
     ui->enabledTypesPushButton->setMenu(&traffic_type_menu_);
     ui->trafficTableTabWidget->setFocus();
 
@@ -340,6 +350,48 @@ void TrafficTableDialog::copyAsYaml()
     wsApp->clipboard()->setText(stream.readAll());
 }
 
+// Unlike the clipboard copies above, which assemble the whole table as
+// one string before handing it to the clipboard, this streams each row
+// to the file as it's formatted, so it stays usable on captures with
+// millions of conversations.
+void TrafficTableDialog::saveAsCsv()
+{
+    QTreeWidget *cur_tree = qobject_cast<QTreeWidget *>(ui->trafficTableTabWidget->currentWidget());
+    if (!cur_tree) {
+        return;
+    }
+
+    QString file_path = WiresharkFileDialog::getSaveFileName(
+                this, wsApp->windowTitleString(tr("Save %1s As" UTF8_HORIZONTAL_ELLIPSIS).arg(table_name_)),
+                wsApp->lastOpenDir().absoluteFilePath(QString("%1s.csv").arg(table_name_.toLower())),
+                tr("Comma-separated values (*.csv)"));
+    if (file_path.isEmpty()) {
+        return;
+    }
+
+    QFile save_file(file_path);
+    if (!save_file.open(QFile::WriteOnly | QFile::Truncate)) {
+        QMessageBox::warning(this, tr("Error saving %1").arg(file_path),
+                             save_file.errorString());
+        return;
+    }
+
+    QTextStream stream(&save_file);
+    for (int row = -1; row < cur_tree->topLevelItemCount(); row++) {
+        QStringList rdsl;
+        foreach (QVariant v, curTreeRowData(row)) {
+            if (!v.isValid()) {
+                rdsl << "\"\"";
+            } else if (v.type() == QVariant::String) {
+                rdsl << QString("\"%1\"").arg(v.toString());
+            } else {
+                rdsl << v.toString();
+            }
+        }
+        stream << rdsl.join(",") << '\n';
+    }
+}
+
 TrafficTableTreeWidget::TrafficTableTreeWidget(QWidget *parent, register_ct_t *table) :
     QTreeWidget(parent),
     table_(table),
@@ -127,6 +127,7 @@ protected:
     QString filter_;
     QMenu traffic_type_menu_;
     QPushButton *copy_bt_;
+    QPushButton *save_bt_;
     QMap<int, TrafficTableTreeWidget *> proto_id_to_tree_;
 
     const QList<int> defaultProtos() const;
@@ -150,6 +151,7 @@ protected slots:
 
 private:
     QString window_name_;
+    QString table_name_;
     bool nanosecond_timestamps_;
 
     QList<QVariant> curTreeRowData(int row) const;
@@ -164,6 +166,7 @@ private slots:
 
     void copyAsCsv();
     void copyAsYaml();
+    void saveAsCsv();
     virtual void on_buttonBox_helpRequested() = 0;
 };
 
@@ -52,10 +52,16 @@ ByteViewText::ByteViewText(const QByteArray &data, packet_char_enc encoding, QWi
     show_ascii_(true),
     row_width_(recent.gui_bytes_view == BYTES_HEX ? 16 : 8),
     font_width_(0),
-    line_height_(0)
+    line_height_(0),
+    x_pos_full_row_(false)
 {
     layout_->setCacheEnabled(true);
 
+    // Bound the memory we spend on formatted rows. 4096 rows cover a lot
+    // of scrolling through a large reassembled payload without having to
+    // keep every row of a multi-megabyte PDU around.
+    line_cache_.setMaxCost(4096);
+
     offset_normal_fg_ = ColorUtils::alphaBlend(palette().windowText(), palette().window(), 0.35);
     offset_field_fg_ = ColorUtils::alphaBlend(palette().windowText(), palette().window(), 0.65);
 
@@ -140,6 +146,7 @@ void ByteViewText::markProtocol(int start, int length)
 {
     proto_start_ = start;
     proto_len_ = length;
+    line_cache_.clear();
     viewport()->update();
 }
 
@@ -147,6 +154,7 @@ void ByteViewText::markField(int start, int length, bool scroll_to)
 {
     field_start_ = start;
     field_len_ = length;
+    line_cache_.clear();
     // This might be called as a result of (de)selecting a proto tree
     // item, so take us out of marked mode.
     marked_byte_offset_ = -1;
@@ -160,6 +168,7 @@ void ByteViewText::markAppendix(int start, int length)
 {
     field_a_start_ = start;
     field_a_len_ = length;
+    line_cache_.clear();
     viewport()->update();
 }
 
@@ -178,6 +187,7 @@ void ByteViewText::setMonospaceFont(const QFont &mono_font)
     // We should probably use ProtoTree::rowHeight.
     line_height_ = fontMetrics().height();
 
+    x_pos_to_column_.clear();
     updateScrollbars();
     viewport()->update();
 }
@@ -212,7 +222,8 @@ void ByteViewText::paintEvent(QPaintEvent *)
     int leading = fontMetrics().leading();
     painter.save();
 
-    x_pos_to_column_.clear();
+    // x_pos_to_column_ is built by the first line we draw and kept until
+    // the font or the bytes-per-row layout changes.
     while ((int) (row_y + line_height_) < widget_height && offset < (int) data_.count()) {
         drawLine(&painter, offset, row_y);
         offset += row_width_;
@@ -326,10 +337,21 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
         return;
     }
 
-    // Build our pixel to byte offset vector the first time through.
-    bool build_x_pos = x_pos_to_column_.empty() ? true : false;
     int tvb_len = data_.count();
     int max_tvb_pos = qMin(offset + row_width_, tvb_len) - 1;
+    // Build our pixel to byte offset vector the first time through and
+    // again if it came from a partial last row and we now have a full one.
+    bool row_is_full = offset + row_width_ <= tvb_len;
+    bool build_x_pos = x_pos_to_column_.empty() || (!x_pos_full_row_ && row_is_full);
+    if (build_x_pos) {
+        x_pos_to_column_.clear();
+        x_pos_full_row_ = row_is_full;
+    }
+    // Hover and mark outlines are computed while the text is built, and
+    // they move on every mouse event, so the lines containing them always
+    // take the slow path.
+    bool outline_in_line = (hovered_byte_offset_ >= offset && hovered_byte_offset_ <= max_tvb_pos)
+            || (marked_byte_offset_ >= offset && marked_byte_offset_ <= max_tvb_pos);
     QList<QTextLayout::FormatRange> fmt_list;
 
     static const guchar hexchars[16] = {
@@ -339,127 +361,145 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
     QString line;
     HighlightMode offset_mode = ModeOffsetNormal;
 
-    // Offset.
-    if (show_offset_) {
-        line = QString(" %1 ").arg(offset, offsetChars(false), 16, QChar('0'));
-        if (build_x_pos) {
-            x_pos_to_column_.fill(-1, fontMetrics().boundingRect(line).width());
-        }
+    CachedLine *cached = NULL;
+    if (!build_x_pos && !outline_in_line) {
+        cached = line_cache_.object(offset);
     }
 
-    // Hex
-    if (show_hex_) {
-        int ascii_start = line.length() + DataPrinter::hexChars() + 3;
-        // Extra hover space before and after each byte.
-        int slop = font_width_ / 2;
+    if (cached) {
+        line = cached->first;
+        fmt_list = cached->second;
+    } else {
 
-        if (build_x_pos) {
-            x_pos_to_column_ += QVector<int>().fill(-1, slop);
+        // Offset.
+        if (show_offset_) {
+            line = QString(" %1 ").arg(offset, offsetChars(false), 16, QChar('0'));
+            if (build_x_pos) {
+                x_pos_to_column_.fill(-1, fontMetrics().boundingRect(line).width());
+            }
         }
 
-        for (int tvb_pos = offset; tvb_pos <= max_tvb_pos; tvb_pos++) {
-            line += ' ';
-            /* insert a space every separator_interval_ bytes */
-            if ((tvb_pos != offset) && ((tvb_pos % separator_interval_) == 0)) {
-                line += ' ';
-                x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_);
-            }
+        // Hex
+        if (show_hex_) {
+            int ascii_start = line.length() + DataPrinter::hexChars() + 3;
+            // Extra hover space before and after each byte.
+            int slop = font_width_ / 2;
 
-            switch (recent.gui_bytes_view) {
-            case BYTES_HEX:
-                line += hexchars[(data_[tvb_pos] & 0xf0) >> 4];
-                line += hexchars[data_[tvb_pos] & 0x0f];
-                break;
-            case BYTES_BITS:
-                /* XXX, bitmask */
-                for (int j = 7; j >= 0; j--) {
-                    line += (data_[tvb_pos] & (1 << j)) ? '1' : '0';
-                }
-                break;
-            }
             if (build_x_pos) {
-                x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset, fontMetrics().boundingRect(line).width() - x_pos_to_column_.size() + slop);
+                x_pos_to_column_ += QVector<int>().fill(-1, slop);
             }
-            if (tvb_pos == hovered_byte_offset_ || tvb_pos == marked_byte_offset_) {
-                int ho_len = recent.gui_bytes_view == BYTES_HEX ? 2 : 8;
-                QRect ho_rect = painter->boundingRect(QRect(), Qt::AlignHCenter|Qt::AlignVCenter, line.right(ho_len));
-                ho_rect.moveRight(fontMetrics().boundingRect(line).width());
-                ho_rect.moveTop(row_y);
-                hover_outlines_.append(ho_rect);
-            }
-        }
-        line += QString(ascii_start - line.length(), ' ');
-        if (build_x_pos) {
-            x_pos_to_column_ += QVector<int>().fill(-1, fontMetrics().boundingRect(line).width() - x_pos_to_column_.size());
-        }
 
-        addHexFormatRange(fmt_list, proto_start_, proto_len_, offset, max_tvb_pos, ModeProtocol);
-        if (addHexFormatRange(fmt_list, field_start_, field_len_, offset, max_tvb_pos, ModeField)) {
-            offset_mode = ModeOffsetField;
-        }
-        addHexFormatRange(fmt_list, field_a_start_, field_a_len_, offset, max_tvb_pos, ModeField);
-    }
-
-    // ASCII
-    if (show_ascii_) {
-        bool in_non_printable = false;
-        int np_start = 0;
-        int np_len = 0;
-        guchar c;
-
-        for (int tvb_pos = offset; tvb_pos <= max_tvb_pos; tvb_pos++) {
-            /* insert a space every separator_interval_ bytes */
-            if ((tvb_pos != offset) && ((tvb_pos % separator_interval_) == 0)) {
+            for (int tvb_pos = offset; tvb_pos <= max_tvb_pos; tvb_pos++) {
                 line += ' ';
+                /* insert a space every separator_interval_ bytes */
+                if ((tvb_pos != offset) && ((tvb_pos % separator_interval_) == 0)) {
+                    line += ' ';
+                    if (build_x_pos) {
+                        x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_);
+                    }
+                }
+
+                switch (recent.gui_bytes_view) {
+                case BYTES_HEX:
+                    line += hexchars[(data_[tvb_pos] & 0xf0) >> 4];
+                    line += hexchars[data_[tvb_pos] & 0x0f];
+                    break;
+                case BYTES_BITS:
+                    /* XXX, bitmask */
+                    for (int j = 7; j >= 0; j--) {
+                        line += (data_[tvb_pos] & (1 << j)) ? '1' : '0';
+                    }
+                    break;
+                }
                 if (build_x_pos) {
-                    x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_ / 2);
+                    x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset, fontMetrics().boundingRect(line).width() - x_pos_to_column_.size() + slop);
+                }
+                if (tvb_pos == hovered_byte_offset_ || tvb_pos == marked_byte_offset_) {
+                    int ho_len = recent.gui_bytes_view == BYTES_HEX ? 2 : 8;
+                    QRect ho_rect = painter->boundingRect(QRect(), Qt::AlignHCenter|Qt::AlignVCenter, line.right(ho_len));
+                    ho_rect.moveRight(fontMetrics().boundingRect(line).width());
+                    ho_rect.moveTop(row_y);
+                    hover_outlines_.append(ho_rect);
                 }
             }
+            line += QString(ascii_start - line.length(), ' ');
+            if (build_x_pos) {
+                x_pos_to_column_ += QVector<int>().fill(-1, fontMetrics().boundingRect(line).width() - x_pos_to_column_.size());
+            }
 
-            if (recent.gui_bytes_encoding != BYTES_ENC_EBCDIC && encoding_ == PACKET_CHAR_ENC_CHAR_ASCII) {
-                c = data_[tvb_pos];
-            } else {
-                c = EBCDIC_to_ASCII1(data_[tvb_pos]);
+            addHexFormatRange(fmt_list, proto_start_, proto_len_, offset, max_tvb_pos, ModeProtocol);
+            if (addHexFormatRange(fmt_list, field_start_, field_len_, offset, max_tvb_pos, ModeField)) {
+                offset_mode = ModeOffsetField;
             }
+            addHexFormatRange(fmt_list, field_a_start_, field_a_len_, offset, max_tvb_pos, ModeField);
+        }
 
-            if (g_ascii_isprint(c)) {
-                line += c;
-                if (in_non_printable) {
-                    in_non_printable = false;
-                    addAsciiFormatRange(fmt_list, np_start, np_len, offset, max_tvb_pos, ModeNonPrintable);
+        // ASCII
+        if (show_ascii_) {
+            bool in_non_printable = false;
+            int np_start = 0;
+            int np_len = 0;
+            guchar c;
+
+            for (int tvb_pos = offset; tvb_pos <= max_tvb_pos; tvb_pos++) {
+                /* insert a space every separator_interval_ bytes */
+                if ((tvb_pos != offset) && ((tvb_pos % separator_interval_) == 0)) {
+                    line += ' ';
+                    if (build_x_pos) {
+                        x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_ / 2);
+                    }
                 }
-            } else {
-                line += UTF8_MIDDLE_DOT;
-                if (!in_non_printable) {
-                    in_non_printable = true;
-                    np_start = tvb_pos;
-                    np_len = 1;
+
+                if (recent.gui_bytes_encoding != BYTES_ENC_EBCDIC && encoding_ == PACKET_CHAR_ENC_CHAR_ASCII) {
+                    c = data_[tvb_pos];
                 } else {
-                    np_len++;
+                    c = EBCDIC_to_ASCII1(data_[tvb_pos]);
+                }
+
+                if (g_ascii_isprint(c)) {
+                    line += c;
+                    if (in_non_printable) {
+                        in_non_printable = false;
+                        addAsciiFormatRange(fmt_list, np_start, np_len, offset, max_tvb_pos, ModeNonPrintable);
+                    }
+                } else {
+                    line += UTF8_MIDDLE_DOT;
+                    if (!in_non_printable) {
+                        in_non_printable = true;
+                        np_start = tvb_pos;
+                        np_len = 1;
+                    } else {
+                        np_len++;
+                    }
+                }
+                if (build_x_pos) {
+                    x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset, fontMetrics().boundingRect(line).width() - x_pos_to_column_.size());
+                }
+                if (tvb_pos == hovered_byte_offset_ || tvb_pos == marked_byte_offset_) {
+                    QRect ho_rect = painter->boundingRect(QRect(), 0, line.right(1));
+                    ho_rect.moveRight(fontMetrics().boundingRect(line).width());
+                    ho_rect.moveTop(row_y);
+                    hover_outlines_.append(ho_rect);
                 }
             }
-            if (build_x_pos) {
-                x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset, fontMetrics().boundingRect(line).width() - x_pos_to_column_.size());
+            if (in_non_printable) {
+                addAsciiFormatRange(fmt_list, np_start, np_len, offset, max_tvb_pos, ModeNonPrintable);
             }
-            if (tvb_pos == hovered_byte_offset_ || tvb_pos == marked_byte_offset_) {
-                QRect ho_rect = painter->boundingRect(QRect(), 0, line.right(1));
-                ho_rect.moveRight(fontMetrics().boundingRect(line).width());
-                ho_rect.moveTop(row_y);
-                hover_outlines_.append(ho_rect);
+            addAsciiFormatRange(fmt_list, proto_start_, proto_len_, offset, max_tvb_pos, ModeProtocol);
+            if (addAsciiFormatRange(fmt_list, field_start_, field_len_, offset, max_tvb_pos, ModeField)) {
+                offset_mode = ModeOffsetField;
             }
+            addAsciiFormatRange(fmt_list, field_a_start_, field_a_len_, offset, max_tvb_pos, ModeField);
         }
-        if (in_non_printable) {
-            addAsciiFormatRange(fmt_list, np_start, np_len, offset, max_tvb_pos, ModeNonPrintable);
-        }
-        addAsciiFormatRange(fmt_list, proto_start_, proto_len_, offset, max_tvb_pos, ModeProtocol);
-        if (addAsciiFormatRange(fmt_list, field_start_, field_len_, offset, max_tvb_pos, ModeField)) {
-            offset_mode = ModeOffsetField;
-        }
-        addAsciiFormatRange(fmt_list, field_a_start_, field_a_len_, offset, max_tvb_pos, ModeField);
-    }
 
-    // XXX Fields won't be highlighted if neither hex nor ascii are enabled.
-    addFormatRange(fmt_list, 0, offsetChars(), offset_mode);
+        // XXX Fields won't be highlighted if neither hex nor ascii are enabled.
+        addFormatRange(fmt_list, 0, offsetChars(), offset_mode);
+
+        // The text and highlight ranges don't depend on the hover position,
+        // so a line built on the slow path is still fine to reuse later.
+        line_cache_.insert(offset, new CachedLine(line, fmt_list));
+
+    }
 
     layout_->clearLayout();
 #if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
@@ -660,6 +700,8 @@ void ByteViewText::setHexDisplayFormat(QAction *action)
 
     recent.gui_bytes_view = action->data().value<bytes_view_type>();
     row_width_ = recent.gui_bytes_view == BYTES_HEX ? 16 : 8;
+    line_cache_.clear();
+    x_pos_to_column_.clear();
     updateScrollbars();
     viewport()->update();
 }
@@ -671,6 +713,7 @@ void ByteViewText::setCharacterEncoding(QAction *action)
     }
 
     recent.gui_bytes_encoding = action->data().value<bytes_encoding_type>();
+    line_cache_.clear();
     viewport()->update();
 }
 
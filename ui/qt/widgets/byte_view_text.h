@@ -15,9 +15,11 @@
 #include "ui/recent.h"
 
 #include <QAbstractScrollArea>
+#include <QCache>
 #include <QFont>
 #include <QVector>
 #include <QMenu>
+#include <QPair>
 #include <QSize>
 #include <QString>
 #include <QTextLayout>
@@ -72,8 +74,12 @@ private:
         ModeNonPrintable
     } HighlightMode;
 
+    // Text and highlight ranges for one row, ready to hand to layout_.
+    typedef QPair<QString, QList<QTextLayout::FormatRange> > CachedLine;
+
     QTextLayout *layout_;
     const QByteArray data_;
+    QCache<int, CachedLine> line_cache_; // Formatted rows, keyed by byte offset.
 
     void drawLine(QPainter *painter, const int offset, const int row_y);
     bool addFormatRange(QList<QTextLayout::FormatRange> &fmt_list, int start, int length, HighlightMode mode);
@@ -122,6 +128,7 @@ private:
 
     // Data selection
     QVector<int> x_pos_to_column_;
+    bool x_pos_full_row_;       // Was x_pos_to_column_ built from a full row?
 
 private slots:
     void copyBytes(bool);
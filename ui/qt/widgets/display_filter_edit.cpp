@@ -512,33 +512,31 @@ void DisplayFilterEdit::buildCompletionList(const QString &field_word)
     completion_model_->setStringList(complex_list);
     completer()->setCompletionPrefix(field_word);
 
-    void *proto_cookie;
     QStringList field_list;
     int field_dots = field_word.count('.'); // Some protocol names (_ws.expert) contain periods.
-    for (int proto_id = proto_get_first_protocol(&proto_cookie); proto_id != -1; proto_id = proto_get_next_protocol(&proto_cookie)) {
-        protocol_t *protocol = find_protocol_by_id(proto_id);
-        if (!proto_is_protocol_enabled(protocol)) continue;
-
-        const QString pfname = proto_get_protocol_filter_name(proto_id);
-        field_list << pfname;
+    const QByteArray fw_ba = field_word.toUtf8(); // or toLatin1 or toStdString?
+    const char *fw_utf8 = fw_ba.constData();
+    gsize fw_len = (gsize) strlen(fw_utf8);
+    guint reg_cookie;
+    // The registrar keeps the abbreviations sorted, so this only visits
+    // fields that actually start with the typed word instead of walking
+    // every registered field on each keystroke.
+    for (header_field_info *hfinfo = proto_registrar_get_first_byprefix(fw_utf8, &reg_cookie);
+         hfinfo; hfinfo = proto_registrar_get_next_byprefix(fw_utf8, &reg_cookie)) {
+        if (proto_registrar_is_protocol(hfinfo->id)) {
+            if (!proto_is_protocol_enabled(find_protocol_by_id(hfinfo->id))) continue;
+            field_list << hfinfo->abbrev;
+            continue;
+        }
+        if (!proto_is_protocol_enabled(find_protocol_by_id(hfinfo->parent))) continue;
 
-        // Add fields only if we're past the protocol name and only for the
-        // current protocol.
+        // Add fields only if we're past the protocol name.
+        const QString pfname = proto_get_protocol_filter_name(hfinfo->parent);
         if (field_dots > pfname.count('.')) {
-            void *field_cookie;
-            const QByteArray fw_ba = field_word.toUtf8(); // or toLatin1 or toStdString?
-            const char *fw_utf8 = fw_ba.constData();
-            gsize fw_len = (gsize) strlen(fw_utf8);
-            for (header_field_info *hfinfo = proto_get_first_protocol_field(proto_id, &field_cookie); hfinfo; hfinfo = proto_get_next_protocol_field(proto_id, &field_cookie)) {
-                if (hfinfo->same_name_prev_id != -1) continue; // Ignore duplicate names.
-
-                if (!g_ascii_strncasecmp(fw_utf8, hfinfo->abbrev, fw_len)) {
-                    if ((gsize) strlen(hfinfo->abbrev) != fw_len) field_list << hfinfo->abbrev;
-                }
-            }
+            if ((gsize) strlen(hfinfo->abbrev) != fw_len) field_list << hfinfo->abbrev;
         }
     }
-    field_list.sort();
+    // Already in abbreviation order, courtesy of the registrar.
 
     completion_model_->setStringList(complex_list + field_list);
     completer()->setCompletionPrefix(field_word);
@@ -25,9 +25,11 @@
 #include "epan/disabled_protos.h"
 #include "epan/ftypes/ftypes.h"
 #include "epan/prefs.h"
+#include "epan/prefs-int.h"
 #include "epan/proto.h"
 #include "epan/tap.h"
 #include "epan/timestamp.h"
+#include "epan/uat.h"
 #include "epan/decode_as.h"
 
 #include "ui/decode_as_utils.h"
@@ -78,6 +80,7 @@
 #include <QDesktopServices>
 #include <QDir>
 #include <QEvent>
+#include <QFile>
 #include <QFileOpenEvent>
 #include <QFontInfo>
 #include <QFontMetrics>
@@ -359,6 +362,34 @@ int WiresharkApplication::monospaceTextSize(const char *str)
 #endif
 }
 
+// The configuration files, besides the preferences themselves, that feed
+// into dissection; if none of them differ between two profiles and no
+// dissection-affecting preference does either, switching profiles doesn't
+// require redissecting the capture.
+static const char *dissection_cfg_files[] = {
+    "decode_as_entries",
+    "disabled_protos",
+    "enabled_protos",
+    "heuristic_protos"
+};
+
+static QList<QByteArray> readDissectionConfigFiles()
+{
+    QList<QByteArray> contents;
+
+    for (unsigned i = 0; i < G_N_ELEMENTS(dissection_cfg_files); i++) {
+        char *path = get_persconffile_path(dissection_cfg_files[i], TRUE);
+        QFile cfg_file(path);
+        g_free(path);
+        if (cfg_file.open(QIODevice::ReadOnly)) {
+            contents << cfg_file.readAll();
+        } else {
+            contents << QByteArray();
+        }
+    }
+    return contents;
+}
+
 void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bool write_recent_file)
 {
     char  *rf_path;
@@ -399,6 +430,16 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
         return;
     }
 
+    /* Profiles often differ only in layout, columns and colors.  Note
+     * what the profile we are leaving fed into dissection; if the new
+     * profile's configuration turns out to be identical, the capture
+     * doesn't have to be redissected.  Loaded UAT data is conservatively
+     * treated as a difference, as it is about to be unloaded. */
+    bool dissection_changed = uat_dissection_data_present();
+    QList<QByteArray> old_dissection_cfg;
+    if (!dissection_changed)
+        old_dissection_cfg = readDissectionConfigFiles();
+
     /* Get the current geometry, before writing it to disk */
     emit profileChanging();
 
@@ -415,6 +456,15 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
     /* Apply new preferences */
     readConfigurationFiles(true);
 
+    /* This has to be checked before prefs_apply_all() below hands the
+     * changed flags to the modules' apply callbacks and clears them. */
+    if (!dissection_changed) {
+        dissection_changed =
+            (prefs_modules_changed_flags() & PREF_EFFECT_DISSECTION) != 0 ||
+            uat_dissection_data_present() ||
+            readDissectionConfigFiles() != old_dissection_cfg;
+    }
+
     if (!recent_read_profile_static(&rf_path, &rf_open_errno)) {
         simple_dialog(ESD_TYPE_WARN, ESD_BTN_OK,
             "Could not open common recent file\n\"%s\": %s.",
@@ -453,7 +503,8 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
     }
 
     emit localInterfaceListChanged();
-    emit packetDissectionChanged();
+    if (dissection_changed)
+        emit packetDissectionChanged();
 
     /* Write recent_common file to ensure last used profile setting is stored. */
     write_recent();
@@ -947,7 +998,15 @@ void WiresharkApplication::emitAppSignal(AppSignal signal)
 void WiresharkApplication::flushAppSignals()
 {
     while (!app_signals_.isEmpty()) {
-        wsApp->emitAppSignal(app_signals_.takeFirst());
+        AppSignal app_signal = app_signals_.takeFirst();
+        // A dialog with several independent frames (the preferences
+        // dialog holds UAT tables, filter expressions and per-module
+        // preferences) queues one signal per frame that changed.  Emit
+        // each distinct signal once: the handlers act on current state,
+        // not on the event, and emitting PacketDissectionChanged twice
+        // would redissect the whole capture twice.
+        app_signals_.removeAll(app_signal);
+        wsApp->emitAppSignal(app_signal);
     }
 }
 
@@ -88,6 +88,7 @@ struct _rtpstream_tapinfo {
     void              *tap_data;            /**< data for tap callbacks */
     int                nstreams; /**< number of streams in the list */
     GList             *strinfo_list; /**< list of rtpstream_info_t* */
+    GHashTable        *strinfo_hash; /**< lookup of rtpstream_info_t* by id, entries owned by strinfo_list */
     int                npackets; /**< total number of rtp packets of all streams */
     /* used while tapping. user shouldn't modify these */
     tap_mode_t         mode;
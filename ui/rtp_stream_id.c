@@ -88,6 +88,25 @@ gboolean rtpstream_id_equal(const rtpstream_id_t *id1, const rtpstream_id_t *id2
 	return FALSE;
 }
 
+/****************************************************************************/
+/* hash of an id, suitable for GHashTable lookups */
+guint rtpstream_id_to_hash(const rtpstream_id_t *id)
+{
+	guint hash;
+
+	if (!id)
+		return 0;
+
+	/* Cheap mix of the endpoints and the SSRC; collisions within a
+	   bucket are sorted out by rtpstream_id_equal(). */
+	hash = add_address_to_hash(0, &(id->src_addr));
+	hash = add_address_to_hash(hash, &(id->dst_addr));
+	hash ^= (guint)id->src_port << 16 | id->dst_port;
+	hash ^= id->ssrc;
+
+	return hash;
+}
+
 /****************************************************************************/
 /* compare two ids, one in pinfo */
 gboolean rtpstream_id_equal_pinfo_rtp_info(const rtpstream_id_t *id, const packet_info *pinfo, const struct _rtp_info *rtp_info)
@@ -70,6 +70,12 @@ gboolean rtpstream_id_equal(const rtpstream_id_t *id1, const rtpstream_id_t *id2
  */
 gboolean rtpstream_id_equal_pinfo_rtp_info(const rtpstream_id_t *id, const packet_info *pinfo, const struct _rtp_info *rtp_info);
 
+/**
+ * Get hash of rtpstream_id_t
+ * - hashes src_addr, dest_addr, src_port, dest_port and ssrc
+ */
+guint rtpstream_id_to_hash(const rtpstream_id_t *id);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -122,6 +122,20 @@ gint rtpstream_info_cmp(gconstpointer aa, gconstpointer bb)
         return 1;
 }
 
+/****************************************************************************/
+/* GHashTable callbacks for rtpstream_info_t*, keyed by the stream id */
+static guint rtpstream_info_hash(gconstpointer key)
+{
+    return rtpstream_id_to_hash(&(((const rtpstream_info_t *)key)->id));
+}
+
+static gboolean rtpstream_info_hash_equal(gconstpointer a, gconstpointer b)
+{
+    return rtpstream_id_equal(&(((const rtpstream_info_t *)a)->id),
+                              &(((const rtpstream_info_t *)b)->id),
+                              RTPSTREAM_ID_EQUAL_SSRC);
+}
+
 /****************************************************************************/
 /* compare the endpoints of two RTP streams */
 gboolean rtpstream_info_is_reverse(const rtpstream_info_t *stream_a, rtpstream_info_t *stream_b)
@@ -157,6 +171,10 @@ void rtpstream_reset(rtpstream_tapinfo_t *tapinfo)
         }
         g_list_free(tapinfo->strinfo_list);
         tapinfo->strinfo_list = NULL;
+        if (tapinfo->strinfo_hash) {
+            g_hash_table_destroy(tapinfo->strinfo_hash);
+            tapinfo->strinfo_hash = NULL;
+        }
         tapinfo->nstreams = 0;
         tapinfo->npackets = 0;
     }
@@ -366,7 +384,6 @@ tap_packet_status rtpstream_packet_cb(void *arg, packet_info *pinfo, epan_dissec
     const struct _rtp_info *rtpinfo = (const struct _rtp_info *)arg2;
     rtpstream_info_t new_stream_info;
     rtpstream_info_t *stream_info = NULL;
-    GList* list;
     rtpdump_info_t rtpdump_info;
 
     struct _rtp_conversation_info *p_conv_data = NULL;
@@ -380,16 +397,13 @@ tap_packet_status rtpstream_packet_cb(void *arg, packet_info *pinfo, epan_dissec
     new_stream_info.first_payload_type_name = rtpinfo->info_payload_type_str;
 
     if (tapinfo->mode == TAP_ANALYSE) {
-        /* check whether we already have a stream with these parameters in the list */
-        list = g_list_first(tapinfo->strinfo_list);
-        while (list)
-        {
-            if (rtpstream_info_cmp(&new_stream_info, (rtpstream_info_t *)(list->data))==0)
-            {
-                stream_info = (rtpstream_info_t *)(list->data);  /*found!*/
-                break;
-            }
-            list = g_list_next(list);
+        /* check whether we already have a stream with these parameters.
+         * The hash spares us a walk over the whole stream list for every
+         * single packet of a large capture. */
+        if (tapinfo->strinfo_hash) {
+            stream_info = (rtpstream_info_t *)g_hash_table_lookup(tapinfo->strinfo_hash, &new_stream_info);
+        } else {
+            tapinfo->strinfo_hash = g_hash_table_new(rtpstream_info_hash, rtpstream_info_hash_equal);
         }
 
         /* not in the list? then create a new entry */
@@ -413,6 +427,7 @@ tap_packet_status rtpstream_packet_cb(void *arg, packet_info *pinfo, epan_dissec
             stream_info = rtpstream_info_malloc_and_init();
             rtpstream_info_copy_deep(stream_info, &new_stream_info);
             tapinfo->strinfo_list = g_list_prepend(tapinfo->strinfo_list, stream_info);
+            g_hash_table_add(tapinfo->strinfo_hash, stream_info);
         }
 
         /* get RTP stats for the packet */
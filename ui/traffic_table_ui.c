@@ -61,6 +61,25 @@ const char *endp_column_titles[ENDP_NUM_GEO_COLUMNS] = {
 const char *endp_conn_title = "Connection";
 
 #ifdef HAVE_MAXMINDDB
+/* One map point per distinct coordinate pair.  MaxMind resolves to
+ * city-level coordinates, so on large captures many endpoints share a
+ * point; aggregating them here keeps the feature count bounded by the
+ * number of distinct locations rather than the number of endpoints,
+ * which is what lets the map survive ISP-scale captures.  Zoom-level
+ * detail is handled client-side: ipmap.html clusters the remaining
+ * points per zoom level with Leaflet.markercluster. */
+typedef struct {
+    double      longitude;
+    double      latitude;
+    guint       accuracy;
+    guint64     packets;
+    guint64     bytes;
+    guint       num_endpoints;
+    char        first_addr[WS_INET6_ADDRSTRLEN];
+    const mmdb_lookup_t *result;    /* representative lookup for this point */
+    gboolean    as_mixed;           /* endpoints span multiple AS numbers */
+} map_point_t;
+
 gboolean
 write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const *hosts, gchar **err_str)
 {
@@ -96,7 +115,8 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
     }
 
     /*
-     * Writes a feature for each resolved address, the output will look like:
+     * Writes a feature for each distinct resolved location, the output
+     * will look like:
      *  {
      *    "type": "FeatureCollection",
      *    "features": [
@@ -113,6 +133,7 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
      *          "city": "(omitted, but key is shown for documentation reasons)",
      *          "country": "United States",
      *          "radius": 1000,
+     *          "endpoints": 1,
      *          "packets": 1,
      *          "bytes": 1543
      *        }
@@ -130,8 +151,9 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
     json_dumper_set_member_name(&dumper, "features");
     json_dumper_begin_array(&dumper);
 
-    /* Append map data. */
-    size_t count = 0;
+    /* Aggregate the endpoints by coordinate pair. */
+    GHashTable *points = g_hash_table_new_full(g_str_hash, g_str_equal,
+            g_free, g_free);
     const hostlist_talker_t *host;
     for (hostlist_talker_t *const *iter = hosts; (host = *iter) != NULL; ++iter) {
         char addr[WS_INET6_ADDRSTRLEN];
@@ -151,7 +173,38 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
             continue;
         }
 
-        ++count;
+        char *key = g_strdup_printf("%f,%f", result->longitude, result->latitude);
+        map_point_t *point = (map_point_t *)g_hash_table_lookup(points, key);
+        if (!point) {
+            point = g_new0(map_point_t, 1);
+            point->longitude = result->longitude;
+            point->latitude = result->latitude;
+            point->result = result;
+            g_strlcpy(point->first_addr, addr, sizeof(point->first_addr));
+            g_hash_table_insert(points, key, point);
+        } else {
+            g_free(key);
+            if (point->result->as_number != result->as_number) {
+                point->as_mixed = TRUE;
+            }
+        }
+        if (result->accuracy > point->accuracy) {
+            point->accuracy = result->accuracy;
+        }
+        point->packets += host->rx_frames + host->tx_frames;
+        point->bytes += host->rx_bytes + host->tx_bytes;
+        point->num_endpoints++;
+    }
+
+    /* Append map data. */
+    size_t count = g_hash_table_size(points);
+    GHashTableIter point_iter;
+    gpointer point_value;
+    g_hash_table_iter_init(&point_iter, points);
+    while (g_hash_table_iter_next(&point_iter, NULL, &point_value)) {
+        const map_point_t *point = (const map_point_t *)point_value;
+        const mmdb_lookup_t *result = point->result;
+
         json_dumper_begin_object(&dumper);
 
         json_dumper_set_member_name(&dumper, "type");
@@ -164,8 +217,8 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
             json_dumper_value_string(&dumper, "Point");
             json_dumper_set_member_name(&dumper, "coordinates");
             json_dumper_begin_array(&dumper);
-            json_dumper_value_double(&dumper, result->longitude);
-            json_dumper_value_double(&dumper, result->latitude);
+            json_dumper_value_double(&dumper, point->longitude);
+            json_dumper_value_double(&dumper, point->latitude);
             json_dumper_end_array(&dumper);     // end coordinates
         }
         json_dumper_end_object(&dumper);    // end geometry
@@ -174,8 +227,17 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
         json_dumper_begin_object(&dumper);
         {
             json_dumper_set_member_name(&dumper, "ip");
-            json_dumper_value_string(&dumper, addr);
-            if (result->as_number && result->as_org) {
+            if (point->num_endpoints > 1) {
+                char *ip_str = g_strdup_printf("%s and %u more",
+                        point->first_addr, point->num_endpoints - 1);
+                json_dumper_value_string(&dumper, ip_str);
+                g_free(ip_str);
+            } else {
+                json_dumper_value_string(&dumper, point->first_addr);
+            }
+            /* The AS fields only make sense if every endpoint at this
+             * point belongs to the same AS. */
+            if (!point->as_mixed && result->as_number && result->as_org) {
                 json_dumper_set_member_name(&dumper, "autonomous_system_number");
                 json_dumper_value_anyf(&dumper, "%u", result->as_number);
                 json_dumper_set_member_name(&dumper, "autonomous_system_organization");
@@ -189,19 +251,22 @@ write_endpoint_geoip_map(FILE *fp, gboolean json_only, hostlist_talker_t *const
                 json_dumper_set_member_name(&dumper, "country");
                 json_dumper_value_string(&dumper, result->country);
             }
-            if (result->accuracy) {
+            if (point->accuracy) {
                 json_dumper_set_member_name(&dumper, "radius");
-                json_dumper_value_anyf(&dumper, "%u", result->accuracy);
+                json_dumper_value_anyf(&dumper, "%u", point->accuracy);
             }
+            json_dumper_set_member_name(&dumper, "endpoints");
+            json_dumper_value_anyf(&dumper, "%u", point->num_endpoints);
             json_dumper_set_member_name(&dumper, "packets");
-            json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, host->rx_frames + host->tx_frames);
+            json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, point->packets);
             json_dumper_set_member_name(&dumper, "bytes");
-            json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, host->rx_bytes + host->tx_bytes);
+            json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, point->bytes);
         }
         json_dumper_end_object(&dumper);    // end properties
 
         json_dumper_end_object(&dumper);
     }
+    g_hash_table_destroy(points);
 
     json_dumper_end_array(&dumper);     // end features
     json_dumper_end_object(&dumper);
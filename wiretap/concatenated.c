@@ -0,0 +1,323 @@
+/* concatenated.c
+ * Present an ordered set of capture files as one virtual capture
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+#include "concatenated.h"
+
+#include <string.h>
+
+#include "wtap-int.h"
+#include "wtap_opttypes.h"
+
+/*
+ * Record offsets handed out by this provider encode the index of the
+ * member file in the upper bits and the offset within that member in
+ * the lower bits, so wtap_seek_read() can dispatch to the right member
+ * without any per-record lookup structure.  48 bits of in-member offset
+ * allows members of up to 256 TiB, far beyond any single ring buffer
+ * file; the index must keep the gint64 offset non-negative, which
+ * leaves 15 bits for it.
+ */
+#define CONCAT_OFFSET_BITS  48
+#define CONCAT_OFFSET_MASK  ((G_GINT64_CONSTANT(1) << CONCAT_OFFSET_BITS) - 1)
+#define CONCAT_MAX_FILES    (1U << (63 - CONCAT_OFFSET_BITS))
+
+typedef struct {
+    wtap    *wth;               /* the open member file */
+    GArray  *idb_index_map;     /* member IDB index -> parent IDB index */
+} concat_in_file_t;
+
+typedef struct {
+    concat_in_file_t *files;
+    guint             n_files;
+    guint             cur;      /* member the sequential side is reading */
+} concat_t;
+
+/* Deep-copy any member IDBs we haven't seen yet into the parent's
+ * interface table and extend the member's index map accordingly.
+ * pcapng files may introduce interfaces anywhere in the stream, so this
+ * is called both at open time and whenever a record references an
+ * interface index beyond the ones mapped so far. */
+static void
+concat_adopt_new_idbs(wtap *wth, concat_in_file_t *in)
+{
+    guint i;
+
+    for (i = in->idb_index_map->len; i < in->wth->interface_data->len; i++) {
+        wtap_block_t src, idb;
+        wtapng_if_descr_mandatory_t *idb_mand;
+        guint parent_index;
+
+        src = g_array_index(in->wth->interface_data, wtap_block_t, i);
+        idb = wtap_block_create(WTAP_BLOCK_IF_DESCR);
+        wtap_block_copy(idb, src);
+        idb_mand = (wtapng_if_descr_mandatory_t*)wtap_block_get_mandatory_data(idb);
+
+        /* Don't copy stat information; it describes the member file,
+         * not the set. */
+        idb_mand->num_stat_entries      = 0;
+        idb_mand->interface_statistics  = NULL;
+
+        g_array_append_val(wth->interface_data, idb);
+        parent_index = wth->interface_data->len - 1;
+        g_array_append_val(in->idb_index_map, parent_index);
+    }
+}
+
+/* Rewrite a record's interface index from the member's interface table
+ * to the parent's. */
+static gboolean
+concat_map_interface_id(wtap *wth, concat_in_file_t *in, wtap_rec *rec,
+                        int *err, gchar **err_info)
+{
+    guint32 member_id;
+
+    if (rec->rec_type != REC_TYPE_PACKET ||
+        !(rec->presence_flags & WTAP_HAS_INTERFACE_ID))
+        return TRUE;
+
+    member_id = rec->rec_header.packet_header.interface_id;
+    if (member_id >= in->idb_index_map->len) {
+        /* the member may have picked up new IDBs since we last looked */
+        concat_adopt_new_idbs(wth, in);
+        if (member_id >= in->idb_index_map->len) {
+            *err = WTAP_ERR_BAD_FILE;
+            *err_info = g_strdup_printf("concatenated: interface index %u not defined in member file",
+                                        member_id);
+            return FALSE;
+        }
+    }
+    rec->rec_header.packet_header.interface_id =
+        g_array_index(in->idb_index_map, guint, member_id);
+    return TRUE;
+}
+
+static gboolean
+concat_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err, gchar **err_info,
+            gint64 *data_offset)
+{
+    concat_t *concat = (concat_t *)wth->priv;
+    concat_in_file_t *in;
+    gint64 in_offset;
+
+    while (concat->cur < concat->n_files) {
+        in = &concat->files[concat->cur];
+
+        /* Addresses and decryption secrets found in the member must
+         * reach whoever is listening on the virtual capture. */
+        in->wth->add_new_ipv4 = wth->add_new_ipv4;
+        in->wth->add_new_ipv6 = wth->add_new_ipv6;
+        in->wth->add_new_secrets = wth->add_new_secrets;
+
+        if (wtap_read(in->wth, rec, buf, err, err_info, &in_offset)) {
+            if (!concat_map_interface_id(wth, in, rec, err, err_info))
+                return FALSE;
+            if (in_offset > CONCAT_OFFSET_MASK) {
+                *err = WTAP_ERR_BAD_FILE;
+                *err_info = g_strdup_printf("concatenated: member file offset %" G_GINT64_MODIFIER "d too large",
+                                            in_offset);
+                return FALSE;
+            }
+            *data_offset = ((gint64)concat->cur << CONCAT_OFFSET_BITS) | in_offset;
+            return TRUE;
+        }
+        if (*err != 0)
+            return FALSE;       /* a real error, not the member's EOF */
+
+        /* End of this member; go on with the next one.  Keep wth->fh
+         * pointing at the member being read, for the benefit of the
+         * generic code that reports errors and progress against it. */
+        concat->cur++;
+        if (concat->cur < concat->n_files)
+            wth->fh = concat->files[concat->cur].wth->fh;
+    }
+
+    /* *err is 0: EOF of the last member is EOF of the set */
+    return FALSE;
+}
+
+static gboolean
+concat_seek_read(wtap *wth, gint64 seek_off, wtap_rec *rec, Buffer *buf,
+                 int *err, gchar **err_info)
+{
+    concat_t *concat = (concat_t *)wth->priv;
+    concat_in_file_t *in;
+    guint file_num = (guint)(seek_off >> CONCAT_OFFSET_BITS);
+
+    if (file_num >= concat->n_files) {
+        *err = WTAP_ERR_INTERNAL;
+        *err_info = g_strdup_printf("concatenated: offset refers to member %u of %u",
+                                    file_num, concat->n_files);
+        return FALSE;
+    }
+    in = &concat->files[file_num];
+    if (!wtap_seek_read(in->wth, seek_off & CONCAT_OFFSET_MASK, rec, buf,
+                        err, err_info))
+        return FALSE;
+    return concat_map_interface_id(wth, in, rec, err, err_info);
+}
+
+static void
+concat_sequential_close(wtap *wth)
+{
+    concat_t *concat = (concat_t *)wth->priv;
+    guint i;
+
+    for (i = 0; i < concat->n_files; i++) {
+        if (concat->files[i].wth != NULL)
+            wtap_sequential_close(concat->files[i].wth);
+    }
+
+    /* wth->fh aliases the current member's sequential side, which the
+     * loop above just closed; don't let the generic code close it again. */
+    wth->fh = NULL;
+}
+
+static void
+concat_close(wtap *wth)
+{
+    concat_t *concat = (concat_t *)wth->priv;
+    guint i;
+
+    for (i = 0; i < concat->n_files; i++) {
+        if (concat->files[i].wth != NULL)
+            wtap_close(concat->files[i].wth);
+        if (concat->files[i].idb_index_map != NULL)
+            g_array_free(concat->files[i].idb_index_map, TRUE);
+    }
+    g_free(concat->files);
+    /* concat itself is wth->priv and is freed by wtap_close() */
+}
+
+wtap *
+wtap_concat_open_offline(const char *const *filenames, guint n_files,
+                         int *err, gchar **err_info, gboolean do_random)
+{
+    wtap *wth;
+    concat_t *concat;
+    guint i;
+    int file_encap;
+
+    if (n_files == 0 || n_files > CONCAT_MAX_FILES) {
+        *err = WTAP_ERR_INTERNAL;
+        *err_info = g_strdup_printf("concatenated: %u files (supported: 1 to %u)",
+                                    n_files, CONCAT_MAX_FILES);
+        return NULL;
+    }
+
+    wth = (wtap *)g_malloc0(sizeof(wtap));
+    concat = g_new0(concat_t, 1);
+    concat->files = g_new0(concat_in_file_t, n_files);
+    concat->n_files = n_files;
+    wth->priv = concat;
+
+    for (i = 0; i < n_files; i++) {
+        concat->files[i].wth = wtap_open_offline(filenames[i], WTAP_TYPE_AUTO,
+                                                 err, err_info, do_random);
+        if (concat->files[i].wth == NULL) {
+            /* Close the members we've already opened. */
+            concat_close(wth);
+            g_free(concat);
+            g_free(wth);
+            return NULL;
+        }
+        concat->files[i].idb_index_map = g_array_new(FALSE, FALSE,
+                                                     sizeof(guint));
+    }
+
+    /* The front-end fields mostly follow the first member, with the
+     * usual "all the same or per-packet" rule for the encapsulation. */
+    wth->fh = concat->files[0].wth->fh;
+    wth->random_fh = NULL;      /* members keep their own random side */
+    wth->ispipe = FALSE;
+    wth->file_type_subtype = wtap_file_type_subtype(concat->files[0].wth);
+    wth->subtype_read = concat_read;
+    wth->subtype_seek_read = concat_seek_read;
+    wth->subtype_sequential_close = concat_sequential_close;
+    wth->subtype_close = concat_close;
+
+    file_encap = wtap_file_encap(concat->files[0].wth);
+    wth->snapshot_length = wtap_snapshot_length(concat->files[0].wth);
+    wth->file_tsprec = wtap_file_tsprec(concat->files[0].wth);
+    for (i = 1; i < n_files; i++) {
+        guint snaplen = wtap_snapshot_length(concat->files[i].wth);
+
+        if (wtap_file_encap(concat->files[i].wth) != file_encap)
+            file_encap = WTAP_ENCAP_PER_PACKET;
+        /* an unknown (0) snapshot length in any member makes it
+         * unknown for the whole set; otherwise take the largest */
+        if (snaplen == 0)
+            wth->snapshot_length = 0;
+        else if (wth->snapshot_length != 0 &&
+                 snaplen > wth->snapshot_length)
+            wth->snapshot_length = snaplen;
+        if (wtap_file_tsprec(concat->files[i].wth) > wth->file_tsprec)
+            wth->file_tsprec = wtap_file_tsprec(concat->files[i].wth);
+    }
+    wth->file_encap = file_encap;
+
+    /* The parent owns deep copies of the members' section headers and
+     * interface descriptions, so each side frees its own blocks. */
+    wth->shb_hdrs = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
+    wth->interface_data = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
+    for (i = 0; i < n_files; i++) {
+        GArray *shbs = wtap_file_get_shb_for_new_file(concat->files[i].wth);
+
+        if (shbs != NULL) {
+            g_array_append_vals(wth->shb_hdrs, shbs->data, shbs->len);
+            g_array_free(shbs, TRUE);
+        }
+        concat_adopt_new_idbs(wth, &concat->files[i]);
+    }
+
+    /* Likewise for any name resolution and decryption secrets blocks
+     * the members have seen so far; ones that show up later in a
+     * member's stream are delivered through the callbacks mirrored in
+     * concat_read(). */
+    for (i = 0; i < n_files; i++) {
+        GArray *member_dsbs = concat->files[i].wth->dsbs;
+        GArray *nrbs = wtap_file_get_nrb_for_new_file(concat->files[i].wth);
+        guint j;
+
+        if (nrbs != NULL) {
+            if (wth->nrb_hdrs == NULL)
+                wth->nrb_hdrs = g_array_new(FALSE, FALSE,
+                                            sizeof(wtap_block_t));
+            g_array_append_vals(wth->nrb_hdrs, nrbs->data, nrbs->len);
+            g_array_free(nrbs, TRUE);
+        }
+        if (member_dsbs != NULL) {
+            if (wth->dsbs == NULL)
+                wth->dsbs = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
+            for (j = 0; j < member_dsbs->len; j++) {
+                wtap_block_t dsb = wtap_block_create(WTAP_BLOCK_DSB);
+
+                wtap_block_copy(dsb, g_array_index(member_dsbs,
+                                                   wtap_block_t, j));
+                g_array_append_val(wth->dsbs, dsb);
+            }
+        }
+    }
+
+    return wth;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
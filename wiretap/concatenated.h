@@ -0,0 +1,63 @@
+/* concatenated.h
+ * Present an ordered set of capture files as one virtual capture
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __CONCATENATED_H__
+#define __CONCATENATED_H__
+
+#include <glib.h>
+#include "wtap.h"
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Open an ordered list of capture files as one virtual, seekable capture.
+ *
+ * No packet data is copied; records are delivered in list order, with
+ * the record offsets encoding which member file they came from, so
+ * wtap_seek_read() works across the whole set.  Interface description
+ * blocks from all members are collected into one table and the records'
+ * interface indexes are remapped accordingly.  This lets a ring buffer
+ * file set be analyzed in place, without first merging it into a single
+ * file.
+ *
+ * @param filenames the member files, in the order they are to appear
+ * @param n_files number of entries in filenames; must be at least 1
+ * @param err a positive "errno" value, or a negative number indicating
+ * the type of error, if the open failed
+ * @param err_info for some errors, a string giving more details of the
+ * error
+ * @param do_random TRUE if random access to the members is needed
+ * @return a wtap handle on success, NULL on failure
+ */
+WS_DLL_PUBLIC
+wtap *wtap_concat_open_offline(const char *const *filenames, guint n_files,
+                               int *err, gchar **err_info, gboolean do_random);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CONCATENATED_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
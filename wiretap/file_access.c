@@ -346,6 +346,13 @@ wtap_get_all_capture_file_extensions_list(void)
  *
  * If your file format has an expected extension (e.g., ".pcap") then you
  * should probably also add it to file_type_extensions_base[] (in this file).
+ *
+ * The magic-number open routines are tried in the order they appear
+ * here, and each one reads only a few bytes, served from the file
+ * wrapper's buffer after the first read.  Keep pcap and pcapng at the
+ * top: they are the overwhelmingly common case, and their position is
+ * what makes opening such a file cost one or two buffered probes rather
+ * than a walk of this whole list.
  */
 static const struct open_info open_info_base[] = {
 	{ "Wireshark/tcpdump/... - pcap",           OPEN_INFO_MAGIC,     libpcap_open,             "pcap",     NULL, NULL },
@@ -888,6 +895,11 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 
 		file_set_random_access(wth->fh, FALSE, wth->fast_seek);
 		file_set_random_access(wth->random_fh, TRUE, wth->fast_seek);
+
+		/* The sequential side benefits from readahead if the file
+		   turns out to be compressed; the random-access side seeks
+		   too much for it to help. */
+		file_set_readahead(wth->fh, TRUE);
 	}
 
 	/* 'type' is 1 greater than the array index */
@@ -2750,6 +2762,38 @@ gboolean wtap_dump_get_needs_reload(wtap_dumper *wdh) {
         return wdh->needs_reload;
 }
 
+/*
+ * Stdio buffer size for dump files.  The per-format write routines issue
+ * several small writes per block or record (header, options, payload,
+ * trailer); fwrite coalesces those in the stdio buffer, so the buffer
+ * size is what decides how large the writes handed to the kernel are.
+ * The platform default is typically a few KB; a larger buffer keeps the
+ * syscall count low enough to sustain throughput on fast storage.
+ */
+#define WTAP_DUMP_BUF_SIZE (256 * 1024)
+
+static FILE *
+wtap_dump_file_fopen(const char *filename)
+{
+	FILE *fh;
+
+	fh = ws_fopen(filename, "wb");
+	if (fh != NULL)
+		setvbuf(fh, NULL, _IOFBF, WTAP_DUMP_BUF_SIZE);
+	return fh;
+}
+
+static FILE *
+wtap_dump_file_plain_fdopen(int fd)
+{
+	FILE *fh;
+
+	fh = ws_fdopen(fd, "wb");
+	if (fh != NULL)
+		setvbuf(fh, NULL, _IOFBF, WTAP_DUMP_BUF_SIZE);
+	return fh;
+}
+
 /* internally open a file for writing (compressed or not) */
 #ifdef HAVE_ZLIB
 static WFILE_T
@@ -2758,14 +2802,14 @@ wtap_dump_file_open(wtap_dumper *wdh, const char *filename)
 	if (wdh->compression_type == WTAP_GZIP_COMPRESSED) {
 		return gzwfile_open(filename);
 	} else {
-		return ws_fopen(filename, "wb");
+		return wtap_dump_file_fopen(filename);
 	}
 }
 #else
 static WFILE_T
 wtap_dump_file_open(wtap_dumper *wdh _U_, const char *filename)
 {
-	return ws_fopen(filename, "wb");
+	return wtap_dump_file_fopen(filename);
 }
 #endif
 
@@ -2777,14 +2821,14 @@ wtap_dump_file_fdopen(wtap_dumper *wdh, int fd)
 	if (wdh->compression_type == WTAP_GZIP_COMPRESSED) {
 		return gzwfile_fdopen(fd);
 	} else {
-		return ws_fdopen(fd, "wb");
+		return wtap_dump_file_plain_fdopen(fd);
 	}
 }
 #else
 static WFILE_T
 wtap_dump_file_fdopen(wtap_dumper *wdh _U_, int fd)
 {
-	return ws_fdopen(fd, "wb");
+	return wtap_dump_file_plain_fdopen(fd);
 }
 #endif
 
@@ -22,6 +22,18 @@
 #include "file_wrappers.h"
 #include <wsutil/file_util.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#ifdef HAVE_PREAD
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_POSIX_FADVISE
+#include <fcntl.h>
+#endif
+
 #ifdef HAVE_ZLIB
 #define ZLIB_CONST
 #include <zlib.h>
@@ -104,6 +116,10 @@ wtap_get_all_compression_type_extensions_list(void)
 
 /* #define GZBUFSIZE 8192 */
 #define GZBUFSIZE 4096
+/* Write-side buffer size. Larger than the read-side buffer so compressed
+   output reaches the file in big chunks instead of one small write() per
+   few KB of compressed data. */
+#define GZWBUFSIZE 65536
 
 /* values for wtap_reader compression */
 typedef enum {
@@ -121,6 +137,39 @@ struct wtap_reader_buf {
     guint avail;  /* number of bytes available to deliver at next */
 };
 
+#ifdef HAVE_PREAD
+/*
+ * Readahead pipeline for compressed files: a worker thread keeps a
+ * small ring of input buffers filled ahead of the decompressor, so
+ * the thread doing the inflating never stalls on file I/O.  The
+ * worker reads with pread() at explicit offsets, so it never touches
+ * the file descriptor's seek position; a seek by the consumer just
+ * flushes the ring and restarts the worker at the new offset.
+ */
+#define READAHEAD_BUFS 4
+
+struct readahead {
+    GThread *thread;
+    GMutex lock;                /* protects all of the fields below */
+    GCond fill_cond;            /* signalled when a buffer is consumed */
+    GCond data_cond;            /* signalled when a buffer is produced */
+    struct {
+        gint64 offset;          /* file offset this buffer starts at */
+        guint len;              /* number of bytes in the buffer */
+        guint8 *data;
+    } bufs[READAHEAD_BUFS];
+    guint head;                 /* oldest filled buffer */
+    guint count;                /* number of filled buffers */
+    guint head_used;            /* bytes already consumed from the head */
+    gint64 next_offset;         /* where the worker reads next */
+    guint bufsize;
+    gboolean stop;              /* tell the worker to exit */
+    gboolean at_eof;            /* worker has seen end-of-file */
+    int err;                    /* errno from a failed read, or 0 */
+    int fd;
+};
+#endif /* HAVE_PREAD */
+
 struct wtap_reader {
     int fd;                     /* file descriptor */
     gint64 raw_pos;             /* current position in file (just to not call lseek()) */
@@ -152,6 +201,19 @@ struct wtap_reader {
     /* fast seeking */
     GPtrArray *fast_seek;
     void *fast_seek_cur;
+
+#ifdef HAVE_MMAP
+    /* read-only mapping of the entire file, or NULL if we couldn't
+       (or shouldn't) map it; used to serve uncompressed data without
+       copying it through the output buffer */
+    guint8 *map;
+    gint64 map_len;             /* size of the mapping */
+#endif
+
+#ifdef HAVE_PREAD
+    gboolean readahead_wanted;  /* start a readahead thread if compressed */
+    struct readahead *ra;       /* readahead state, or NULL */
+#endif
 };
 
 /* Current read offset within a buffer. */
@@ -190,6 +252,156 @@ buf_reset(struct wtap_reader_buf *buf)
     buf->avail = 0;
 }
 
+#ifdef HAVE_PREAD
+static gpointer
+readahead_thread(gpointer data)
+{
+    struct readahead *ra = (struct readahead *)data;
+    guint slot;
+    gint64 offset;
+    ssize_t ret;
+
+    g_mutex_lock(&ra->lock);
+    for (;;) {
+        while (!ra->stop &&
+               (ra->count == READAHEAD_BUFS || ra->at_eof || ra->err != 0))
+            g_cond_wait(&ra->fill_cond, &ra->lock);
+        if (ra->stop)
+            break;
+        slot = (ra->head + ra->count) % READAHEAD_BUFS;
+        offset = ra->next_offset;
+        g_mutex_unlock(&ra->lock);
+        ret = pread(ra->fd, ra->bufs[slot].data, ra->bufsize, offset);
+        g_mutex_lock(&ra->lock);
+        /*
+         * If a seek flushed the ring while we were reading, this
+         * buffer is for the wrong offset; just drop it and loop
+         * around to read at the new offset.
+         */
+        if (!ra->stop && offset == ra->next_offset) {
+            if (ret < 0)
+                ra->err = errno;
+            else if (ret == 0)
+                ra->at_eof = TRUE;
+            else {
+                ra->bufs[slot].offset = offset;
+                ra->bufs[slot].len = (guint)ret;
+                ra->count++;
+                ra->next_offset = offset + ret;
+            }
+            g_cond_signal(&ra->data_cond);
+        }
+    }
+    g_mutex_unlock(&ra->lock);
+    return NULL;
+}
+
+static void
+readahead_start(FILE_T state)
+{
+    struct readahead *ra;
+    guint i;
+
+    ra = g_new0(struct readahead, 1);
+    g_mutex_init(&ra->lock);
+    g_cond_init(&ra->fill_cond);
+    g_cond_init(&ra->data_cond);
+    ra->bufsize = state->size;
+    for (i = 0; i < READAHEAD_BUFS; i++)
+        ra->bufs[i].data = (guint8 *)g_malloc(ra->bufsize);
+    ra->fd = state->fd;
+    /* raw_pos is where the next read from the file would happen. */
+    ra->next_offset = state->raw_pos;
+    ra->thread = g_thread_new("wtap_readahead", readahead_thread, ra);
+    state->ra = ra;
+}
+
+static void
+readahead_stop(FILE_T state)
+{
+    struct readahead *ra = state->ra;
+    guint i;
+
+    if (ra == NULL)
+        return;
+    g_mutex_lock(&ra->lock);
+    ra->stop = TRUE;
+    g_cond_signal(&ra->fill_cond);
+    g_mutex_unlock(&ra->lock);
+    g_thread_join(ra->thread);
+    for (i = 0; i < READAHEAD_BUFS; i++)
+        g_free(ra->bufs[i].data);
+    g_mutex_clear(&ra->lock);
+    g_cond_clear(&ra->fill_cond);
+    g_cond_clear(&ra->data_cond);
+    g_free(ra);
+    state->ra = NULL;
+}
+
+/*
+ * Satisfy a read at the given file offset from the readahead ring,
+ * blocking until the worker has produced data if necessary.  Returns
+ * the number of bytes delivered - possibly fewer than requested, as
+ * with read() - 0 at end-of-file, or -1 with *err set to an errno
+ * value.
+ */
+static ssize_t
+readahead_read(struct readahead *ra, void *buf, guint len, gint64 offset,
+               int *err)
+{
+    gboolean in_sequence;
+    ssize_t ret;
+
+    g_mutex_lock(&ra->lock);
+    /*
+     * Is the request where the pipeline expects the next read?  If
+     * not, the consumer has seeked; flush the ring and restart the
+     * worker at the new offset.
+     */
+    if (ra->count != 0)
+        in_sequence =
+            (ra->bufs[ra->head].offset + (gint64)ra->head_used == offset);
+    else
+        in_sequence = (ra->next_offset == offset);
+    if (!in_sequence) {
+        ra->count = 0;
+        ra->head_used = 0;
+        ra->at_eof = FALSE;
+        ra->err = 0;
+        ra->next_offset = offset;
+        g_cond_signal(&ra->fill_cond);
+    }
+
+    while (ra->count == 0 && !ra->at_eof && ra->err == 0)
+        g_cond_wait(&ra->data_cond, &ra->lock);
+
+    if (ra->count == 0) {
+        if (ra->err != 0) {
+            *err = ra->err;
+            ra->err = 0;
+            ret = -1;
+        } else
+            ret = 0;            /* end of file */
+    } else {
+        guint n = ra->bufs[ra->head].len - ra->head_used;
+
+        if (n > len)
+            n = len;
+        memcpy(buf, ra->bufs[ra->head].data + ra->head_used, n);
+        ra->head_used += n;
+        if (ra->head_used == ra->bufs[ra->head].len) {
+            ra->head = (ra->head + 1) % READAHEAD_BUFS;
+            ra->head_used = 0;
+            ra->count--;
+            g_cond_signal(&ra->fill_cond);
+        }
+        ret = n;
+    }
+    g_mutex_unlock(&ra->lock);
+    return ret;
+}
+#endif /* HAVE_PREAD */
+
 static int
 buf_read(FILE_T state, struct wtap_reader_buf *buf)
 {
@@ -215,11 +427,23 @@ buf_read(FILE_T state, struct wtap_reader_buf *buf)
         to_read = space_left;
     }
 
-    ret = ws_read(state->fd, read_ptr, to_read);
-    if (ret < 0) {
-        state->err = errno;
-        state->err_info = NULL;
-        return -1;
+#ifdef HAVE_PREAD
+    if (state->ra != NULL) {
+        ret = readahead_read(state->ra, read_ptr, to_read, state->raw_pos,
+                             &state->err);
+        if (ret < 0) {
+            state->err_info = NULL;
+            return -1;
+        }
+    } else
+#endif
+    {
+        ret = ws_read(state->fd, read_ptr, to_read);
+        if (ret < 0) {
+            state->err = errno;
+            state->err_info = NULL;
+            return -1;
+        }
     }
     if (ret == 0)
         state->eof = TRUE;
@@ -767,6 +991,13 @@ gz_head(FILE_T state)
                 state->strm.adler = crc32(0L, Z_NULL, 0);
                 state->compression = ZLIB;
                 state->is_compressed = TRUE;
+#ifdef HAVE_PREAD
+                /* The file is compressed, so feed the decompressor
+                   from a readahead thread, overlapping the file I/O
+                   with the decompression. */
+                if (state->readahead_wanted && state->ra == NULL)
+                    readahead_start(state);
+#endif
 #ifdef Z_BLOCK
                 if (state->fast_seek) {
                     struct zlib_cur_seek_point *cur = g_new(struct zlib_cur_seek_point,1);
@@ -817,6 +1048,19 @@ gz_head(FILE_T state)
        the input buffer, which also assures space for gzungetc() */
     state->raw = state->pos;
     state->out.next = state->out.buf;
+#ifdef HAVE_MMAP
+    if (state->map != NULL) {
+        /* not a compressed file, and we have the whole file mapped;
+           discard what we've read into the input buffer while sniffing
+           the header - fill_out_buffer() will deliver the data directly
+           from the mapping, including any end-of-input we may have seen
+           while sniffing. */
+        buf_reset(&state->in);
+        state->eof = FALSE;
+        state->compression = UNCOMPRESSED;
+        return 0;
+    }
+#endif
     /* not a compressed file -- copy everything we've read into the
        input buffer to the output buffer and fall to raw i/o */
     already_read = bytes_in_buffer(&state->in);
@@ -841,6 +1085,27 @@ fill_out_buffer(FILE_T state)
             return 0;
     }
     if (state->compression == UNCOMPRESSED) {           /* straight copy */
+#ifdef HAVE_MMAP
+        if (state->map != NULL) {
+            /* The uncompressed data *is* the file, so the byte at
+               uncompressed position state->pos is at file offset
+               state->start + state->pos; point the output buffer
+               into the mapping rather than copying the data out of
+               the file.  Chunks are the same size a buffered read
+               would produce, which keeps the avail arithmetic in
+               the callers comfortably within a guint. */
+            gint64 map_off = state->start + state->pos + state->out.avail;
+
+            if (map_off >= state->map_len)
+                state->eof = TRUE;
+            else if (state->out.avail == 0) {
+                state->out.next = state->map + map_off;
+                state->out.avail = (guint)MIN(state->map_len - map_off,
+                    (gint64)(state->size << 1));
+            }
+            return 0;
+        }
+#endif
         if (buf_read(state, &state->out) < 0)
             return -1;
     }
@@ -969,6 +1234,18 @@ file_fdopen(int fd)
     }
 #endif
 
+#ifdef HAVE_POSIX_FADVISE
+    /*
+     * Capture files are overwhelmingly read front to back; tell the
+     * kernel so it can read ahead more aggressively.  That keeps the
+     * next chunk in flight while we're dissecting the current one,
+     * which matters most when the file lives on a network filesystem
+     * and each read would otherwise wait out a server round-trip.
+     * Purely a hint - if it fails we just do without the readahead.
+     */
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
     /* allocate buffers */
     state->in.buf = (unsigned char *)g_try_malloc((gsize)want);
     state->in.next = state->in.buf;
@@ -1003,6 +1280,35 @@ file_fdopen(int fd)
     /* for now, assume we should check the crc */
     state->dont_check_crc = FALSE;
 #endif
+
+#ifdef HAVE_MMAP
+    /*
+     * If this is a regular file, try to map the whole thing; if the
+     * file turns out to be uncompressed, reads are then served
+     * directly from the mapping - see fill_out_buffer() - rather than
+     * being copied through the output buffer.  If we can't map it,
+     * we just fall back on read().
+     */
+    {
+        ws_statb64 map_st;
+
+        if (ws_fstat64(fd, &map_st) >= 0 && S_ISREG(map_st.st_mode) &&
+            map_st.st_size > 0 && (guint64)map_st.st_size <= (guint64)G_MAXSIZE) {
+            void *map = mmap(NULL, (size_t)map_st.st_size, PROT_READ,
+                MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                state->map = (guint8 *)map;
+                state->map_len = map_st.st_size;
+#ifdef MADV_SEQUENTIAL
+                /* Same readahead hint as the fadvise above, but for
+                   faults on the mapping rather than explicit reads. */
+                (void)madvise(map, (size_t)map_st.st_size, MADV_SEQUENTIAL);
+#endif
+            }
+        }
+    }
+#endif
+
     /* return stream */
     return state;
 }
@@ -1065,6 +1371,22 @@ file_set_random_access(FILE_T stream, gboolean random_flag _U_, GPtrArray *seek)
     stream->fast_seek = seek;
 }
 
+/*
+ * Say whether this stream should read ahead of the decompressor on a
+ * worker thread if the file turns out to be compressed.  Only useful
+ * for streams that are read sequentially; a stream that seeks a lot
+ * would just keep flushing the readahead ring.
+ */
+void
+file_set_readahead(FILE_T stream _U_, gboolean readahead _U_)
+{
+#ifdef HAVE_PREAD
+    stream->readahead_wanted = readahead;
+    if (!readahead)
+        readahead_stop(stream);
+#endif
+}
+
 gint64
 file_seek(FILE_T file, gint64 offset, int whence, int *err)
 {
@@ -1115,6 +1437,31 @@ file_seek(FILE_T file, gint64 offset, int whence, int *err)
         return file->pos;
     }
 
+#ifdef HAVE_MMAP
+    /*
+     * Is this an uncompressed file that we have mapped?  If so, a
+     * seek anywhere within the raw data is pure bookkeeping - we
+     * just empty the output buffer and let the next read pick the
+     * data up directly from the mapping.  Note that, unlike the
+     * fast-seek case below, this doesn't require random access to
+     * have been enabled, as no lseek is involved.
+     */
+    if (file->map != NULL && file->compression == UNCOMPRESSED) {
+        if (file->pos + offset < file->raw) {
+            /* before the start of the data! */
+            *err = EINVAL;
+            return -1;
+        }
+        buf_reset(&file->out);
+        file->eof = FALSE;
+        file->seek_pending = FALSE;
+        file->err = 0;
+        file->err_info = NULL;
+        file->pos += offset;
+        return file->pos;
+    }
+#endif
+
     /*
      * Are we seeking backwards?
      */
@@ -1624,6 +1971,9 @@ file_clearerr(FILE_T stream)
 void
 file_fdclose(FILE_T file)
 {
+#ifdef HAVE_PREAD
+    readahead_stop(file);
+#endif
     ws_close(file->fd);
     file->fd = -1;
 }
@@ -1644,6 +1994,10 @@ file_close(FILE_T file)
 {
     int fd = file->fd;
 
+#ifdef HAVE_PREAD
+    readahead_stop(file);
+#endif
+
     /* free memory and close file */
     if (file->size) {
 #ifdef HAVE_ZLIB
@@ -1652,6 +2006,10 @@ file_close(FILE_T file)
         g_free(file->out.buf);
         g_free(file->in.buf);
     }
+#ifdef HAVE_MMAP
+    if (file->map != NULL)
+        munmap(file->map, (size_t)file->map_len);
+#endif
     g_free(file->fast_seek_cur);
     file->err = 0;
     file->err_info = NULL;
@@ -1671,7 +2029,7 @@ struct wtap_writer {
     int fd;                 /* file descriptor */
     gint64 pos;             /* current position in uncompressed data */
     guint size;          /* buffer size, zero if not allocated yet */
-    guint want;          /* requested buffer size, default is GZBUFSIZE */
+    guint want;          /* requested buffer size, default is GZWBUFSIZE */
     unsigned char *in;      /* input buffer */
     unsigned char *out;     /* output buffer (double-sized when reading) */
     unsigned char *next;    /* next output data to deliver or write */
@@ -1712,7 +2070,7 @@ gzwfile_fdopen(int fd)
         return NULL;
     state->fd = fd;
     state->size = 0;            /* no buffers allocated yet */
-    state->want = GZBUFSIZE;    /* requested buffer size */
+    state->want = GZWBUFSIZE;   /* requested buffer size */
 
     state->level = Z_DEFAULT_COMPRESSION;
     state->strategy = Z_DEFAULT_STRATEGY;
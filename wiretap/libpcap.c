@@ -826,13 +826,22 @@ libpcap_read_packet(wtap *wth, FILE_T fh, wtap_rec *rec,
 	rec->rec_header.packet_header.len = orig_size;
 
 	/*
-	 * Read the packet data.
+	 * Read the packet data, unless this is a sequential read and the
+	 * caller told us it only wants the record headers, in which case
+	 * just seek past it.
 	 */
-	if (!wtap_read_packet_bytes(fh, buf, packet_size, err, err_info))
-		return FALSE;	/* failed */
+	if (wth->skip_record_data && fh == wth->fh) {
+		if (packet_size != 0 &&
+		    file_seek(fh, packet_size, SEEK_CUR, err) == -1)
+			return FALSE;	/* failed */
+	} else {
+		if (!wtap_read_packet_bytes(fh, buf, packet_size, err,
+		    err_info))
+			return FALSE;	/* failed */
 
-	pcap_read_post_process(wth->file_type_subtype, wth->file_encap,
-	    rec, ws_buffer_start_ptr(buf), libpcap->byte_swapped, -1);
+		pcap_read_post_process(wth->file_type_subtype, wth->file_encap,
+		    rec, ws_buffer_start_ptr(buf), libpcap->byte_swapped, -1);
+	}
 	return TRUE;
 }
 
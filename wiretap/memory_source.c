@@ -0,0 +1,117 @@
+/* memory_source.c
+ * Feed records into wiretap from caller-owned memory
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+#include "memory_source.h"
+
+#include "wtap-int.h"
+
+/*
+ * A memory source has no FILE_T at all: the generic code's uses of
+ * wth->fh are guarded against NULL, and everything record-shaped goes
+ * through the caller's callbacks.  The data offsets handed out are
+ * whatever the read callback put into *data_offset, passed back to
+ * seek_read verbatim, so the caller can use ring indexes, sequence
+ * numbers or real memory offsets as it pleases.
+ */
+typedef struct {
+    wtap_memory_callbacks_t cbs;
+    void *ctx;
+} memory_source_t;
+
+static gboolean
+memory_source_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
+                   gchar **err_info, gint64 *data_offset)
+{
+    memory_source_t *src = (memory_source_t *)wth->priv;
+
+    return src->cbs.read(src->ctx, rec, buf, data_offset, err, err_info);
+}
+
+static gboolean
+memory_source_seek_read(wtap *wth, gint64 seek_off, wtap_rec *rec,
+                        Buffer *buf, int *err, gchar **err_info)
+{
+    memory_source_t *src = (memory_source_t *)wth->priv;
+
+    if (src->cbs.seek_read == NULL) {
+        *err = WTAP_ERR_UNSUPPORTED;
+        *err_info = g_strdup("memory_source: the caller supplied no seek_read callback");
+        return FALSE;
+    }
+    return src->cbs.seek_read(src->ctx, seek_off, rec, buf, err, err_info);
+}
+
+static void
+memory_source_close(wtap *wth)
+{
+    memory_source_t *src = (memory_source_t *)wth->priv;
+
+    if (src->cbs.close != NULL)
+        src->cbs.close(src->ctx);
+    /* src itself is wth->priv and is freed by wtap_close() */
+}
+
+wtap *
+wtap_memory_open(const wtap_memory_callbacks_t *cbs, void *ctx,
+                 int file_encap, guint snaplen, int tsprec,
+                 int *err, gchar **err_info)
+{
+    wtap *wth;
+    memory_source_t *src;
+    wtap_block_t shb;
+
+    if (cbs == NULL || cbs->read == NULL) {
+        *err = WTAP_ERR_INTERNAL;
+        *err_info = g_strdup("memory_source: a read callback is required");
+        return NULL;
+    }
+
+    wth = (wtap *)g_malloc0(sizeof(wtap));
+    src = g_new0(memory_source_t, 1);
+    src->cbs = *cbs;
+    src->ctx = ctx;
+    wth->priv = src;
+
+    wth->fh = NULL;
+    wth->random_fh = NULL;
+    wth->ispipe = FALSE;
+    wth->file_type_subtype = WTAP_FILE_TYPE_SUBTYPE_UNKNOWN;
+    wth->snapshot_length = snaplen;
+    wth->file_encap = file_encap;
+    wth->file_tsprec = tsprec;
+    wth->subtype_read = memory_source_read;
+    wth->subtype_seek_read = memory_source_seek_read;
+    wth->subtype_sequential_close = NULL;
+    wth->subtype_close = memory_source_close;
+
+    /* Keep the usual metadata blocks around, so code that expects a
+     * section header and a (possibly empty) interface table doesn't
+     * have to special-case memory sources. */
+    wth->shb_hdrs = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
+    shb = wtap_block_create(WTAP_BLOCK_NG_SECTION);
+    g_array_append_val(wth->shb_hdrs, shb);
+    wth->interface_data = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
+
+    return wth;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
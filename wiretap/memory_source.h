@@ -0,0 +1,96 @@
+/* memory_source.h
+ * Feed records into wiretap from caller-owned memory
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __MEMORY_SOURCE_H__
+#define __MEMORY_SOURCE_H__
+
+#include <glib.h>
+#include "wtap.h"
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Callbacks through which a memory source produces records.
+ *
+ * The caller keeps ownership of whatever structure backs the records
+ * (a ring buffer, a message queue, ...); wiretap only sees the records
+ * the callbacks fill in.
+ */
+typedef struct wtap_memory_callbacks {
+    /**
+     * Produce the next record, filling in rec and buf the way a file
+     * reader's read routine would, and set *data_offset to a value of
+     * the caller's choosing that identifies the record (an index or
+     * cookie; it is handed back verbatim to seek_read).  Return TRUE
+     * on success.  At the end of the stream return FALSE with *err
+     * set to 0; on a hard error return FALSE with *err (and
+     * optionally *err_info) set.
+     */
+    gboolean (*read)(void *ctx, wtap_rec *rec, Buffer *buf,
+                     gint64 *data_offset, int *err, gchar **err_info);
+
+    /**
+     * Reproduce the record previously handed out under data_offset.
+     * May be NULL if the caller never re-reads records (sequential,
+     * one-shot processing); random access then fails with
+     * WTAP_ERR_UNSUPPORTED.
+     */
+    gboolean (*seek_read)(void *ctx, gint64 data_offset, wtap_rec *rec,
+                          Buffer *buf, int *err, gchar **err_info);
+
+    /** Called once when the wtap is closed.  May be NULL. */
+    void (*close)(void *ctx);
+} wtap_memory_callbacks_t;
+
+/**
+ * Open a wtap whose records come from the given callbacks instead of a
+ * file, so libwireshark can be fed packets straight from memory without
+ * a tempfile round-trip.  The returned handle supports wtap_read() and,
+ * if a seek_read callback is supplied, wtap_seek_read(), like any other
+ * wtap; fd-based queries such as wtap_file_size() fail on it.
+ *
+ * @param cbs the record callbacks; read must be non-NULL
+ * @param ctx caller context passed to every callback
+ * @param file_encap the WTAP_ENCAP_ value for the stream, or
+ * WTAP_ENCAP_PER_PACKET if the read callback sets each record's
+ * @param snaplen the snapshot length, or 0 if unknown
+ * @param tsprec the WTAP_TSPREC_ timestamp precision of the records
+ * @param err a positive "errno" value, or a negative number indicating
+ * the type of error, if the open failed
+ * @param err_info for some errors, a string giving more details of the
+ * error
+ * @return a wtap handle on success, NULL on failure
+ */
+WS_DLL_PUBLIC
+wtap *wtap_memory_open(const wtap_memory_callbacks_t *cbs, void *ctx,
+                       int file_encap, guint snaplen, int tsprec,
+                       int *err, gchar **err_info);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __MEMORY_SOURCE_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
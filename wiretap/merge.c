@@ -225,6 +225,111 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
     return TRUE;
 }
 
+/*
+ * Priority queue of the input files that have a record waiting, so the
+ * chronological merge picks the earliest record with an O(log n) heap
+ * operation per output record instead of scanning every input file.
+ * The ordering is the one the old linear scan produced: records with no
+ * time stamp sort before everything else (lowest file index first, and
+ * yes, that means you won't get a chronological merge of those records,
+ * but you obviously *can't* get that), time stamps sort chronologically,
+ * and files with equal time stamps sort in reverse file order, so the
+ * merged output stays byte-identical.
+ */
+typedef struct {
+    int     *files;      /* binary min-heap of indices into in_files[] */
+    int      count;      /* number of entries in the heap */
+    int      need_read;  /* file consumed by the previous call, or -1 */
+    gboolean primed;     /* every file has been read from once */
+} merge_file_heap_t;
+
+static gboolean
+record_before(merge_in_file_t in_files[], int a, int b)
+{
+    wtap_rec *ra = &in_files[a].rec;
+    wtap_rec *rb = &in_files[b].rec;
+
+    if (!(ra->presence_flags & WTAP_HAS_TS) ||
+        !(rb->presence_flags & WTAP_HAS_TS)) {
+        if ((ra->presence_flags & WTAP_HAS_TS) !=
+            (rb->presence_flags & WTAP_HAS_TS))
+            return !(ra->presence_flags & WTAP_HAS_TS);
+        return a < b;
+    }
+    if (!is_earlier(&ra->ts, &rb->ts))
+        return FALSE;
+    if (!is_earlier(&rb->ts, &ra->ts))
+        return TRUE;
+    /* Equal time stamps: the old scan kept the last such file it saw. */
+    return a > b;
+}
+
+static void
+merge_heap_push(merge_file_heap_t *heap, merge_in_file_t in_files[], int i)
+{
+    int child = heap->count++;
+
+    heap->files[child] = i;
+    while (child > 0) {
+        int parent = (child - 1) / 2;
+
+        if (!record_before(in_files, heap->files[child], heap->files[parent]))
+            break;
+        heap->files[child] = heap->files[parent];
+        heap->files[parent] = i;
+        child = parent;
+    }
+}
+
+static int
+merge_heap_pop(merge_file_heap_t *heap, merge_in_file_t in_files[])
+{
+    int top = heap->files[0];
+    int parent = 0;
+    int tmp;
+
+    heap->files[0] = heap->files[--heap->count];
+    for (;;) {
+        int child = 2 * parent + 1;
+
+        if (child >= heap->count)
+            break;
+        if (child + 1 < heap->count &&
+            record_before(in_files, heap->files[child + 1], heap->files[child]))
+            child++;
+        if (!record_before(in_files, heap->files[child], heap->files[parent]))
+            break;
+        tmp = heap->files[parent];
+        heap->files[parent] = heap->files[child];
+        heap->files[child] = tmp;
+        parent = child;
+    }
+    return top;
+}
+
+/* Read the next record from a file into its slot and, if the file isn't
+ * at EOF, add the file to the heap.  Returns FALSE on a read error. */
+static gboolean
+merge_queue_record(merge_in_file_t in_files[], merge_file_heap_t *heap,
+                   int i, int *err, gchar **err_info)
+{
+    gint64 data_offset;
+
+    if (!wtap_read(in_files[i].wth, &in_files[i].rec,
+                   &in_files[i].frame_buffer, err, err_info,
+                   &data_offset)) {
+        if (*err != 0) {
+            in_files[i].state = GOT_ERROR;
+            return FALSE;
+        }
+        in_files[i].state = AT_EOF;
+        return TRUE;
+    }
+    in_files[i].state = RECORD_PRESENT;
+    merge_heap_push(heap, in_files, i);
+    return TRUE;
+}
+
 /** Read the next packet, in chronological order, from the set of files to
  * be merged.
  *
@@ -239,6 +344,7 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  *
  * @param in_file_count number of entries in in_files
  * @param in_files input file array
+ * @param heap priority queue of the files with a record waiting
  * @param err wiretap error, if failed
  * @param err_info wiretap error string, if failed
  * @return pointer to merge_in_file_t for file from which that packet
@@ -247,69 +353,42 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  */
 static merge_in_file_t *
 merge_read_packet(int in_file_count, merge_in_file_t in_files[],
-                  int *err, gchar **err_info)
+                  merge_file_heap_t *heap, int *err, gchar **err_info)
 {
     int i;
-    int ei = -1;
-    nstime_t tv = NSTIME_INIT_MAX;
-    wtap_rec *rec;
+    int ei;
 
     /*
      * Make sure we have a record available from each file that's not at
-     * EOF, and search for the record with the earliest time stamp or
-     * with no time stamp (those records are treated as earlier than
-     * all other records).  Yes, this means you won't get a chronological
-     * merge of those records, but you obviously *can't* get that.
+     * EOF.  Only the file whose record the previous call handed out can
+     * be missing one, except on the first call, which fills the heap
+     * from every file.
      */
-    for (i = 0; i < in_file_count; i++) {
-        gint64 data_offset;
-
-        if (in_files[i].state == RECORD_NOT_PRESENT) {
-            /*
-             * No packet available, and we haven't seen an error or EOF yet,
-             * so try to read the next packet.
-             */
-            if (!wtap_read(in_files[i].wth, &in_files[i].rec,
-                           &in_files[i].frame_buffer, err, err_info,
-                           &data_offset)) {
-                if (*err != 0) {
-                    in_files[i].state = GOT_ERROR;
-                    return &in_files[i];
-                }
-                in_files[i].state = AT_EOF;
-            } else
-                in_files[i].state = RECORD_PRESENT;
-        }
-
-        if (in_files[i].state == RECORD_PRESENT) {
-            rec = &in_files[i].rec;
-            if (!(rec->presence_flags & WTAP_HAS_TS)) {
-                /*
-                 * No time stamp.  Pick this record, and stop looking.
-                 */
-                ei = i;
-                break;
-            }
-            if (is_earlier(&rec->ts, &tv)) {
-                /*
-                 * This record's time stamp is earlier than any of the
-                 * records we've seen so far.  Pick it, for now, but
-                 * keep looking.
-                 */
-                tv = rec->ts;
-                ei = i;
-            }
+    if (!heap->primed) {
+        for (i = 0; i < in_file_count; i++) {
+            if (!merge_queue_record(in_files, heap, i, err, err_info))
+                return &in_files[i];
         }
+        heap->primed = TRUE;
+    } else if (heap->need_read != -1) {
+        i = heap->need_read;
+        heap->need_read = -1;
+        if (!merge_queue_record(in_files, heap, i, err, err_info))
+            return &in_files[i];
     }
 
-    if (ei == -1) {
+    if (heap->count == 0) {
         /* All the streams are at EOF.  Return an EOF indication. */
         *err = 0;
         return NULL;
     }
 
+    /* The heap's top entry is the earliest waiting record. */
+    ei = merge_heap_pop(heap, in_files);
+
     /* We'll need to read another packet from this file. */
     in_files[ei].state = RECORD_NOT_PRESENT;
+    heap->need_read = ei;
 
     /* Count this packet. */
     in_files[ei].packet_num++;
@@ -851,6 +930,12 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
     int                 count = 0;
     gboolean            stop_flag = FALSE;
     wtap_rec *rec,      snap_rec;
+    merge_file_heap_t   heap;
+
+    heap.files     = g_new(int, in_file_count);
+    heap.count     = 0;
+    heap.need_read = -1;
+    heap.primed    = FALSE;
 
     for (;;) {
         *err = 0;
@@ -860,8 +945,8 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
                                                err_info);
         }
         else {
-            in_file = merge_read_packet(in_file_count, in_files, err,
-                                        err_info);
+            in_file = merge_read_packet(in_file_count, in_files, &heap,
+                                        err, err_info);
         }
 
         if (in_file == NULL) {
@@ -942,6 +1027,8 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
         }
     }
 
+    g_free(heap.files);
+
     if (cb)
         cb->callback_func(MERGE_EVENT_DONE, count, in_files, in_file_count, cb->data);
 
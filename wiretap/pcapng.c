@@ -446,12 +446,10 @@ register_pcapng_option_handler(guint block_type, guint option_code,
 #endif /* HAVE_PLUGINS */
 
 static int
-pcapng_read_option(FILE_T fh, pcapng_t *pn, pcapng_option_header_t *oh,
-                   guint8 *content, guint len, guint to_read,
-                   int *err, gchar **err_info, gchar* block_name)
+pcapng_read_option_header(FILE_T fh, pcapng_t *pn, pcapng_option_header_t *oh,
+                          guint to_read, int *err, gchar **err_info,
+                          gchar* block_name)
 {
-    int     block_read;
-
     /* sanity check: don't run past the end of the block */
     if (to_read < sizeof (*oh)) {
         *err = WTAP_ERR_BAD_FILE;
@@ -465,7 +463,6 @@ pcapng_read_option(FILE_T fh, pcapng_t *pn, pcapng_option_header_t *oh,
         pcapng_debug("pcapng_read_option: failed to read option");
         return -1;
     }
-    block_read = sizeof (*oh);
     if (pn->byte_swapped) {
         oh->option_code      = GUINT16_SWAP_LE_BE(oh->option_code);
         oh->option_length    = GUINT16_SWAP_LE_BE(oh->option_length);
@@ -479,6 +476,16 @@ pcapng_read_option(FILE_T fh, pcapng_t *pn, pcapng_option_header_t *oh,
         return -1;
     }
 
+    return sizeof (*oh);
+}
+
+static int
+pcapng_read_option_content(FILE_T fh, const pcapng_option_header_t *oh,
+                           guint8 *content, guint len,
+                           int *err, gchar **err_info, gchar* block_name)
+{
+    int     block_read;
+
     /* sanity check: option length */
     if (len < oh->option_length) {
         *err = WTAP_ERR_BAD_FILE;
@@ -492,7 +499,7 @@ pcapng_read_option(FILE_T fh, pcapng_t *pn, pcapng_option_header_t *oh,
         pcapng_debug("pcapng_read_option: failed to read content of option %u", oh->option_code);
         return -1;
     }
-    block_read += oh->option_length;
+    block_read = oh->option_length;
 
     /* jump over potential padding bytes at end of option */
     if ( (oh->option_length % 4) != 0) {
@@ -504,6 +511,52 @@ pcapng_read_option(FILE_T fh, pcapng_t *pn, pcapng_option_header_t *oh,
     return block_read;
 }
 
+/*
+ * Skip the content (and padding) of an option whose value nothing will
+ * look at, without copying it anywhere.  Files with large per-packet
+ * custom options are not charged for decoding options that are never
+ * consumed.
+ */
+static int
+pcapng_skip_option_content(FILE_T fh, const pcapng_option_header_t *oh,
+                           int *err, gchar **err_info)
+{
+    guint   to_skip;
+
+    to_skip = oh->option_length;
+    /* include potential padding bytes at end of option */
+    if ((to_skip % 4) != 0)
+        to_skip += 4 - (to_skip % 4);
+
+    if (!wtap_read_bytes(fh, NULL, to_skip, err, err_info)) {
+        pcapng_debug("pcapng_skip_option_content: failed to skip content of option %u", oh->option_code);
+        return -1;
+    }
+
+    return to_skip;
+}
+
+static int
+pcapng_read_option(FILE_T fh, pcapng_t *pn, pcapng_option_header_t *oh,
+                   guint8 *content, guint len, guint to_read,
+                   int *err, gchar **err_info, gchar* block_name)
+{
+    int     block_read;
+    int     content_read;
+
+    block_read = pcapng_read_option_header(fh, pn, oh, to_read, err, err_info,
+                                           block_name);
+    if (block_read < 0)
+        return -1;
+
+    content_read = pcapng_read_option_content(fh, oh, content, len, err,
+                                              err_info, block_name);
+    if (content_read < 0)
+        return -1;
+
+    return block_read + content_read;
+}
+
 typedef enum {
     PCAPNG_BLOCK_OK,
     PCAPNG_BLOCK_NOT_SHB,
@@ -1115,7 +1168,7 @@ pcapng_read_decryption_secrets_block(FILE_T fh, pcapng_block_header_t *bh, pcapn
 }
 
 static gboolean
-pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wtapng_block_t *wblock, int *err, gchar **err_info, gboolean enhanced)
+pcapng_read_packet_block(wtap *wth, FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wtapng_block_t *wblock, int *err, gchar **err_info, gboolean enhanced)
 {
     int bytes_read;
     guint block_read;
@@ -1130,10 +1183,11 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
     guint8 *opt_ptr;
     pcapng_option_header_t *oh;
     guint8 *option_content;
+    gboolean decode_option;
     int pseudo_header_len;
     int fcslen;
 #ifdef HAVE_PLUGINS
-    option_handler *handler;
+    option_handler *handler = NULL;
 #endif
 
     /* "(Enhanced) Packet Block" read fixed part */
@@ -1308,10 +1362,18 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
     wblock->rec->ts.secs = (time_t)(ts / iface_info.time_units_per_second);
     wblock->rec->ts.nsecs = (int)(((ts % iface_info.time_units_per_second) * 1000000000) / iface_info.time_units_per_second);
 
-    /* "(Enhanced) Packet Block" read capture data */
-    if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
-                                packet.cap_len - pseudo_header_len, err, err_info))
-        return FALSE;
+    /* "(Enhanced) Packet Block" read capture data, unless this is a
+     * sequential read and the caller told us it only wants the record
+     * headers, in which case just seek past it. */
+    if (wth->skip_record_data && fh == wth->fh) {
+        if (packet.cap_len - pseudo_header_len != 0 &&
+            file_seek(fh, packet.cap_len - pseudo_header_len, SEEK_CUR, err) == -1)
+            return FALSE;
+    } else {
+        if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
+                                    packet.cap_len - pseudo_header_len, err, err_info))
+            return FALSE;
+    }
     block_read += packet.cap_len - pseudo_header_len;
 
     /* jump over potential padding bytes at end of the packet data */
@@ -1351,10 +1413,10 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
     opt_ptr = ws_buffer_start_ptr(&wblock->rec->options_buf);
 
     while (to_read != 0) {
-        /* read option */
+        /* read option header */
         oh = (pcapng_option_header_t *)(void *)opt_ptr;
         option_content = opt_ptr + sizeof (pcapng_option_header_t);
-        bytes_read = pcapng_read_option(fh, pn, oh, option_content, opt_cont_buf_len, to_read, err, err_info, "packet");
+        bytes_read = pcapng_read_option_header(fh, pn, oh, to_read, err, err_info, "packet");
         if (bytes_read <= 0) {
             pcapng_debug("pcapng_read_packet_block: failed to read option");
             /* XXX - free anything? */
@@ -1362,6 +1424,61 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
         }
         to_read -= bytes_read;
 
+        /*
+         * Decide whether anything will consume this option's content.
+         * Capture tools can attach large per-packet custom options;
+         * copying those into the option buffer for every packet just to
+         * ignore them is wasted work, so seek past unconsumed options
+         * instead of decoding them.
+         */
+        decode_option = FALSE;
+        switch (oh->option_code) {
+            case(OPT_EOFOPT):
+            case(OPT_COMMENT):
+            case(OPT_EPB_FLAGS):
+            case(OPT_EPB_DROPCOUNT):
+                decode_option = TRUE;
+                break;
+            case(OPT_EPB_HASH):
+                pcapng_debug("pcapng_read_packet_block: epb_hash %u currently not handled - skipping %u bytes",
+                              oh->option_code, oh->option_length);
+                break;
+            default:
+#ifdef HAVE_PLUGINS
+                /*
+                 * Do we have a handler for this packet block option code?
+                 */
+                if (option_handlers[BT_INDEX_PBS] != NULL &&
+                    (handler = (option_handler *)g_hash_table_lookup(option_handlers[BT_INDEX_PBS],
+                                                                   GUINT_TO_POINTER((guint)oh->option_code))) != NULL) {
+                    /* Yes - decode it and call the handler below. */
+                    decode_option = TRUE;
+                } else
+#endif
+                {
+                    pcapng_debug("pcapng_read_packet_block: unknown option %u - skipping %u bytes",
+                                  oh->option_code, oh->option_length);
+                }
+        }
+
+        if (!decode_option) {
+            bytes_read = pcapng_skip_option_content(fh, oh, err, err_info);
+            if (bytes_read < 0) {
+                /* XXX - free anything? */
+                return FALSE;
+            }
+            to_read -= bytes_read;
+            continue;
+        }
+
+        bytes_read = pcapng_read_option_content(fh, oh, option_content, opt_cont_buf_len, err, err_info, "packet");
+        if (bytes_read < 0) {
+            pcapng_debug("pcapng_read_packet_block: failed to read option");
+            /* XXX - free anything? */
+            return FALSE;
+        }
+        to_read -= bytes_read;
+
         /* handle option content */
         switch (oh->option_code) {
             case(OPT_EOFOPT):
@@ -1405,10 +1522,6 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
                 }
                 pcapng_debug("pcapng_read_packet_block: pack_flags %u (ignored)", wblock->rec->rec_header.packet_header.pack_flags);
                 break;
-            case(OPT_EPB_HASH):
-                pcapng_debug("pcapng_read_packet_block: epb_hash %u currently not handled - ignoring %u bytes",
-                              oh->option_code, oh->option_length);
-                break;
             case(OPT_EPB_DROPCOUNT):
                 if (oh->option_length != 8) {
                     *err = WTAP_ERR_BAD_FILE;
@@ -1430,31 +1543,23 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
 
                 pcapng_debug("pcapng_read_packet_block: drop_count %" G_GINT64_MODIFIER "u", wblock->rec->rec_header.packet_header.drop_count);
                 break;
-            default:
 #ifdef HAVE_PLUGINS
-                /*
-                 * Do we have a handler for this packet block option code?
-                 */
-                if (option_handlers[BT_INDEX_PBS] != NULL &&
-                    (handler = (option_handler *)g_hash_table_lookup(option_handlers[BT_INDEX_PBS],
-                                                                   GUINT_TO_POINTER((guint)oh->option_code))) != NULL) {
-                    /* Yes - call the handler. */
-                    if (!handler->hfunc(pn->byte_swapped, oh->option_length,
-                                 option_content, err, err_info))
-                        /* XXX - free anything? */
-                        return FALSE;
-                } else
+            default:
+                /* Call the handler we found above. */
+                if (!handler->hfunc(pn->byte_swapped, oh->option_length,
+                             option_content, err, err_info))
+                    /* XXX - free anything? */
+                    return FALSE;
+                break;
 #endif
-                {
-                    pcapng_debug("pcapng_read_packet_block: unknown option %u - ignoring %u bytes",
-                                  oh->option_code, oh->option_length);
-                }
         }
     }
 
-    pcap_read_post_process(WTAP_FILE_TYPE_SUBTYPE_PCAPNG, iface_info.wtap_encap,
-                           wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
-                           pn->byte_swapped, fcslen);
+    if (!(wth->skip_record_data && fh == wth->fh)) {
+        pcap_read_post_process(WTAP_FILE_TYPE_SUBTYPE_PCAPNG, iface_info.wtap_encap,
+                               wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
+                               pn->byte_swapped, fcslen);
+    }
 
     /*
      * We return these to the caller in pcapng_read().
@@ -1466,7 +1571,7 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
 
 
 static gboolean
-pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wtapng_block_t *wblock, int *err, gchar **err_info)
+pcapng_read_simple_packet_block(wtap *wth, FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wtapng_block_t *wblock, int *err, gchar **err_info)
 {
     interface_info_t iface_info;
     pcapng_simple_packet_block_t spb;
@@ -1593,10 +1698,18 @@ pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *
 
     memset((void *)&wblock->rec->rec_header.packet_header.pseudo_header, 0, sizeof(union wtap_pseudo_header));
 
-    /* "Simple Packet Block" read capture data */
-    if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
-                                simple_packet.cap_len, err, err_info))
-        return FALSE;
+    /* "Simple Packet Block" read capture data, unless this is a
+     * sequential read and the caller told us it only wants the record
+     * headers, in which case just seek past it. */
+    if (wth->skip_record_data && fh == wth->fh) {
+        if (simple_packet.cap_len != 0 &&
+            file_seek(fh, simple_packet.cap_len, SEEK_CUR, err) == -1)
+            return FALSE;
+    } else {
+        if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
+                                    simple_packet.cap_len, err, err_info))
+            return FALSE;
+    }
 
     /* jump over potential padding bytes at end of the packet data */
     if ((simple_packet.cap_len % 4) != 0) {
@@ -1604,9 +1717,11 @@ pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *
             return FALSE;
     }
 
-    pcap_read_post_process(WTAP_FILE_TYPE_SUBTYPE_PCAPNG, iface_info.wtap_encap,
-                           wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
-                           pn->byte_swapped, iface_info.fcslen);
+    if (!(wth->skip_record_data && fh == wth->fh)) {
+        pcap_read_post_process(WTAP_FILE_TYPE_SUBTYPE_PCAPNG, iface_info.wtap_encap,
+                               wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
+                               pn->byte_swapped, iface_info.fcslen);
+    }
 
     /*
      * We return these to the caller in pcapng_read().
@@ -2563,15 +2678,15 @@ pcapng_read_block(wtap *wth, FILE_T fh, pcapng_t *pn, wtapng_block_t *wblock, in
                     return PCAPNG_BLOCK_ERROR;
                 break;
             case(BLOCK_TYPE_PB):
-                if (!pcapng_read_packet_block(fh, &bh, pn, wblock, err, err_info, FALSE))
+                if (!pcapng_read_packet_block(wth, fh, &bh, pn, wblock, err, err_info, FALSE))
                     return PCAPNG_BLOCK_ERROR;
                 break;
             case(BLOCK_TYPE_SPB):
-                if (!pcapng_read_simple_packet_block(fh, &bh, pn, wblock, err, err_info))
+                if (!pcapng_read_simple_packet_block(wth, fh, &bh, pn, wblock, err, err_info))
                     return PCAPNG_BLOCK_ERROR;
                 break;
             case(BLOCK_TYPE_EPB):
-                if (!pcapng_read_packet_block(fh, &bh, pn, wblock, err, err_info, TRUE))
+                if (!pcapng_read_packet_block(wth, fh, &bh, pn, wblock, err, err_info, TRUE))
                     return PCAPNG_BLOCK_ERROR;
                 break;
             case(BLOCK_TYPE_NRB):
@@ -70,6 +70,13 @@ struct wtap {
     wtap_new_ipv6_callback_t    add_new_ipv6;
     wtap_new_secrets_callback_t add_new_secrets;
     GPtrArray                   *fast_seek;
+    gboolean                    skip_record_data;   /* the caller only needs
+                                                     * record headers from
+                                                     * sequential reads;
+                                                     * readers that support
+                                                     * it seek past the
+                                                     * packet data
+                                                     */
 };
 
 struct wtap_dumper;
@@ -65,6 +65,11 @@ wtap_file_size(wtap *wth, int *err)
 int
 wtap_fstat(wtap *wth, ws_statb64 *statb, int *err)
 {
+	if (wth->fh == NULL && wth->random_fh == NULL) {
+		/* a memory source has no file descriptor to stat */
+		*err = WTAP_ERR_CANT_OPEN;
+		return -1;
+	}
 	if (file_fstat((wth->fh == NULL) ? wth->random_fh : wth->fh,
 	    statb, err) == -1)
 		return -1;
@@ -1262,7 +1267,8 @@ wtap_close(wtap *wth)
 void
 wtap_cleareof(wtap *wth) {
 	/* Reset EOF */
-	file_clearerr(wth->fh);
+	if (wth->fh != NULL)
+		file_clearerr(wth->fh);
 }
 
 void wtap_set_cb_new_ipv4(wtap *wth, wtap_new_ipv4_callback_t add_new_ipv4) {
@@ -1292,6 +1298,11 @@ void wtap_set_cb_new_secrets(wtap *wth, wtap_new_secrets_callback_t add_new_secr
 	}
 }
 
+void wtap_set_skip_record_data(wtap *wth, gboolean skip) {
+	if (wth)
+		wth->skip_record_data = skip;
+}
+
 void
 wtapng_process_dsb(wtap *wth, wtap_block_t dsb)
 {
@@ -1329,8 +1340,11 @@ wtap_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
 		 * reading compressed data from the file, but
 		 * got enough compressed data to decompress the
 		 * last packet of the file.
+		 *
+		 * (A memory source has no file handle; its callback is
+		 * responsible for setting *err itself.)
 		 */
-		if (*err == 0)
+		if (*err == 0 && wth->fh != NULL)
 			*err = file_error(wth->fh, err_info);
 		return FALSE;	/* failure */
 	}
@@ -1777,6 +1777,18 @@ typedef void (*wtap_new_secrets_callback_t)(guint32 secrets_type, const void *se
 WS_DLL_PUBLIC
 void wtap_set_cb_new_secrets(wtap *wth, wtap_new_secrets_callback_t add_new_secrets);
 
+/**
+ * Tell the sequential reader that the caller needs only the record
+ * headers, not the packet data, so the Buffer passed to wtap_read()
+ * may be left untouched.  File formats that support this seek past
+ * the packet data rather than copying it, making a metadata-only scan
+ * of a large file much cheaper; formats that don't support it keep
+ * delivering the data.  Only use this if you never look at the packet
+ * bytes, as capinfos doesn't.
+ */
+WS_DLL_PUBLIC
+void wtap_set_skip_record_data(wtap *wth, gboolean skip);
+
 /** Read the next record in the file, filling in *phdr and *buf.
  *
  * @wth a wtap * returned by a call that opened a file for reading.
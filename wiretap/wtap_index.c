@@ -0,0 +1,264 @@
+/* wtap_index.c
+ * Record-offset index sidecar, so that reopening a previously-seen
+ * capture doesn't require an end-to-end read to learn where the
+ * records are.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "wtap_index.h"
+#include <wsutil/file_util.h>
+
+/*
+ * On-disk layout: a header followed by one packed entry per record,
+ * all in host byte order.  The sidecar is a cache, not an interchange
+ * format - an index written by a different host, a different version,
+ * or against a since-modified capture file fails validation and is
+ * rebuilt.
+ */
+#define WTAP_REC_INDEX_MAGIC    0x57495831      /* "WIX1" */
+#define WTAP_REC_INDEX_VERSION  1
+
+typedef struct {
+    guint32 magic;
+    guint32 version;
+    gint64  file_size;          /* size of the capture file when indexed */
+    gint64  file_mtime;         /* mtime of the capture file when indexed */
+    guint32 num_records;
+    guint32 reserved;
+} wtap_rec_index_hdr_t;
+
+typedef struct {
+    gint64  offset;             /* offset to hand to wtap_seek_read() */
+    gint64  ts_secs;
+    gint32  ts_nsecs;
+    guint32 interface_id;       /* 0 for non-packet records */
+} wtap_rec_index_entry_t;
+
+struct wtap_rec_index {
+    GArray *entries;            /* of wtap_rec_index_entry_t */
+};
+
+static char *
+wtap_rec_index_path(const char *cap_path)
+{
+    return g_strdup_printf("%s.idx", cap_path);
+}
+
+wtap_rec_index_t *
+wtap_rec_index_new(void)
+{
+    wtap_rec_index_t *idx = g_new(wtap_rec_index_t, 1);
+
+    idx->entries = g_array_new(FALSE, FALSE, sizeof(wtap_rec_index_entry_t));
+    return idx;
+}
+
+void
+wtap_rec_index_add(wtap_rec_index_t *idx, gint64 offset, const wtap_rec *rec)
+{
+    wtap_rec_index_entry_t entry;
+
+    entry.offset = offset;
+    entry.ts_secs = rec->ts.secs;
+    entry.ts_nsecs = rec->ts.nsecs;
+    if (rec->rec_type == REC_TYPE_PACKET &&
+        (rec->presence_flags & WTAP_HAS_INTERFACE_ID))
+        entry.interface_id = rec->rec_header.packet_header.interface_id;
+    else
+        entry.interface_id = 0;
+    g_array_append_val(idx->entries, entry);
+}
+
+/* Write all of a buffer, coping with short writes. */
+static gboolean
+write_all(int fd, const void *buf, size_t count, int *err)
+{
+    const char *p = (const char *)buf;
+    ssize_t written;
+
+    while (count != 0) {
+        written = ws_write(fd, p, (unsigned int)count);
+        if (written < 0) {
+            *err = errno;
+            return FALSE;
+        }
+        p += written;
+        count -= written;
+    }
+    return TRUE;
+}
+
+gboolean
+wtap_rec_index_save(const wtap_rec_index_t *idx, const char *cap_path,
+                    int *err)
+{
+    ws_statb64 statb;
+    wtap_rec_index_hdr_t hdr;
+    char *idx_path, *tmp_path;
+    int fd;
+
+    /*
+     * Stamp the index with the capture file's current size and mtime;
+     * wtap_rec_index_load() uses them to reject a stale index.
+     */
+    if (ws_stat64(cap_path, &statb) == -1) {
+        *err = errno;
+        return FALSE;
+    }
+
+    memset(&hdr, 0, sizeof hdr);
+    hdr.magic = WTAP_REC_INDEX_MAGIC;
+    hdr.version = WTAP_REC_INDEX_VERSION;
+    hdr.file_size = statb.st_size;
+    hdr.file_mtime = statb.st_mtime;
+    hdr.num_records = idx->entries->len;
+
+    idx_path = wtap_rec_index_path(cap_path);
+    tmp_path = g_strdup_printf("%s.tmp", idx_path);
+
+    fd = ws_open(tmp_path, O_WRONLY|O_CREAT|O_TRUNC|O_BINARY, 0644);
+    if (fd == -1) {
+        *err = errno;
+        g_free(tmp_path);
+        g_free(idx_path);
+        return FALSE;
+    }
+    if (!write_all(fd, &hdr, sizeof hdr, err) ||
+        !write_all(fd, idx->entries->data,
+                   (size_t)idx->entries->len * sizeof(wtap_rec_index_entry_t),
+                   err)) {
+        ws_close(fd);
+        ws_unlink(tmp_path);
+        g_free(tmp_path);
+        g_free(idx_path);
+        return FALSE;
+    }
+    if (ws_close(fd) == -1) {
+        *err = errno;
+        ws_unlink(tmp_path);
+        g_free(tmp_path);
+        g_free(idx_path);
+        return FALSE;
+    }
+
+    /* Rename into place, so a reader never sees a partial index. */
+    if (ws_rename(tmp_path, idx_path) == -1) {
+        *err = errno;
+        ws_unlink(tmp_path);
+        g_free(tmp_path);
+        g_free(idx_path);
+        return FALSE;
+    }
+    g_free(tmp_path);
+    g_free(idx_path);
+    return TRUE;
+}
+
+wtap_rec_index_t *
+wtap_rec_index_load(const char *cap_path)
+{
+    ws_statb64 statb;
+    wtap_rec_index_hdr_t hdr;
+    wtap_rec_index_t *idx;
+    char *idx_path;
+    size_t entries_size;
+    ssize_t bytes_read;
+    int fd;
+
+    if (ws_stat64(cap_path, &statb) == -1)
+        return NULL;
+
+    idx_path = wtap_rec_index_path(cap_path);
+    fd = ws_open(idx_path, O_RDONLY|O_BINARY, 0000);
+    g_free(idx_path);
+    if (fd == -1)
+        return NULL;
+
+    bytes_read = ws_read(fd, &hdr, sizeof hdr);
+    if (bytes_read != (ssize_t)sizeof hdr ||
+        hdr.magic != WTAP_REC_INDEX_MAGIC ||
+        hdr.version != WTAP_REC_INDEX_VERSION ||
+        hdr.file_size != statb.st_size ||
+        hdr.file_mtime != (gint64)statb.st_mtime) {
+        /* No index, or one for some other version of the capture. */
+        ws_close(fd);
+        return NULL;
+    }
+
+    idx = g_new(wtap_rec_index_t, 1);
+    idx->entries = g_array_sized_new(FALSE, FALSE,
+                                     sizeof(wtap_rec_index_entry_t),
+                                     hdr.num_records);
+    g_array_set_size(idx->entries, hdr.num_records);
+    entries_size = (size_t)hdr.num_records * sizeof(wtap_rec_index_entry_t);
+    bytes_read = ws_read(fd, idx->entries->data, (unsigned int)entries_size);
+    ws_close(fd);
+    if (bytes_read != (ssize_t)entries_size) {
+        /* Truncated; treat it as no index at all. */
+        wtap_rec_index_free(idx);
+        return NULL;
+    }
+    return idx;
+}
+
+guint
+wtap_rec_index_count(const wtap_rec_index_t *idx)
+{
+    return idx->entries->len;
+}
+
+gint64
+wtap_rec_index_offset(const wtap_rec_index_t *idx, guint n)
+{
+    return g_array_index(idx->entries, wtap_rec_index_entry_t, n).offset;
+}
+
+void
+wtap_rec_index_ts(const wtap_rec_index_t *idx, guint n, nstime_t *ts)
+{
+    const wtap_rec_index_entry_t *entry =
+        &g_array_index(idx->entries, wtap_rec_index_entry_t, n);
+
+    ts->secs = (time_t)entry->ts_secs;
+    ts->nsecs = entry->ts_nsecs;
+}
+
+guint32
+wtap_rec_index_interface_id(const wtap_rec_index_t *idx, guint n)
+{
+    return g_array_index(idx->entries, wtap_rec_index_entry_t, n).interface_id;
+}
+
+void
+wtap_rec_index_free(wtap_rec_index_t *idx)
+{
+    if (idx == NULL)
+        return;
+    g_array_free(idx->entries, TRUE);
+    g_free(idx);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local Variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
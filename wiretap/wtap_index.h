@@ -0,0 +1,105 @@
+/* wtap_index.h
+ * Declarations for the record-offset index sidecar.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __WTAP_INDEX_H__
+#define __WTAP_INDEX_H__
+
+#include "wiretap/wtap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * A sidecar index of the records in a capture file, built during a
+ * sequential read and saved next to the capture as "<name>.idx".  It
+ * records, for every record, the seek offset a subsequent
+ * wtap_seek_read() would use, the record's timestamp, and - for
+ * packet records - the interface ID, so that reopening a
+ * previously-seen capture can learn the record count and offsets
+ * without reading the file end-to-end.
+ *
+ * The sidecar is a machine-local cache: it's written in host byte
+ * order and validated against the capture file's size and mtime, so
+ * a stale or foreign index is simply ignored and rebuilt.
+ *
+ * This is deliberately the limit of what gets persisted.  The rest of
+ * the first pass's derived state - conversation tables, reassembly
+ * fragments, per-protocol conversation data - lives in wmem scopes as
+ * object graphs full of untagged pointers, including per-dissector
+ * structures the core can't even name, and its contents depend on the
+ * enabled-protocol set, preferences and Decode As entries in force
+ * when the pass ran.  A snapshot of it would need every dissector to
+ * provide serialize/deserialize hooks and would be invalidated by any
+ * configuration change, so reopening a capture re-runs the first pass
+ * and only the record geometry above is carried over.
+ */
+typedef struct wtap_rec_index wtap_rec_index_t;
+
+/** Create an empty index, to be filled in during a sequential read. */
+WS_DLL_PUBLIC wtap_rec_index_t *
+wtap_rec_index_new(void);
+
+/** Append one record's offset and metadata; call in record order. */
+WS_DLL_PUBLIC void
+wtap_rec_index_add(wtap_rec_index_t *idx, gint64 offset,
+                   const wtap_rec *rec);
+
+/** Save the index as a sidecar next to the given capture file.
+ * Returns FALSE, setting *err to an errno value, on write failure;
+ * the sidecar is written to a temporary file and renamed into place,
+ * so a failed save leaves no partial index behind. */
+WS_DLL_PUBLIC gboolean
+wtap_rec_index_save(const wtap_rec_index_t *idx, const char *cap_path,
+                    int *err);
+
+/** Load the sidecar index for the given capture file, or return NULL
+ * if there isn't one or it doesn't match the capture file's current
+ * size and mtime. */
+WS_DLL_PUBLIC wtap_rec_index_t *
+wtap_rec_index_load(const char *cap_path);
+
+/** Number of records in the index. */
+WS_DLL_PUBLIC guint
+wtap_rec_index_count(const wtap_rec_index_t *idx);
+
+/** Seek offset of record n (0-origin). */
+WS_DLL_PUBLIC gint64
+wtap_rec_index_offset(const wtap_rec_index_t *idx, guint n);
+
+/** Timestamp of record n (0-origin). */
+WS_DLL_PUBLIC void
+wtap_rec_index_ts(const wtap_rec_index_t *idx, guint n, nstime_t *ts);
+
+/** Interface ID of record n (0-origin); 0 for non-packet records. */
+WS_DLL_PUBLIC guint32
+wtap_rec_index_interface_id(const wtap_rec_index_t *idx, guint n);
+
+WS_DLL_PUBLIC void
+wtap_rec_index_free(wtap_rec_index_t *idx);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __WTAP_INDEX_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local Variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -353,6 +353,66 @@ static const guint32 crc32_5D6DCB[] =
 		0x0098206c, 0x00c54da7, 0x0022fbfa, 0x007f9631
 };
 
+/*
+ * Slice-by-8: process eight bytes per step through eight derived
+ * tables instead of one byte per step through one.  The derived
+ * tables are computed once, on first use, from the 256-entry tables
+ * above; slice[k] gives the effect of a byte k positions further
+ * from the end of an 8-byte group.  This only works for the
+ * reflected (bit-reversed) CRC-32 variants, which is what the CCITT
+ * and Castagnoli polynomials here use.
+ */
+#define CRC32_SLICE_TABLES 8
+
+static guint32 crc32_ccitt_slice[CRC32_SLICE_TABLES][256];
+static guint32 crc32c_slice[CRC32_SLICE_TABLES][256];
+static gboolean crc32_slice_tables_ready = FALSE;
+
+static void
+crc32_slice_expand(guint32 slice[][256], const guint32 *table)
+{
+	guint32 c;
+	int i, k;
+
+	for (i = 0; i < 256; i++) {
+		c = table[i];
+		slice[0][i] = c;
+		for (k = 1; k < CRC32_SLICE_TABLES; k++) {
+			c = (c >> 8) ^ table[c & 0xff];
+			slice[k][i] = c;
+		}
+	}
+}
+
+static guint32
+crc32_slice_calculate(guint32 slice[][256], const guint8 *p, guint len, guint32 crc)
+{
+	if (!crc32_slice_tables_ready) {
+		crc32_slice_expand(crc32_ccitt_slice, crc32_ccitt_table);
+		crc32_slice_expand(crc32c_slice, crc32c_table);
+		crc32_slice_tables_ready = TRUE;
+	}
+
+	while (len >= 8) {
+		crc ^= (guint32)p[0] | ((guint32)p[1] << 8) |
+		    ((guint32)p[2] << 16) | ((guint32)p[3] << 24);
+		crc = slice[7][crc & 0xff] ^
+		    slice[6][(crc >> 8) & 0xff] ^
+		    slice[5][(crc >> 16) & 0xff] ^
+		    slice[4][crc >> 24] ^
+		    slice[3][p[4]] ^
+		    slice[2][p[5]] ^
+		    slice[1][p[6]] ^
+		    slice[0][p[7]];
+		p += 8;
+		len -= 8;
+	}
+	while (len-- > 0)
+		crc = (crc >> 8) ^ slice[0][(crc ^ *p++) & 0xff];
+
+	return crc;
+}
+
 guint32
 crc32c_table_lookup (guchar pos)
 {
@@ -370,9 +430,8 @@ crc32c_calculate(const void *buf, int len, guint32 crc)
 {
 	const guint8 *p = (const guint8 *)buf;
 	crc = CRC32C_SWAP(crc);
-	while (len-- > 0) {
-		CRC32C(crc, *p++);
-	}
+	if (len > 0)
+		crc = crc32_slice_calculate(crc32c_slice, p, (guint)len, crc);
 	return CRC32C_SWAP(crc);
 }
 
@@ -380,9 +439,8 @@ guint32
 crc32c_calculate_no_swap(const void *buf, int len, guint32 crc)
 {
 	const guint8 *p = (const guint8 *)buf;
-	while (len-- > 0) {
-		CRC32C(crc, *p++);
-	}
+	if (len > 0)
+		crc = crc32_slice_calculate(crc32c_slice, p, (guint)len, crc);
 
 	return crc;
 }
@@ -396,13 +454,7 @@ crc32_ccitt(const guint8 *buf, guint len)
 guint32
 crc32_ccitt_seed(const guint8 *buf, guint len, guint32 seed)
 {
-	guint i;
-	guint32 crc32 = seed;
-
-	for (i = 0; i < len; i++)
-		CRC32_ACCUMULATE(crc32, buf[i], crc32_ccitt_table);
-
-	return ( ~crc32 );
+	return ( ~crc32_slice_calculate(crc32_ccitt_slice, buf, len, seed) );
 }
 
 guint32
@@ -55,23 +55,61 @@ json_puts_string(FILE *fp, const char *str, gboolean dot_to_underscore)
         "u0010", "u0011", "u0012", "u0013", "u0014", "u0015", "u0016", "u0017", "u0018", "u0019", "u001a", "u001b", "u001c", "u001d", "u001e", "u001f"
     };
 
+    enum json_char_class {
+        JSON_CHAR_VERBATIM = 0, /* copied through as-is */
+        JSON_CHAR_CTRL,         /* control character, escaped via json_cntrl */
+        JSON_CHAR_BACKSLASHED,  /* '"' or '\\', escaped with a backslash */
+        JSON_CHAR_SLASH,        /* '/', escaped only right after '<' */
+        JSON_CHAR_DOT           /* '.', replaced when dot_to_underscore is set */
+    };
+    /* Class per byte; one table lookup decides whether a byte can be part
+     * of the current verbatim run. Bytes >= 0x80 are all verbatim. */
+    static const guint8 json_char_class[0x80] = {
+        1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,1,    /* 0x00 - 0x0f */
+        1,1,1,1, 1,1,1,1, 1,1,1,1, 1,1,1,1,    /* 0x10 - 0x1f */
+        0,0,2,0, 0,0,0,0, 0,0,0,0, 0,0,4,3,    /* 0x20 - 0x2f */
+        0,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,0,    /* 0x30 - 0x3f */
+        0,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,0,    /* 0x40 - 0x4f */
+        0,0,0,0, 0,0,0,0, 0,0,0,0, 2,0,0,0,    /* 0x50 - 0x5f */
+    };
+
     fputc('"', fp);
-    for (int i = 0; str[i]; i++) {
-        if ((guint)str[i] < 0x20) {
-            fputc('\\', fp);
-            fputs(json_cntrl[(guint)str[i]], fp);
-        } else if (i > 0 && str[i - 1] == '<' && str[i] == '/') {
-            // Convert </script> to <\/script> to avoid breaking web pages.
-            fputs("\\/", fp);
-        } else {
-            if (str[i] == '\\' || str[i] == '"') {
+    int i, run_start = 0;
+    for (i = 0; str[i]; i++) {
+        /* Characters that can be copied through verbatim are written in
+         * runs with a single fwrite() rather than one fputc() each. */
+        guchar c = (guchar)str[i];
+        enum json_char_class cls = (enum json_char_class)
+            (c < G_N_ELEMENTS(json_char_class) ? json_char_class[c] : 0);
+        if (cls == JSON_CHAR_VERBATIM ||
+            (cls == JSON_CHAR_SLASH && !(i > 0 && str[i - 1] == '<')) ||
+            (cls == JSON_CHAR_DOT && !dot_to_underscore)) {
+            continue;
+        }
+        if (i > run_start) {
+            fwrite(str + run_start, 1, i - run_start, fp);
+        }
+        switch (cls) {
+            case JSON_CHAR_CTRL:
                 fputc('\\', fp);
-            }
-            if (dot_to_underscore && str[i] == '.')
+                fputs(json_cntrl[c], fp);
+                break;
+            case JSON_CHAR_SLASH:
+                // Convert </script> to <\/script> to avoid breaking web pages.
+                fputs("\\/", fp);
+                break;
+            case JSON_CHAR_DOT:
                 fputc('_', fp);
-            else
+                break;
+            default:
+                fputc('\\', fp);
                 fputc(str[i], fp);
+                break;
         }
+        run_start = i + 1;
+    }
+    if (i > run_start) {
+        fwrite(str + run_start, 1, i - run_start, fp);
     }
     fputc('"', fp);
 }
@@ -100,3 +100,38 @@ ws_cpuid_sse42(void)
 	/* in ECX bit 20 toggled on */
 	return (CPUInfo[2] & (1 << 20));
 }
+
+static int
+ws_cpuid_avx2(void)
+{
+	guint32 CPUInfo[4];
+
+	/* AVX2 needs OS support for the YMM state (OSXSAVE plus AVX
+	   state enabled in XCR0) in addition to the CPUID feature bit. */
+	if (!ws_cpuid(CPUInfo, 1))
+		return 0;
+	if (!(CPUInfo[2] & (1 << 27)) || !(CPUInfo[2] & (1 << 28)))
+		return 0;	/* no OSXSAVE or no AVX */
+
+#if defined(_MSC_VER)
+	if ((_xgetbv(0) & 0x6) != 0x6)
+		return 0;	/* XMM/YMM state not enabled by the OS */
+#elif defined(__GNUC__) && defined(__x86_64__)
+	{
+		guint32 xcr0_lo, xcr0_hi;
+
+		__asm__ __volatile__("xgetbv"
+							: "=a" (xcr0_lo), "=d" (xcr0_hi)
+							: "c" (0));
+		if ((xcr0_lo & 0x6) != 0x6)
+			return 0;	/* XMM/YMM state not enabled by the OS */
+	}
+#else
+	return 0;
+#endif
+
+	/* CPUID leaf 7, subleaf 0: AVX2 is EBX bit 5 */
+	if (!ws_cpuid(CPUInfo, 7))
+		return 0;
+	return (CPUInfo[1] & (1 << 5));
+}
@@ -39,6 +39,9 @@ ws_mempbrk_compile(ws_mempbrk_pattern* pattern, const gchar *needles)
 #ifdef HAVE_SSE4_2
     ws_mempbrk_sse42_compile(pattern, needles);
 #endif
+#ifdef HAVE_AVX2
+    ws_mempbrk_avx2_compile(pattern, needles);
+#endif
 }
 
 
@@ -63,6 +66,12 @@ ws_mempbrk_portable_exec(const guint8* haystack, size_t haystacklen, const ws_me
 WS_DLL_PUBLIC const guint8 *
 ws_mempbrk_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pattern* pattern, guchar *found_needle)
 {
+#ifdef HAVE_AVX2
+    /* Wider blocks beat pcmpistri once there's at least one full
+       32-byte block to look at. */
+    if (haystacklen >= 32 && pattern->use_avx2)
+        return ws_mempbrk_avx2_exec(haystack, haystacklen, pattern, found_needle);
+#endif
 #ifdef HAVE_SSE4_2
     if (haystacklen >= 16 && pattern->use_sse42)
         return ws_mempbrk_sse42_exec(haystack, haystacklen, pattern, found_needle);
@@ -16,6 +16,11 @@
 #include <emmintrin.h>
 #endif
 
+/** Maximum number of needles the AVX2 kernel will handle; beyond this
+ * the per-needle broadcast compares stop paying for themselves.
+ */
+#define WS_MEMPBRK_AVX2_MAX_NEEDLES 8
+
 /** The pattern object used for ws_mempbrk_exec().
  */
 typedef struct {
@@ -24,6 +29,11 @@ typedef struct {
     gboolean use_sse42;
     __m128i mask;
 #endif
+#ifdef HAVE_AVX2
+    gboolean use_avx2;
+    guint8 num_needles_avx2;
+    gchar needles_avx2[WS_MEMPBRK_AVX2_MAX_NEEDLES];
+#endif
 } ws_mempbrk_pattern;
 
 /** Compile the pattern for the needles to find using ws_mempbrk_exec().
@@ -0,0 +1,93 @@
+/* ws_mempbrk_avx2.c
+ *
+ * AVX2 pattern-set scanning, runtime-dispatched from ws_mempbrk_exec().
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#ifdef HAVE_AVX2
+
+#include <glib.h>
+#include "ws_cpuid.h"
+
+#include <immintrin.h>
+#include <string.h>
+#include "bits_ctz.h"
+#include "ws_mempbrk.h"
+#include "ws_mempbrk_int.h"
+
+void
+ws_mempbrk_avx2_compile(ws_mempbrk_pattern* pattern, const gchar *needles)
+{
+    size_t length = strlen(needles);
+
+    /*
+     * One broadcast-compare per needle per 32-byte block; past a
+     * handful of needles the table-driven portable loop (or the
+     * pcmpistri path) wins, so don't bother.
+     */
+    pattern->use_avx2 = ws_cpuid_avx2() && length > 0 &&
+                        length <= WS_MEMPBRK_AVX2_MAX_NEEDLES;
+    if (pattern->use_avx2) {
+        pattern->num_needles_avx2 = (guint8)length;
+        memcpy(pattern->needles_avx2, needles, length);
+    }
+}
+
+const guint8 *
+ws_mempbrk_avx2_exec(const guint8* haystack, size_t haystacklen,
+                     const ws_mempbrk_pattern* pattern, guchar *found_needle)
+{
+    __m256i needle[WS_MEMPBRK_AVX2_MAX_NEEDLES];
+    unsigned i;
+
+    for (i = 0; i < pattern->num_needles_avx2; i++)
+        needle[i] = _mm256_set1_epi8(pattern->needles_avx2[i]);
+
+    while (haystacklen >= 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(const void *)haystack);
+        __m256i hits = _mm256_cmpeq_epi8(block, needle[0]);
+        guint32 mask;
+
+        for (i = 1; i < pattern->num_needles_avx2; i++)
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needle[i]));
+
+        mask = (guint32)_mm256_movemask_epi8(hits);
+        if (mask != 0) {
+            const guint8 *hit = haystack + ws_ctz(mask);
+
+            if (found_needle)
+                *found_needle = *hit;
+            return hit;
+        }
+        haystack += 32;
+        haystacklen -= 32;
+    }
+
+    /* Sub-block tail; the byte-table loop is fine for < 32 bytes. */
+    if (haystacklen > 0)
+        return ws_mempbrk_portable_exec(haystack, haystacklen, pattern, found_needle);
+
+    return NULL;
+}
+
+#endif /* HAVE_AVX2 */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */